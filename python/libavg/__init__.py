@@ -13,6 +13,13 @@ del system
 from avg import *
 player = avg.Player.get()
 
+import atexit
+def _stopAsyncLogging():
+    # Stop the flusher thread and pass messages still queued by an asynchronous logger
+    # to the sinks while python is still alive.
+    logger.async = False
+atexit.register(_stopAsyncLogging)
+
 from enumcompat import *
 
 import textarea
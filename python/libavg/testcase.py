@@ -25,6 +25,7 @@ import unittest
 import sys
 import os
 import math
+import time
 
 from libavg import avg, player, logger
 
@@ -70,6 +71,18 @@ class SuppressOutput(object):
         sys.stdout, sys.stderr = self.__savedStreams
 
 
+class LogDuration(object):
+    # Logs the time spent in the with block. Used by benchmark-style tests.
+    def __init__(self, msg):
+        self.__msg = msg
+
+    def __enter__(self):
+        self.__startTime = time.time()
+
+    def __exit__(self, *args):
+        logger.info("%s in %.1f ms"%(self.__msg, (time.time()-self.__startTime)*1000))
+
+
 class MouseEmulator(object):
     def __init__(self):
         self.btnStates = [False, False, False]
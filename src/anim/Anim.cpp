@@ -71,7 +71,7 @@ void Anim::start(bool)
     m_bRunning = true;
     m_This = shared_from_this();
     if (m_bIsRoot) {
-        Player::get()->registerPreRenderListener(this);
+        startStepping();
     }
     if (m_StartCallback != object()) {
         call<void>(m_StartCallback.ptr());
@@ -107,7 +107,7 @@ void Anim::onPlaybackEnd()
 void Anim::setStopped()
 {
     if (m_bIsRoot) {
-        Player::get()->unregisterPreRenderListener(this);
+        stopStepping();
     }
     m_bRunning = false;
     if (m_StopCallback != object()) {
@@ -122,4 +122,14 @@ void Anim::setStopped()
     m_This = AnimPtr();
 }
 
+void Anim::startStepping()
+{
+    Player::get()->registerPreRenderListener(this);
+}
+
+void Anim::stopStepping()
+{
+    Player::get()->unregisterPreRenderListener(this);
+}
+
 }
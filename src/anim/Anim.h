@@ -65,6 +65,10 @@ public:
 
 protected:
     void setStopped();
+    // Called for root animations on start and stop. By default, the animation is 
+    // stepped by a pre-render listener of its own.
+    virtual void startStepping();
+    virtual void stopStepping();
    
 private:
     Anim();
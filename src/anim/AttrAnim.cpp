@@ -23,6 +23,7 @@
 #include "../base/Exception.h"
 #include "../player/Player.h"
 #include "../player/Node.h"
+#include "../player/ExportedObject.h"
 
 using namespace boost;
 using namespace boost::python;
@@ -32,6 +33,18 @@ namespace avg {
 
 AttrAnim::AttrAnimationMap AttrAnim::s_ActiveAnimations;
 
+ObjAttrID::ObjAttrID(const object& obj, const string& sAttrName)
+    : m_sAttrName(sAttrName)
+{
+    // Avoid the python call for libavg objects. getHash() is what __hash__ returns.
+    extract<ExportedObject*> exportedObj(obj);
+    if (exportedObj.check()) {
+        m_ObjHash = exportedObj()->getHash();
+    } else {
+        m_ObjHash = extract<long>(obj.attr("__hash__")());
+    }
+}
+
 bool ObjAttrID::operator < (const ObjAttrID& other) const
 {
     if (m_ObjHash < other.m_ObjHash) {
@@ -54,7 +67,8 @@ AttrAnim::AttrAnim(const object& node, const string& sAttrName,
         const object& startCallback, const object& stopCallback)
     : Anim(startCallback, stopCallback),
       m_Node(node),
-      m_sAttrName(sAttrName)
+      m_sAttrName(sAttrName),
+      m_ID(node, sAttrName)
 {
     object obj = getValue();
 }
@@ -80,21 +94,30 @@ void AttrAnim::setValue(const object& val)
     m_Node.attr(m_sAttrName.c_str()) = val;
 }
 
+const object& AttrAnim::getNode() const
+{
+    return m_Node;
+}
+
+const string& AttrAnim::getAttrName() const
+{
+    return m_sAttrName;
+}
+
 void AttrAnim::addToMap()
 {
-    s_ActiveAnimations[ObjAttrID(m_Node, m_sAttrName)] = 
+    s_ActiveAnimations[m_ID] = 
             dynamic_pointer_cast<AttrAnim>(shared_from_this());
 }
 
 void AttrAnim::removeFromMap()
 {
-    s_ActiveAnimations.erase(ObjAttrID(m_Node, m_sAttrName));
+    s_ActiveAnimations.erase(m_ID);
 }
 
 void AttrAnim::stopActiveAttrAnim()
 {
-    ObjAttrID id(m_Node, m_sAttrName);
-    AttrAnimationMap::iterator it = s_ActiveAnimations.find(id);
+    AttrAnimationMap::iterator it = s_ActiveAnimations.find(m_ID);
     if (it != s_ActiveAnimations.end()) {
         it->second->abort();
     }
@@ -38,11 +38,7 @@
 namespace avg {
 
 struct ObjAttrID {
-    ObjAttrID(const boost::python::object& obj, const std::string& sAttrName)
-        : m_ObjHash(boost::python::extract<long>(obj.attr("__hash__")())),
-          m_sAttrName(sAttrName)
-    {
-    }
+    ObjAttrID(const boost::python::object& obj, const std::string& sAttrName);
     long m_ObjHash;
     std::string m_sAttrName;
     bool operator < (const ObjAttrID& other) const;
@@ -68,6 +64,8 @@ public:
 protected:
     boost::python::object getValue() const;
     void setValue(const boost::python::object& val);
+    const boost::python::object& getNode() const;
+    const std::string& getAttrName() const;
 
     void addToMap();
     void removeFromMap();
@@ -79,6 +77,7 @@ private:
 
     boost::python::object m_Node;
     std::string m_sAttrName;
+    ObjAttrID m_ID;
 
     typedef std::map<ObjAttrID, AttrAnimPtr> AttrAnimationMap;
     static AttrAnimationMap s_ActiveAnimations;
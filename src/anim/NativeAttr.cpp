@@ -0,0 +1,252 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "NativeAttr.h"
+
+#include "../base/Exception.h"
+
+#include "../player/Node.h"
+#include "../player/AreaNode.h"
+#include "../player/VectorNode.h"
+#include "../player/FilledVectorNode.h"
+#include "../player/RectNode.h"
+#include "../player/CircleNode.h"
+
+using namespace boost::python;
+using namespace std;
+
+namespace avg {
+
+template<class NODE>
+class FloatNativeAttr: public NativeAttr
+{
+public:
+    typedef void (NODE::*Setter)(float);
+
+    FloatNativeAttr(NODE* pNode, Setter setter)
+        : NativeAttr(FLOAT),
+          m_pNode(pNode),
+          m_Setter(setter)
+    {}
+
+    virtual void setFloat(float val)
+    {
+        (m_pNode->*m_Setter)(val);
+    }
+
+private:
+    NODE* m_pNode;
+    Setter m_Setter;
+};
+
+template<class NODE>
+class PointNativeAttr: public NativeAttr
+{
+public:
+    typedef void (NODE::*Setter)(const glm::vec2&);
+
+    PointNativeAttr(NODE* pNode, Setter setter)
+        : NativeAttr(POINT),
+          m_pNode(pNode),
+          m_Setter(setter)
+    {}
+
+    virtual void setPoint(const glm::vec2& val)
+    {
+        (m_pNode->*m_Setter)(val);
+    }
+
+private:
+    NODE* m_pNode;
+    Setter m_Setter;
+};
+
+template<class NODE>
+class ColorNativeAttr: public NativeAttr
+{
+public:
+    typedef void (NODE::*Setter)(const Color&);
+
+    ColorNativeAttr(NODE* pNode, Setter setter)
+        : NativeAttr(COLOR),
+          m_pNode(pNode),
+          m_Setter(setter)
+    {}
+
+    virtual void setColor(const Color& val)
+    {
+        (m_pNode->*m_Setter)(val);
+    }
+
+private:
+    NODE* m_pNode;
+    Setter m_Setter;
+};
+
+// True if the attribute the node's python class exposes is the property that libavg
+// exports for NODE.
+template<class NODE>
+bool isExportedAttr(const object& node, const string& sAttrName)
+{
+    PyTypeObject* pClass = converter::registered<NODE>::converters.get_class_object();
+    object exportedClass = object(handle<>(borrowed((PyObject*)pClass)));
+    object nodeClass = node.attr("__class__");
+    const char* pszName = sAttrName.c_str();
+    if (!PyObject_HasAttrString(exportedClass.ptr(), pszName) ||
+            !PyObject_HasAttrString(nodeClass.ptr(), pszName))
+    {
+        return false;
+    }
+    object nodeAttr = nodeClass.attr(pszName);
+    object exportedAttr = exportedClass.attr(pszName);
+    return nodeAttr.ptr() == exportedAttr.ptr();
+}
+
+template<class NODE>
+NODE* getExportedNode(Node* pNode, const object& node, const string& sAttrName)
+{
+    NODE* pTypedNode = dynamic_cast<NODE*>(pNode);
+    if (pTypedNode && isExportedAttr<NODE>(node, sAttrName)) {
+        return pTypedNode;
+    } else {
+        return 0;
+    }
+}
+
+NativeAttrPtr NativeAttr::create(const object& node, const string& sAttrName)
+{
+    extract<Node*> extractNode(node);
+    if (!extractNode.check()) {
+        return NativeAttrPtr();
+    }
+    Node* pNode = extractNode();
+    if (!pNode) {
+        return NativeAttrPtr();
+    }
+
+    if (Node* pTypedNode = getExportedNode<Node>(pNode, node, sAttrName)) {
+        if (sAttrName == "opacity") {
+            return NativeAttrPtr(new FloatNativeAttr<Node>(pTypedNode, 
+                    &Node::setOpacity));
+        }
+    }
+    if (AreaNode* pAreaNode = getExportedNode<AreaNode>(pNode, node, sAttrName)) {
+        if (sAttrName == "x") {
+            return NativeAttrPtr(new FloatNativeAttr<AreaNode>(pAreaNode, 
+                    &AreaNode::setX));
+        } else if (sAttrName == "y") {
+            return NativeAttrPtr(new FloatNativeAttr<AreaNode>(pAreaNode, 
+                    &AreaNode::setY));
+        } else if (sAttrName == "width") {
+            return NativeAttrPtr(new FloatNativeAttr<AreaNode>(pAreaNode, 
+                    &AreaNode::setWidth));
+        } else if (sAttrName == "height") {
+            return NativeAttrPtr(new FloatNativeAttr<AreaNode>(pAreaNode, 
+                    &AreaNode::setHeight));
+        } else if (sAttrName == "angle") {
+            return NativeAttrPtr(new FloatNativeAttr<AreaNode>(pAreaNode, 
+                    &AreaNode::setAngle));
+        } else if (sAttrName == "pos") {
+            return NativeAttrPtr(new PointNativeAttr<AreaNode>(pAreaNode, 
+                    &AreaNode::setPos));
+        } else if (sAttrName == "size") {
+            return NativeAttrPtr(new PointNativeAttr<AreaNode>(pAreaNode, 
+                    &AreaNode::setSize));
+        } else if (sAttrName == "pivot") {
+            return NativeAttrPtr(new PointNativeAttr<AreaNode>(pAreaNode, 
+                    &AreaNode::setPivot));
+        }
+    }
+    if (VectorNode* pVectorNode = getExportedNode<VectorNode>(pNode, node, sAttrName)) {
+        if (sAttrName == "strokewidth") {
+            return NativeAttrPtr(new FloatNativeAttr<VectorNode>(pVectorNode, 
+                    &VectorNode::setStrokeWidth));
+        } else if (sAttrName == "color") {
+            return NativeAttrPtr(new ColorNativeAttr<VectorNode>(pVectorNode, 
+                    &VectorNode::setColor));
+        }
+    }
+    if (FilledVectorNode* pFilledNode = 
+            getExportedNode<FilledVectorNode>(pNode, node, sAttrName))
+    {
+        if (sAttrName == "fillopacity") {
+            return NativeAttrPtr(new FloatNativeAttr<FilledVectorNode>(pFilledNode, 
+                    &FilledVectorNode::setFillOpacity));
+        } else if (sAttrName == "fillcolor") {
+            return NativeAttrPtr(new ColorNativeAttr<FilledVectorNode>(pFilledNode, 
+                    &FilledVectorNode::setFillColor));
+        }
+    }
+    if (RectNode* pRectNode = getExportedNode<RectNode>(pNode, node, sAttrName)) {
+        if (sAttrName == "pos") {
+            return NativeAttrPtr(new PointNativeAttr<RectNode>(pRectNode, 
+                    &RectNode::setPos));
+        } else if (sAttrName == "size") {
+            return NativeAttrPtr(new PointNativeAttr<RectNode>(pRectNode, 
+                    &RectNode::setSize));
+        } else if (sAttrName == "angle") {
+            return NativeAttrPtr(new FloatNativeAttr<RectNode>(pRectNode, 
+                    &RectNode::setAngle));
+        }
+    }
+    if (CircleNode* pCircleNode = getExportedNode<CircleNode>(pNode, node, sAttrName)) {
+        if (sAttrName == "pos") {
+            return NativeAttrPtr(new PointNativeAttr<CircleNode>(pCircleNode, 
+                    &CircleNode::setPos));
+        } else if (sAttrName == "r") {
+            return NativeAttrPtr(new FloatNativeAttr<CircleNode>(pCircleNode, 
+                    &CircleNode::setR));
+        }
+    }
+    return NativeAttrPtr();
+}
+
+NativeAttr::NativeAttr(ValueType type)
+    : m_Type(type)
+{
+}
+
+NativeAttr::~NativeAttr()
+{
+}
+
+NativeAttr::ValueType NativeAttr::getType() const
+{
+    return m_Type;
+}
+
+void NativeAttr::setFloat(float val)
+{
+    AVG_ASSERT(false);
+}
+
+void NativeAttr::setPoint(const glm::vec2& val)
+{
+    AVG_ASSERT(false);
+}
+
+void NativeAttr::setColor(const Color& val)
+{
+    AVG_ASSERT(false);
+}
+
+}
@@ -0,0 +1,69 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#ifndef _NativeAttr_H_
+#define _NativeAttr_H_
+
+#include "../api.h"
+// Python docs say python.h should be included before any standard headers (!)
+#include "../player/WrapPython.h" 
+
+#include "../base/GLMHelper.h"
+#include "../graphics/Color.h"
+
+#include <boost/python.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <string>
+
+namespace avg {
+
+class NativeAttr;
+typedef boost::shared_ptr<NativeAttr> NativeAttrPtr;
+
+// Sets a node attribute by calling the C++ setter directly instead of going through
+// python. Only attributes whose python property is the one exported by libavg are 
+// supported, so python subclasses that override an attribute keep working.
+class AVG_API NativeAttr
+{
+public:
+    enum ValueType {FLOAT, POINT, COLOR};
+
+    // Returns an empty pointer if the attribute has no native setter.
+    static NativeAttrPtr create(const boost::python::object& node, 
+            const std::string& sAttrName);
+
+    NativeAttr(ValueType type);
+    virtual ~NativeAttr();
+
+    ValueType getType() const;
+
+    virtual void setFloat(float val);
+    virtual void setPoint(const glm::vec2& val);
+    virtual void setColor(const Color& val);
+
+private:
+    ValueType m_Type;
+};
+
+}
+
+#endif
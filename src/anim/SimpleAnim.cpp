@@ -25,11 +25,94 @@
 #include "../graphics/Color.h"
 #include "../player/Player.h"
 
+#include <vector>
+
 using namespace boost;
 using namespace boost::python;
 using namespace std;
 
 namespace avg {
+
+// Steps all root animations that have a native attribute in one loop per frame, 
+// instead of registering a pre-render listener for each of them.
+class NativeAnimStepper: public IPreRenderListener
+{
+public:
+    NativeAnimStepper()
+        : m_NumAnims(0),
+          m_bIsStepping(false)
+    {
+    }
+
+    void add(SimpleAnim* pAnim)
+    {
+        if (m_NumAnims == 0 && !m_bIsStepping) {
+            Player::get()->registerPreRenderListener(this);
+        }
+        pAnim->m_StepperIndex = m_pAnims.size();
+        m_pAnims.push_back(pAnim);
+        m_NumAnims++;
+    }
+
+    void remove(SimpleAnim* pAnim)
+    {
+        AVG_ASSERT(m_pAnims[pAnim->m_StepperIndex] == pAnim);
+        // Just clear the entry here. The array is compacted after the next step.
+        m_pAnims[pAnim->m_StepperIndex] = 0;
+        pAnim->m_StepperIndex = -1;
+        m_NumAnims--;
+        if (m_NumAnims == 0 && !m_bIsStepping) {
+            m_pAnims.clear();
+            Player::get()->unregisterPreRenderListener(this);
+        }
+    }
+
+    virtual void onPreRender()
+    {
+        // Animations started in callbacks are appended and not stepped in this frame.
+        m_bIsStepping = true;
+        unsigned numEntries = m_pAnims.size();
+        try {
+            for (unsigned i = 0; i < numEntries; ++i) {
+                SimpleAnim* pAnim = m_pAnims[i];
+                if (pAnim) {
+                    pAnim->step();
+                }
+            }
+        } catch (...) {
+            m_bIsStepping = false;
+            throw;
+        }
+        m_bIsStepping = false;
+        if (m_NumAnims == 0) {
+            m_pAnims.clear();
+            Player::get()->unregisterPreRenderListener(this);
+        } else if (m_NumAnims != m_pAnims.size()) {
+            compact();
+        }
+    }
+
+private:
+    void compact()
+    {
+        unsigned numAnims = 0;
+        for (unsigned i = 0; i < m_pAnims.size(); ++i) {
+            SimpleAnim* pAnim = m_pAnims[i];
+            if (pAnim) {
+                pAnim->m_StepperIndex = numAnims;
+                m_pAnims[numAnims] = pAnim;
+                numAnims++;
+            }
+        }
+        m_pAnims.resize(numAnims);
+    }
+
+    std::vector<SimpleAnim*> m_pAnims;
+    unsigned m_NumAnims;
+    bool m_bIsStepping;
+};
+
+static NativeAnimStepper s_NativeAnimStepper;
    
 SimpleAnim::SimpleAnim(const object& node, const string& sAttrName, long long duration, 
         const object& startValue, const object& endValue, bool bUseInt, 
@@ -38,7 +121,8 @@ SimpleAnim::SimpleAnim(const object& node, const string& sAttrName, long long du
       m_Duration(duration),
       m_StartValue(startValue),
       m_EndValue(endValue),
-      m_bUseInt(bUseInt)
+      m_bUseInt(bUseInt),
+      m_StepperIndex(-1)
 {
 }
 
@@ -51,6 +135,7 @@ SimpleAnim::~SimpleAnim()
 
 void SimpleAnim::start(bool bKeepAttr)
 {
+    initNativeAttr();
     AttrAnim::start();
     if (bKeepAttr) {
         m_StartTime = calcStartTime();
@@ -58,7 +143,11 @@ void SimpleAnim::start(bool bKeepAttr)
         m_StartTime = Player::get()->getFrameTime();
     }
     if (m_Duration == 0) {
-        setValue(m_EndValue);
+        if (m_pNativeAttr) {
+            setNativeEndValue();
+        } else {
+            setValue(m_EndValue);
+        }
         remove();
     } else {
         step();
@@ -87,12 +176,20 @@ bool SimpleAnim::step()
     float t = ((float(Player::get()->getFrameTime())-m_StartTime)
             /m_Duration);
     if (t >= 1.0) {
-        setValue(m_EndValue);
+        if (m_pNativeAttr) {
+            setNativeEndValue();
+        } else {
+            setValue(m_EndValue);
+        }
         remove();
         return true;
     } else {
         object curValue;
         float part = interpolate(t);
+        if (m_pNativeAttr) {
+            setNativeValue(part);
+            return false;
+        }
         if (isPythonType<float>(m_StartValue)) {
             curValue = typedLERP<float>(m_StartValue, m_EndValue, part);
             if (m_bUseInt) {
@@ -185,4 +282,104 @@ void SimpleAnim::remove()
     setStopped();
 }
 
+void SimpleAnim::startStepping()
+{
+    if (m_pNativeAttr) {
+        s_NativeAnimStepper.add(this);
+    } else {
+        AttrAnim::startStepping();
+    }
+}
+
+void SimpleAnim::stopStepping()
+{
+    if (m_StepperIndex != -1) {
+        s_NativeAnimStepper.remove(this);
+    } else {
+        AttrAnim::stopStepping();
+    }
+}
+
+void SimpleAnim::initNativeAttr()
+{
+    m_pNativeAttr = NativeAttr::create(getNode(), getAttrName());
+    if (!m_pNativeAttr) {
+        return;
+    }
+    switch (m_pNativeAttr->getType()) {
+        case NativeAttr::FLOAT:
+            if (isPythonType<float>(m_StartValue) && isPythonType<float>(m_EndValue)) {
+                m_NativeStart = glm::vec2(extract<float>(m_StartValue)(), 0);
+                m_NativeEnd = glm::vec2(extract<float>(m_EndValue)(), 0);
+                return;
+            }
+            break;
+        case NativeAttr::POINT:
+            if (isPythonType<glm::vec2>(m_StartValue) && 
+                    isPythonType<glm::vec2>(m_EndValue))
+            {
+                m_NativeStart = extract<glm::vec2>(m_StartValue);
+                m_NativeEnd = extract<glm::vec2>(m_EndValue);
+                return;
+            }
+            break;
+        case NativeAttr::COLOR:
+            if (isPythonType<Color>(m_StartValue) && isPythonType<Color>(m_EndValue)) {
+                m_NativeStartColor = extract<Color>(m_StartValue);
+                m_NativeEndColor = extract<Color>(m_EndValue);
+                return;
+            }
+            break;
+        default:
+            AVG_ASSERT(false);
+    }
+    // Unexpected value types: Let python handle (and report) them.
+    m_pNativeAttr = NativeAttrPtr();
+}
+
+void SimpleAnim::setNativeValue(float part)
+{
+    switch (m_pNativeAttr->getType()) {
+        case NativeAttr::FLOAT: {
+                float cur = m_NativeStart.x+(m_NativeEnd.x-m_NativeStart.x)*part;
+                if (m_bUseInt) {
+                    cur = round(cur);
+                }
+                m_pNativeAttr->setFloat(cur);
+            }
+            break;
+        case NativeAttr::POINT: {
+                glm::vec2 cur = m_NativeStart+(m_NativeEnd-m_NativeStart)*part;
+                if (m_bUseInt) {
+                    cur = glm::vec2(round(cur.x), round(cur.y));
+                }
+                m_pNativeAttr->setPoint(cur);
+            }
+            break;
+        case NativeAttr::COLOR:
+            m_pNativeAttr->setColor(
+                    Color::mix(m_NativeStartColor, m_NativeEndColor, 1-part));
+            break;
+        default:
+            AVG_ASSERT(false);
+    }
+}
+
+void SimpleAnim::setNativeEndValue()
+{
+    switch (m_pNativeAttr->getType()) {
+        case NativeAttr::FLOAT:
+            m_pNativeAttr->setFloat(m_NativeEnd.x);
+            break;
+        case NativeAttr::POINT:
+            m_pNativeAttr->setPoint(m_NativeEnd);
+            break;
+        case NativeAttr::COLOR:
+            m_pNativeAttr->setColor(m_NativeEndColor);
+            break;
+        default:
+            AVG_ASSERT(false);
+    }
+}
+
 }
@@ -27,6 +27,7 @@
 #include "../player/WrapPython.h" 
 
 #include "AttrAnim.h"
+#include "NativeAttr.h"
 
 #include <boost/python.hpp>
 
@@ -57,8 +58,16 @@ public:
 protected:
     virtual float interpolate(float t)=0;
     void remove();
+    virtual void startStepping();
+    virtual void stopStepping();
     
 private:
+    friend class NativeAnimStepper;
+
+    void initNativeAttr();
+    void setNativeValue(float part);
+    void setNativeEndValue();
+
     long long getStartTime() const;
     long long getDuration() const;
     long long calcStartTime();
@@ -69,6 +78,14 @@ private:
     boost::python::object m_EndValue;
     bool m_bUseInt;
     long long m_StartTime;
+
+    // Set if the attribute can be animated without calling python.
+    NativeAttrPtr m_pNativeAttr;
+    glm::vec2 m_NativeStart;
+    glm::vec2 m_NativeEnd;
+    Color m_NativeStartColor;
+    Color m_NativeEndColor;
+    int m_StepperIndex;
 };
 
 }
@@ -79,6 +79,11 @@ void AudioMsg::setClosed()
     setType(CLOSED);
 }
 
+void AudioMsg::setLoop()
+{
+    setType(LOOP);
+}
+
 AudioMsg::MsgType AudioMsg::getType()
 {
     return m_MsgType;
@@ -144,6 +149,9 @@ void AudioMsg::dump()
         case CLOSED:
             cerr << "CLOSED" << endl;
             break;
+        case LOOP:
+            cerr << "LOOP" << endl;
+            break;
         default:
             AVG_ASSERT(false);
             break;
@@ -35,7 +35,7 @@ namespace avg {
 class AVG_API AudioMsg {
 public:
     enum MsgType {NONE, AUDIO, AUDIO_TIME, END_OF_FILE, ERROR, FRAME, SEEK_DONE, PACKET,
-            CLOSED};
+            CLOSED, LOOP};
     AudioMsg();
     void setAudio(AudioBufferPtr pAudioBuffer, float audioTime);
     void setAudioTime(float audioTime);
@@ -43,6 +43,7 @@ public:
     void setError(const Exception& ex);
     void setSeekDone(int seqNum, float seekTime);
     void setClosed();
+    void setLoop();
 
     virtual ~AudioMsg();
 
@@ -139,6 +139,13 @@ bool AudioSource::processNextMsg(bool bWait)
                 m_StatusQ.push(pStatusMsg);
                 return false;
             }
+            case AudioMsg::LOOP: {
+                // Playback continues with the start of the file.
+                AudioMsgPtr pStatusMsg(new AudioMsg);
+                pStatusMsg->setLoop();
+                m_StatusQ.push(pStatusMsg);
+                return true;
+            }
             case AudioMsg::SEEK_DONE: {
 //                cerr << "        AudioSource: SEEK_DONE" << endl;
                 m_bSeeking = false;
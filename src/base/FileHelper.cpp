@@ -120,6 +120,17 @@ bool fileExists(const string& sFilename)
     return stat(sFilename.c_str(), &myStat) != -1;
 }
 
+bool getFileStamp(const string& sFilename, long long& fileSize, long long& modTime)
+{
+    struct stat myStat;
+    if (stat(sFilename.c_str(), &myStat) == -1) {
+        return false;
+    }
+    fileSize = myStat.st_size;
+    modTime = myStat.st_mtime;
+    return true;
+}
+
 void readWholeFile(const string& sFilename, string& sContent)
 {
     ifstream file(sFilename.c_str());
@@ -36,6 +36,11 @@ bool AVG_API isAbsPath(const std::string& path);
 
 bool AVG_API fileExists(const std::string& sFilename);
 
+// Gets size and modification time of a file so cached data derived from it can be
+// invalidated when it changes. Returns false if the file can't be accessed.
+bool AVG_API getFileStamp(const std::string& sFilename, long long& fileSize,
+        long long& modTime);
+
 void AVG_API readWholeFile(const std::string& sFilename, std::string& sContents);
 
 void AVG_API writeWholeFile(const std::string& sFilename, const std::string& sContent);
@@ -0,0 +1,95 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "LogRingBuffer.h"
+
+#include "Exception.h"
+#include "MathHelper.h"
+
+using namespace std;
+
+namespace avg {
+
+LogRingBuffer::LogRingBuffer(unsigned size)
+    : m_ReadPos(0),
+      m_WritePos(0),
+      m_bOrphaned(false)
+{
+    AVG_ASSERT(ispow2(size));
+    m_Records.resize(size);
+    m_Mask = size-1;
+}
+
+LogRingBuffer::~LogRingBuffer()
+{
+}
+
+bool LogRingBuffer::push(long long seqNum, long long secs, unsigned millis,
+        const category_t& category, severity_t severity, const UTF8String& sMsg)
+{
+    unsigned writePos = m_WritePos.load(memory_order_relaxed);
+    if (writePos - m_ReadPos.load(memory_order_acquire) > m_Mask) {
+        return false;
+    }
+    LogRecord& record = m_Records[writePos & m_Mask];
+    record.m_SeqNum = seqNum;
+    record.m_Secs = secs;
+    record.m_Millis = millis;
+    record.m_Category = category;
+    record.m_Severity = severity;
+    record.m_sMsg = sMsg;
+    m_WritePos.store(writePos+1, memory_order_release);
+    return true;
+}
+
+const LogRecord* LogRingBuffer::front() const
+{
+    unsigned readPos = m_ReadPos.load(memory_order_relaxed);
+    if (readPos == m_WritePos.load(memory_order_acquire)) {
+        return 0;
+    }
+    return &m_Records[readPos & m_Mask];
+}
+
+void LogRingBuffer::pop()
+{
+    unsigned readPos = m_ReadPos.load(memory_order_relaxed);
+    AVG_ASSERT(readPos != m_WritePos.load(memory_order_acquire));
+    m_ReadPos.store(readPos+1, memory_order_release);
+}
+
+bool LogRingBuffer::empty() const
+{
+    return m_ReadPos.load(memory_order_acquire) == m_WritePos.load(memory_order_acquire);
+}
+
+void LogRingBuffer::setOrphaned()
+{
+    m_bOrphaned = true;
+}
+
+bool LogRingBuffer::isOrphaned() const
+{
+    return m_bOrphaned;
+}
+
+}
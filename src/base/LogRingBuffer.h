@@ -0,0 +1,82 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _LogRingBuffer_H_
+#define _LogRingBuffer_H_
+
+#include "../api.h"
+#include "ILogSink.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <atomic>
+#include <vector>
+
+namespace avg {
+
+// A log message as it is stored before being passed to the sinks. The time is kept
+// in binary form and converted by the flusher.
+struct LogRecord
+{
+    long long m_SeqNum;
+    long long m_Secs;
+    unsigned m_Millis;
+    category_t m_Category;
+    severity_t m_Severity;
+    UTF8String m_sMsg;
+};
+
+// Lock-free single producer/single consumer ring of log records. Each logging thread
+// owns one ring; the log flusher is the only consumer. Record slots are reused, so
+// pushing doesn't allocate once the strings in the slots are large enough.
+class AVG_API LogRingBuffer
+{
+public:
+    LogRingBuffer(unsigned size);
+    virtual ~LogRingBuffer();
+
+    // Producer side. Returns false if the ring is full.
+    bool push(long long seqNum, long long secs, unsigned millis,
+            const category_t& category, severity_t severity, const UTF8String& sMsg);
+
+    // Consumer side.
+    const LogRecord* front() const;
+    void pop();
+    bool empty() const;
+
+    // Set when the producing thread has terminated.
+    void setOrphaned();
+    bool isOrphaned() const;
+
+private:
+    std::vector<LogRecord> m_Records;
+    unsigned m_Mask;
+    std::atomic<unsigned> m_ReadPos;
+    std::atomic<unsigned> m_WritePos;
+    std::atomic<bool> m_bOrphaned;
+};
+
+typedef boost::shared_ptr<LogRingBuffer> LogRingBufferPtr;
+
+}
+
+#endif
@@ -22,9 +22,13 @@
 #include "Logger.h"
 #include "Exception.h"
 #include "StandardLogSink.h"
+#include "LogRingBuffer.h"
 #include "OSHelper.h"
 
 #include <boost/algorithm/string.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/condition.hpp>
+#include <boost/thread/tss.hpp>
 
 #ifdef _WIN32
 #include <Winsock2.h>
@@ -68,6 +72,72 @@ namespace {
     boost::mutex s_traceMutex;
     boost::mutex s_sinkMutex;
     boost::mutex s_removeStdSinkMutex;
+
+    // Async mode state.
+    const unsigned RING_BUFFER_SIZE = 1024;
+    std::atomic<bool> s_bAsync(false);
+    std::atomic<long long> s_NextSeqNum(0);
+    std::atomic<long long> s_NumDroppedMessages(0);
+    long long s_NumReportedDroppedMessages = 0;
+    boost::mutex s_asyncMutex;
+    boost::mutex s_drainMutex;
+    boost::mutex s_ringBufferMutex;
+    std::vector<LogRingBufferPtr> s_pRingBuffers;
+    boost::mutex s_flusherMutex;
+    boost::condition s_flusherCond;
+    bool s_bStopFlusher = false;
+    boost::thread* s_pFlusherThread = 0;
+
+    void orphanRingBuffer(LogRingBuffer* pRingBuffer)
+    {
+        // The ring buffer is owned by s_pRingBuffers and removed once it's empty.
+        pRingBuffer->setOrphaned();
+    }
+
+    boost::thread_specific_ptr<LogRingBuffer> s_pThreadRingBuffer(orphanRingBuffer);
+
+    LogRingBuffer* getThreadRingBuffer()
+    {
+        LogRingBuffer* pRingBuffer = s_pThreadRingBuffer.get();
+        if (!pRingBuffer) {
+            LogRingBufferPtr pNewRingBuffer(new LogRingBuffer(RING_BUFFER_SIZE));
+            {
+                lock_guard lock(s_ringBufferMutex);
+                s_pRingBuffers.push_back(pNewRingBuffer);
+            }
+            pRingBuffer = pNewRingBuffer.get();
+            s_pThreadRingBuffer.reset(pRingBuffer);
+        }
+        return pRingBuffer;
+    }
+
+    void getCurrentLogTime(long long& secs, unsigned& millis)
+    {
+        #ifdef _WIN32
+        __int64 now;
+        _time64(&now);
+        secs = now;
+        DWORD tms = timeGetTime();
+        millis = unsigned(tms % 1000);
+        #else
+        struct timeval time;
+        gettimeofday(&time, NULL);
+        secs = time.tv_sec;
+        millis = time.tv_usec/1000;
+        #endif
+    }
+
+    // Static destruction runs in reverse order of construction, so this stops the
+    // flusher thread before the mutexes and ring buffers above are destroyed.
+    struct FlusherStopper {
+        ~FlusherStopper()
+        {
+            if (s_pLogger) {
+                s_pLogger->setAsync(false);
+            }
+        }
+    };
+    FlusherStopper s_FlusherStopper;
 }
 
 boost::mutex Logger::m_CategoryMutex;
@@ -120,10 +190,15 @@ Logger::Logger()
         m_pStdSink = LogSinkPtr(new StandardLogSink);
         addLogSink(m_pStdSink);
     }
+
+    if (getEnv("AVG_LOG_ASYNC", sDummy)) {
+        setAsync(true);
+    }
 }
 
 Logger::~Logger()
 {
+    setAsync(false);
 }
 
 void Logger::addLogSink(const LogSinkPtr& logSink)
@@ -171,30 +246,168 @@ CatToSeverityMap Logger::getCategories()
     return m_CategorySeverities;
 }
 
+void Logger::setAsync(bool bAsync)
+{
+    lock_guard lock(s_asyncMutex);
+    if (bAsync == s_bAsync) {
+        return;
+    }
+    if (bAsync) {
+        s_bStopFlusher = false;
+        s_pFlusherThread = new boost::thread(boost::bind(&Logger::runFlusher, this));
+        s_bAsync = true;
+    } else {
+        s_bAsync = false;
+        {
+            lock_guard flusherLock(s_flusherMutex);
+            s_bStopFlusher = true;
+            s_flusherCond.notify_one();
+        }
+        s_pFlusherThread->join();
+        delete s_pFlusherThread;
+        s_pFlusherThread = 0;
+        drainRingBuffers();
+    }
+}
+
+bool Logger::isAsync() const
+{
+    return s_bAsync;
+}
+
+void Logger::flush()
+{
+    drainRingBuffers();
+}
+
+long long Logger::getNumDroppedMessages() const
+{
+    return s_NumDroppedMessages;
+}
+
 void Logger::trace(const UTF8String& sMsg, const category_t& category,
         severity_t severity) const
 {
-    lock_guard lock(s_traceMutex);
+    long long secs;
+    unsigned millis;
+    getCurrentLogTime(secs, millis);
+    if (s_bAsync) {
+        long long seqNum = s_NextSeqNum++;
+        if (!getThreadRingBuffer()->push(seqNum, secs, millis, category, severity, sMsg))
+        {
+            s_NumDroppedMessages++;
+        }
+        if (!s_bAsync) {
+            // setAsync(false) ran while we were pushing, and its final drain might 
+            // have missed the record.
+            drainRingBuffers();
+        }
+    } else {
+        lock_guard lock(s_traceMutex);
+        dispatch(secs, millis, category, severity, sMsg);
+    }
+}
+
+void Logger::dispatch(long long secs, unsigned millis, const category_t& category,
+        severity_t severity, const UTF8String& sMsg) const
+{
+    // Called with s_traceMutex locked.
     struct tm* pTime;
     #ifdef _WIN32
-    __int64 now;
-    _time64(&now);
+    __int64 now = secs;
     pTime = _localtime64(&now);
-    DWORD tms = timeGetTime();
-    unsigned millis = unsigned(tms % 1000);
     #else
-    struct timeval time;
-    gettimeofday(&time, NULL);
-    pTime = localtime(&time.tv_sec);
-    unsigned millis = time.tv_usec/1000;
+    time_t now = time_t(secs);
+    pTime = localtime(&now);
     #endif
-    lock_guard lockHandler(s_sinkMutex);
+    // The sinks are called without holding s_sinkMutex so sinks can be removed while
+    // another thread is blocked in a sink.
+    std::vector<LogSinkPtr> pSinks;
+    {
+        lock_guard lockHandler(s_sinkMutex);
+        pSinks = m_pSinks;
+    }
     std::vector<LogSinkPtr>::const_iterator it;
-    for(it=m_pSinks.begin(); it!=m_pSinks.end(); ++it){
+    for(it=pSinks.begin(); it!=pSinks.end(); ++it){
         (*it)->logMessage(pTime, millis, category, severity, sMsg);
     }
 }
 
+void Logger::drainRingBuffers() const
+{
+    lock_guard drainLock(s_drainMutex);
+    std::vector<LogRingBufferPtr> pRingBuffers;
+    {
+        lock_guard lock(s_ringBufferMutex);
+        pRingBuffers = s_pRingBuffers;
+    }
+    // Merge the ring buffers by sequence number. Records queued after this point are
+    // left for the next pass, so a busy producer can't keep us here forever.
+    long long endSeqNum = s_NextSeqNum;
+    while (true) {
+        LogRingBuffer* pNextRingBuffer = 0;
+        const LogRecord* pNextRecord = 0;
+        for (unsigned i=0; i<pRingBuffers.size(); ++i) {
+            const LogRecord* pRecord = pRingBuffers[i]->front();
+            if (pRecord && pRecord->m_SeqNum < endSeqNum && 
+                    (!pNextRecord || pRecord->m_SeqNum < pNextRecord->m_SeqNum))
+            {
+                pNextRingBuffer = pRingBuffers[i].get();
+                pNextRecord = pRecord;
+            }
+        }
+        if (!pNextRecord) {
+            break;
+        }
+        {
+            lock_guard lock(s_traceMutex);
+            dispatch(pNextRecord->m_Secs, pNextRecord->m_Millis, 
+                    pNextRecord->m_Category, pNextRecord->m_Severity,
+                    pNextRecord->m_sMsg);
+        }
+        pNextRingBuffer->pop();
+    }
+
+    long long numDropped = s_NumDroppedMessages;
+    if (numDropped != s_NumReportedDroppedMessages) {
+        stringstream ss;
+        ss << "Log buffer overflow: " << numDropped-s_NumReportedDroppedMessages
+                << " messages dropped.";
+        s_NumReportedDroppedMessages = numDropped;
+        long long secs;
+        unsigned millis;
+        getCurrentLogTime(secs, millis);
+        lock_guard lock(s_traceMutex);
+        dispatch(secs, millis, category::NONE, severity::WARNING, ss.str());
+    }
+
+    lock_guard lock(s_ringBufferMutex);
+    std::vector<LogRingBufferPtr>::iterator it = s_pRingBuffers.begin();
+    while (it != s_pRingBuffers.end()) {
+        if ((*it)->isOrphaned() && (*it)->empty()) {
+            it = s_pRingBuffers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void Logger::runFlusher()
+{
+    while (true) {
+        {
+            boost::unique_lock<boost::mutex> lock(s_flusherMutex);
+            if (!s_bStopFlusher) {
+                s_flusherCond.timed_wait(lock, boost::posix_time::milliseconds(10));
+            }
+            if (s_bStopFlusher) {
+                break;
+            }
+        }
+        drainRingBuffers();
+    }
+}
+
 void Logger::logDebug(const UTF8String& msg, const category_t& category) const
 {
     log(msg, category, Logger::severity::DEBUG);
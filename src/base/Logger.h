@@ -90,6 +90,14 @@ public:
             severity_t severity=severity::NONE);
     CatToSeverityMap getCategories();
 
+    // In async mode, trace() only queues the message in a per-thread ring buffer.
+    // A flusher thread passes queued messages to the sinks. Messages from one thread
+    // stay in order; messages that don't fit into a full ring are dropped and counted.
+    void setAsync(bool bAsync);
+    bool isAsync() const;
+    void flush();
+    long long getNumDroppedMessages() const;
+
     void trace(const UTF8String& sMsg, const category_t& category,
             severity_t severity) const;
     void logDebug(const UTF8String& msg,
@@ -119,6 +127,10 @@ public:
 private:
     Logger();
     void setupCategory();
+    void dispatch(long long secs, unsigned millis, const category_t& category,
+            severity_t severity, const UTF8String& sMsg) const;
+    void drainRingBuffers() const;
+    void runFlusher();
 
     std::vector<LogSinkPtr> m_pSinks;
     LogSinkPtr m_pStdSink;
@@ -21,12 +21,10 @@
 
 #include "ObjectCounter.h"
 #include "Exception.h"
-#include "ThreadHelper.h"
-
-#include <boost/thread/mutex.hpp>
 
 #include <iostream>
 #include <sstream>
+#include <iomanip>
 #include <vector>
 #include <algorithm>
 
@@ -37,25 +35,29 @@
 #include <cxxabi.h>
 #endif
 
-#define DEBUG_ALLOC 1
-
 namespace avg {
 
 using namespace std;
 
 ObjectCounter* ObjectCounter::s_pObjectCounter = 0;
 bool ObjectCounter::s_bDeleted = false;
-boost::mutex * pCounterMutex;
 
 void deleteObjectCounter()
 {
     delete ObjectCounter::s_pObjectCounter;
-    delete pCounterMutex;
     ObjectCounter::s_pObjectCounter = 0;
 }
 
 ObjectCounter::ObjectCounter()
+    : m_bOverflowReported(false)
 {
+    for (int i=0; i<NUM_SLOTS; ++i) {
+        m_pTypes[i] = 0;
+        m_Counts[i] = 0;
+    }
+    for (int i=0; i<NUM_MEM_CATEGORIES; ++i) {
+        m_MemUsed[i] = 0;
+    }
 }
 
 ObjectCounter::~ObjectCounter()
@@ -71,7 +73,6 @@ ObjectCounter * ObjectCounter::get()
             return 0;
         } else {
             s_pObjectCounter = new ObjectCounter;
-            pCounterMutex = new boost::mutex;
             atexit(deleteObjectCounter);
         }
     }
@@ -80,67 +81,107 @@ ObjectCounter * ObjectCounter::get()
 
 void ObjectCounter::incRef(const std::type_info* pType)
 {
-#ifdef DEBUG_ALLOC
-    lock_guard Lock(*pCounterMutex);
-    TypeMap::iterator MapEntry = m_TypeMap.find(pType);
-    if (MapEntry == m_TypeMap.end()) {
-        m_TypeMap[pType] = 1;
-    } else {
-        (MapEntry->second)++;
+    int slot = findSlot(pType, true);
+    if (slot != -1) {
+        m_Counts[slot].fetch_add(1, memory_order_relaxed);
     }
-//    cerr << "incRef " << demangle(pType->name()) << ":" << m_TypeMap[pType] << endl;
-#endif
 }
 
 void ObjectCounter::decRef(const std::type_info* pType)
 {
-#ifdef DEBUG_ALLOC
     if (s_bDeleted) {
         // This happens if there are counted static objects that are deleted after 
         // s_pObjectCounter has been deleted.
         return;
     }
-    lock_guard Lock(*pCounterMutex);
-    TypeMap::iterator MapEntry = m_TypeMap.find(pType);
-    if (MapEntry == m_TypeMap.end()) {
+    int slot = findSlot(pType, false);
+    if (slot == -1) {
+        if (m_bOverflowReported) {
+            return;
+        }
         cerr << "ObjectCounter for " << demangle(pType->name()) 
                 << " does not exist." << endl;
         // Can't decref a type that hasn't been incref'd.
         AVG_ASSERT(false);
     } else {
-        (MapEntry->second)--;
-        if (MapEntry->second < 0) {
-            cerr << "ObjectCounter: refcount for " << 
-                    demangle(MapEntry->first->name()) <<
+        int oldCount = m_Counts[slot].fetch_sub(1, memory_order_relaxed);
+        if (oldCount <= 0) {
+            cerr << "ObjectCounter: refcount for " << demangle(pType->name()) <<
                     " < 0" << endl;
             AVG_ASSERT(false);
         }
     }
-//    cerr << "decRef " << demangle(pType->name()) << ":" << MapEntry->second << endl;
-#endif
 }
     
 int ObjectCounter::getCount(const std::type_info* pType)
 {
-    TypeMap::iterator MapEntry = m_TypeMap.find(pType);
-    if (MapEntry == m_TypeMap.end()) {
+    int slot = findSlot(pType, false);
+    if (slot == -1) {
         return 0;
     } else {
-        return MapEntry->second;
+        return m_Counts[slot];
+    }
+}
+
+void ObjectCounter::addBytes(MemCategory category, long long numBytes)
+{
+    if (s_bDeleted) {
+        return;
+    }
+    m_MemUsed[category].fetch_add(numBytes, memory_order_relaxed);
+}
+
+void ObjectCounter::subBytes(MemCategory category, long long numBytes)
+{
+    if (s_bDeleted) {
+        return;
+    }
+    m_MemUsed[category].fetch_sub(numBytes, memory_order_relaxed);
+}
+
+void ObjectCounter::setBytes(MemCategory category, long long numBytes)
+{
+    if (s_bDeleted) {
+        return;
+    }
+    m_MemUsed[category].store(numBytes, memory_order_relaxed);
+}
+
+long long ObjectCounter::getBytes(MemCategory category) const
+{
+    return m_MemUsed[category].load(memory_order_relaxed);
+}
+
+const char* ObjectCounter::memCategoryToString(MemCategory category)
+{
+    switch (category) {
+        case MEM_BITMAP:
+            return "bitmap";
+        case MEM_TEXTURE:
+            return "texture";
+        case MEM_VERTEX_DATA:
+            return "vertexdata";
+        case MEM_IMAGECACHE_CPU:
+            return "imagecache_cpu";
+        case MEM_IMAGECACHE_GPU:
+            return "imagecache_gpu";
+        default:
+            AVG_ASSERT(false);
+            return 0;
     }
-    
 }
 
 std::string ObjectCounter::dump()
 {
     stringstream ss;
     ss << "Object dump: " << endl;
-    TypeMap::iterator it;
     vector<string> strings;
-    for (it = m_TypeMap.begin(); it != m_TypeMap.end(); ++it) {
-        stringstream tempStream;
-        if (it->second > 0) {
-            tempStream << "  " << demangle(it->first->name()) << ": " << it->second;
+    for (int i=0; i<NUM_SLOTS; ++i) {
+        const type_info* pType = m_pTypes[i];
+        int count = m_Counts[i];
+        if (pType && count > 0) {
+            stringstream tempStream;
+            tempStream << "  " << demangle(pType->name()) << ": " << count;
             strings.push_back(tempStream.str());
         }
     }
@@ -148,6 +189,19 @@ std::string ObjectCounter::dump()
     for (vector<string>::iterator it=strings.begin(); it != strings.end(); ++it) {
         ss << *it << endl;
     }
+    ss << dumpMemUsage();
+    return ss.str();
+}
+
+std::string ObjectCounter::dumpMemUsage()
+{
+    stringstream ss;
+    ss << "Memory usage (KB): " << endl;
+    for (int i=0; i<NUM_MEM_CATEGORIES; ++i) {
+        MemCategory category = MemCategory(i);
+        ss << "  " << setw(16) << left << memCategoryToString(category) 
+                << setw(10) << right << getBytes(category)/1024 << endl;
+    }
     return ss.str();
 }
 
@@ -180,8 +234,62 @@ string ObjectCounter::demangle(string s)
     return sResult;
 }
 
-TypeMap ObjectCounter::getObjectCount(){
-    return m_TypeMap;
+TypeMap ObjectCounter::getObjectCount()
+{
+    TypeMap typeMap;
+    for (int i=0; i<NUM_SLOTS; ++i) {
+        const type_info* pType = m_pTypes[i];
+        if (pType) {
+            typeMap[pType] = m_Counts[i];
+        }
+    }
+    return typeMap;
+}
+
+MemUsageMap ObjectCounter::getMemUsage()
+{
+    MemUsageMap memUsage;
+    for (int i=0; i<NUM_MEM_CATEGORIES; ++i) {
+        MemCategory category = MemCategory(i);
+        memUsage[memCategoryToString(category)] = getBytes(category);
+    }
+    return memUsage;
+}
+
+int ObjectCounter::findSlot(const std::type_info* pType, bool bInsert)
+{
+    size_t hash = size_t(pType);
+    hash ^= hash >> 17;
+    hash *= 0x9E3779B1u;
+    int startSlot = int((hash >> 4) % NUM_SLOTS);
+    int slot = startSlot;
+    do {
+        const type_info* pSlotType = m_pTypes[slot].load(memory_order_acquire);
+        if (pSlotType == pType) {
+            return slot;
+        }
+        if (!pSlotType) {
+            if (!bInsert) {
+                return -1;
+            }
+            const type_info* pExpected = 0;
+            if (m_pTypes[slot].compare_exchange_strong(pExpected, pType,
+                    memory_order_acq_rel))
+            {
+                return slot;
+            } else if (pExpected == pType) {
+                // Another thread registered the same type concurrently.
+                return slot;
+            }
+        }
+        slot = (slot+1) % NUM_SLOTS;
+    } while (slot != startSlot);
+
+    if (bInsert && !m_bOverflowReported.exchange(true)) {
+        cerr << "ObjectCounter: Too many types, not counting " << 
+                demangle(pType->name()) << endl;
+    }
+    return -1;
 }
 
 }
@@ -26,30 +26,59 @@
 #include <string>
 #include <map>
 #include <typeinfo>
+#include <atomic>
 
 namespace avg {
 
 typedef std::map<const std::type_info *, int> TypeMap;
+typedef std::map<std::string, long long> MemUsageMap;
 
 class AVG_API ObjectCounter {
 public:
+    enum MemCategory {
+        MEM_BITMAP,         // Pixel memory owned by Bitmaps.
+        MEM_TEXTURE,        // Video memory allocated for GLTextures.
+        MEM_VERTEX_DATA,    // Vertex and index arrays.
+        MEM_IMAGECACHE_CPU, // Bitmaps held by the ImageCache.
+        MEM_IMAGECACHE_GPU, // Textures held by the ImageCache.
+        NUM_MEM_CATEGORIES
+    };
+
     static ObjectCounter* get();
     virtual ~ObjectCounter();
 
+    // incRef and decRef are lock-free and always active.
     void incRef(const std::type_info* pType);
     void decRef(const std::type_info* pType);
 
     int getCount(const std::type_info* pType);
 
+    void addBytes(MemCategory category, long long numBytes);
+    void subBytes(MemCategory category, long long numBytes);
+    void setBytes(MemCategory category, long long numBytes);
+    long long getBytes(MemCategory category) const;
+    static const char* memCategoryToString(MemCategory category);
+
     std::string demangle(std::string s);
     std::string dump();
+    std::string dumpMemUsage();
     TypeMap getObjectCount();
+    MemUsageMap getMemUsage();
 
 private:
     ObjectCounter();
     static void deleteSingleton();
 
-    TypeMap m_TypeMap;
+    int findSlot(const std::type_info* pType, bool bInsert);
+
+    // Open-addressing hash table keyed by type_info address. Slots are claimed
+    // with a compare-and-swap and never released, so lookups need no lock.
+    static const int NUM_SLOTS = 4096;
+    std::atomic<const std::type_info*> m_pTypes[NUM_SLOTS];
+    std::atomic<int> m_Counts[NUM_SLOTS];
+    std::atomic<bool> m_bOverflowReported;
+
+    std::atomic<long long> m_MemUsed[NUM_MEM_CATEGORIES];
 
     static ObjectCounter* s_pObjectCounter;
     static bool s_bDeleted;
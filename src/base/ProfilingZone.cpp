@@ -29,6 +29,8 @@ namespace avg {
 ProfilingZone::ProfilingZone(const ProfilingZoneID& zoneID)
     : m_TimeSum(0),
       m_AvgTime(0),
+      m_NumCalls(0),
+      m_AvgCalls(0),
       m_NumFrames(0),
       m_Indent(0),
       m_ZoneID(zoneID)
@@ -46,6 +48,8 @@ void ProfilingZone::restart()
     m_NumFrames = 0;
     m_AvgTime = 0;
     m_TimeSum = 0;
+    m_NumCalls = 0;
+    m_AvgCalls = 0;
 }
 
 void ProfilingZone::reset()
@@ -53,6 +57,8 @@ void ProfilingZone::reset()
     m_NumFrames++;
     m_AvgTime = (m_AvgTime*(m_NumFrames-1)+m_TimeSum)/m_NumFrames;
     m_TimeSum = 0;
+    m_AvgCalls = (m_AvgCalls*(m_NumFrames-1)+m_NumCalls)/m_NumFrames;
+    m_NumCalls = 0;
 }
 
 long long ProfilingZone::getUSecs() const
@@ -65,6 +71,11 @@ long long ProfilingZone::getAvgUSecs() const
     return m_AvgTime;
 }
 
+float ProfilingZone::getAvgCalls() const
+{
+    return m_AvgCalls;
+}
+
 void ProfilingZone::setIndentLevel(int indent)
 {
     m_Indent = indent;
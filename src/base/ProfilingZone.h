@@ -38,6 +38,7 @@ public:
     void start() 
     {
         m_StartTime = TimeSource::get()->getCurrentMicrosecs();
+        m_NumCalls++;
     };
     void stop()
     {
@@ -46,6 +47,7 @@ public:
     void reset();
     long long getUSecs() const;
     long long getAvgUSecs() const;
+    float getAvgCalls() const;
     void setIndentLevel(int indent);
     int getIndentLevel() const;
     std::string getIndentString() const;
@@ -55,6 +57,8 @@ private:
     long long m_TimeSum;
     long long m_AvgTime;
     long long m_StartTime;
+    int m_NumCalls;
+    float m_AvgCalls;
     int m_NumFrames;
     int m_Indent;
     const ProfilingZoneID& m_ZoneID;
@@ -27,6 +27,7 @@
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/condition.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/function.hpp>
 
 #include <deque>
 
@@ -39,6 +40,7 @@ class AVG_TEMPLATE_API Queue
 {
 public:
     typedef boost::shared_ptr<QElement> QElementPtr;
+    typedef boost::function<void ()> PushCallback;
 
     Queue(int maxSize=-1);
     virtual ~Queue();
@@ -51,6 +53,10 @@ public:
     int size() const;
     int getMaxSize() const;
 
+    // The callback is called with the queue locked after every push. Pass an empty
+    // function to remove it.
+    void setPushCallback(const PushCallback& callback);
+
 private:
     QElementPtr getFrontElement(bool bBlock, unique_lock& Lock) const;
 
@@ -58,6 +64,7 @@ private:
     mutable boost::mutex m_Mutex;
     mutable boost::condition m_Cond;
     int m_MaxSize;
+    PushCallback m_PushCallback;
 };
 
 template<class QElement>
@@ -122,6 +129,9 @@ void Queue<QElement>::push(const QElementPtr& pElem)
     }
     m_pElements.push_back(pElem);
     m_Cond.notify_one();
+    if (m_PushCallback) {
+        m_PushCallback();
+    }
 }
 
 template<class QElement>
@@ -138,6 +148,13 @@ int Queue<QElement>::getMaxSize() const
     return m_MaxSize;
 }
 
+template<class QElement>
+void Queue<QElement>::setPushCallback(const PushCallback& callback)
+{
+    unique_lock lock(m_Mutex);
+    m_PushCallback = callback;
+}
+
 template<class QElement>
 typename Queue<QElement>::QElementPtr 
         Queue<QElement>::getFrontElement(bool bBlock, unique_lock& lock) const
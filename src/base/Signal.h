@@ -26,13 +26,19 @@
 
 #include "Exception.h"
 
-#include <list>
+#include <boost/unordered_map.hpp>
+
+#include <vector>
 
 namespace avg {
 
 
 // Simple implementation of a signal/slot mechanism.
-// Might need to be replaced by boost::signal when things get more complicated.
+// Listeners live in a vector of slots in connection order. Each connected listener
+// maps to its slot index, so connect() and disconnect() are O(1). Disconnected slots
+// are nulled and compacted away once they make up more than half of the slots and
+// no emit() is in progress. This makes it safe to connect and disconnect any listener
+// from inside a listener callback.
 template <class LISTENEROBJ>
 class AVG_TEMPLATE_API Signal {
 public:
@@ -42,23 +48,27 @@ public:
 
     void connect(LISTENEROBJ* pListener);
     void disconnect(LISTENEROBJ* pListener);
+    bool isConnected(LISTENEROBJ* pListener) const;
     
     void emit();
     int getNumListeners() const;
 
 private:
+    void compact();
+
     ListenerFunc m_pFunc;
-    std::list<LISTENEROBJ*> m_Listeners;
-    typedef typename std::list<LISTENEROBJ*>::iterator ListenerIterator;
-    LISTENEROBJ* m_pCurrentListener;
-    bool m_bKillCurrentListener;
+    std::vector<LISTENEROBJ*> m_Listeners;
+    typedef boost::unordered_map<LISTENEROBJ*, unsigned> SlotMap;
+    SlotMap m_SlotMap;
+    unsigned m_NumFreeSlots;
+    int m_EmitDepth;
 };
 
 template<class LISTENEROBJ>
 Signal<LISTENEROBJ>::Signal(ListenerFunc pFunc)
     : m_pFunc(pFunc),
-      m_pCurrentListener(0),
-      m_bKillCurrentListener(false)
+      m_NumFreeSlots(0),
+      m_EmitDepth(0)
 {
 }
 
@@ -70,49 +80,76 @@ Signal<LISTENEROBJ>::~Signal()
 template<class LISTENEROBJ>
 void Signal<LISTENEROBJ>::connect(LISTENEROBJ* pListener)
 {
-    ListenerIterator it;
-    it = find(m_Listeners.begin(), m_Listeners.end(), pListener);
-    // If the listener is already connected, something is wrong, unless we're
-    // deleting it at this very moment.
-    AVG_ASSERT(it == m_Listeners.end() || 
-            (*it == m_pCurrentListener && m_bKillCurrentListener));
+    // If the listener is already connected, something is wrong.
+    AVG_ASSERT(pListener);
+    AVG_ASSERT(m_SlotMap.find(pListener) == m_SlotMap.end());
+    m_SlotMap[pListener] = m_Listeners.size();
     m_Listeners.push_back(pListener);
 }
 
 template<class LISTENEROBJ>
 void Signal<LISTENEROBJ>::disconnect(LISTENEROBJ* pListener)
 {
-    if (m_pCurrentListener == pListener) {
-        m_bKillCurrentListener = true;
-    } else {
-        ListenerIterator it;
-        it = find(m_Listeners.begin(), m_Listeners.end(), pListener);
-        AVG_ASSERT(it != m_Listeners.end());
-        m_Listeners.erase(it);
+    typename SlotMap::iterator it = m_SlotMap.find(pListener);
+    AVG_ASSERT(it != m_SlotMap.end());
+    m_Listeners[it->second] = 0;
+    m_SlotMap.erase(it);
+    m_NumFreeSlots++;
+    if (m_EmitDepth == 0 && m_NumFreeSlots*2 > m_Listeners.size()) {
+        compact();
     }
 }
 
+template<class LISTENEROBJ>
+bool Signal<LISTENEROBJ>::isConnected(LISTENEROBJ* pListener) const
+{
+    return m_SlotMap.find(pListener) != m_SlotMap.end();
+}
+
 template<class LISTENEROBJ>
 void Signal<LISTENEROBJ>::emit()
 {
-    ListenerIterator it;
-    for (it=m_Listeners.begin(); it != m_Listeners.end();) {
-        m_pCurrentListener = *it;
-        ((*it)->*m_pFunc)();   // This is the actual call to the listener.
-        if (m_bKillCurrentListener) {
-            it = m_Listeners.erase(it);
-            m_bKillCurrentListener = false;
-        } else {
-            ++it;
+    m_EmitDepth++;
+    try {
+        // Listeners connected during emit() are appended and called in this pass.
+        for (unsigned i=0; i < m_Listeners.size(); ++i) {
+            LISTENEROBJ* pListener = m_Listeners[i];
+            if (pListener) {
+                (pListener->*m_pFunc)();   // This is the actual call to the listener.
+            }
         }
+    } catch (...) {
+        m_EmitDepth--;
+        throw;
+    }
+    m_EmitDepth--;
+    if (m_EmitDepth == 0 && m_NumFreeSlots*2 > m_Listeners.size()) {
+        compact();
     }
-    m_pCurrentListener = 0;
 }
 
 template<class LISTENEROBJ>
 int Signal<LISTENEROBJ>::getNumListeners() const
 {
-    return m_Listeners.size();
+    return m_SlotMap.size();
+}
+
+template<class LISTENEROBJ>
+void Signal<LISTENEROBJ>::compact()
+{
+    unsigned numUsed = 0;
+    for (unsigned i=0; i < m_Listeners.size(); ++i) {
+        LISTENEROBJ* pListener = m_Listeners[i];
+        if (pListener) {
+            if (numUsed != i) {
+                m_Listeners[numUsed] = pListener;
+                m_SlotMap[pListener] = numUsed;
+            }
+            numUsed++;
+        }
+    }
+    m_Listeners.resize(numUsed);
+    m_NumFreeSlots = 0;
 }
 
 }
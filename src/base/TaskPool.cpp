@@ -0,0 +1,438 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "TaskPool.h"
+
+#include "Logger.h"
+#include "ProfilingZoneID.h"
+#include "ThreadHelper.h"
+#include "TimeSource.h"
+
+#include <boost/thread/once.hpp>
+
+#include <iomanip>
+#include <algorithm>
+
+using namespace std;
+
+namespace avg {
+
+boost::thread_specific_ptr<TaskPool::WorkerInfo> TaskPool::s_pWorkerInfo;
+
+namespace {
+    TaskPool* s_pTaskPool = 0;
+    boost::once_flag s_TaskPoolOnceFlag = BOOST_ONCE_INIT;
+    TaskPool* s_pBackgroundTaskPool = 0;
+    boost::once_flag s_BackgroundTaskPoolOnceFlag = BOOST_ONCE_INIT;
+
+    // Background tasks are mostly bound by file I/O, so two threads are enough.
+    const int NUM_BACKGROUND_THREADS = 2;
+
+    void createTaskPool()
+    {
+        int numThreads = boost::thread::hardware_concurrency();
+        s_pTaskPool = new TaskPool(max(numThreads, 1));
+    }
+
+    void createBackgroundTaskPool()
+    {
+        s_pBackgroundTaskPool = new TaskPool(NUM_BACKGROUND_THREADS, 
+                "BackgroundTaskPool", true);
+    }
+}
+
+TaskPool* TaskPool::get()
+{
+    boost::call_once(s_TaskPoolOnceFlag, createTaskPool);
+    return s_pTaskPool;
+}
+
+bool TaskPool::exists()
+{
+    return s_pTaskPool != 0;
+}
+
+TaskPool* TaskPool::getBackground()
+{
+    boost::call_once(s_BackgroundTaskPoolOnceFlag, createBackgroundTaskPool);
+    return s_pBackgroundTaskPool;
+}
+
+bool TaskPool::backgroundExists()
+{
+    return s_pBackgroundTaskPool != 0;
+}
+
+TaskPool::TaskPool(int numThreads, const string& sName, bool bLowPriority)
+    : m_sName(sName),
+      m_bLowPriority(bLowPriority),
+      m_NumPending(0),
+      m_NextQueue(0),
+      m_bStop(false)
+{
+    AVG_ASSERT(numThreads > 0);
+    for (int i=0; i<numThreads; ++i) {
+        m_pQueues.push_back(WorkerQueuePtr(new WorkerQueue));
+    }
+    for (int i=0; i<numThreads; ++i) {
+        m_pThreads.push_back(
+                new boost::thread(boost::bind(&TaskPool::workerMain, this, i)));
+    }
+}
+
+TaskPool::~TaskPool()
+{
+    {
+        lock_guard lock(m_SleepMutex);
+        m_bStop = true;
+    }
+    m_SleepCondition.notify_all();
+    for (unsigned i=0; i<m_pThreads.size(); ++i) {
+        m_pThreads[i]->join();
+        delete m_pThreads[i];
+    }
+}
+
+void TaskPool::submit(const TaskFunc& func, ProfilingZoneID* pZoneID)
+{
+    pushTask(Task(func, pZoneID, 0));
+}
+
+int TaskPool::getNumThreads() const
+{
+    return int(m_pThreads.size());
+}
+
+bool TaskPool::isWorkerThread() const
+{
+    return getCurrentWorkerIndex() != -1;
+}
+
+bool TaskPool::isLowPriority() const
+{
+    return m_bLowPriority;
+}
+
+bool TaskPool::runPendingTask()
+{
+    int workerIndex = getCurrentWorkerIndex();
+    Task task;
+    if ((workerIndex != -1 && popTask(workerIndex, task)) ||
+            stealTask(workerIndex, task))
+    {
+        executeTask(task);
+        return true;
+    } else {
+        return false;
+    }
+}
+
+void TaskPool::dumpStatistics()
+{
+    ZoneStatsMap stats;
+    vector<StatsBucket*> pBuckets;
+    for (unsigned i=0; i<m_pQueues.size(); ++i) {
+        pBuckets.push_back(&(m_pQueues[i]->m_Stats));
+    }
+    pBuckets.push_back(&m_ExternalStats);
+    for (unsigned i=0; i<pBuckets.size(); ++i) {
+        lock_guard lock(pBuckets[i]->m_Mutex);
+        ZoneStatsMap::iterator it;
+        for (it = pBuckets[i]->m_Stats.begin(); it != pBuckets[i]->m_Stats.end(); ++it) {
+            ZoneStats& zoneStats = stats[it->first];
+            zoneStats.m_NumCalls += it->second.m_NumCalls;
+            zoneStats.m_TotalUSecs += it->second.m_TotalUSecs;
+        }
+    }
+    if (stats.empty()) {
+        return;
+    }
+    category_t category = Logger::category::PROFILE;
+    AVG_TRACE(category, Logger::severity::INFO, m_sName << " (" << m_pThreads.size() 
+            << " threads)");
+    AVG_TRACE(category, Logger::severity::INFO,
+            "Task name                          Avg. time        Calls");
+    AVG_TRACE(category, Logger::severity::INFO,
+            "---------                          ---------        -----");
+    for (ZoneStatsMap::iterator it = stats.begin(); it != stats.end(); ++it) {
+        const ZoneStats& zoneStats = it->second;
+        AVG_TRACE(category, Logger::severity::INFO,
+                std::setw(35) << std::left << it->first->getName()
+                << std::setw(9) << std::right 
+                << zoneStats.m_TotalUSecs/zoneStats.m_NumCalls
+                << std::setw(13) << zoneStats.m_NumCalls);
+    }
+    AVG_TRACE(category, Logger::severity::INFO, "");
+}
+
+TaskPool::Task::Task()
+    : m_pZoneID(0),
+      m_pGroup(0)
+{
+}
+
+TaskPool::Task::Task(const TaskFunc& func, ProfilingZoneID* pZoneID, 
+        TaskGroup* pGroup)
+    : m_Func(func),
+      m_pZoneID(pZoneID),
+      m_pGroup(pGroup)
+{
+}
+
+TaskPool::ZoneStats::ZoneStats()
+    : m_NumCalls(0),
+      m_TotalUSecs(0)
+{
+}
+
+void TaskPool::pushTask(const Task& task)
+{
+    int queueIndex = getCurrentWorkerIndex();
+    if (queueIndex == -1) {
+        queueIndex = m_NextQueue.fetch_add(1) % m_pQueues.size();
+    }
+    WorkerQueue& queue = *m_pQueues[queueIndex];
+    {
+        lock_guard lock(queue.m_Mutex);
+        queue.m_Tasks.push_back(task);
+    }
+    m_NumPending++;
+    lock_guard lock(m_SleepMutex);
+    m_SleepCondition.notify_one();
+}
+
+bool TaskPool::popTask(int workerIndex, Task& task)
+{
+    // Newest task first: It's most likely to still be in the cache.
+    WorkerQueue& queue = *m_pQueues[workerIndex];
+    lock_guard lock(queue.m_Mutex);
+    if (queue.m_Tasks.empty()) {
+        return false;
+    }
+    task = queue.m_Tasks.back();
+    queue.m_Tasks.pop_back();
+    m_NumPending--;
+    return true;
+}
+
+bool TaskPool::stealTask(int thiefIndex, Task& task)
+{
+    // Oldest task first: It's likely to be the largest chunk of remaining work.
+    int numQueues = int(m_pQueues.size());
+    for (int i=1; i<=numQueues; ++i) {
+        int victimIndex = (thiefIndex+i) % numQueues;
+        if (victimIndex == thiefIndex) {
+            continue;
+        }
+        WorkerQueue& queue = *m_pQueues[victimIndex];
+        lock_guard lock(queue.m_Mutex);
+        if (!queue.m_Tasks.empty()) {
+            task = queue.m_Tasks.front();
+            queue.m_Tasks.pop_front();
+            m_NumPending--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskPool::executeTask(Task& task)
+{
+    long long startTime = 0;
+    if (task.m_pZoneID) {
+        startTime = TimeSource::get()->getCurrentMicrosecs();
+    }
+    try {
+        task.m_Func();
+    } catch (const Exception& ex) {
+        if (task.m_pGroup) {
+            task.m_pGroup->onTaskException(ex);
+        } else {
+            AVG_LOG_ERROR("Uncaught exception in " << m_sName << " task: " 
+                    << ex.getStr());
+        }
+    } catch (const std::exception& ex) {
+        if (task.m_pGroup) {
+            task.m_pGroup->onTaskException(Exception(AVG_ERR_UNKNOWN, ex.what()));
+        } else {
+            AVG_LOG_ERROR("Uncaught exception in " << m_sName << " task: " 
+                    << ex.what());
+        }
+    }
+    if (task.m_pZoneID) {
+        long long duration = TimeSource::get()->getCurrentMicrosecs()-startTime;
+        int workerIndex = getCurrentWorkerIndex();
+        StatsBucket& bucket = (workerIndex == -1) ? 
+                m_ExternalStats : m_pQueues[workerIndex]->m_Stats;
+        lock_guard lock(bucket.m_Mutex);
+        ZoneStats& zoneStats = bucket.m_Stats[task.m_pZoneID];
+        zoneStats.m_NumCalls++;
+        zoneStats.m_TotalUSecs += duration;
+    }
+    if (task.m_pGroup) {
+        task.m_pGroup->onTaskDone();
+    }
+}
+
+int TaskPool::getCurrentWorkerIndex() const
+{
+    WorkerInfo* pInfo = s_pWorkerInfo.get();
+    if (pInfo && pInfo->m_pPool == this) {
+        return pInfo->m_Index;
+    } else {
+        return -1;
+    }
+}
+
+void TaskPool::workerMain(int workerIndex)
+{
+    WorkerInfo* pInfo = new WorkerInfo;
+    pInfo->m_pPool = this;
+    pInfo->m_Index = workerIndex;
+    s_pWorkerInfo.reset(pInfo);
+    setAffinityMask(false);
+    if (m_bLowPriority) {
+        setLowThreadPriority();
+    }
+
+    while (true) {
+        Task task;
+        if (popTask(workerIndex, task) || stealTask(workerIndex, task)) {
+            executeTask(task);
+        } else {
+            boost::unique_lock<boost::mutex> lock(m_SleepMutex);
+            if (m_NumPending == 0) {
+                if (m_bStop) {
+                    break;
+                }
+                m_SleepCondition.wait(lock);
+            }
+        }
+    }
+}
+
+
+TaskGroup::TaskGroup(TaskPool* pPool)
+    : m_pPool(pPool),
+      m_NumOutstanding(0)
+{
+}
+
+TaskGroup::~TaskGroup()
+{
+    waitForTasks();
+}
+
+void TaskGroup::run(const TaskPool::TaskFunc& func, ProfilingZoneID* pZoneID)
+{
+    m_NumOutstanding++;
+    m_pPool->pushTask(TaskPool::Task(func, pZoneID, this));
+}
+
+void TaskGroup::wait()
+{
+    waitForTasks();
+    boost::shared_ptr<Exception> pException;
+    {
+        lock_guard lock(m_Mutex);
+        pException.swap(m_pException);
+    }
+    if (pException) {
+        throw *pException;
+    }
+}
+
+bool TaskGroup::isDone() const
+{
+    return m_NumOutstanding == 0;
+}
+
+void TaskGroup::addPendingWork()
+{
+    m_NumOutstanding++;
+}
+
+void TaskGroup::removePendingWork()
+{
+    onTaskDone();
+}
+
+void TaskGroup::waitForTasks()
+{
+    // Outside threads don't help low-priority pools, since they'd be running long 
+    // background tasks at their own priority.
+    bool bHelp = !m_pPool->isLowPriority() || m_pPool->isWorkerThread();
+    while (m_NumOutstanding > 0) {
+        // Help out instead of blocking. The timeout makes sure we get back to 
+        // helping if tasks are pushed while we're waiting.
+        if (!bHelp || !m_pPool->runPendingTask()) {
+            boost::unique_lock<boost::mutex> lock(m_Mutex);
+            if (m_NumOutstanding > 0) {
+                m_DoneCondition.timed_wait(lock, boost::posix_time::milliseconds(1));
+            }
+        }
+    }
+    // Make sure the thread that finished the last task doesn't hold the lock anymore.
+    lock_guard lock(m_Mutex);
+}
+
+void TaskGroup::onTaskDone()
+{
+    lock_guard lock(m_Mutex);
+    m_NumOutstanding--;
+    if (m_NumOutstanding == 0) {
+        m_DoneCondition.notify_all();
+    }
+}
+
+void TaskGroup::onTaskException(const Exception& ex)
+{
+    lock_guard lock(m_Mutex);
+    if (!m_pException) {
+        m_pException = boost::shared_ptr<Exception>(new Exception(ex));
+    }
+}
+
+
+void parallelFor(int begin, int end, const boost::function<void (int, int)>& func, 
+        int grainSize, ProfilingZoneID* pZoneID, TaskPool* pPool)
+{
+    int numElements = end-begin;
+    if (numElements <= 0) {
+        return;
+    }
+    // A few chunks per thread so stealing can even out uneven chunk durations.
+    int chunkSize = max(grainSize, numElements/(pPool->getNumThreads()*4));
+    chunkSize = max(chunkSize, 1);
+    if (chunkSize >= numElements) {
+        func(begin, end);
+        return;
+    }
+    TaskGroup group(pPool);
+    for (int chunkStart = begin; chunkStart < end; chunkStart += chunkSize) {
+        int chunkEnd = min(chunkStart+chunkSize, end);
+        group.run(boost::bind(func, chunkStart, chunkEnd), pZoneID);
+    }
+    group.wait();
+}
+
+}
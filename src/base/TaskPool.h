@@ -0,0 +1,182 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _TaskPool_H_
+#define _TaskPool_H_
+
+#include "../api.h"
+#include "Exception.h"
+
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <vector>
+#include <string>
+
+namespace avg {
+
+class ProfilingZoneID;
+class TaskGroup;
+
+// Central pool of worker threads that executes short, independent tasks. Each
+// worker owns a deque of tasks: it pops its own work LIFO and, when the deque is
+// empty, steals FIFO from the other workers. Tasks submitted from outside the pool
+// are distributed round-robin.
+//
+// If a ProfilingZoneID is passed along with a task, the number of calls and the
+// execution time are accumulated per zone and logged by dumpStatistics().
+class AVG_API TaskPool: boost::noncopyable {
+public:
+    typedef boost::function<void()> TaskFunc;
+
+    // Returns the shared pool, which is created on first use with one thread per
+    // core.
+    static TaskPool* get();
+    static bool exists();
+    // Returns the shared pool for long-running background work like scanning media
+    // files. Its threads run at low priority, and threads outside the pool that wait
+    // for its tasks don't help, so the work never ends up on the main thread.
+    static TaskPool* getBackground();
+    static bool backgroundExists();
+
+    TaskPool(int numThreads, const std::string& sName="TaskPool", 
+            bool bLowPriority=false);
+    virtual ~TaskPool();
+
+    void submit(const TaskFunc& func, ProfilingZoneID* pZoneID=0);
+
+    int getNumThreads() const;
+    bool isWorkerThread() const;
+    bool isLowPriority() const;
+
+    // Executes one pending task in the calling thread if one is available. Used by
+    // TaskGroup::wait() so that waiting threads help instead of blocking.
+    bool runPendingTask();
+
+    void dumpStatistics();
+
+private:
+    struct Task {
+        Task();
+        Task(const TaskFunc& func, ProfilingZoneID* pZoneID, TaskGroup* pGroup);
+
+        TaskFunc m_Func;
+        ProfilingZoneID* m_pZoneID;
+        TaskGroup* m_pGroup;
+    };
+
+    struct ZoneStats {
+        ZoneStats();
+
+        long long m_NumCalls;
+        long long m_TotalUSecs;
+    };
+    typedef std::map<const ProfilingZoneID*, ZoneStats> ZoneStatsMap;
+
+    struct StatsBucket {
+        boost::mutex m_Mutex;
+        ZoneStatsMap m_Stats;
+    };
+
+    struct WorkerQueue {
+        boost::mutex m_Mutex;
+        std::deque<Task> m_Tasks;
+        StatsBucket m_Stats;
+    };
+    typedef boost::shared_ptr<WorkerQueue> WorkerQueuePtr;
+
+    friend class TaskGroup;
+    void pushTask(const Task& task);
+    bool popTask(int workerIndex, Task& task);
+    bool stealTask(int thiefIndex, Task& task);
+    void executeTask(Task& task);
+    int getCurrentWorkerIndex() const;
+    void workerMain(int workerIndex);
+
+    std::string m_sName;
+    bool m_bLowPriority;
+    std::vector<WorkerQueuePtr> m_pQueues;
+    // Statistics for tasks executed by threads outside the pool.
+    StatsBucket m_ExternalStats;
+    std::vector<boost::thread*> m_pThreads;
+    std::atomic<int> m_NumPending;
+    std::atomic<unsigned> m_NextQueue;
+
+    boost::mutex m_SleepMutex;
+    boost::condition_variable m_SleepCondition;
+    bool m_bStop;
+
+    // Index of the current thread's queue in the pool that owns it.
+    struct WorkerInfo {
+        const TaskPool* m_pPool;
+        int m_Index;
+    };
+    static boost::thread_specific_ptr<WorkerInfo> s_pWorkerInfo;
+};
+
+// Fork-join helper. Tasks run through a TaskGroup can be waited for; the first
+// exception thrown by a task is rethrown by wait(). The destructor waits as well.
+class AVG_API TaskGroup: boost::noncopyable {
+public:
+    TaskGroup(TaskPool* pPool=TaskPool::get());
+    virtual ~TaskGroup();
+
+    void run(const TaskPool::TaskFunc& func, ProfilingZoneID* pZoneID=0);
+    void wait();
+    // Returns true if all tasks have finished. wait() still needs to be called to
+    // get exceptions thrown by the tasks.
+    bool isDone() const;
+
+    // Keeps wait() from returning while work that isn't queued as a task is still
+    // outstanding, e.g. an idle WorkerThread that waits for its next command.
+    void addPendingWork();
+    void removePendingWork();
+
+private:
+    friend class TaskPool;
+    void waitForTasks();
+    void onTaskDone();
+    void onTaskException(const Exception& ex);
+
+    TaskPool* m_pPool;
+    std::atomic<int> m_NumOutstanding;
+    boost::mutex m_Mutex;
+    boost::condition_variable m_DoneCondition;
+    boost::shared_ptr<Exception> m_pException;
+};
+
+// Calls func(rangeStart, rangeEnd) for consecutive chunks of [begin, end) in 
+// parallel and returns when all chunks are done. Chunks contain at least grainSize
+// elements.
+void AVG_API parallelFor(int begin, int end, 
+        const boost::function<void (int, int)>& func, int grainSize=1,
+        ProfilingZoneID* pZoneID=0, TaskPool* pPool=TaskPool::get());
+
+}
+
+#endif
@@ -26,6 +26,14 @@
 #ifdef _WIN32
 #include <Windows.h>
 #include <Mmsystem.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 #endif
 
 using namespace std;
@@ -105,6 +113,24 @@ unsigned getLowestBitSet(unsigned val)
     return pos;
 }
 
+void setLowThreadPriority()
+{
+    // Failure isn't fatal here, the thread just keeps its priority.
+#ifdef __linux__
+    // Under linux, the nice value is per thread.
+    setpriority(PRIO_PROCESS, syscall(SYS_gettid), 10);
+#elif defined _WIN32
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+#else
+    int policy;
+    sched_param param;
+    if (pthread_getschedparam(pthread_self(), &policy, &param) == 0) {
+        param.sched_priority = sched_get_priority_min(policy);
+        pthread_setschedparam(pthread_self(), policy, &param);
+    }
+#endif
+}
+
 void yield()
 {
 #ifdef __linux__
@@ -33,6 +33,9 @@ void AVG_API setAffinityMask(bool bIsMainThread);
 typedef boost::lock_guard<boost::mutex> lock_guard;
 unsigned getLowestBitSet(unsigned val);
 void AVG_API yield();
+// Lowers the scheduling priority of the calling thread. Used for background work
+// that shouldn't compete with rendering and decoding.
+void AVG_API setLowThreadPriority();
 
 }
 
@@ -112,15 +112,17 @@ void ThreadProfiler::dumpStatistics()
     if (!m_Zones.empty()) {
         AVG_TRACE(m_LogCategory, Logger::severity::INFO, "Thread " << m_sName);
         AVG_TRACE(m_LogCategory, Logger::severity::INFO,
-                "Zone name                          Avg. time");
+                "Zone name                          Avg. time  Calls/frame");
         AVG_TRACE(m_LogCategory, Logger::severity::INFO,
-                "---------                          ---------");
+                "---------                          ---------  -----------");
 
         for (auto it = m_Zones.begin(); it != m_Zones.end(); ++it) {
             AVG_TRACE(m_LogCategory, Logger::severity::INFO,
                     std::setw(35) << std::left 
                     << ((*it)->getIndentString()+(*it)->getName())
-                    << std::setw(9) << std::right << (*it)->getAvgUSecs());
+                    << std::setw(9) << std::right << (*it)->getAvgUSecs()
+                    << std::setw(13) << std::fixed << std::setprecision(1) 
+                    << (*it)->getAvgCalls());
         }
         AVG_TRACE(m_LogCategory, Logger::severity::INFO, "");
     }
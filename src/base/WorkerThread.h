@@ -28,10 +28,14 @@
 #include "Logger.h"
 #include "ThreadProfiler.h"
 #include "CmdQueue.h"
+#include "TaskPool.h"
+#include "ProfilingZoneID.h"
 
 #include <boost/shared_ptr.hpp>
+#include <boost/bind.hpp>
 
 #include <iostream>
+#include <atomic>
 
 namespace avg {
 
@@ -50,6 +54,13 @@ public:
     virtual ~WorkerThread();
     void operator()();
 
+    // Alternative to running the thread in a dedicated boost::thread: Each iteration
+    // of the thread loop is scheduled as a task on the group's TaskPool. work() must
+    // not block in this mode. Once the command queue is empty, the thread stays idle
+    // until the next command is pushed. The object must stay alive until group.wait()
+    // returns, which happens after the thread has stopped.
+    void startOnPool(TaskGroup& group);
+
     void waitForCommand();
     void stop();
 
@@ -62,11 +73,18 @@ private:
     virtual void deinit() {};
 
     void processCommands();
+    void runPoolSlice();
+    void onPoolCmdPushed();
+    void stopOnPool();
 
     std::string m_sName;
     bool m_bShouldStop;
     CQueue& m_CmdQ;
     category_t m_LogCategory;
+    bool m_bInitialized;
+    ProfilingZoneID m_PoolZoneID;
+    TaskGroup* m_pPoolGroup;
+    std::atomic<bool> m_bPoolSliceScheduled;
 };
 
 template<class DERIVED_THREAD>
@@ -75,17 +93,25 @@ WorkerThread<DERIVED_THREAD>::WorkerThread(const std::string& sName, CQueue& Cmd
     : m_sName(sName),
       m_bShouldStop(false),
       m_CmdQ(CmdQ),
-      m_LogCategory(logCategory)
+      m_LogCategory(logCategory),
+      m_bInitialized(false),
+      m_PoolZoneID(sName),
+      m_pPoolGroup(0),
+      m_bPoolSliceScheduled(false)
 {
 }
 
 template<class DERIVED_THREAD>
 WorkerThread<DERIVED_THREAD>::WorkerThread(WorkerThread const& other)
-    : m_CmdQ(other.m_CmdQ)
+    : m_CmdQ(other.m_CmdQ),
+      m_PoolZoneID(other.m_sName),
+      m_pPoolGroup(other.m_pPoolGroup),
+      m_bPoolSliceScheduled(false)
 {
     m_sName = other.m_sName;
     m_bShouldStop = other.m_bShouldStop;
     m_LogCategory = other.m_LogCategory;
+    m_bInitialized = other.m_bInitialized;
 }
 
 template<class DERIVED_THREAD>
@@ -125,6 +151,16 @@ void WorkerThread<DERIVED_THREAD>::operator()()
     }
 }
 
+template<class DERIVED_THREAD>
+void WorkerThread<DERIVED_THREAD>::startOnPool(TaskGroup& group)
+{
+    m_pPoolGroup = &group;
+    group.addPendingWork();
+    m_bPoolSliceScheduled = true;
+    m_CmdQ.setPushCallback(boost::bind(&WorkerThread::onPoolCmdPushed, this));
+    group.run(boost::bind(&WorkerThread::runPoolSlice, this), &m_PoolZoneID);
+}
+
 template<class DERIVED_THREAD>
 void WorkerThread<DERIVED_THREAD>::waitForCommand() 
 {
@@ -150,6 +186,60 @@ bool WorkerThread<DERIVED_THREAD>::init()
     return true;
 }
 
+template<class DERIVED_THREAD>
+void WorkerThread<DERIVED_THREAD>::runPoolSlice()
+{
+    try {
+        if (!m_bInitialized) {
+            if (!init()) {
+                stopOnPool();
+                return;
+            }
+            m_bInitialized = true;
+        }
+        bool bOK = work();
+        if (!bOK) {
+            m_bShouldStop = true;
+        }
+        if (!m_bShouldStop) {
+            processCommands();
+        }
+        if (m_bShouldStop) {
+            deinit();
+            stopOnPool();
+        } else {
+            // Go idle. A command pushed after processCommands() either finds the flag
+            // cleared and schedules the next slice itself or is caught by the check
+            // below.
+            m_bPoolSliceScheduled = false;
+            if (!m_CmdQ.empty() && !m_bPoolSliceScheduled.exchange(true)) {
+                m_pPoolGroup->run(boost::bind(&WorkerThread::runPoolSlice, this),
+                        &m_PoolZoneID);
+            }
+        }
+    } catch (const Exception& e) {
+         AVG_LOG_ERROR("Uncaught exception in thread " << m_sName << ": " << e.getStr());
+         stopOnPool();
+         throw;
+    }
+}
+
+template<class DERIVED_THREAD>
+void WorkerThread<DERIVED_THREAD>::onPoolCmdPushed()
+{
+    if (!m_bPoolSliceScheduled.exchange(true)) {
+        m_pPoolGroup->run(boost::bind(&WorkerThread::runPoolSlice, this), &m_PoolZoneID);
+    }
+}
+
+template<class DERIVED_THREAD>
+void WorkerThread<DERIVED_THREAD>::stopOnPool()
+{
+    // m_bPoolSliceScheduled stays set, so no further slices are scheduled.
+    m_CmdQ.setPushCallback(typename CQueue::PushCallback());
+    m_pPoolGroup->removePendingWork();
+}
+
 template<class DERIVED_THREAD>
 void WorkerThread<DERIVED_THREAD>::processCommands()
 {
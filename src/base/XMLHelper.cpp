@@ -52,6 +52,12 @@ string getXmlChildrenAsString(const xmlDocPtr xmlDoc, const xmlNodePtr& xmlNode)
 static xmlExternalEntityLoader DefaultLoaderProc = 0;
 static std::map<string, string> g_DTDMap;
 
+struct CachedDTD {
+    string m_sDTD;
+    boost::shared_ptr<xmlDtd> m_pDTD;
+};
+static std::map<string, CachedDTD> g_DTDCache;
+
 xmlParserInputPtr
 DTDExternalEntityLoader(const char *pURL, const char *pID, xmlParserCtxtPtr ctxt) 
 {
@@ -82,7 +88,6 @@ XMLParser::XMLParser()
     : m_SchemaParserCtxt(0),
       m_Schema(0),
       m_SchemaValidCtxt(0),
-      m_DTD(0),
       m_DTDValidCtxt(0),
       m_Doc(0)
 {
@@ -102,9 +107,6 @@ XMLParser::~XMLParser()
     if (m_SchemaValidCtxt) {
         xmlSchemaFreeValidCtxt(m_SchemaValidCtxt);
     }
-    if (m_DTD) {
-        xmlFreeDtd(m_DTD);
-    }
     if (m_DTDValidCtxt) {
         xmlFreeValidCtxt(m_DTDValidCtxt);
     }
@@ -119,7 +121,7 @@ void XMLParser::setSchema(const string& sSchema, const string& sSchemaName)
     AVG_ASSERT(!m_SchemaParserCtxt);
     AVG_ASSERT(!m_Schema);
     AVG_ASSERT(!m_SchemaValidCtxt);
-    AVG_ASSERT(!m_DTD);
+    AVG_ASSERT(!m_pDTD);
     AVG_ASSERT(!m_DTDValidCtxt);
 
     m_SchemaParserCtxt = xmlSchemaNewMemParserCtxt(sSchema.c_str(), sSchema.length());
@@ -137,13 +139,22 @@ void XMLParser::setDTD(const std::string& sDTD, const std::string& sDTDName)
     AVG_ASSERT(!m_SchemaParserCtxt);
     AVG_ASSERT(!m_Schema);
     AVG_ASSERT(!m_SchemaValidCtxt);
-    AVG_ASSERT(!m_DTD);
+    AVG_ASSERT(!m_pDTD);
     AVG_ASSERT(!m_DTDValidCtxt);
 
-    registerDTDEntityLoader("memory.dtd", sDTD.c_str());
-    string sDTDFName = "memory.dtd";
-    m_DTD = xmlParseDTD(NULL, (const xmlChar*) sDTDFName.c_str());
-    checkError(!m_DTD, sDTDName);
+    std::map<string, CachedDTD>::iterator it = g_DTDCache.find(sDTDName);
+    if (it != g_DTDCache.end() && it->second.m_sDTD == sDTD) {
+        m_pDTD = it->second.m_pDTD;
+    } else {
+        registerDTDEntityLoader("memory.dtd", sDTD.c_str());
+        string sDTDFName = "memory.dtd";
+        xmlDtdPtr pDTD = xmlParseDTD(NULL, (const xmlChar*) sDTDFName.c_str());
+        checkError(!pDTD, sDTDName);
+        m_pDTD = boost::shared_ptr<xmlDtd>(pDTD, xmlFreeDtd);
+        CachedDTD& cachedDTD = g_DTDCache[sDTDName];
+        cachedDTD.m_sDTD = sDTD;
+        cachedDTD.m_pDTD = m_pDTD;
+    }
 
     m_DTDValidCtxt = xmlNewValidCtxt();
     checkError(!m_DTDValidCtxt, sDTDName);
@@ -165,8 +176,8 @@ void XMLParser::parse(const string& sXML, const string& sXMLName)
         AVG_ASSERT(err != -1);
         bOK = (err == 0);
     }
-    if (m_DTD) {
-        int err = xmlValidateDtd(m_DTDValidCtxt, m_Doc, m_DTD);
+    if (m_pDTD) {
+        int err = xmlValidateDtd(m_DTDValidCtxt, m_Doc, m_pDTD.get());
         bOK = (err != 0);
     }
     if (!bOK) {
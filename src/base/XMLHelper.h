@@ -28,6 +28,8 @@
 #include <libxml/xmlwriter.h>
 #include <libxml/xmlschemas.h>
 
+#include <boost/shared_ptr.hpp>
+
 #include <string>
 
 namespace avg {
@@ -59,7 +61,8 @@ private:
     xmlSchemaPtr m_Schema;
     xmlSchemaValidCtxtPtr m_SchemaValidCtxt;
 
-    xmlDtdPtr m_DTD;
+    // Parsed DTDs are shared between parsers using the same DTD.
+    boost::shared_ptr<xmlDtd> m_pDTD;
     xmlValidCtxtPtr m_DTDValidCtxt;
     
     xmlDocPtr m_Doc;
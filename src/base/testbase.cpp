@@ -23,6 +23,7 @@
 #include "Queue.h"
 #include "Command.h"
 #include "WorkerThread.h"
+#include "TaskPool.h"
 #include "ObjectCounter.h"
 #include "Polygon.h"
 #include "GLMHelper.h"
@@ -331,6 +332,133 @@ public:
 };
 
 
+// work() must not block when the thread runs on a TaskPool.
+class PoolWorkerThread: public WorkerThread<PoolWorkerThread>
+{
+public:
+    PoolWorkerThread(CQueue& cmdQ)
+        : WorkerThread<PoolWorkerThread>("PoolThread", cmdQ),
+          m_NumWorkCalls(0),
+          m_IntParam(0)
+    {
+    }
+
+    bool work()
+    {
+        m_NumWorkCalls++;
+        return true;
+    }
+
+    void setIntParam(int i)
+    {
+        m_IntParam = i;
+    }
+
+    int getNumWorkCalls() const
+    {
+        return m_NumWorkCalls;
+    }
+
+    int getIntParam() const
+    {
+        return m_IntParam;
+    }
+
+private:
+    std::atomic<int> m_NumWorkCalls;
+    std::atomic<int> m_IntParam;
+};
+
+
+static void fillRange(vector<int>* pValues, int start, int end)
+{
+    for (int i=start; i<end; ++i) {
+        (*pValues)[i] = i;
+    }
+}
+
+static void nestedFill(vector<int>* pValues, TaskPool* pPool, int start, int end)
+{
+    parallelFor(start, end, boost::bind(&fillRange, pValues, _1, _2), 16, 0, pPool);
+}
+
+static void throwException()
+{
+    throw Exception(AVG_ERR_UNKNOWN, "TaskPoolTest");
+}
+
+class TaskPoolTest: public Test
+{
+public:
+    TaskPoolTest()
+        : Test("TaskPoolTest", 2)
+    {
+    }
+
+    void runTests() 
+    {
+        TaskPool pool(4);
+        TEST(pool.getNumThreads() == 4);
+        TEST(!pool.isWorkerThread());
+        {
+            vector<int> values(100000, -1);
+            parallelFor(0, int(values.size()), boost::bind(&fillRange, &values, _1, _2),
+                    1, 0, &pool);
+            TEST(checkValues(values));
+        }
+        {
+            // Tasks that wait for subtasks help out instead of blocking the pool.
+            vector<int> values(4096, -1);
+            parallelFor(0, int(values.size()), 
+                    boost::bind(&nestedFill, &values, &pool, _1, _2), 256, 0, &pool);
+            TEST(checkValues(values));
+        }
+        {
+            TaskGroup group(&pool);
+            group.run(&throwException);
+            bool bExceptionThrown = false;
+            try {
+                group.wait();
+            } catch (const Exception& ex) {
+                bExceptionThrown = (ex.getStr() == "TaskPoolTest");
+            }
+            TEST(bExceptionThrown);
+        }
+        {
+            PoolWorkerThread::CQueue cmdQ;
+            PoolWorkerThread thread(cmdQ);
+            TaskGroup group(&pool);
+            thread.startOnPool(group);
+            msleep(20);
+            // Without commands, the thread runs a single slice and then stays idle.
+            TEST(thread.getNumWorkCalls() == 1);
+            TEST(!group.isDone());
+            cmdQ.pushCmd(boost::bind(&PoolWorkerThread::setIntParam, _1, 23));
+            for (int i=0; i<1000 && thread.getIntParam() != 23; ++i) {
+                msleep(1);
+            }
+            TEST(thread.getIntParam() == 23);
+            msleep(20);
+            TEST(thread.getNumWorkCalls() == 2);
+            cmdQ.pushCmd(boost::bind(&PoolWorkerThread::stop, _1));
+            group.wait();
+            TEST(thread.getNumWorkCalls() == 3);
+        }
+    }
+
+private:
+    bool checkValues(const vector<int>& values)
+    {
+        for (unsigned i=0; i<values.size(); ++i) {
+            if (values[i] != int(i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+
 class DummyClass
 {
 public:
@@ -364,6 +492,14 @@ public:
             TEST(ObjectCounter::get()->getCount(&typeid(dummy1)) == 2);
         }
         TEST(ObjectCounter::get()->getCount(&typeid(DummyClass)) == 0);
+
+        ObjectCounter* pCounter = ObjectCounter::get();
+        long long oldBytes = pCounter->getBytes(ObjectCounter::MEM_VERTEX_DATA);
+        pCounter->addBytes(ObjectCounter::MEM_VERTEX_DATA, 1000);
+        TEST(pCounter->getBytes(ObjectCounter::MEM_VERTEX_DATA) == oldBytes+1000);
+        TEST(pCounter->getMemUsage()["vertexdata"] == oldBytes+1000);
+        pCounter->subBytes(ObjectCounter::MEM_VERTEX_DATA, 1000);
+        TEST(pCounter->getBytes(ObjectCounter::MEM_VERTEX_DATA) == oldBytes);
     }
 };
 
@@ -853,6 +989,70 @@ public:
 };
 
 
+class SignalBenchmarkTest: public Test
+{
+public:
+    SignalBenchmarkTest()
+        : Test("SignalBenchmarkTest", 2)
+    {
+    }
+
+    void runTests()
+    {
+        const int NUM_LISTENERS = 10000;
+        const int NUM_CHURN = 1000;
+        const int NUM_FRAMES = 100;
+
+        Signal<Listener> s(&Listener::func);
+        vector<boost::shared_ptr<Listener> > pListeners;
+        for (int i=0; i<NUM_LISTENERS; ++i) {
+            pListeners.push_back(boost::shared_ptr<Listener>(new Listener(s)));
+            s.connect(pListeners[i].get());
+        }
+        vector<boost::shared_ptr<Listener> > pDisconnecters;
+        for (int i=0; i<NUM_CHURN; ++i) {
+            pDisconnecters.push_back(boost::shared_ptr<Listener>(
+                    new DisconnectingSelfListener(s)));
+        }
+
+        long long startTime = TimeSource::get()->getCurrentMicrosecs();
+        for (int frame=0; frame<NUM_FRAMES; ++frame) {
+            // Move a block of listeners to the end and add listeners that
+            // disconnect themselves during emit().
+            for (int i=0; i<NUM_CHURN; ++i) {
+                Listener* pListener = pListeners[(frame*NUM_CHURN+i)%NUM_LISTENERS].get();
+                s.disconnect(pListener);
+                s.connect(pListener);
+                s.connect(pDisconnecters[i].get());
+            }
+            s.emit();
+        }
+        long long duration = TimeSource::get()->getCurrentMicrosecs() - startTime;
+        string sDummy;
+        if (getEnv("AVG_BENCHMARK", sDummy)) {
+            cerr << string(m_IndentLevel+6, ' ') << NUM_LISTENERS << " listeners, "
+                    << NUM_CHURN << " reconnects/frame: " << duration/NUM_FRAMES 
+                    << " us/frame" << endl;
+        }
+
+        TEST(s.getNumListeners() == NUM_LISTENERS);
+        bool bAllCalled = true;
+        for (int i=0; i<NUM_LISTENERS; ++i) {
+            bAllCalled &= pListeners[i]->funcCalled();
+        }
+        for (int i=0; i<NUM_CHURN; ++i) {
+            bAllCalled &= pDisconnecters[i]->funcCalled();
+            TEST(!s.isConnected(pDisconnecters[i].get()));
+        }
+        TEST(bAllCalled);
+        for (int i=0; i<NUM_LISTENERS; ++i) {
+            s.disconnect(pListeners[i].get());
+        }
+        TEST(s.getNumListeners() == 0);
+    }
+};
+
+
 class BacktraceTest: public Test
 {
 public:
@@ -975,6 +1175,110 @@ public:
     }
 };
 
+class RecordingLogSink: public ILogSink
+{
+public:
+    virtual void logMessage(const tm* pTime, unsigned millis, const category_t& category,
+            severity_t severity, const UTF8String& sMsg)
+    {
+        boost::lock_guard<boost::mutex> lock(m_Mutex);
+        if (category == m_Category) {
+            m_sMsgs.push_back(sMsg);
+        }
+    }
+
+    category_t m_Category;
+    vector<string> m_sMsgs;
+    boost::mutex m_Mutex;
+};
+
+typedef boost::shared_ptr<RecordingLogSink> RecordingLogSinkPtr;
+
+
+class AsyncLoggerTest: public Test
+{
+public:
+    AsyncLoggerTest()
+      : Test("AsyncLoggerTest", 2)
+    {
+    }
+
+    void runTests()
+    {
+        const int NUM_THREADS = 4;
+        const int NUM_MSGS = 500;
+
+        Logger* pLogger = Logger::get();
+        RecordingLogSinkPtr pSink(new RecordingLogSink);
+        pSink->m_Category = pLogger->configureCategory("ASYNC_TEST",
+                Logger::severity::INFO);
+        pLogger->addLogSink(pSink);
+
+        // Keep the standard sink's output out of the test log. The TESTs run after
+        // cerr is restored, since the flusher thread writes to it.
+        std::stringstream buffer;
+        std::streambuf *sbuf = std::cerr.rdbuf();
+        std::cerr.rdbuf(buffer.rdbuf());
+
+        pLogger->setAsync(true);
+        bool bIsAsync = pLogger->isAsync();
+        {
+            boost::thread_group threads;
+            for (int i=0; i<NUM_THREADS; ++i) {
+                threads.create_thread(boost::bind(&AsyncLoggerTest::logMessages,
+                        this, i, NUM_MSGS, pSink->m_Category));
+            }
+            threads.join_all();
+        }
+        long long numDropped = pLogger->getNumDroppedMessages();
+        pLogger->flush();
+        bool bAllReceived;
+        bool bInOrder = true;
+        {
+            boost::lock_guard<boost::mutex> lock(pSink->m_Mutex);
+            bAllReceived = (pSink->m_sMsgs.size() + numDropped == 
+                    unsigned(NUM_THREADS*NUM_MSGS));
+            // Messages from each thread must arrive in order.
+            vector<int> lastMsg(NUM_THREADS, -1);
+            for (unsigned i=0; i<pSink->m_sMsgs.size(); ++i) {
+                int threadNum;
+                int msgNum;
+                sscanf(pSink->m_sMsgs[i].c_str(), "%i:%i", &threadNum, &msgNum);
+                bInOrder &= (msgNum > lastMsg[threadNum]);
+                lastMsg[threadNum] = msgNum;
+            }
+        }
+
+        // Block the flusher in the sink so the ring buffer overflows.
+        bool bDropped;
+        {
+            boost::lock_guard<boost::mutex> lock(pSink->m_Mutex);
+            for (int i=0; i<5000; ++i) {
+                AVG_TRACE(pSink->m_Category, Logger::severity::INFO, "0:" << i);
+            }
+            bDropped = pLogger->getNumDroppedMessages() > numDropped;
+        }
+        pLogger->setAsync(false);
+        std::cerr.rdbuf(sbuf);
+
+        TEST(bIsAsync);
+        TEST(bAllReceived);
+        TEST(bInOrder);
+        TEST(bDropped);
+        TEST(!pLogger->isAsync());
+        pLogger->removeLogSink(pSink);
+    }
+
+private:
+    void logMessages(int threadNum, int numMsgs, category_t category)
+    {
+        for (int i=0; i<numMsgs; ++i) {
+            AVG_TRACE(category, Logger::severity::INFO, threadNum << ":" << i);
+        }
+    }
+};
+
+
 class BaseTestSuite: public TestSuite
 {
 public:
@@ -984,6 +1288,7 @@ public:
         addTest(TestPtr(new DAGTest));
         addTest(TestPtr(new QueueTest));
         addTest(TestPtr(new WorkerThreadTest));
+        addTest(TestPtr(new TaskPoolTest));
         addTest(TestPtr(new ObjectCounterTest));
         addTest(TestPtr(new GeomTest));
         addTest(TestPtr(new TriangleTest));
@@ -993,9 +1298,11 @@ public:
         addTest(TestPtr(new SplineTest));
         addTest(TestPtr(new BezierCurveTest));
         addTest(TestPtr(new SignalTest));
+        addTest(TestPtr(new SignalBenchmarkTest));
         addTest(TestPtr(new BacktraceTest));
         addTest(TestPtr(new XmlParserTest));
         addTest(TestPtr(new StandardLoggerTest));
+        addTest(TestPtr(new AsyncLoggerTest));
     }
 };
 
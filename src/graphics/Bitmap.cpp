@@ -49,6 +49,7 @@ Bitmap::Bitmap(glm::vec2 size, PixelFormat pf, const UTF8String& sName, int stri
     : m_Size(size),
       m_PF(pf),
       m_pBits(0),
+      m_AllocSize(0),
       m_bOwnsBits(true),
       m_sName(sName)
 {
@@ -60,6 +61,7 @@ Bitmap::Bitmap(IntPoint size, PixelFormat pf, const UTF8String& sName, int strid
     : m_Size(size),
       m_PF(pf),
       m_pBits(0),
+      m_AllocSize(0),
       m_bOwnsBits(true),
       m_sName(sName)
 {
@@ -72,6 +74,7 @@ Bitmap::Bitmap(IntPoint size, PixelFormat pf, unsigned char* pBits,
     : m_Size(size),
       m_PF(pf),
       m_pBits(0),
+      m_AllocSize(0),
       m_sName(sName)
 {
     ObjectCounter::get()->incRef(&typeid(*this));
@@ -82,6 +85,7 @@ Bitmap::Bitmap(const Bitmap& origBmp)
     : m_Size(origBmp.getSize()),
       m_PF(origBmp.getPixelFormat()),
       m_pBits(0),
+      m_AllocSize(0),
       m_bOwnsBits(origBmp.m_bOwnsBits),
       m_sName(origBmp.getName()+" copy")
 {
@@ -94,6 +98,7 @@ Bitmap::Bitmap(const Bitmap& origBmp, bool bOwnsBits)
     : m_Size(origBmp.getSize()),
       m_PF(origBmp.getPixelFormat()),
       m_pBits(0),
+      m_AllocSize(0),
       m_bOwnsBits(bOwnsBits),
       m_sName(origBmp.getName()+" copy")
 {
@@ -108,6 +113,7 @@ Bitmap::Bitmap(Bitmap& origBmp, const IntRect& rect)
     : m_Size(rect.size()),
       m_PF(origBmp.getPixelFormat()),
       m_pBits(0),
+      m_AllocSize(0),
       m_bOwnsBits(false)
 {
     ObjectCounter::get()->incRef(&typeid(*this));
@@ -128,19 +134,13 @@ Bitmap::Bitmap(Bitmap& origBmp, const IntRect& rect)
 Bitmap::~Bitmap()
 {
     ObjectCounter::get()->decRef(&typeid(*this));
-    if (m_bOwnsBits) {
-        delete[] m_pBits;
-        m_pBits = 0;
-    }
+    freeBits();
 }
 
 Bitmap &Bitmap::operator =(const Bitmap& origBmp)
 {
     if (this != &origBmp) {
-        if (m_bOwnsBits) {
-            delete[] m_pBits;
-            m_pBits = 0;
-        }
+        freeBits();
         m_Size = origBmp.getSize();
         m_PF = origBmp.getPixelFormat();
         m_bOwnsBits = origBmp.m_bOwnsBits;
@@ -1162,9 +1162,23 @@ void Bitmap::allocBits(int stride)
         //XXX: We allocate more than nessesary here because ffmpeg seems to
         // overwrite memory after the bits - probably during yuv conversion.
         // Yuck.
-        m_pBits = new unsigned char[size_t(m_Stride+1)*(m_Size.y+1)];
+        m_AllocSize = size_t(m_Stride+1)*(m_Size.y+1);
     } else {
-        m_pBits = new unsigned char[size_t(m_Stride)*m_Size.y];
+        m_AllocSize = size_t(m_Stride)*m_Size.y;
+    }
+    m_pBits = new unsigned char[m_AllocSize];
+    ObjectCounter::get()->addBytes(ObjectCounter::MEM_BITMAP, m_AllocSize);
+}
+
+void Bitmap::freeBits()
+{
+    if (m_bOwnsBits) {
+        delete[] m_pBits;
+        m_pBits = 0;
+        if (m_AllocSize) {
+            ObjectCounter::get()->subBytes(ObjectCounter::MEM_BITMAP, m_AllocSize);
+            m_AllocSize = 0;
+        }
     }
 }
 
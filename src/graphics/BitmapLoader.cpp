@@ -104,6 +104,43 @@ BitmapPtr BitmapLoader::load(const UTF8String& sFName, PixelFormat pf) const
         g_error_free(pError);
         throw Exception(AVG_ERR_FILEIO, sErr);
     }
+    return pixbufToBitmap(pPixBuf, sFName, pf);
+}
+
+BitmapPtr BitmapLoader::loadScaled(const UTF8String& sFName, const IntPoint& size,
+        PixelFormat pf) const
+{
+    AVG_ASSERT(s_pBitmapLoader != 0);
+    GError* pError = 0;
+    GdkPixbuf* pPixBuf;
+    {
+        ScopeTimer timer(GDKPixbufProfilingZone);
+        pPixBuf = gdk_pixbuf_new_from_file_at_scale(sFName.c_str(), size.x, size.y, 
+                false, &pError);
+    }
+    if (!pPixBuf) {
+        string sErr = pError->message;
+        g_error_free(pError);
+        throw Exception(AVG_ERR_FILEIO, sErr);
+    }
+    return pixbufToBitmap(pPixBuf, sFName, pf);
+}
+
+IntPoint BitmapLoader::getImageSize(const UTF8String& sFName) const
+{
+    IntPoint size;
+    GdkPixbufFormat* pFormat = gdk_pixbuf_get_file_info(sFName.c_str(), 
+            &size.x, &size.y);
+    if (!pFormat) {
+        throw Exception(AVG_ERR_FILEIO, 
+                string("Couldn't recognize image file format of ")+sFName);
+    }
+    return size;
+}
+
+BitmapPtr BitmapLoader::pixbufToBitmap(GdkPixbuf* pPixBuf, const UTF8String& sFName,
+        PixelFormat pf) const
+{
     IntPoint size = IntPoint(gdk_pixbuf_get_width(pPixBuf), 
             gdk_pixbuf_get_height(pPixBuf));
     
@@ -30,6 +30,8 @@
 
 #include <string>
 
+typedef struct _GdkPixbuf GdkPixbuf;
+
 namespace avg {
 
 class AVG_API BitmapLoader {
@@ -39,11 +41,20 @@ public:
     bool isBlueFirst() const;
     PixelFormat getDefaultPixelFormat(bool bAlpha);
     BitmapPtr load(const UTF8String& sFName, PixelFormat pf=NO_PIXELFORMAT) const;
+    // Loads the image scaled to size. Decoders that support it (e.g. jpeg) decode
+    // directly to a reduced size, which is much faster than a full decode.
+    BitmapPtr loadScaled(const UTF8String& sFName, const IntPoint& size, 
+            PixelFormat pf=NO_PIXELFORMAT) const;
+    // Reads the image dimensions without decoding the image.
+    IntPoint getImageSize(const UTF8String& sFName) const;
 
 private:
     BitmapLoader(bool bBlueFirst);
     virtual ~BitmapLoader();
 
+    BitmapPtr pixbufToBitmap(GdkPixbuf* pPixBuf, const UTF8String& sFName, 
+            PixelFormat pf) const;
+
     bool m_bBlueFirst;
     static BitmapLoader * s_pBitmapLoader;
 };
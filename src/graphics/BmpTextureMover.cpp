@@ -25,6 +25,7 @@
 #include "GLTexture.h"
 #include "FBO.h"
 #include "Filterfliprgb.h"
+#include "RenderStats.h"
 
 #include "../base/Logger.h"
 #include "../base/Exception.h"
@@ -62,6 +63,7 @@ void BmpTextureMover::moveBmpToTexture(BitmapPtr pBmp, GLTexture& tex)
             pStartPos);
     tex.generateMipmaps();
     GLContext::checkError("BmpTextureMover::moveBmpToTexture: glTexSubImage2D()");
+    RenderStats::countTexUpload((long long)(size.x)*size.y*getBytesPerPixel(getPF()));
 }
 
 BitmapPtr BmpTextureMover::moveTextureToBmp(GLTexture& tex, int mipmapLevel)
@@ -85,6 +87,7 @@ BitmapPtr BmpTextureMover::moveTextureToBmp(GLTexture& tex, int mipmapLevel)
                 pBmp->getPixels());
     }
     GLContext::checkError("BmpTextureMover::moveTextureToBmp: glReadPixels()");
+    RenderStats::countTexDownload((long long)(size.x)*size.y*getBytesPerPixel(getPF()));
     glproc::FramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 
             0, 0);
     pContext->returnFBOToCache(fbo);
@@ -33,20 +33,32 @@
 #include "ImageCache.h"
 #include "Filterfliprgb.h"
 
+#include <sstream>
+
 using namespace std;
 
 namespace avg {
 
-CachedImage::CachedImage(const std::string& sFilename, TexCompression compression)
-    : m_bUseMipmaps(false),
+CachedImage::CachedImage(const std::string& sFilename, TexCompression compression,
+        int level, BitmapPtr pBmp)
+    : m_Level(level),
+      m_bUseMipmaps(false),
       m_Compression(compression),
       m_BmpRefCount(0),
       m_TexRefCount(0)
 {
     ObjectCounter::get()->incRef(&typeid(*this));
     m_sFilename = sFilename;
-    AVG_TRACE(Logger::category::MEMORY, Logger::severity::INFO, "Loading " << sFilename);
-    BitmapPtr pBmp = loadBitmap(m_sFilename);
+    if (!pBmp) {
+        AVG_TRACE(Logger::category::MEMORY, Logger::severity::INFO, 
+                "Loading " << getCacheKey());
+        pBmp = loadLevel(m_sFilename, m_Level);
+    }
+    if (m_Level == 0) {
+        m_FullSize = pBmp->getSize();
+    } else {
+        m_FullSize = ImageCache::get()->getImageSize(m_sFilename);
+    }
     m_pBmp = applyCompression(pBmp);
     incBmpRef(m_Compression);
 }
@@ -63,6 +75,50 @@ std::string CachedImage::getFilename() const
     return m_sFilename;
 }
 
+int CachedImage::getLevel() const
+{
+    return m_Level;
+}
+
+const IntPoint& CachedImage::getFullSize() const
+{
+    return m_FullSize;
+}
+
+std::string CachedImage::getCacheKey() const
+{
+    return getCacheKey(m_sFilename, m_Level);
+}
+
+std::string CachedImage::getCacheKey(const std::string& sFilename, int level)
+{
+    if (level == 0) {
+        return sFilename;
+    } else {
+        stringstream ss;
+        ss << sFilename << "@" << level;
+        return ss.str();
+    }
+}
+
+IntPoint CachedImage::getLevelSize(const IntPoint& fullSize, int level)
+{
+    int divisor = 1 << level;
+    return IntPoint(std::max(1, (fullSize.x+divisor-1)/divisor), 
+            std::max(1, (fullSize.y+divisor-1)/divisor));
+}
+
+BitmapPtr CachedImage::loadLevel(const std::string& sFilename, int level)
+{
+    if (level == 0) {
+        return loadBitmap(sFilename);
+    } else {
+        BitmapLoader* pLoader = BitmapLoader::get();
+        IntPoint size = getLevelSize(pLoader->getImageSize(sFilename), level);
+        return pLoader->loadScaled(sFilename, size);
+    }
+}
+
 void CachedImage::incBmpRef(TexCompression compression)
 {
     m_BmpRefCount++;
@@ -71,7 +127,7 @@ void CachedImage::incBmpRef(TexCompression compression)
         // Reload from disk, making sure the cache knows about the size change
         int oldSize = m_pBmp->getMemNeeded();
         m_Compression = compression;
-        BitmapPtr pBmp = loadBitmap(m_sFilename);
+        BitmapPtr pBmp = loadLevel(m_sFilename, m_Level);
         m_pBmp = applyCompression(pBmp);
         ImageCache::get()->onSizeChange(pBmp->getMemNeeded()-oldSize, STORAGE_CPU);
     }
@@ -83,7 +139,7 @@ void CachedImage::decBmpRef()
     m_BmpRefCount--;
     AVG_ASSERT(m_TexRefCount <= m_BmpRefCount);
     if (m_BmpRefCount == 0 && m_TexRefCount == 0) {
-        ImageCache::get()->onImageUnused(m_sFilename, STORAGE_CPU);
+        ImageCache::get()->onImageUnused(getCacheKey(), STORAGE_CPU);
     }
 }
 
@@ -95,7 +151,7 @@ void CachedImage::incTexRef(bool bUseMipmaps)
         m_bUseMipmaps = bUseMipmaps;
         if (!m_pTex) {
             createTexture();
-            ImageCache::get()->onTexLoad(m_sFilename);
+            ImageCache::get()->onTexLoad(getCacheKey());
         }
     } else if (bUseMipmaps && !m_bUseMipmaps) {
         m_bUseMipmaps = true;
@@ -110,7 +166,7 @@ void CachedImage::decTexRef()
     AVG_ASSERT(m_TexRefCount >= 1);
     m_TexRefCount--;
     if (m_TexRefCount == 0) {
-        ImageCache::get()->onImageUnused(m_sFilename, STORAGE_GPU);
+        ImageCache::get()->onImageUnused(getCacheKey(), STORAGE_GPU);
     }
 }
 
@@ -171,7 +227,7 @@ int CachedImage::getRefCount(StorageType st) const
 
 void CachedImage::dump() const
 {
-    cerr << "  " << m_sFilename << ": " << m_BmpRefCount << ", " << m_TexRefCount
+    cerr << "  " << getCacheKey() << ": " << m_BmpRefCount << ", " << m_TexRefCount
             << ", " << hasTex() << endl;
 }
 
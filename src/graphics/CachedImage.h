@@ -26,6 +26,8 @@
 
 #include "TexInfo.h"
 
+#include "../base/GLMHelper.h"
+
 #include <boost/shared_ptr.hpp>
 #include <string>
 
@@ -44,10 +46,19 @@ class AVG_API CachedImage
             STORAGE_GPU
         };
 
-        CachedImage(const std::string& sFilename, TexCompression compression);
+        // Level 0 is the image at full resolution, each further level halves the
+        // size. If pBmp is given, it is used instead of loading the file.
+        CachedImage(const std::string& sFilename, TexCompression compression,
+                int level=0, BitmapPtr pBmp=BitmapPtr());
         virtual ~CachedImage();
 
         std::string getFilename() const;
+        int getLevel() const;
+        const IntPoint& getFullSize() const;
+        std::string getCacheKey() const;
+        static std::string getCacheKey(const std::string& sFilename, int level);
+        static IntPoint getLevelSize(const IntPoint& fullSize, int level);
+        static BitmapPtr loadLevel(const std::string& sFilename, int level);
 
         void incBmpRef(TexCompression compression);
         void decBmpRef();
@@ -69,6 +80,8 @@ class AVG_API CachedImage
         void testDelete();
 
         std::string m_sFilename;
+        int m_Level;
+        IntPoint m_FullSize;
         BitmapPtr m_pBmp;
         MCTexturePtr m_pTex;
 
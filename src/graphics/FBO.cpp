@@ -117,6 +117,17 @@ void FBO::copyToDestTexture() const
     }
 }
 
+void FBO::activateForReading(int i) const
+{
+    copyToDestTexture();
+    glproc::BindFramebuffer(GL_FRAMEBUFFER, m_OutputFBO); 
+    GLContext::checkError("FBO::activateForReading BindFramebuffer()"); 
+#ifndef AVG_ENABLE_EGL
+    glReadBuffer(GL_COLOR_ATTACHMENT0+i); 
+    GLContext::checkError("FBO::activateForReading ReadBuffer()"); 
+#endif
+}
+
 BitmapPtr FBO::getImage(int i) const
 {
     GLContext* pContext = GLContext::getCurrent();
@@ -141,13 +152,10 @@ void FBO::moveToPBO(int i) const
 #ifndef AVG_ENABLE_EGL
     // Get data directly from the FBO using glReadBuffer. At least on NVidia/Linux, this 
     // is faster than reading stuff from the texture.
-    copyToDestTexture();
-    glproc::BindFramebuffer(GL_FRAMEBUFFER, m_OutputFBO); 
+    activateForReading(i);
  
     m_pOutputPBO->activate(); 
     GLContext::checkError("FBO::moveToPBO BindBuffer()"); 
-    glReadBuffer(GL_COLOR_ATTACHMENT0+i); 
-    GLContext::checkError("FBO::moveToPBO ReadBuffer()"); 
  
     IntPoint size = getSize();
     PixelFormat pf = getPF();
@@ -54,6 +54,7 @@ public:
     void activate() const;
 
     void copyToDestTexture() const;
+    void activateForReading(int i=0) const;
     BitmapPtr getImage(int i=0) const;
     void moveToPBO(int i=0) const;
     BitmapPtr getImageFromPBO() const;
@@ -29,8 +29,13 @@ using namespace std;
 using namespace boost;
 
 namespace avg {
+
+// Buffers returned beyond this are deleted instead of cached.
+static const long long MAX_CACHED_BYTES = 64*1024*1024;
+static const unsigned MIN_BUCKET_SIZE = 4096;
     
 GLBufferCache::GLBufferCache()
+    : m_CachedBytes(0)
 {
 }
 
@@ -57,9 +62,62 @@ void GLBufferCache::returnBuffer(unsigned int bufferID)
     m_BufferIDs.push_back(bufferID);
 }
 
+unsigned GLBufferCache::getBucketSize(unsigned size)
+{
+    if (size <= MIN_BUCKET_SIZE) {
+        return MIN_BUCKET_SIZE;
+    }
+    // Four size classes per power of two, so at most 25% of a buffer is unused.
+    unsigned powerOfTwo = MIN_BUCKET_SIZE;
+    while (powerOfTwo*2 < size) {
+        powerOfTwo *= 2;
+    }
+    unsigned step = powerOfTwo/4;
+    return ((size+step-1)/step)*step;
+}
+
+unsigned int GLBufferCache::getBuffer(unsigned target, unsigned usage, unsigned size)
+{
+    AVG_ASSERT(size == getBucketSize(size));
+    vector<unsigned int>& bucket = m_Buckets[make_pair(usage, size)];
+    unsigned int bufferID;
+    if (bucket.empty()) {
+        glproc::GenBuffers(1, &bufferID);
+        GLContext::checkError("GLBufferCache: GenBuffers()");
+        glproc::BindBuffer(target, bufferID);
+        glproc::BufferData(target, size, 0, usage);
+        GLContext::checkError("GLBufferCache: BufferData()");
+        glproc::BindBuffer(target, 0);
+    } else {
+        bufferID = bucket.back();
+        bucket.pop_back();
+        m_CachedBytes -= size;
+    }
+    return bufferID;
+}
+
+void GLBufferCache::returnBuffer(unsigned int bufferID, unsigned usage, unsigned size)
+{
+    if (m_CachedBytes+size > MAX_CACHED_BYTES) {
+        glproc::DeleteBuffers(1, &bufferID);
+    } else {
+        m_Buckets[make_pair(usage, size)].push_back(bufferID);
+        m_CachedBytes += size;
+    }
+}
+
 unsigned int GLBufferCache::getNumBuffers() const
 {
-    return m_BufferIDs.size();
+    unsigned int numBuffers = m_BufferIDs.size();
+    for (BucketMap::const_iterator it = m_Buckets.begin(); it != m_Buckets.end(); ++it) {
+        numBuffers += it->second.size();
+    }
+    return numBuffers;
+}
+
+long long GLBufferCache::getNumCachedBytes() const
+{
+    return m_CachedBytes;
 }
 
 void GLBufferCache::deleteBuffers()
@@ -68,6 +126,14 @@ void GLBufferCache::deleteBuffers()
         glproc::DeleteBuffers(1, &(m_BufferIDs[i]));
     }
     m_BufferIDs.clear();
+    for (BucketMap::iterator it = m_Buckets.begin(); it != m_Buckets.end(); ++it) {
+        vector<unsigned int>& bucket = it->second;
+        for (unsigned i=0; i<bucket.size(); ++i) {
+            glproc::DeleteBuffers(1, &(bucket[i]));
+        }
+    }
+    m_Buckets.clear();
+    m_CachedBytes = 0;
 }
 
 }
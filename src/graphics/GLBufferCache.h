@@ -27,6 +27,7 @@
 #include "../graphics/OGLHelper.h"
 
 #include <vector>
+#include <map>
 
 #include <boost/shared_ptr.hpp>
 #include <boost/thread/tss.hpp>
@@ -41,12 +42,25 @@ public:
     unsigned int getBuffer();
     void returnBuffer(unsigned int);
 
+    // Buffers that keep their storage while cached. The size must be a bucket size, so
+    // buffers of similar size can be reused without reallocation.
+    static unsigned getBucketSize(unsigned size);
+    unsigned int getBuffer(unsigned target, unsigned usage, unsigned size);
+    void returnBuffer(unsigned int bufferID, unsigned usage, unsigned size);
+
     unsigned int getNumBuffers() const;
+    long long getNumCachedBytes() const;
 
     void deleteBuffers();
 
 private:
     std::vector<unsigned int> m_BufferIDs;
+
+    // Key is (usage, size).
+    typedef std::map<std::pair<unsigned, unsigned>, std::vector<unsigned int> > 
+            BucketMap;
+    BucketMap m_Buckets;
+    long long m_CachedBytes;
 };
 
 }
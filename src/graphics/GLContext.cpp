@@ -369,6 +369,26 @@ bool GLContext::arePBOsSupported()
     }
 }
 
+bool GLContext::areFencesSupported()
+{
+    if (isGLES()) {
+        return false;
+    } else {
+        return (m_MajorGLVersion > 3 || (m_MajorGLVersion == 3 && m_MinorGLVersion >= 2)
+                || queryOGLExtension("GL_ARB_sync"));
+    }
+}
+
+bool GLContext::areTimerQueriesSupported()
+{
+    if (isGLES()) {
+        return false;
+    } else {
+        return (m_MajorGLVersion > 3 || (m_MajorGLVersion == 3 && m_MinorGLVersion >= 3)
+                || queryOGLExtension("GL_ARB_timer_query"));
+    }
+}
+
 OGLMemoryMode GLContext::getMemoryMode()
 {
     if (!m_bCheckedMemoryMode) {
@@ -70,6 +70,8 @@ public:
     int getMaxTexSize();
     bool usePOTTextures();
     bool arePBOsSupported();
+    bool areFencesSupported();
+    bool areTimerQueriesSupported();
     OGLMemoryMode getMemoryMode();
     bool isGLES() const;
     bool isVendor(const std::string& sWantedVendor) const;
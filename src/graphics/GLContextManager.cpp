@@ -26,6 +26,7 @@
 #include "../base/Backtrace.h"
 #include "../base/ScopeTimer.h"
 
+#include "Bitmap.h"
 #include "GLTexture.h"
 #include "MCTexture.h"
 #include "VertexArray.h"
@@ -62,7 +63,20 @@ bool GLContextManager::isActive()
     return s_pGLContextManager != 0 && (s_pGLContextManager->m_pContexts.size() > 0);
 }
 
+GLContextManager::TexUpload::TexUpload(MCTexturePtr pTex, BitmapPtr pBmp, 
+        bool bStreaming)
+    : m_pTex(pTex),
+      m_pBmp(pBmp),
+      m_bStreaming(bStreaming),
+      m_bPlanned(false),
+      m_bDeferred(false)
+{
+}
+
 GLContextManager::GLContextManager()
+    : m_bTexUploadsPlanned(false),
+      m_TexUploadBudget(0),
+      m_FrameTexUploadBytes(0)
 {
 //    AVG_ASSERT(!s_pGLContextManager);
     s_pGLContextManager = this;
@@ -71,7 +85,8 @@ GLContextManager::GLContextManager()
 GLContextManager::~GLContextManager()
 {
     m_pPendingTexCreates.clear();
-    m_pPendingTexUploads.clear();
+    m_PendingTexUploads.clear();
+    m_UnplannedTexUploads.clear();
     m_PendingTexDeletes.clear();
 
     m_pPendingFBOCreates.clear();
@@ -119,6 +134,11 @@ void GLContextManager::unregisterContext(GLContext* pContext)
     for (it=m_pContexts.begin(); it!=m_pContexts.end(); ++it) {
         if (*it == pContext) {
             m_pContexts.erase(it);
+            if (m_pContexts.empty()) {
+                // Deferred uploads can't outlive the textures' contexts.
+                m_PendingTexUploads.clear();
+                m_UnplannedTexUploads.clear();
+            }
             return;
         }
     }
@@ -164,9 +184,32 @@ void GLContextManager::createShader(const string& sID)
     pContext->activate();
 }
 
-void GLContextManager::scheduleTexUpload(MCTexturePtr pTex, BitmapPtr pBmp)
+void GLContextManager::scheduleTexUpload(MCTexturePtr pTex, BitmapPtr pBmp, 
+        bool bStreaming)
 {
-    m_pPendingTexUploads[pTex] = pBmp;
+    pTex->setDirty();
+    pTex->setUploadScheduled();
+    TexUploadMap::iterator mapIt = m_UnplannedTexUploads.find(pTex.get());
+    if (mapIt != m_UnplannedTexUploads.end()) {
+        // Newer data replaces the pending upload but keeps its place in the queue.
+        TexUpload& upload = *(mapIt->second);
+        upload.m_pBmp = pBmp;
+        upload.m_bStreaming = upload.m_bStreaming || bStreaming;
+    } else {
+        m_PendingTexUploads.push_back(TexUpload(pTex, pBmp, bStreaming));
+        m_UnplannedTexUploads[pTex.get()] = --m_PendingTexUploads.end();
+    }
+}
+
+void GLContextManager::forceTexUpload(const MCTexturePtr& pTex)
+{
+    TexUploadMap::iterator mapIt = m_UnplannedTexUploads.find(pTex.get());
+    if (mapIt != m_UnplannedTexUploads.end()) {
+        TexUpload& upload = *(mapIt->second);
+        upload.m_bPlanned = true;
+        m_FrameTexUploadBytes += upload.m_pBmp->getMemNeeded();
+        m_UnplannedTexUploads.erase(mapIt);
+    }
 }
 
 MCTexturePtr GLContextManager::createTextureFromBmp(BitmapPtr pBmp, bool bMipmap,
@@ -231,11 +274,14 @@ void GLContextManager::uploadDataForContext()
         m_pPendingTexCreates[i]->initForGLContext(pContext);
     }
 
-    TexUploadMap::iterator it;
-    for (it=m_pPendingTexUploads.begin(); it!=m_pPendingTexUploads.end(); ++it) {
-        MCTexturePtr pTex = it->first;
-        BitmapPtr pBmp = it->second;
-        pTex->moveBmpToTexture(pContext, pBmp);
+    if (!m_bTexUploadsPlanned) {
+        planTexUploads();
+    }
+    TexUploadList::iterator it;
+    for (it=m_PendingTexUploads.begin(); it!=m_PendingTexUploads.end(); ++it) {
+        if (it->m_bPlanned) {
+            it->m_pTex->moveBmpToTexture(pContext, it->m_pBmp);
+        }
     }
 
     for (unsigned i=0; i<m_pPendingFBOCreates.size(); ++i) {
@@ -254,7 +300,20 @@ void GLContextManager::reset()
     // cause texture deletes to be scheduled!
     m_PendingTexDeletes.clear();
     m_pPendingTexCreates.clear();
-    m_pPendingTexUploads.clear();
+    TexUploadList::iterator it = m_PendingTexUploads.begin();
+    while (it != m_PendingTexUploads.end()) {
+        if (it->m_bPlanned) {
+            if (it->m_bDeferred) {
+                // Make sure the new contents are picked up by anything that caches 
+                // rendering results.
+                it->m_pTex->setDirty();
+            }
+            it = m_PendingTexUploads.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    m_bTexUploadsPlanned = false;
 
     m_pPendingFBOCreates.clear();
     m_pPendingShaderParamCreates.clear();
@@ -263,6 +322,73 @@ void GLContextManager::reset()
     m_PendingBufferDeletes.clear();
 }
 
+void GLContextManager::setTexUploadBudget(long long budget)
+{
+    AVG_ASSERT(budget >= 0);
+    m_TexUploadBudget = budget;
+}
+
+long long GLContextManager::getTexUploadBudget() const
+{
+    return m_TexUploadBudget;
+}
+
+int GLContextManager::getNumDeferredTexUploads() const
+{
+    int numDeferred = 0;
+    TexUploadList::const_iterator it;
+    for (it=m_PendingTexUploads.begin(); it!=m_PendingTexUploads.end(); ++it) {
+        if (it->m_bDeferred && !it->m_bPlanned) {
+            numDeferred++;
+        }
+    }
+    return numDeferred;
+}
+
+void GLContextManager::startFrame()
+{
+    m_FrameTexUploadBytes = 0;
+}
+
+void GLContextManager::planTexUploads()
+{
+    bool bOverBudget = false;
+    TexUploadList::iterator it = m_PendingTexUploads.begin();
+    while (it != m_PendingTexUploads.end()) {
+        TexUpload& upload = *it;
+        if (upload.m_bPlanned) {
+            ++it;
+            continue;
+        }
+        if (upload.m_bDeferred && upload.m_pTex.unique()) {
+            // Nobody is interested in the texture anymore.
+            m_UnplannedTexUploads.erase(upload.m_pTex.get());
+            it = m_PendingTexUploads.erase(it);
+            continue;
+        }
+        long long numBytes = upload.m_pBmp->getMemNeeded();
+        bool bUpload;
+        if (upload.m_bStreaming || m_TexUploadBudget == 0) {
+            bUpload = true;
+        } else {
+            // Uploads happen in order. At least one is done per frame, so textures 
+            // larger than the budget still get uploaded eventually.
+            bUpload = !bOverBudget && (m_FrameTexUploadBytes == 0 || 
+                    m_FrameTexUploadBytes+numBytes <= m_TexUploadBudget);
+            bOverBudget = !bUpload;
+        }
+        if (bUpload) {
+            upload.m_bPlanned = true;
+            m_UnplannedTexUploads.erase(upload.m_pTex.get());
+            m_FrameTexUploadBytes += numBytes;
+        } else {
+            upload.m_bDeferred = true;
+        }
+        ++it;
+    }
+    m_bTexUploadsPlanned = true;
+}
+
 bool GLContextManager::isGLESSupported()
 {
 #if defined __linux__
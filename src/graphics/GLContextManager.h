@@ -27,7 +27,10 @@
 #include "GLContext.h"
 #include "MCShaderParam.h"
 
+#include <boost/unordered_map.hpp>
+
 #include <map>
+#include <list>
 
 struct SDL_SysWMinfo;
 
@@ -75,7 +78,11 @@ public:
         return pParam;
     }
 
-    void scheduleTexUpload(MCTexturePtr pTex, BitmapPtr pBmp);
+    // Streaming uploads (e.g. video frames) are never deferred to a later frame.
+    void scheduleTexUpload(MCTexturePtr pTex, BitmapPtr pBmp, bool bStreaming=false);
+    // Makes sure the next upload pass includes pending data for pTex, regardless of
+    // the budget. For textures that are needed right after uploadData().
+    void forceTexUpload(const MCTexturePtr& pTex);
     MCTexturePtr createTextureFromBmp(BitmapPtr pBmp, bool bMipmap=false, 
             bool bForcePOT=false, int potBorderColor=0);
     void deleteTexture(unsigned texID);
@@ -88,14 +95,41 @@ public:
     void uploadDataForContext();
     void reset();
 
+    // Maximum number of bytes of texture data uploaded per frame, 0 for no limit.
+    // Uploads over budget are deferred to later frames in the order they were 
+    // scheduled.
+    void setTexUploadBudget(long long budget);
+    long long getTexUploadBudget() const;
+    int getNumDeferredTexUploads() const;
+    void startFrame();
+
     static bool isGLESSupported();
 
 private:
+    struct TexUpload {
+        TexUpload(MCTexturePtr pTex, BitmapPtr pBmp, bool bStreaming);
+
+        MCTexturePtr m_pTex;
+        BitmapPtr m_pBmp;
+        bool m_bStreaming;
+        // Set if the upload is done in the current pass over the contexts.
+        bool m_bPlanned;
+        bool m_bDeferred;
+    };
+    typedef std::list<TexUpload> TexUploadList;
+    // Uploads that aren't planned yet, indexed by texture.
+    typedef boost::unordered_map<MCTexture*, TexUploadList::iterator> TexUploadMap;
+
+    void planTexUploads();
+
     std::vector<GLContext*> m_pContexts;
 
     std::vector<MCTexturePtr> m_pPendingTexCreates;
-    typedef std::map<MCTexturePtr, BitmapPtr> TexUploadMap;
-    TexUploadMap m_pPendingTexUploads;
+    TexUploadList m_PendingTexUploads;
+    TexUploadMap m_UnplannedTexUploads;
+    bool m_bTexUploadsPlanned;
+    long long m_TexUploadBudget;
+    long long m_FrameTexUploadBytes;
     std::vector<unsigned> m_PendingTexDeletes;
 
     std::vector<MCFBOPtr> m_pPendingFBOCreates;
@@ -90,4 +90,13 @@ void GLShaderParamTemplate<glm::mat4>::uniformSet(unsigned location, const glm::
     glproc::UniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(val));
 }
 
+template<>
+void GLShaderParamTemplate<vector<float> >::uniformSet(unsigned location, 
+        const vector<float>& val)
+{
+    if (!val.empty()) {
+        glproc::Uniform1fv(location, val.size(), &(val[0]));
+    }
+}
+
 }
@@ -31,6 +31,7 @@
 #include <boost/shared_ptr.hpp>
 
 #include <string>
+#include <vector>
 
 namespace avg {
 
@@ -103,6 +104,9 @@ void GLShaderParamTemplate<glm::vec4>::uniformSet(unsigned location,
 template<>
 void GLShaderParamTemplate<glm::mat4>::uniformSet(unsigned location, 
         const glm::mat4& val);
+template<>
+void GLShaderParamTemplate<std::vector<float> >::uniformSet(unsigned location, 
+        const std::vector<float>& val);
 
 typedef boost::shared_ptr<GLShaderParam> GLShaderParamPtr;
 
@@ -124,6 +128,9 @@ typedef boost::shared_ptr<Vec4fGLShaderParam> Vec4fGLShaderParamPtr;
 typedef GLShaderParamTemplate<glm::mat4> Mat4fGLShaderParam; 
 typedef boost::shared_ptr<Mat4fGLShaderParam> Mat4fGLShaderParamPtr;
 
+typedef GLShaderParamTemplate<std::vector<float> > FloatArrayGLShaderParam; 
+typedef boost::shared_ptr<FloatArrayGLShaderParam> FloatArrayGLShaderParamPtr;
+
 }
 
 #endif
@@ -67,6 +67,7 @@ GLTexture::~GLTexture()
     if (GLContextManager::isActive()) {
         GLContextManager::get()->deleteTexture(m_TexID);
     }
+    ObjectCounter::get()->subBytes(ObjectCounter::MEM_TEXTURE, getVideoMemUsed());
     ObjectCounter::get()->decRef(&typeid(*this));
 }
 
@@ -83,6 +84,7 @@ void GLTexture::init()
     glTexImage2D(GL_TEXTURE_2D, 0, getGLInternalFormat(), size.x, size.y, 0,
             getGLFormat(pf), getGLType(pf), 0);
     GLContext::checkError("GLTexture: glTexImage2D()");
+    ObjectCounter::get()->addBytes(ObjectCounter::MEM_TEXTURE, getVideoMemUsed());
     if (getUseMipmap()) {
         glproc::GenerateMipmap(GL_TEXTURE_2D);
         GLContext::checkError("GLTexture::GLTexture generateMipmap()");
@@ -149,4 +151,14 @@ unsigned GLTexture::getID() const
     return m_TexID;
 }
 
+long long GLTexture::getVideoMemUsed() const
+{
+    long long memUsed = getMemNeeded();
+    if (getUseMipmap()) {
+        // The complete mipmap chain adds a third to the base level.
+        memUsed += memUsed/3;
+    }
+    return memUsed;
+}
+
 }
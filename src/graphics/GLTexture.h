@@ -53,6 +53,8 @@ public:
     unsigned getID() const;
 
 private:
+    long long getVideoMemUsed() const;
+
     GLContext* m_pContext;
 
     WrapMode m_WrapMode;
@@ -26,6 +26,7 @@
 #include "OGLShader.h"
 #include "GLContextManager.h"
 #include "FBO.h"
+#include "MCFBO.h"
 #include "MCTexture.h"
 #include "GLTexture.h"
 
@@ -38,16 +39,21 @@
 
 #define SHADERID_HORIZ "horizblur"
 #define SHADERID_VERT "vertblur"
+#define SHADERID_FAST "blurfast"
 
 using namespace std;
 
 namespace avg {
 
 GPUBlurFilter::GPUBlurFilter(const IntPoint& size, PixelFormat pfSrc, PixelFormat pfDest,
-        float stdDev, bool bClipBorders, bool bStandalone, bool bUseFloatKernel)
+        float stdDev, bool bClipBorders, bool bStandalone, bool bUseFloatKernel, 
+        bool bFast)
     : GPUFilter(pfSrc, pfDest, bStandalone, SHADERID_HORIZ, 2),
       m_bClipBorders(bClipBorders),
-      m_bUseFloatKernel(bUseFloatKernel)
+      m_bUseFloatKernel(bUseFloatKernel),
+      m_bFast(bFast),
+      m_Downscale(1),
+      m_PFDownscale(pfDest)
 {
     ObjectCounter::get()->incRef(&typeid(*this));
 
@@ -61,6 +67,7 @@ GPUBlurFilter::GPUBlurFilter(const IntPoint& size, PixelFormat pfSrc, PixelForma
     setDimensions(size, stdDev);
     GLContextManager* pCM = GLContextManager::get();
     pCM->createShader(SHADERID_VERT);
+    pCM->createShader(SHADERID_FAST);
     setStdDev(stdDev);
 
     m_pHorizWidthParam = pCM->createShaderParam<float>(SHADERID_HORIZ, "u_Width");
@@ -72,6 +79,17 @@ GPUBlurFilter::GPUBlurFilter(const IntPoint& size, PixelFormat pfSrc, PixelForma
     m_pVertRadiusParam = pCM->createShaderParam<int>(SHADERID_VERT, "u_Radius");
     m_pVertTextureParam = pCM->createShaderParam<int>(SHADERID_VERT, "u_Texture");
     m_pVertKernelTexParam = pCM->createShaderParam<int>(SHADERID_VERT, "u_KernelTex");
+
+    m_pFastTextureParam = pCM->createShaderParam<int>(SHADERID_FAST, "u_Texture");
+    m_pFastNumTapsParam = pCM->createShaderParam<int>(SHADERID_FAST, "u_NumTaps");
+    m_pFastWeightsParam = 
+            pCM->createShaderParam<vector<float> >(SHADERID_FAST, "u_Weights");
+    m_pFastOffsetsParam = 
+            pCM->createShaderParam<vector<float> >(SHADERID_FAST, "u_Offsets");
+    m_pFastDirectionParam = 
+            pCM->createShaderParam<glm::vec2>(SHADERID_FAST, "u_Direction");
+    m_pFastStepScaleParam = 
+            pCM->createShaderParam<float>(SHADERID_FAST, "u_StepScale");
 }
 
 GPUBlurFilter::~GPUBlurFilter()
@@ -87,10 +105,21 @@ void GPUBlurFilter::setStdDev(float stdDev)
     IntRect destRect2(IntPoint(0,0), getDestRect().size());
     m_pProjection2 = ImagingProjectionPtr(new ImagingProjection(
             getDestRect().size(), destRect2));
+    initFastParams();
+}
+
+void GPUBlurFilter::setFast(bool bFast)
+{
+    m_bFast = bFast;
+    initFastParams();
 }
 
 void GPUBlurFilter::applyOnGPU(GLContext* pContext, GLTexturePtr pSrcTex)
 {
+    if (m_bFast) {
+        applyFastOnGPU(pContext, pSrcTex);
+        return;
+    }
     int kernelWidth = m_pGaussCurveTex->getSize().x;
     getFBO(pContext, 1)->activate();
     getShader()->activate();
@@ -112,6 +141,67 @@ void GPUBlurFilter::applyOnGPU(GLContext* pContext, GLTexturePtr pSrcTex)
     m_pProjection2->draw(pContext, pVShader);
 }
 
+void GPUBlurFilter::initFastParams()
+{
+    m_pDownscaleFBO = MCFBOPtr();
+    m_pDownscaleProjection = ImagingProjectionPtr();
+    if (!m_bFast) {
+        return;
+    }
+    m_Downscale = getBlurDownscale(m_StdDev, 1);
+    float scaledStdDev = m_StdDev/m_Downscale;
+    if (m_Downscale == 1) {
+        calcBlurTaps(scaledStdDev, 1, true, m_HorizWeights, m_HorizOffsets);
+    } else {
+        // The horizontal pass renders into a smaller texture. Taps aren't paired 
+        // here, since one step already spans several source texels.
+        calcBlurTaps(scaledStdDev, 1, false, m_HorizWeights, m_HorizOffsets);
+        IntPoint destSize = getDestRect().size();
+        IntPoint scaledSize((destSize.x+m_Downscale-1)/m_Downscale, 
+                (destSize.y+m_Downscale-1)/m_Downscale);
+        m_pDownscaleFBO = GLContextManager::get()->createFBO(scaledSize, m_PFDownscale);
+        m_pDownscaleProjection = ImagingProjectionPtr(new ImagingProjection(
+                getSrcSize(), getDestRect(), scaledSize));
+    }
+    calcBlurTaps(scaledStdDev, 1, true, m_VertWeights, m_VertOffsets);
+}
+
+void GPUBlurFilter::applyFastOnGPU(GLContext* pContext, GLTexturePtr pSrcTex)
+{
+    OGLShaderPtr pShader = avg::getShader(SHADERID_FAST);
+    if (m_pDownscaleFBO) {
+        m_pDownscaleFBO->activate(pContext);
+    } else {
+        getFBO(pContext, 1)->activate();
+    }
+    pShader->activate();
+    m_pFastTextureParam->set(pContext, 0);
+    m_pFastNumTapsParam->set(pContext, int(m_HorizWeights.size()));
+    m_pFastWeightsParam->set(pContext, m_HorizWeights);
+    m_pFastOffsetsParam->set(pContext, m_HorizOffsets);
+    m_pFastDirectionParam->set(pContext, glm::vec2(1,0));
+    m_pFastStepScaleParam->set(pContext, 1.f);
+    GLTexturePtr pHBlurTex;
+    if (m_pDownscaleFBO) {
+        pSrcTex->activate(m_WrapMode, GL_TEXTURE0);
+        m_pDownscaleProjection->draw(pContext, pShader);
+        m_pDownscaleFBO->copyToDestTexture(pContext);
+        pHBlurTex = m_pDownscaleFBO->getTex()->getTex(pContext);
+    } else {
+        draw(pContext, pSrcTex, m_WrapMode, pShader);
+        pHBlurTex = getDestTex(pContext, 1);
+    }
+
+    getFBO(pContext, 0)->activate();
+    m_pFastNumTapsParam->set(pContext, int(m_VertWeights.size()));
+    m_pFastWeightsParam->set(pContext, m_VertWeights);
+    m_pFastOffsetsParam->set(pContext, m_VertOffsets);
+    m_pFastDirectionParam->set(pContext, glm::vec2(0,1));
+    m_pFastStepScaleParam->set(pContext, float(m_Downscale));
+    pHBlurTex->activate(m_WrapMode, GL_TEXTURE0);
+    m_pProjection2->draw(pContext, pShader);
+}
+
 void GPUBlurFilter::setDimensions(IntPoint size, float stdDev)
 {
     if (m_bClipBorders) {
@@ -34,18 +34,22 @@ class AVG_API GPUBlurFilter: public GPUFilter
 public:
     GPUBlurFilter(const IntPoint& size, PixelFormat pfSrc, PixelFormat pfDest, 
             float stdDev, bool bClipBorders, bool bStandalone=true, 
-            bool bUseFloatKernel=false);
+            bool bUseFloatKernel=false, bool bFast=false);
     virtual ~GPUBlurFilter();
     
     void setStdDev(float stdDev);
+    void setFast(bool bFast);
     virtual void applyOnGPU(GLContext* pContext, GLTexturePtr pSrcTex);
 
 private:
     void setDimensions(IntPoint size, float stdDev);
+    void initFastParams();
+    void applyFastOnGPU(GLContext* pContext, GLTexturePtr pSrcTex);
 
     float m_StdDev;
     bool m_bClipBorders;
     bool m_bUseFloatKernel;
+    bool m_bFast;
     WrapMode m_WrapMode;
 
     MCTexturePtr m_pGaussCurveTex;
@@ -60,6 +64,23 @@ private:
     IntMCShaderParamPtr m_pVertRadiusParam;
     IntMCShaderParamPtr m_pVertTextureParam;
     IntMCShaderParamPtr m_pVertKernelTexParam;
+
+    // Tap-optimized mode
+    int m_Downscale;
+    PixelFormat m_PFDownscale;
+    MCFBOPtr m_pDownscaleFBO;
+    ImagingProjectionPtr m_pDownscaleProjection;
+    std::vector<float> m_HorizWeights;
+    std::vector<float> m_HorizOffsets;
+    std::vector<float> m_VertWeights;
+    std::vector<float> m_VertOffsets;
+
+    IntMCShaderParamPtr m_pFastTextureParam;
+    IntMCShaderParamPtr m_pFastNumTapsParam;
+    FloatArrayMCShaderParamPtr m_pFastWeightsParam;
+    FloatArrayMCShaderParamPtr m_pFastOffsetsParam;
+    Vec2fMCShaderParamPtr m_pFastDirectionParam;
+    FloatMCShaderParamPtr m_pFastStepScaleParam;
 };
 
 typedef boost::shared_ptr<GPUBlurFilter> GPUBlurFilterPtr;
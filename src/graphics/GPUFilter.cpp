@@ -45,6 +45,12 @@ using namespace boost;
 
 namespace avg {
 
+// Must match MAX_BLUR_TAPS in blurfast.frag, horizshadowfast.frag and vertshadowfast.frag.
+const unsigned MAX_BLUR_TAPS = 32;
+
+// Tap-optimized blurs with a larger stddev are done at reduced resolution.
+const float MAX_UNSCALED_BLUR_STDDEV = 8;
+
 GPUFilter::GPUFilter(const string& sShaderID, bool bUseAlpha,
         bool bStandalone, unsigned numTextures, bool bMipmap)
     : m_bStandalone(bStandalone),
@@ -199,32 +205,73 @@ void GPUFilter::draw(GLContext* pContext, GLTexturePtr pTex, const WrapMode& wra
     m_pProjection->draw(pContext, getShader());
 }
 
-void dumpKernel(int width, float* pKernel)
+void GPUFilter::draw(GLContext* pContext, GLTexturePtr pTex, const WrapMode& wrapMode,
+        OGLShaderPtr pShader)
 {
-    cerr << "  Kernel width: " << width << endl;
-    float sum = 0;
-    for (int i = 0; i < width; ++i) {
-        sum += pKernel[i];
-        cerr << "  " << pKernel[i] << endl;
+    pTex->activate(wrapMode, GL_TEXTURE0);
+    m_pProjection->draw(pContext, pShader);
+}
+
+int GPUFilter::getBlurDownscale(float stdDev, float opacity) const
+{
+    int downscale = 1;
+    while (stdDev/downscale > MAX_UNSCALED_BLUR_STDDEV) {
+        downscale *= 2;
     }
-    cerr << "Sum of coefficients: " << sum << endl;
+    // High opacities make the kernel wider. Keep going until even the unpaired taps 
+    // fit into the shader, so the kernel never needs to be truncated.
+    vector<float> halfKernel;
+    calcBlurKernel(stdDev/downscale, opacity, halfKernel);
+    while (halfKernel.size() > MAX_BLUR_TAPS) {
+        downscale *= 2;
+        calcBlurKernel(stdDev/downscale, opacity, halfKernel);
+    }
+    return downscale;
 }
 
-int GPUFilter::getBlurKernelRadius(float stdDev) const
+void GPUFilter::calcBlurTaps(float stdDev, float opacity, bool bLinearPairs,
+        vector<float>& weights, vector<float>& offsets) const
 {
-    return int(ceil(stdDev*3));
+    vector<float> halfKernel;
+    calcBlurKernel(stdDev, opacity, halfKernel);
+    weights.clear();
+    offsets.clear();
+    weights.push_back(halfKernel[0]);
+    offsets.push_back(0);
+    if (bLinearPairs) {
+        // Combine neighboring coefficients into one tap positioned so that linear 
+        // texture filtering returns the weighted sum of both texels.
+        for (unsigned i = 1; i < halfKernel.size(); i += 2) {
+            float w1 = halfKernel[i];
+            float w2 = 0;
+            if (i+1 < halfKernel.size()) {
+                w2 = halfKernel[i+1];
+            }
+            float weight = w1+w2;
+            weights.push_back(weight);
+            if (weight > 0) {
+                offsets.push_back((i*w1 + (i+1)*w2)/weight);
+            } else {
+                offsets.push_back(float(i));
+            }
+        }
+    } else {
+        for (unsigned i = 1; i < halfKernel.size(); ++i) {
+            weights.push_back(halfKernel[i]);
+            offsets.push_back(float(i));
+        }
+    }
+    // getBlurDownscale() chooses the scale so that the kernel fits.
+    AVG_ASSERT(weights.size() <= MAX_BLUR_TAPS);
 }
 
-MCTexturePtr GPUFilter::calcBlurKernelTex(float stdDev, float opacity, bool bUseFloat)
+void GPUFilter::calcBlurKernel(float stdDev, float opacity, vector<float>& halfKernel) 
         const
 {
     AVG_ASSERT(opacity != -1);
-    int kernelWidth;
-    float* pKernel;
+    halfKernel.clear();
     if (stdDev == 0) {
-        kernelWidth = 1;
-        pKernel = new float[1];
-        pKernel[0] = float(opacity);
+        halfKernel.push_back(opacity);
     } else {
         float tempCoeffs[1024];
         int i=0;
@@ -237,29 +284,54 @@ MCTexturePtr GPUFilter::calcBlurKernelTex(float stdDev, float opacity, bool bUse
         } while (coeff > 0.003 && i < 1024);
         if (i > 1) {
             int kernelCenter = i - 2;
-            kernelWidth = kernelCenter*2+1;
-            pKernel = new float[kernelWidth];
             float sum = 0;
             for (int i = 0; i <= kernelCenter; ++i) {
-                pKernel[kernelCenter+i] = tempCoeffs[i];
+                halfKernel.push_back(tempCoeffs[i]);
                 sum += tempCoeffs[i];
                 if (i != 0) {
-                    pKernel[kernelCenter-i] = tempCoeffs[i];
                     sum += tempCoeffs[i];
                 }
             }
             // Make sure the sum of coefficients is opacity despite the inaccuracies
             // introduced by using a kernel of finite size.
-            for (int i = 0; i < kernelWidth; ++i) {
-                pKernel[i] *= float(opacity)/sum;
+            for (int i = 0; i <= kernelCenter; ++i) {
+                halfKernel[i] *= float(opacity)/sum;
             }
         } else {
             // Blur is so wide that all pixels would be black at 8-bit precision
-            kernelWidth = 1;
-            pKernel = new float[1];
-            pKernel[0] = 0.;
+            halfKernel.push_back(0.);
         }
     }
+}
+
+void dumpKernel(int width, float* pKernel)
+{
+    cerr << "  Kernel width: " << width << endl;
+    float sum = 0;
+    for (int i = 0; i < width; ++i) {
+        sum += pKernel[i];
+        cerr << "  " << pKernel[i] << endl;
+    }
+    cerr << "Sum of coefficients: " << sum << endl;
+}
+
+int GPUFilter::getBlurKernelRadius(float stdDev) const
+{
+    return int(ceil(stdDev*3));
+}
+
+MCTexturePtr GPUFilter::calcBlurKernelTex(float stdDev, float opacity, bool bUseFloat)
+        const
+{
+    vector<float> halfKernel;
+    calcBlurKernel(stdDev, opacity, halfKernel);
+    int kernelCenter = halfKernel.size()-1;
+    int kernelWidth = kernelCenter*2+1;
+    float* pKernel = new float[kernelWidth];
+    for (int i = 0; i <= kernelCenter; ++i) {
+        pKernel[kernelCenter+i] = halfKernel[i];
+        pKernel[kernelCenter-i] = halfKernel[i];
+    }
 //    dumpKernel(kernelWidth, pKernel);
     
     IntPoint size(kernelWidth, 1);
@@ -286,7 +358,10 @@ MCTexturePtr GPUFilter::calcBlurKernelTex(float stdDev, float opacity, bool bUse
             ++pCurPixel;
         }
     }
-    MCTexturePtr pTex = GLContextManager::get()->createTextureFromBmp(pBmp);
+    GLContextManager* pCM = GLContextManager::get();
+    MCTexturePtr pTex = pCM->createTextureFromBmp(pBmp);
+    // The filter can't run without its kernel.
+    pCM->forceTexUpload(pTex);
 
     delete[] pKernel;
     return pTex;
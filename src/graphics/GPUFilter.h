@@ -70,10 +70,18 @@ protected:
     OGLShaderPtr getShader() const;
 
     void draw(GLContext* pContext, GLTexturePtr pTex, const WrapMode& wrapMode);
+    void draw(GLContext* pContext, GLTexturePtr pTex, const WrapMode& wrapMode,
+            OGLShaderPtr pShader);
     int getBlurKernelRadius(float stdDev) const;
     MCTexturePtr calcBlurKernelTex(float stdDev, float opacity, bool bUseFloat) const;
+    int getBlurDownscale(float stdDev, float opacity) const;
+    void calcBlurTaps(float stdDev, float opacity, bool bLinearPairs, 
+            std::vector<float>& weights, std::vector<float>& offsets) const;
 
 private:
+    void calcBlurKernel(float stdDev, float opacity, std::vector<float>& halfKernel) 
+            const;
+
     PixelFormat m_PFSrc;
     PixelFormat m_PFDest;
     bool m_bStandalone;
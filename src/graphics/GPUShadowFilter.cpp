@@ -25,6 +25,7 @@
 #include "OGLShader.h"
 #include "ImagingProjection.h"
 #include "FBO.h"
+#include "MCFBO.h"
 #include "GLContextManager.h"
 #include "GLTexture.h"
 
@@ -37,14 +38,18 @@
 
 #define SHADERID_HORIZ "horizshadow"
 #define SHADERID_VERT "vertshadow"
+#define SHADERID_FAST_HORIZ "horizshadowfast"
+#define SHADERID_FAST_VERT "vertshadowfast"
 
 using namespace std;
 
 namespace avg {
 
 GPUShadowFilter::GPUShadowFilter(const IntPoint& size, const glm::vec2& offset, 
-        float stdDev, float opacity, const Pixel32& color)
-    : GPUFilter(SHADERID_HORIZ, true, false, 2)
+        float stdDev, float opacity, const Pixel32& color, bool bFast)
+    : GPUFilter(SHADERID_HORIZ, true, false, 2),
+      m_bFast(bFast),
+      m_Downscale(1)
 {
     ObjectCounter::get()->incRef(&typeid(*this));
 
@@ -56,6 +61,8 @@ GPUShadowFilter::GPUShadowFilter(const IntPoint& size, const glm::vec2& offset,
     setDimensions(size, stdDev, offset);
     GLContextManager* pCM = GLContextManager::get();
     pCM->createShader(SHADERID_VERT);
+    pCM->createShader(SHADERID_FAST_HORIZ);
+    pCM->createShader(SHADERID_FAST_VERT);
     setParams(offset, stdDev, opacity, color);
     
     m_pHorizWidthParam = pCM->createShaderParam<float>(SHADERID_HORIZ, "u_Width");
@@ -72,6 +79,36 @@ GPUShadowFilter::GPUShadowFilter(const IntPoint& size, const glm::vec2& offset,
     m_pVertOrigTexParam = pCM->createShaderParam<int>(SHADERID_VERT, "u_OrigTex");
     m_pVertDestPosParam = pCM->createShaderParam<glm::vec2>(SHADERID_VERT, "u_DestPos");
     m_pVertDestSizeParam = pCM->createShaderParam<glm::vec2>(SHADERID_VERT, "u_DestSize");
+
+    m_pFastHorizTextureParam = 
+            pCM->createShaderParam<int>(SHADERID_FAST_HORIZ, "u_Texture");
+    m_pFastHorizNumTapsParam = 
+            pCM->createShaderParam<int>(SHADERID_FAST_HORIZ, "u_NumTaps");
+    m_pFastHorizWeightsParam = 
+            pCM->createShaderParam<vector<float> >(SHADERID_FAST_HORIZ, "u_Weights");
+    m_pFastHorizOffsetsParam = 
+            pCM->createShaderParam<vector<float> >(SHADERID_FAST_HORIZ, "u_Offsets");
+    m_pFastHorizOffsetParam = 
+            pCM->createShaderParam<glm::vec2>(SHADERID_FAST_HORIZ, "u_Offset");
+
+    m_pFastVertTextureParam = 
+            pCM->createShaderParam<int>(SHADERID_FAST_VERT, "u_HBlurTex");
+    m_pFastVertNumTapsParam = 
+            pCM->createShaderParam<int>(SHADERID_FAST_VERT, "u_NumTaps");
+    m_pFastVertWeightsParam = 
+            pCM->createShaderParam<vector<float> >(SHADERID_FAST_VERT, "u_Weights");
+    m_pFastVertOffsetsParam = 
+            pCM->createShaderParam<vector<float> >(SHADERID_FAST_VERT, "u_Offsets");
+    m_pFastVertStepScaleParam = 
+            pCM->createShaderParam<float>(SHADERID_FAST_VERT, "u_StepScale");
+    m_pFastVertColorParam = 
+            pCM->createShaderParam<Pixel32>(SHADERID_FAST_VERT, "u_Color");
+    m_pFastVertOrigTexParam = 
+            pCM->createShaderParam<int>(SHADERID_FAST_VERT, "u_OrigTex");
+    m_pFastVertDestPosParam = 
+            pCM->createShaderParam<glm::vec2>(SHADERID_FAST_VERT, "u_DestPos");
+    m_pFastVertDestSizeParam = 
+            pCM->createShaderParam<glm::vec2>(SHADERID_FAST_VERT, "u_DestSize");
 }
 
 GPUShadowFilter::~GPUShadowFilter()
@@ -91,10 +128,21 @@ void GPUShadowFilter::setParams(const glm::vec2& offset, float stdDev, float opa
     IntRect destRect2(IntPoint(0,0), getDestRect().size());
     m_pProjection2 = ImagingProjectionPtr(new ImagingProjection(
             getDestRect().size(), destRect2));
+    initFastParams();
+}
+
+void GPUShadowFilter::setFast(bool bFast)
+{
+    m_bFast = bFast;
+    initFastParams();
 }
 
 void GPUShadowFilter::applyOnGPU(GLContext* pContext, GLTexturePtr pSrcTex)
 {
+    if (m_bFast) {
+        applyFastOnGPU(pContext, pSrcTex);
+        return;
+    }
     int kernelWidth = m_pGaussCurveTex->getSize().x;
     getFBO(pContext, 1)->activate();
     getShader()->activate();
@@ -128,6 +176,76 @@ void GPUShadowFilter::applyOnGPU(GLContext* pContext, GLTexturePtr pSrcTex)
     m_pProjection2->draw(pContext, avg::getShader(SHADERID_VERT));
 }
 
+void GPUShadowFilter::initFastParams()
+{
+    m_pDownscaleFBO = MCFBOPtr();
+    m_pDownscaleProjection = ImagingProjectionPtr();
+    if (!m_bFast) {
+        return;
+    }
+    m_Downscale = getBlurDownscale(m_StdDev, m_Opacity);
+    float scaledStdDev = m_StdDev/m_Downscale;
+    if (m_Downscale == 1) {
+        calcBlurTaps(scaledStdDev, m_Opacity, true, m_HorizWeights, m_HorizOffsets);
+    } else {
+        // See GPUBlurFilter::initFastParams().
+        calcBlurTaps(scaledStdDev, m_Opacity, false, m_HorizWeights, m_HorizOffsets);
+        IntPoint destSize = getDestRect().size();
+        IntPoint scaledSize((destSize.x+m_Downscale-1)/m_Downscale, 
+                (destSize.y+m_Downscale-1)/m_Downscale);
+        m_pDownscaleFBO = GLContextManager::get()->createFBO(scaledSize, B8G8R8A8);
+        m_pDownscaleProjection = ImagingProjectionPtr(new ImagingProjection(
+                getSrcSize(), getDestRect(), scaledSize));
+    }
+    calcBlurTaps(scaledStdDev, m_Opacity, true, m_VertWeights, m_VertOffsets);
+}
+
+void GPUShadowFilter::applyFastOnGPU(GLContext* pContext, GLTexturePtr pSrcTex)
+{
+    if (m_pDownscaleFBO) {
+        m_pDownscaleFBO->activate(pContext);
+    } else {
+        getFBO(pContext, 1)->activate();
+    }
+    OGLShaderPtr pHShader = avg::getShader(SHADERID_FAST_HORIZ);
+    pHShader->activate();
+    m_pFastHorizTextureParam->set(pContext, 0);
+    m_pFastHorizNumTapsParam->set(pContext, int(m_HorizWeights.size()));
+    m_pFastHorizWeightsParam->set(pContext, m_HorizWeights);
+    m_pFastHorizOffsetsParam->set(pContext, m_HorizOffsets);
+    IntPoint size = getSrcSize();
+    glm::vec2 texOffset(m_Offset.x/size.x, m_Offset.y/size.y);
+    m_pFastHorizOffsetParam->set(pContext, texOffset);
+    pSrcTex->activate(m_WrapMode, GL_TEXTURE0);
+    GLTexturePtr pHBlurTex;
+    if (m_pDownscaleFBO) {
+        m_pDownscaleProjection->draw(pContext, pHShader);
+        m_pDownscaleFBO->copyToDestTexture(pContext);
+        pHBlurTex = m_pDownscaleFBO->getTex()->getTex(pContext);
+    } else {
+        draw(pContext, pSrcTex, m_WrapMode, pHShader);
+        pHBlurTex = getDestTex(pContext, 1);
+    }
+
+    getFBO(pContext, 0)->activate();
+    OGLShaderPtr pVShader = avg::getShader(SHADERID_FAST_VERT);
+    pVShader->activate();
+    m_pFastVertTextureParam->set(pContext, 0);
+    m_pFastVertNumTapsParam->set(pContext, int(m_VertWeights.size()));
+    m_pFastVertWeightsParam->set(pContext, m_VertWeights);
+    m_pFastVertOffsetsParam->set(pContext, m_VertOffsets);
+    m_pFastVertStepScaleParam->set(pContext, float(m_Downscale));
+    m_pFastVertColorParam->set(pContext, m_Color);
+
+    pSrcTex->activate(m_WrapMode, GL_TEXTURE2);
+    m_pFastVertOrigTexParam->set(pContext, 2);
+    FRect destRect = getRelDestRect();
+    m_pFastVertDestPosParam->set(pContext, destRect.tl);
+    m_pFastVertDestSizeParam->set(pContext, destRect.size());
+    pHBlurTex->activate(m_WrapMode, GL_TEXTURE0);
+    m_pProjection2->draw(pContext, pVShader);
+}
+
 void GPUShadowFilter::setDimensions(IntPoint size, float stdDev, const glm::vec2& offset)
 {
     int radius = getBlurKernelRadius(stdDev);
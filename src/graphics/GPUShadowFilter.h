@@ -35,20 +35,24 @@ class AVG_API GPUShadowFilter: public GPUFilter
 {
 public:
     GPUShadowFilter(const IntPoint& size, const glm::vec2& offset, float stdDev,
-            float opacity, const Pixel32& color);
+            float opacity, const Pixel32& color, bool bFast=false);
     virtual ~GPUShadowFilter();
     
     void setParams(const glm::vec2& offset, float stdDev, float opacity, 
             const Pixel32& color);
+    void setFast(bool bFast);
     virtual void applyOnGPU(GLContext* pContext, GLTexturePtr pSrcTex);
 
 private:
     void setDimensions(IntPoint size, float stdDev, const glm::vec2& offset);
+    void initFastParams();
+    void applyFastOnGPU(GLContext* pContext, GLTexturePtr pSrcTex);
 
     glm::vec2 m_Offset;
     float m_StdDev;
     float m_Opacity;
     Pixel32 m_Color;
+    bool m_bFast;
     WrapMode m_WrapMode;
 
     MCTexturePtr m_pGaussCurveTex;
@@ -68,6 +72,31 @@ private:
     IntMCShaderParamPtr m_pVertOrigTexParam;
     Vec2fMCShaderParamPtr m_pVertDestPosParam;
     Vec2fMCShaderParamPtr m_pVertDestSizeParam;
+
+    // Tap-optimized mode
+    int m_Downscale;
+    MCFBOPtr m_pDownscaleFBO;
+    ImagingProjectionPtr m_pDownscaleProjection;
+    std::vector<float> m_HorizWeights;
+    std::vector<float> m_HorizOffsets;
+    std::vector<float> m_VertWeights;
+    std::vector<float> m_VertOffsets;
+
+    IntMCShaderParamPtr m_pFastHorizTextureParam;
+    IntMCShaderParamPtr m_pFastHorizNumTapsParam;
+    FloatArrayMCShaderParamPtr m_pFastHorizWeightsParam;
+    FloatArrayMCShaderParamPtr m_pFastHorizOffsetsParam;
+    Vec2fMCShaderParamPtr m_pFastHorizOffsetParam;
+
+    IntMCShaderParamPtr m_pFastVertTextureParam;
+    IntMCShaderParamPtr m_pFastVertNumTapsParam;
+    FloatArrayMCShaderParamPtr m_pFastVertWeightsParam;
+    FloatArrayMCShaderParamPtr m_pFastVertOffsetsParam;
+    FloatMCShaderParamPtr m_pFastVertStepScaleParam;
+    ColorMCShaderParamPtr m_pFastVertColorParam;
+    IntMCShaderParamPtr m_pFastVertOrigTexParam;
+    Vec2fMCShaderParamPtr m_pFastVertDestPosParam;
+    Vec2fMCShaderParamPtr m_pFastVertDestSizeParam;
 };
 
 typedef boost::shared_ptr<GPUShadowFilter> GPUShadowFilterPtr;
@@ -0,0 +1,113 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "GPUTimer.h"
+
+#include "GLContext.h"
+#include "OGLHelper.h"
+
+#include "../base/Exception.h"
+#include "../base/ObjectCounter.h"
+
+namespace avg {
+
+GPUTimer::GPUTimer()
+    : m_CurQuery(0),
+      m_OldestPending(0),
+      m_LastResult(-1)
+{
+    ObjectCounter::get()->incRef(&typeid(*this));
+    AVG_ASSERT(isSupported());
+#ifndef AVG_ENABLE_EGL
+    glproc::GenQueries(NUM_QUERIES, m_QueryIDs);
+    GLContext::checkError("GPUTimer: GenQueries()");
+#endif
+    for (int i=0; i<NUM_QUERIES; ++i) {
+        m_bPending[i] = false;
+    }
+}
+
+GPUTimer::~GPUTimer()
+{
+#ifndef AVG_ENABLE_EGL
+    if (GLContext::getCurrent()) {
+        glproc::DeleteQueries(NUM_QUERIES, m_QueryIDs);
+    }
+#endif
+    ObjectCounter::get()->decRef(&typeid(*this));
+}
+
+bool GPUTimer::isSupported()
+{
+    GLContext* pContext = GLContext::getCurrent();
+    return pContext && pContext->areTimerQueriesSupported();
+}
+
+void GPUTimer::begin()
+{
+    collectResults();
+    if (m_bPending[m_CurQuery]) {
+        // All queries are still in flight. Drop the oldest one instead of stalling.
+        m_bPending[m_CurQuery] = false;
+        m_OldestPending = (m_CurQuery+1) % NUM_QUERIES;
+    }
+#ifndef AVG_ENABLE_EGL
+    glproc::BeginQuery(GL_TIME_ELAPSED, m_QueryIDs[m_CurQuery]);
+#endif
+}
+
+void GPUTimer::end()
+{
+#ifndef AVG_ENABLE_EGL
+    glproc::EndQuery(GL_TIME_ELAPSED);
+    GLContext::checkError("GPUTimer::end()");
+#endif
+    m_bPending[m_CurQuery] = true;
+    m_CurQuery = (m_CurQuery+1) % NUM_QUERIES;
+}
+
+long long GPUTimer::getLastResult()
+{
+    collectResults();
+    return m_LastResult;
+}
+
+void GPUTimer::collectResults()
+{
+#ifndef AVG_ENABLE_EGL
+    while (m_bPending[m_OldestPending]) {
+        unsigned queryID = m_QueryIDs[m_OldestPending];
+        GLint bAvailable = 0;
+        glproc::GetQueryObjectiv(queryID, GL_QUERY_RESULT_AVAILABLE, &bAvailable);
+        if (!bAvailable) {
+            break;
+        }
+        GLuint64 nanosecs = 0;
+        glproc::GetQueryObjectui64v(queryID, GL_QUERY_RESULT, &nanosecs);
+        m_LastResult = (long long)(nanosecs/1000);
+        m_bPending[m_OldestPending] = false;
+        m_OldestPending = (m_OldestPending+1) % NUM_QUERIES;
+    }
+#endif
+}
+
+}
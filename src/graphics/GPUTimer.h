@@ -0,0 +1,65 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _GPUTimer_H_
+#define _GPUTimer_H_
+
+#include "../api.h"
+
+#include <boost/shared_ptr.hpp>
+
+namespace avg {
+
+// Measures the GPU time spent on the commands issued between begin() and end() using
+// GL_TIME_ELAPSED queries. Results arrive asynchronously, so a small ring of queries
+// is used and getLastResult() returns the most recent measurement that has completed,
+// typically from one or two frames ago. Timers can't be nested and must be used with
+// the GL context that was current when the timer was constructed.
+class AVG_API GPUTimer {
+public:
+    GPUTimer();
+    virtual ~GPUTimer();
+
+    static bool isSupported();
+
+    void begin();
+    void end();
+
+    // Returns the time in microseconds or -1 if no result is available yet.
+    long long getLastResult();
+
+private:
+    void collectResults();
+
+    static const int NUM_QUERIES = 4;
+    unsigned m_QueryIDs[NUM_QUERIES];
+    bool m_bPending[NUM_QUERIES];
+    int m_CurQuery;
+    int m_OldestPending;
+    long long m_LastResult;
+};
+
+typedef boost::shared_ptr<GPUTimer> GPUTimerPtr;
+
+}
+
+#endif
@@ -25,6 +25,13 @@
 #include "../base/OSHelper.h"
 #include "../base/ConfigMgr.h"
 #include "../base/Logger.h"
+#include "../base/ObjectCounter.h"
+#include "../base/ProfilingZoneID.h"
+#include "../base/TaskPool.h"
+
+#include "BitmapLoader.h"
+
+#include <boost/bind.hpp>
 
 using namespace std;
 
@@ -32,6 +39,8 @@ namespace avg {
 
 ImageCache * ImageCache::s_pImageCache = 0;
 
+static ProfilingZoneID LoadImageProfilingZone("ImageCache: load level");
+
 bool ImageCache::exists()
 {
     return (s_pImageCache != 0);
@@ -46,7 +55,8 @@ ImageCache* ImageCache::get()
 }
 
 ImageCache::ImageCache()
-    : m_CPUCacheUsed(0),
+    : m_pLoadedImages(new LoadedImageQueue),
+      m_CPUCacheUsed(0),
       m_GPUCacheUsed(0)
 {
     glm::vec2 sizeOpt = ConfigMgr::get()->getSizeOption("scr", "imgcachesize");
@@ -95,14 +105,15 @@ long long ImageCache::getMemUsed(CachedImage::StorageType st)
 }
 
 CachedImagePtr ImageCache::getImage(const std::string& sFilename,
-        TexCompression compression)
+        TexCompression compression, int level)
 {
-    ImageMap::iterator it = m_pImageMap.find(sFilename);
+    string sKey = CachedImage::getCacheKey(sFilename, level);
+    ImageMap::iterator it = m_pImageMap.find(sKey);
     CachedImagePtr pImg;
     if (it == m_pImageMap.end()) {
-        pImg = CachedImagePtr(new CachedImage(sFilename, compression));
+        pImg = CachedImagePtr(new CachedImage(sFilename, compression, level));
         m_pLRUList.push_front(pImg);
-        m_pImageMap.insert(make_pair(sFilename, m_pLRUList.begin()));
+        m_pImageMap.insert(make_pair(sKey, m_pLRUList.begin()));
         m_CPUCacheUsed += pImg->getMemUsed(CachedImage::STORAGE_CPU);
         checkCPUUnload();
     } else {
@@ -115,6 +126,91 @@ CachedImagePtr ImageCache::getImage(const std::string& sFilename,
     return pImg;
 }
 
+CachedImagePtr ImageCache::getImageIfLoaded(const std::string& sFilename,
+        TexCompression compression, int level)
+{
+    ImageMap::iterator it = m_pImageMap.find(CachedImage::getCacheKey(sFilename, level));
+    if (it == m_pImageMap.end()) {
+        return CachedImagePtr();
+    }
+    return getImage(sFilename, compression, level);
+}
+
+void ImageCache::requestImage(const std::string& sFilename, TexCompression compression,
+        int level)
+{
+    string sKey = CachedImage::getCacheKey(sFilename, level);
+    if (m_pImageMap.find(sKey) != m_pImageMap.end() || 
+            m_PendingImages.find(sKey) != m_PendingImages.end() ||
+            m_FailedImages.find(sKey) != m_FailedImages.end())
+    {
+        return;
+    }
+    m_PendingImages.insert(sKey);
+    TaskPool::get()->submit(boost::bind(&ImageCache::loadImageTask,
+            LoadedImageQueueWeakPtr(m_pLoadedImages), sFilename, compression, level),
+            &LoadImageProfilingZone);
+}
+
+void ImageCache::processLoadedImages()
+{
+    vector<LoadedImage> loadedImages;
+    {
+        boost::mutex::scoped_lock lock(m_pLoadedImages->m_Mutex);
+        loadedImages.swap(m_pLoadedImages->m_Images);
+    }
+    if (loadedImages.empty()) {
+        return;
+    }
+    for (vector<LoadedImage>::iterator it = loadedImages.begin(); 
+            it != loadedImages.end(); ++it)
+    {
+        string sKey = CachedImage::getCacheKey(it->m_sFilename, it->m_Level);
+        m_PendingImages.erase(sKey);
+        if (!it->m_pBmp) {
+            AVG_LOG_WARNING("Could not load " << sKey << ": " << it->m_sError);
+            m_FailedImages.insert(sKey);
+        } else if (m_pImageMap.find(sKey) == m_pImageMap.end()) {
+            CachedImagePtr pImg(new CachedImage(it->m_sFilename, it->m_Compression,
+                    it->m_Level, it->m_pBmp));
+            m_pLRUList.push_front(pImg);
+            m_pImageMap.insert(make_pair(sKey, m_pLRUList.begin()));
+            m_CPUCacheUsed += pImg->getMemUsed(CachedImage::STORAGE_CPU);
+            // Nobody is using the image yet, so it goes into the unused partition.
+            pImg->decBmpRef();
+        }
+    }
+    checkCPUUnload();
+    for (vector<LoadedImage>::iterator it = loadedImages.begin(); 
+            it != loadedImages.end(); ++it)
+    {
+        string sKey = CachedImage::getCacheKey(it->m_sFilename, it->m_Level);
+        if (it->m_pBmp && m_pImageMap.find(sKey) == m_pImageMap.end()) {
+            // Evicted right away because the cache is full of images in use. Don't
+            // request it again every frame.
+            AVG_LOG_WARNING("Image cache full, not loading " << sKey);
+            m_FailedImages.insert(sKey);
+        }
+    }
+}
+
+int ImageCache::getNumPendingImages() const
+{
+    return m_PendingImages.size();
+}
+
+IntPoint ImageCache::getImageSize(const std::string& sFilename)
+{
+    map<string, IntPoint>::iterator it = m_ImageSizes.find(sFilename);
+    if (it == m_ImageSizes.end()) {
+        IntPoint size = BitmapLoader::get()->getImageSize(sFilename);
+        m_ImageSizes[sFilename] = size;
+        return size;
+    } else {
+        return it->second;
+    }
+}
+
 void ImageCache::onTexLoad(const std::string& sFilename)
 {
     CachedImagePtr pImg = *(m_pImageMap[sFilename]);
@@ -152,6 +248,7 @@ void ImageCache::onSizeChange(int sizeDiff, CachedImage::StorageType st)
         m_GPUCacheUsed += sizeDiff;
     }
     assertValid();
+    updateMemAccounting();
 }
 
 int ImageCache::getNumCPUImages() const
@@ -180,6 +277,7 @@ void ImageCache::unloadAllTextures()
             pImg->unloadTex();
         }
     }
+    updateMemAccounting();
 }
 
 void ImageCache::dump() const
@@ -197,7 +295,7 @@ void ImageCache::checkCPUUnload()
     while (m_CPUCacheUsed > m_CPUCacheCapacity) {
         CachedImagePtr pImg = *(m_pLRUList.rbegin());
         if (pImg->getRefCount(CachedImage::STORAGE_CPU) == 0) {
-            m_pImageMap.erase(pImg->getFilename());
+            m_pImageMap.erase(pImg->getCacheKey());
             m_pLRUList.pop_back();
             m_CPUCacheUsed -= pImg->getMemUsed(CachedImage::STORAGE_CPU);
             m_GPUCacheUsed -= pImg->getMemUsed(CachedImage::STORAGE_GPU);
@@ -236,6 +334,36 @@ void ImageCache::checkGPUUnload()
         }
     }
     assertValid();
+    updateMemAccounting();
+}
+
+void ImageCache::loadImageTask(LoadedImageQueueWeakPtr pWeakQueue,
+        const std::string& sFilename, TexCompression compression, int level)
+{
+    if (pWeakQueue.expired()) {
+        return;
+    }
+    LoadedImage loadedImage;
+    loadedImage.m_sFilename = sFilename;
+    loadedImage.m_Compression = compression;
+    loadedImage.m_Level = level;
+    try {
+        loadedImage.m_pBmp = CachedImage::loadLevel(sFilename, level);
+    } catch (const Exception& ex) {
+        loadedImage.m_sError = ex.getStr();
+    }
+    LoadedImageQueuePtr pQueue = pWeakQueue.lock();
+    if (pQueue) {
+        boost::mutex::scoped_lock lock(pQueue->m_Mutex);
+        pQueue->m_Images.push_back(loadedImage);
+    }
+}
+
+void ImageCache::updateMemAccounting()
+{
+    ObjectCounter* pCounter = ObjectCounter::get();
+    pCounter->setBytes(ObjectCounter::MEM_IMAGECACHE_CPU, m_CPUCacheUsed);
+    pCounter->setBytes(ObjectCounter::MEM_IMAGECACHE_GPU, m_GPUCacheUsed);
 }
 
 void ImageCache::assertValid()
@@ -30,8 +30,13 @@
 #include "TexInfo.h"
 
 #include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/thread/mutex.hpp>
 #include <string>
 #include <list>
+#include <map>
+#include <set>
+#include <vector>
 
 #ifdef _WIN32
 #include <unordered_map>
@@ -54,7 +59,21 @@ class AVG_API ImageCache
         long long getCapacity(CachedImage::StorageType st);
         long long getMemUsed(CachedImage::StorageType st);
         CachedImagePtr getImage(const std::string& sFilename,
-                TexCompression compression);
+                TexCompression compression, int level=0);
+
+        // Level of detail support: Reduced-resolution versions of an image are
+        // cached as separate entries. getImageIfLoaded() returns an empty pointer if
+        // the level isn't in the cache. requestImage() loads a level in the
+        // background; it is added to the cache in processLoadedImages(), which is
+        // called once per frame.
+        CachedImagePtr getImageIfLoaded(const std::string& sFilename,
+                TexCompression compression, int level);
+        void requestImage(const std::string& sFilename, TexCompression compression,
+                int level);
+        void processLoadedImages();
+        int getNumPendingImages() const;
+        IntPoint getImageSize(const std::string& sFilename);
+
         void onTexLoad(const std::string& sFilename);
         void onImageUnused(const std::string& sFilename, CachedImage::StorageType st);
         void onSizeChange(int sizeDiff, CachedImage::StorageType st);
@@ -69,8 +88,27 @@ class AVG_API ImageCache
         void checkCPUUnload();
         void checkGPUUnload();
 
+        void updateMemAccounting();
         void assertValid();
 
+        struct LoadedImage {
+            std::string m_sFilename;
+            TexCompression m_Compression;
+            int m_Level;
+            BitmapPtr m_pBmp;
+            std::string m_sError;
+        };
+        // Background loads deliver their results here. Tasks only hold a weak
+        // pointer, so they don't touch the cache if it's gone by the time they finish.
+        struct LoadedImageQueue {
+            boost::mutex m_Mutex;
+            std::vector<LoadedImage> m_Images;
+        };
+        typedef boost::shared_ptr<LoadedImageQueue> LoadedImageQueuePtr;
+        typedef boost::weak_ptr<LoadedImageQueue> LoadedImageQueueWeakPtr;
+        static void loadImageTask(LoadedImageQueueWeakPtr pQueue,
+                const std::string& sFilename, TexCompression compression, int level);
+
         typedef std::list<CachedImagePtr> LRUListType;
         // This is a list of all loaded images in three partitions:
         // 1) Images that have both CPU and GPU refcounts > 0
@@ -85,6 +123,14 @@ class AVG_API ImageCache
 #endif
         ImageMap m_pImageMap;
 
+        // Background loads: keys of images requested but not yet in the cache, and
+        // keys that failed to load or didn't fit into the cache so they aren't
+        // requested again.
+        std::set<std::string> m_PendingImages;
+        std::set<std::string> m_FailedImages;
+        LoadedImageQueuePtr m_pLoadedImages;
+        std::map<std::string, IntPoint> m_ImageSizes;
+
         long long m_CPUCacheCapacity;
         long long m_GPUCacheCapacity;
         long long m_CPUCacheUsed;
@@ -33,7 +33,8 @@ using namespace std;
 namespace avg {
 
 ImagingProjection::ImagingProjection(IntPoint size)
-    : m_Color(0, 0, 0, 0)
+    : m_ViewportSize(size),
+      m_Color(0, 0, 0, 0)
 {
     GLContextManager* pCM = GLContextManager::get();
     m_pVA = pCM->createVertexArray();
@@ -43,7 +44,8 @@ ImagingProjection::ImagingProjection(IntPoint size)
 }
 
 ImagingProjection::ImagingProjection(IntPoint srcSize, IntRect destRect)
-    : m_Color(0, 0, 0, 0)
+    : m_ViewportSize(destRect.size()),
+      m_Color(0, 0, 0, 0)
 {
     GLContextManager* pCM = GLContextManager::get();
     m_pVA = pCM->createVertexArray();
@@ -52,6 +54,19 @@ ImagingProjection::ImagingProjection(IntPoint srcSize, IntRect destRect)
     init(srcSize, destRect);
 }
 
+ImagingProjection::ImagingProjection(IntPoint srcSize, IntRect destRect, 
+        IntPoint viewportSize)
+    : m_ViewportSize(viewportSize),
+      m_Color(0, 0, 0, 0)
+{
+    // Renders destRect into a viewport of a different size, e.g. to scale down.
+    GLContextManager* pCM = GLContextManager::get();
+    m_pVA = pCM->createVertexArray();
+    pCM->uploadData();
+
+    init(srcSize, destRect);
+}
+
 ImagingProjection::~ImagingProjection()
 {
 }
@@ -66,8 +81,7 @@ void ImagingProjection::setColor(const Pixel32& color)
 
 void ImagingProjection::draw(GLContext* pContext, const OGLShaderPtr& pShader)
 {
-    IntPoint destSize = m_DestRect.size();
-    glViewport(0, 0, destSize.x, destSize.y);
+    glViewport(0, 0, m_ViewportSize.x, m_ViewportSize.y);
     pShader->setTransform(m_ProjMat); 
     m_pVA->draw(pContext);
 }
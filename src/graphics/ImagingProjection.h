@@ -42,6 +42,7 @@ class AVG_API ImagingProjection
 public:
     ImagingProjection(IntPoint size);
     ImagingProjection(IntPoint srcSize, IntRect destRect);
+    ImagingProjection(IntPoint srcSize, IntRect destRect, IntPoint viewportSize);
     virtual ~ImagingProjection();
 
     void setColor(const Pixel32& color);
@@ -52,6 +53,7 @@ private:
 
     IntPoint m_SrcSize;
     IntRect m_DestRect;
+    IntPoint m_ViewportSize;
     IntPoint m_Offset;
     Pixel32 m_Color;
     VertexArrayPtr m_pVA;
@@ -106,6 +106,9 @@ typedef boost::shared_ptr<Vec4fMCShaderParam> Vec4fMCShaderParamPtr;
 typedef MCShaderParamTemplate<glm::mat4> Mat4fMCShaderParam; 
 typedef boost::shared_ptr<Mat4fMCShaderParam> Mat4fMCShaderParamPtr;
 
+typedef MCShaderParamTemplate<std::vector<float> > FloatArrayMCShaderParam; 
+typedef boost::shared_ptr<FloatArrayMCShaderParam> FloatArrayMCShaderParamPtr;
+
 }
 
 #endif
@@ -42,7 +42,10 @@ using namespace std;
 MCTexture::MCTexture(const IntPoint& size, PixelFormat pf, bool bMipmap, bool bForcePOT,
         int potBorderColor)
     : TexInfo(size, pf, bMipmap, usePOT(bForcePOT, bMipmap), potBorderColor),
-      m_bIsDirty(true)
+      m_bIsDirty(true),
+      m_ContentVersion(0),
+      m_bUploadScheduled(false),
+      m_bHasContent(false)
 {
     ObjectCounter::get()->incRef(&typeid(*this));
 }
@@ -63,11 +66,13 @@ void MCTexture::moveBmpToTexture(GLContext* pContext, BitmapPtr pBmp)
 {
     getTex(pContext)->moveBmpToTexture(pBmp);
     m_bIsDirty = true;
+    m_bHasContent = true;
 }
 
 void MCTexture::setDirty()
 {
     m_bIsDirty = true;
+    m_ContentVersion++;
 }
 
 bool MCTexture::isDirty() const
@@ -80,6 +85,21 @@ void MCTexture::resetDirty()
     m_bIsDirty = false;
 }
 
+unsigned MCTexture::getContentVersion() const
+{
+    return m_ContentVersion;
+}
+
+bool MCTexture::isReady() const
+{
+    return m_bHasContent || !m_bUploadScheduled;
+}
+
+void MCTexture::setUploadScheduled()
+{
+    m_bUploadScheduled = true;
+}
+
 const GLTexturePtr& MCTexture::getTex(GLContext* pContext) const
 {
     TexMap::const_iterator it = m_pTextures.find(pContext);
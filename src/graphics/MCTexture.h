@@ -59,6 +59,13 @@ public:
     void setDirty();
     bool isDirty() const;
     void resetDirty();
+    // Incremented whenever the texture is marked dirty, e.g. when new data is scheduled
+    // for upload.
+    unsigned getContentVersion() const;
+    // False if data for the texture has been scheduled for upload but the first upload
+    // hasn't happened yet, i.e. the texture contents are undefined.
+    bool isReady() const;
+    void setUploadScheduled();
 
 private:
 #ifdef __APPLE__
@@ -69,6 +76,9 @@ private:
     TexMap m_pTextures;
 
     bool m_bIsDirty;
+    unsigned m_ContentVersion;
+    bool m_bUploadScheduled;
+    bool m_bHasContent;
 };
 
 typedef boost::shared_ptr<MCTexture> MCTexturePtr;
@@ -53,6 +53,15 @@ namespace glproc {
     PFNGLDRAWBUFFERSPROC DrawBuffers;
     PFNGLDRAWRANGEELEMENTSPROC DrawRangeElements;
     PFNGLGETOBJECTPARAMETERIVARBPROC GetObjectParameteriv;
+    PFNGLFENCESYNCPROC FenceSync;
+    PFNGLCLIENTWAITSYNCPROC ClientWaitSync;
+    PFNGLDELETESYNCPROC DeleteSync;
+    PFNGLGENQUERIESPROC GenQueries;
+    PFNGLDELETEQUERIESPROC DeleteQueries;
+    PFNGLBEGINQUERYPROC BeginQuery;
+    PFNGLENDQUERYPROC EndQuery;
+    PFNGLGETQUERYOBJECTIVPROC GetQueryObjectiv;
+    PFNGLGETQUERYOBJECTUI64VPROC GetQueryObjectui64v;
 #endif
     PFNGLGENBUFFERSPROC GenBuffers;
     PFNGLBUFFERDATAPROC BufferData;
@@ -415,6 +424,17 @@ namespace glproc {
                 getFuzzyProcAddress("glDrawRangeElements");
         DebugMessageCallback = (PFNGLDEBUGMESSAGECALLBACKARBPROC)
                 getFuzzyProcAddress("glDebugMessageCallback");
+        FenceSync = (PFNGLFENCESYNCPROC)getFuzzyProcAddress("glFenceSync");
+        ClientWaitSync = (PFNGLCLIENTWAITSYNCPROC)getFuzzyProcAddress("glClientWaitSync");
+        DeleteSync = (PFNGLDELETESYNCPROC)getFuzzyProcAddress("glDeleteSync");
+        GenQueries = (PFNGLGENQUERIESPROC)getFuzzyProcAddress("glGenQueries");
+        DeleteQueries = (PFNGLDELETEQUERIESPROC)getFuzzyProcAddress("glDeleteQueries");
+        BeginQuery = (PFNGLBEGINQUERYPROC)getFuzzyProcAddress("glBeginQuery");
+        EndQuery = (PFNGLENDQUERYPROC)getFuzzyProcAddress("glEndQuery");
+        GetQueryObjectiv = (PFNGLGETQUERYOBJECTIVPROC)
+                getFuzzyProcAddress("glGetQueryObjectiv");
+        GetQueryObjectui64v = (PFNGLGETQUERYOBJECTUI64VPROC)
+                getFuzzyProcAddress("glGetQueryObjectui64v");
 #endif
         VertexAttribPointer = (PFNGLVERTEXATTRIBPOINTERPROC)
                 getFuzzyProcAddress("glVertexAttribPointer");
@@ -183,6 +183,15 @@ namespace glproc {
     extern AVG_API PFNGLDRAWRANGEELEMENTSPROC DrawRangeElements;
     extern AVG_API PFNGLBLITFRAMEBUFFERPROC BlitFramebuffer;
     extern AVG_API PFNGLGETOBJECTPARAMETERIVARBPROC GetObjectParameteriv;
+    extern AVG_API PFNGLFENCESYNCPROC FenceSync;
+    extern AVG_API PFNGLCLIENTWAITSYNCPROC ClientWaitSync;
+    extern AVG_API PFNGLDELETESYNCPROC DeleteSync;
+    extern AVG_API PFNGLGENQUERIESPROC GenQueries;
+    extern AVG_API PFNGLDELETEQUERIESPROC DeleteQueries;
+    extern AVG_API PFNGLBEGINQUERYPROC BeginQuery;
+    extern AVG_API PFNGLENDQUERYPROC EndQuery;
+    extern AVG_API PFNGLGETQUERYOBJECTIVPROC GetQueryObjectiv;
+    extern AVG_API PFNGLGETQUERYOBJECTUI64VPROC GetQueryObjectui64v;
 #endif
     extern AVG_API PFNGLDEBUGMESSAGECALLBACKPROC DebugMessageCallback;
     extern AVG_API PFNGLDELETEBUFFERSPROC DeleteBuffers;
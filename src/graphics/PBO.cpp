@@ -22,6 +22,7 @@
 #include "PBO.h"
 #include "GLContext.h"
 #include "GLTexture.h"
+#include "RenderStats.h"
 
 #include "../base/Logger.h"
 #include "../base/Exception.h"
@@ -40,26 +41,19 @@ PBO::PBO(const IntPoint& size, PixelFormat pf, unsigned usage)
       m_Usage(usage)
 {
     ObjectCounter::get()->incRef(&typeid(*this));
-    m_PBOID = GLContext::getCurrent()->getPBOCache().getBuffer();
-    
-    unsigned target = getTarget();
-    glproc::BindBuffer(target, m_PBOID);
-    GLContext::checkError("PBO: BindBuffer()");
-    glproc::BufferData(target, getMemNeeded(), 0, usage);
-    GLContext::checkError("PBO: BufferData()");
-    glproc::BindBuffer(target, 0);
+    // PBOs are short-lived (one per texture upload in most cases), so the buffers and 
+    // their storage are recycled through the context's PBO cache.
+    m_Capacity = GLBufferCache::getBucketSize(getMemNeeded());
+    m_PBOID = GLContext::getCurrent()->getPBOCache().getBuffer(getTarget(), usage,
+            m_Capacity);
 }
 
 PBO::~PBO()
 {
-    glproc::BindBuffer(getTarget(), m_PBOID);
-    glproc::BufferData(getTarget(), 0, 0, m_Usage);
     GLContext* pContext = GLContext::getCurrent();
     if (pContext) {
-        pContext->getPBOCache().returnBuffer(m_PBOID);
+        pContext->getPBOCache().returnBuffer(m_PBOID, m_Usage, m_Capacity);
     }
-    glproc::BindBuffer(getTarget(), 0);
-    GLContext::checkError("PBO: DeleteBuffers()");
     ObjectCounter::get()->decRef(&typeid(*this));
 }
 
@@ -83,6 +77,10 @@ void PBO::moveBmpToTexture(BitmapPtr pBmp, GLTexture& tex)
     AVG_ASSERT(!isReadPBO());
     glproc::BindBuffer(GL_PIXEL_UNPACK_BUFFER_EXT, m_PBOID);
     GLContext::checkError("PBO::moveBmpToTexture BindBuffer()");
+    // Orphan the old storage: A recycled buffer may still be the source of an upload
+    // that the GPU hasn't executed yet, and mapping it would wait for that.
+    glproc::BufferData(GL_PIXEL_UNPACK_BUFFER_EXT, m_Capacity, 0, m_Usage);
+    GLContext::checkError("PBO::moveBmpToTexture BufferData()");
     void * pPBOPixels = glproc::MapBuffer(GL_PIXEL_UNPACK_BUFFER_EXT, GL_WRITE_ONLY);
     GLContext::checkError("PBO::moveBmpToTexture MapBuffer()");
     Bitmap PBOBitmap(getSize(), getPF(), (unsigned char *)pPBOPixels, getStride(), false);
@@ -112,6 +110,7 @@ void PBO::moveTextureToPBO(GLTexture& tex, int mipmapLevel)
     glGetTexImage(GL_TEXTURE_2D, mipmapLevel, GLTexture::getGLFormat(getPF()), 
             GLTexture::getGLType(getPF()), 0);
     GLContext::checkError("PBO::moveTextureToPBO: glGetTexImage()");
+    RenderStats::countTexDownload(getMemNeeded());
     if (mipmapLevel == 0) {
         m_ActiveSize = tex.getSize();
         m_BufferStride = tex.getGLSize().x;
@@ -180,6 +179,7 @@ void PBO::moveToTexture(GLTexture& tex)
     glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size.x, size.y,
             GLTexture::getGLFormat(getPF()), GLTexture::getGLType(getPF()), 0);
     GLContext::checkError("PBO::setImage: glTexSubImage2D()");
+    RenderStats::countTexUpload((long long)(size.x)*size.y*getBytesPerPixel(getPF()));
     glproc::BindBuffer(GL_PIXEL_UNPACK_BUFFER_EXT, 0);
     tex.generateMipmaps();
 }
@@ -60,6 +60,7 @@ private:
 
     unsigned m_Usage;
     unsigned m_PBOID;
+    unsigned m_Capacity;
     IntPoint m_ActiveSize;
     int m_BufferStride;
 };
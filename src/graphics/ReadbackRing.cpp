@@ -0,0 +1,253 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "ReadbackRing.h"
+
+#include "Bitmap.h"
+#include "FBO.h"
+#include "GLContext.h"
+#include "GLTexture.h"
+
+#include "../base/Exception.h"
+#include "../base/ObjectCounter.h"
+
+using namespace std;
+using namespace boost;
+
+namespace avg {
+
+// Maximum time to block in getImage(true), in nanoseconds.
+static const GLuint64 MAX_WAIT_TIME = 1000000000;
+
+ReadbackRing::ReadbackRing(const IntPoint& size, PixelFormat pf, unsigned numBuffers)
+    : m_Size(size),
+      m_PF(pf),
+      m_SeqNum(0)
+{
+    ObjectCounter::get()->incRef(&typeid(*this));
+    AVG_ASSERT(numBuffers >= 2);
+    GLContext* pContext = GLContext::getCurrent();
+    m_bUseFences = pContext->areFencesSupported();
+    m_Slots.resize(numBuffers);
+    for (unsigned i=0; i<numBuffers; ++i) {
+        Slot& slot = m_Slots[i];
+        slot.m_PBOID = pContext->getPBOCache().getBuffer();
+        slot.m_Fence = 0;
+        slot.m_State = SLOT_FREE;
+        slot.m_SeqNum = 0;
+        glproc::BindBuffer(GL_PIXEL_PACK_BUFFER_EXT, slot.m_PBOID);
+        glproc::BufferData(GL_PIXEL_PACK_BUFFER_EXT, getStride()*m_Size.y, 0, 
+                GL_STREAM_READ);
+        GLContext::checkError("ReadbackRing: BufferData()");
+    }
+    glproc::BindBuffer(GL_PIXEL_PACK_BUFFER_EXT, 0);
+}
+
+ReadbackRing::~ReadbackRing()
+{
+    GLContext* pContext = GLContext::getCurrent();
+    for (unsigned i=0; i<m_Slots.size(); ++i) {
+        Slot& slot = m_Slots[i];
+        if (slot.m_State == SLOT_MAPPED) {
+            AVG_ASSERT(slot.m_pBmp.unique());
+            unmapSlot(slot);
+        }
+        deleteFence(slot);
+        glproc::BindBuffer(GL_PIXEL_PACK_BUFFER_EXT, slot.m_PBOID);
+        glproc::BufferData(GL_PIXEL_PACK_BUFFER_EXT, 0, 0, GL_STREAM_READ);
+        if (pContext) {
+            pContext->getPBOCache().returnBuffer(slot.m_PBOID);
+        }
+    }
+    glproc::BindBuffer(GL_PIXEL_PACK_BUFFER_EXT, 0);
+    GLContext::checkError("~ReadbackRing");
+    ObjectCounter::get()->decRef(&typeid(*this));
+}
+
+bool ReadbackRing::readFBO(const FBO& fbo, int i)
+{
+    AVG_ASSERT(fbo.getSize() == m_Size);
+    AVG_ASSERT(fbo.getTex(i)->getPF() == m_PF);
+    reclaimSlots();
+    if (findFreeSlot() == -1) {
+        return false;
+    }
+    fbo.activateForReading(i);
+    bool bOk = startReadback();
+    glproc::BindFramebuffer(GL_FRAMEBUFFER, 0);
+    return bOk;
+}
+
+bool ReadbackRing::readWindow(unsigned buffer)
+{
+    reclaimSlots();
+    if (findFreeSlot() == -1) {
+        return false;
+    }
+    glproc::BindFramebuffer(GL_FRAMEBUFFER, 0);
+    glReadBuffer(buffer);
+    GLContext::checkError("ReadbackRing::readWindow: glReadBuffer()");
+    return startReadback();
+}
+
+BitmapPtr ReadbackRing::getImage(bool bWait)
+{
+    reclaimSlots();
+    if (m_PendingSlots.empty()) {
+        return BitmapPtr();
+    }
+    unsigned slotIndex = m_PendingSlots.front();
+    Slot& slot = m_Slots[slotIndex];
+    if (!isSlotReady(slot, bWait)) {
+        return BitmapPtr();
+    }
+    m_PendingSlots.pop_front();
+    deleteFence(slot);
+
+    glproc::BindBuffer(GL_PIXEL_PACK_BUFFER_EXT, slot.m_PBOID);
+    GLContext::checkError("ReadbackRing::getImage BindBuffer()");
+    void * pPBOPixels = glproc::MapBuffer(GL_PIXEL_PACK_BUFFER_EXT, GL_READ_ONLY);
+    GLContext::checkError("ReadbackRing::getImage MapBuffer()");
+    BitmapPtr pBmp(new Bitmap(m_Size, m_PF, (unsigned char *)pPBOPixels, getStride(),
+            false, "readback"));
+    slot.m_State = SLOT_MAPPED;
+    if (findFreeSlot() == -1) {
+        // Handing out this buffer would leave no room for further readbacks, so the
+        // data is copied and the buffer is released immediately.
+        BitmapPtr pCopyBmp(new Bitmap(*pBmp));
+        unmapSlot(slot);
+        glproc::BindBuffer(GL_PIXEL_PACK_BUFFER_EXT, 0);
+        return pCopyBmp;
+    }
+    slot.m_pBmp = pBmp;
+    glproc::BindBuffer(GL_PIXEL_PACK_BUFFER_EXT, 0);
+    return pBmp;
+}
+
+unsigned ReadbackRing::getNumPending() const
+{
+    return m_PendingSlots.size();
+}
+
+unsigned ReadbackRing::getNumBuffers() const
+{
+    return m_Slots.size();
+}
+
+const IntPoint& ReadbackRing::getSize() const
+{
+    return m_Size;
+}
+
+PixelFormat ReadbackRing::getPF() const
+{
+    return m_PF;
+}
+
+bool ReadbackRing::startReadback()
+{
+    int slotIndex = findFreeSlot();
+    if (slotIndex == -1) {
+        return false;
+    }
+    Slot& slot = m_Slots[slotIndex];
+    glproc::BindBuffer(GL_PIXEL_PACK_BUFFER_EXT, slot.m_PBOID);
+    GLContext::checkError("ReadbackRing::startReadback BindBuffer()");
+    glReadPixels(0, 0, m_Size.x, m_Size.y, GLTexture::getGLFormat(m_PF), 
+            GLTexture::getGLType(m_PF), 0);
+    GLContext::checkError("ReadbackRing::startReadback ReadPixels()");
+    if (m_bUseFences) {
+        slot.m_Fence = glproc::FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        GLContext::checkError("ReadbackRing::startReadback FenceSync()");
+    }
+    glproc::BindBuffer(GL_PIXEL_PACK_BUFFER_EXT, 0);
+    slot.m_State = SLOT_PENDING;
+    slot.m_SeqNum = m_SeqNum;
+    m_SeqNum++;
+    m_PendingSlots.push_back(slotIndex);
+    return true;
+}
+
+bool ReadbackRing::isSlotReady(Slot& slot, bool bWait) const
+{
+    if (bWait) {
+        if (m_bUseFences) {
+            glproc::ClientWaitSync(slot.m_Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 
+                    MAX_WAIT_TIME);
+        }
+        // Without fences, MapBuffer blocks until the data is available.
+        return true;
+    }
+    if (m_bUseFences) {
+        GLenum rc = glproc::ClientWaitSync(slot.m_Fence, 0, 0);
+        return (rc == GL_ALREADY_SIGNALED || rc == GL_CONDITION_SATISFIED);
+    } else {
+        // No way to query the GPU. Assume that readbacks started two frames ago are
+        // finished.
+        return (m_SeqNum - slot.m_SeqNum >= (long long)(m_Slots.size()-1));
+    }
+}
+
+void ReadbackRing::reclaimSlots()
+{
+    for (unsigned i=0; i<m_Slots.size(); ++i) {
+        Slot& slot = m_Slots[i];
+        if (slot.m_State == SLOT_MAPPED && slot.m_pBmp.unique()) {
+            unmapSlot(slot);
+        }
+    }
+}
+
+void ReadbackRing::unmapSlot(Slot& slot)
+{
+    AVG_ASSERT(slot.m_State == SLOT_MAPPED);
+    slot.m_pBmp = BitmapPtr();
+    glproc::BindBuffer(GL_PIXEL_PACK_BUFFER_EXT, slot.m_PBOID);
+    glproc::UnmapBuffer(GL_PIXEL_PACK_BUFFER_EXT);
+    GLContext::checkError("ReadbackRing::unmapSlot UnmapBuffer()");
+    glproc::BindBuffer(GL_PIXEL_PACK_BUFFER_EXT, 0);
+    slot.m_State = SLOT_FREE;
+}
+
+void ReadbackRing::deleteFence(Slot& slot)
+{
+    if (slot.m_Fence) {
+        glproc::DeleteSync(slot.m_Fence);
+        slot.m_Fence = 0;
+    }
+}
+
+int ReadbackRing::findFreeSlot() const
+{
+    for (unsigned i=0; i<m_Slots.size(); ++i) {
+        if (m_Slots[i].m_State == SLOT_FREE) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+unsigned ReadbackRing::getStride() const
+{
+    return m_Size.x*getBytesPerPixel(m_PF);
+}
+
+}
@@ -0,0 +1,97 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _ReadbackRing_H_
+#define _ReadbackRing_H_
+
+#include "../api.h"
+
+#include "OGLHelper.h"
+#include "PixelFormat.h"
+
+#include "../base/GLMHelper.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+#include <deque>
+
+namespace avg {
+
+class Bitmap;
+typedef boost::shared_ptr<Bitmap> BitmapPtr;
+class FBO;
+
+// Ring of pixel pack buffers used for asynchronous framebuffer readback. Each 
+// readback is started with glReadPixels into a free buffer and guarded by a fence, so
+// the data can be fetched a few frames later without stalling the GL pipeline.
+//
+// Finished images are returned as bitmaps that point directly into the mapped buffer.
+// The buffer is unmapped and reused as soon as the last reference to the bitmap is
+// gone, so bitmaps can be passed to other threads without copying. All of them must 
+// be released before the ring is deleted.
+class AVG_API ReadbackRing {
+public:
+    ReadbackRing(const IntPoint& size, PixelFormat pf, unsigned numBuffers=3);
+    virtual ~ReadbackRing();
+
+    bool readFBO(const FBO& fbo, int i=0);
+    bool readWindow(unsigned buffer);
+    BitmapPtr getImage(bool bWait);
+
+    unsigned getNumPending() const;
+    unsigned getNumBuffers() const;
+    const IntPoint& getSize() const;
+    PixelFormat getPF() const;
+
+private:
+    enum SlotState {SLOT_FREE, SLOT_PENDING, SLOT_MAPPED};
+    struct Slot {
+        unsigned m_PBOID;
+        GLsync m_Fence;
+        SlotState m_State;
+        long long m_SeqNum;
+        BitmapPtr m_pBmp;
+    };
+
+    bool startReadback();
+    bool isSlotReady(Slot& slot, bool bWait) const;
+    void reclaimSlots();
+    void unmapSlot(Slot& slot);
+    void deleteFence(Slot& slot);
+    int findFreeSlot() const;
+    unsigned getStride() const;
+
+    IntPoint m_Size;
+    PixelFormat m_PF;
+    bool m_bUseFences;
+    std::vector<Slot> m_Slots;
+    std::deque<unsigned> m_PendingSlots;
+    long long m_SeqNum;
+};
+
+typedef boost::shared_ptr<ReadbackRing> ReadbackRingPtr;
+
+}
+
+#endif
+
@@ -0,0 +1,75 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "RenderStats.h"
+
+#include <atomic>
+
+namespace avg {
+
+namespace {
+    std::atomic<int> s_NumDrawCalls(0);
+    std::atomic<int> s_NumTexUploads(0);
+    std::atomic<long long> s_BytesMoved(0);
+    std::atomic<int> s_NumFXRenders(0);
+}
+
+RenderStats::Counters::Counters()
+    : m_NumDrawCalls(0),
+      m_NumTexUploads(0),
+      m_BytesMoved(0),
+      m_NumFXRenders(0)
+{
+}
+
+void RenderStats::countDrawCall()
+{
+    s_NumDrawCalls.fetch_add(1, std::memory_order_relaxed);
+}
+
+void RenderStats::countTexUpload(long long numBytes)
+{
+    s_NumTexUploads.fetch_add(1, std::memory_order_relaxed);
+    s_BytesMoved.fetch_add(numBytes, std::memory_order_relaxed);
+}
+
+void RenderStats::countTexDownload(long long numBytes)
+{
+    s_BytesMoved.fetch_add(numBytes, std::memory_order_relaxed);
+}
+
+void RenderStats::countFXRender()
+{
+    s_NumFXRenders.fetch_add(1, std::memory_order_relaxed);
+}
+
+RenderStats::Counters RenderStats::getAndReset()
+{
+    Counters counters;
+    counters.m_NumDrawCalls = s_NumDrawCalls.exchange(0);
+    counters.m_NumTexUploads = s_NumTexUploads.exchange(0);
+    counters.m_BytesMoved = s_BytesMoved.exchange(0);
+    counters.m_NumFXRenders = s_NumFXRenders.exchange(0);
+    return counters;
+}
+
+}
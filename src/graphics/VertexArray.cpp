@@ -24,6 +24,7 @@
 #include "GLContext.h"
 #include "GLContextManager.h"
 #include "SubVertexArray.h"
+#include "RenderStats.h"
 
 #include "../base/Exception.h"
 #include "../base/WideLine.h"
@@ -117,6 +118,7 @@ void VertexArray::draw(GLContext* pContext)
 #else
     glDrawElements(GL_TRIANGLES, getNumIndexes(), GL_UNSIGNED_INT, 0);
 #endif
+    RenderStats::countDrawCall();
     GLContext::checkError("VertexArray::draw()");
 }
 
@@ -133,6 +135,7 @@ void VertexArray::draw(unsigned startIndex, unsigned numIndexes, unsigned startV
 //    XXX: Theoretically faster, but broken on Linux/Intel N10 graphics, Ubuntu 12/04
 //    glproc::DrawRangeElements(GL_TRIANGLES, startVertex, startVertex+numVertexes, 
 //            numIndexes, GL_UNSIGNED_SHORT, (void *)(startIndex*sizeof(unsigned short)));
+    RenderStats::countDrawCall();
     GLContext::checkError("VertexArray::draw()");
 }
 
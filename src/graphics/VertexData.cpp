@@ -62,13 +62,14 @@ VertexData::VertexData(int reserveVerts, int reserveIndexes)
     
     m_pVertexData = new Vertex[m_ReserveVerts];
     m_pIndexData = new GL_INDEX_TYPE[m_ReserveIndexes];
-
+    ObjectCounter::get()->addBytes(ObjectCounter::MEM_VERTEX_DATA, getMemUsed());
 }
 
 VertexData::~VertexData()
 {
     delete[] m_pVertexData;
     delete[] m_pIndexData;
+    ObjectCounter::get()->subBytes(ObjectCounter::MEM_VERTEX_DATA, getMemUsed());
     ObjectCounter::get()->decRef(&typeid(*this));
 }
 
@@ -207,6 +208,7 @@ void VertexData::dump(unsigned startVertex, int numVerts, unsigned startIndex,
 void VertexData::grow()
 {
     bool bChanged = false;
+    long long oldMemUsed = getMemUsed();
     if (m_NumVerts >= m_ReserveVerts-1) {
         bChanged = true;
         int oldReserveVerts = m_ReserveVerts;
@@ -239,9 +241,17 @@ void VertexData::grow()
     }
     if (bChanged) {
         m_bDataChanged = true;
+        ObjectCounter::get()->addBytes(ObjectCounter::MEM_VERTEX_DATA,
+                getMemUsed()-oldMemUsed);
     }
 }
 
+long long VertexData::getMemUsed() const
+{
+    return (long long)(m_ReserveVerts)*sizeof(Vertex) + 
+            (long long)(m_ReserveIndexes)*sizeof(GL_INDEX_TYPE);
+}
+
 const Vertex * VertexData::getVertexPointer() const
 {
     return m_pVertexData;
@@ -85,6 +85,7 @@ protected:
 
 private:
     void grow();
+    long long getMemUsed() const;
 
     int m_NumVerts;
     int m_NumIndexes;
@@ -0,0 +1,54 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2011 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+// Separable gaussian blur pass with precomputed weights. Used for both directions:
+// u_Direction selects the axis, u_StepScale is the tap distance in output pixels.
+// Taps are symmetric around the center tap, and the offsets are usually positioned 
+// between two texels so that one linear-filtered fetch returns the weighted 
+// sum of both.
+
+#define MAX_BLUR_TAPS 32
+
+uniform sampler2D u_Texture;
+uniform int u_NumTaps;
+uniform float u_Weights[MAX_BLUR_TAPS];
+uniform float u_Offsets[MAX_BLUR_TAPS];
+uniform vec2 u_Direction;
+uniform float u_StepScale;
+
+#ifndef FRAGMENT_ONLY
+varying vec2 v_TexCoord;
+varying vec4 v_Color;
+#endif
+
+void main(void)
+{
+    vec2 step = vec2(dFdx(v_TexCoord.x), dFdy(v_TexCoord.y))*u_Direction*u_StepScale;
+    vec4 sum = texture2D(u_Texture, v_TexCoord)*u_Weights[0];
+    for (int i=1; i<u_NumTaps; ++i) {
+        vec2 offset = step*u_Offsets[i];
+        sum += (texture2D(u_Texture, v_TexCoord+offset) + 
+                texture2D(u_Texture, v_TexCoord-offset))*u_Weights[i];
+    }
+    gl_FragColor = sum;
+}
+
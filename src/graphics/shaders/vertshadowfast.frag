@@ -0,0 +1,57 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2011 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+// Vertical pass of the tap-optimized shadow. See blurfast.frag.
+
+#define MAX_BLUR_TAPS 32
+
+uniform sampler2D u_HBlurTex;
+uniform sampler2D u_OrigTex;
+uniform int u_NumTaps;
+uniform float u_Weights[MAX_BLUR_TAPS];
+uniform float u_Offsets[MAX_BLUR_TAPS];
+uniform float u_StepScale;
+uniform vec4 u_Color;
+uniform vec2 u_DestPos;
+uniform vec2 u_DestSize;
+
+#ifndef FRAGMENT_ONLY
+varying vec2 v_TexCoord;
+varying vec4 v_Color;
+#endif
+
+void main(void)
+{
+    vec2 step = vec2(0., dFdy(v_TexCoord.y)*u_StepScale);
+    float sum = texture2D(u_HBlurTex, v_TexCoord).a*u_Weights[0];
+    for (int i=1; i<u_NumTaps; ++i) {
+        vec2 offset = step*u_Offsets[i];
+        sum += (texture2D(u_HBlurTex, v_TexCoord+offset).a + 
+                texture2D(u_HBlurTex, v_TexCoord-offset).a)*u_Weights[i];
+    }
+    sum = min(1., sum);
+    vec2 origCoord = u_DestPos + 
+            vec2(v_TexCoord.s*u_DestSize.x, v_TexCoord.t*u_DestSize.y);
+    vec4 origCol = texture2D(u_OrigTex, origCoord);
+    gl_FragColor = origCol+(1.-origCol.a)*u_Color*sum;
+}
+
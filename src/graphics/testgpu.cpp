@@ -37,6 +37,10 @@
 #include "PBO.h"
 #include "ImageCache.h"
 #include "CachedImage.h"
+#include "FBO.h"
+#ifndef AVG_ENABLE_EGL
+    #include "ReadbackRing.h"
+#endif
 
 #include "../base/TestSuite.h"
 #include "../base/Exception.h"
@@ -505,6 +509,140 @@ private:
 };
 
 
+class TexUploadBudgetTest: public GraphicsTest {
+public:
+    TexUploadBudgetTest()
+        : GraphicsTest("TexUploadBudgetTest", 2)
+    {
+    }
+
+    void runTests()
+    {
+        GLContextManager* pCM = GLContextManager::get();
+        BitmapPtr pOrigBmp = loadTestBmp("rgb24-64x64");
+        pCM->setTexUploadBudget(1);
+        pCM->startFrame();
+        MCTexturePtr pTex1 = pCM->createTextureFromBmp(pOrigBmp);
+        MCTexturePtr pTex2 = pCM->createTextureFromBmp(pOrigBmp);
+        MCTexturePtr pTex3 = pCM->createTextureFromBmp(pOrigBmp);
+        cerr << "    Testing forced upload" << endl;
+        pCM->forceTexUpload(pTex3);
+        pCM->uploadData();
+        TEST(pTex3->isReady());
+        TEST(!pTex1->isReady());
+        TEST(!pTex2->isReady());
+        TEST(pCM->getNumDeferredTexUploads() == 2);
+        BitmapPtr pDestBmp = pTex3->getTex(GLContext::getCurrent())->moveTextureToBmp();
+        testEqual(*pDestBmp, *pOrigBmp, "forced-upload", 0.01, 0.1);
+
+        cerr << "    Testing deferred uploads" << endl;
+        pCM->startFrame();
+        pCM->uploadData();
+        TEST(pTex1->isReady());
+        TEST(!pTex2->isReady());
+        TEST(pCM->getNumDeferredTexUploads() == 1);
+        pCM->setTexUploadBudget(0);
+        pCM->uploadData();
+        TEST(pTex2->isReady());
+        TEST(pCM->getNumDeferredTexUploads() == 0);
+    }
+};
+
+
+#ifndef AVG_ENABLE_EGL
+class ReadbackRingTest: public GraphicsTest {
+public:
+    ReadbackRingTest()
+        : GraphicsTest("ReadbackRingTest", 2)
+    {
+    }
+
+    void runTests()
+    {
+        GLContext* pContext = GLContext::getCurrent();
+        IntPoint size(16, 16);
+        vector<GLTexturePtr> pTextures;
+        pTextures.push_back(GLTexturePtr(new GLTexture(pContext, size, B8G8R8A8)));
+        FBO fbo(FBOInfo(size, B8G8R8A8, 1, 1, false, false, false), pTextures);
+
+        cerr << "    Testing wraparound" << endl;
+        ReadbackRing ring(size, B8G8R8A8, 3);
+        TEST(!ring.getImage(false));
+        for (int i = 0; i < 3; ++i) {
+            clearFBO(fbo, i*40);
+            TEST(ring.readFBO(fbo));
+        }
+        TEST(ring.getNumPending() == 3);
+        // All buffers are in use.
+        TEST(!ring.readFBO(fbo));
+        for (int i = 0; i < 3; ++i) {
+            checkImage(ring.getImage(true), i*40);
+        }
+        TEST(ring.getNumPending() == 0);
+        // Keep one image mapped while the ring goes around several times.
+        clearFBO(fbo, 200);
+        TEST(ring.readFBO(fbo));
+        BitmapPtr pHeldBmp = ring.getImage(true);
+        checkImage(pHeldBmp, 200);
+        for (int i = 0; i < 7; ++i) {
+            clearFBO(fbo, i*20);
+            TEST(ring.readFBO(fbo));
+            checkImage(ring.getImage(true), i*20);
+        }
+        checkImage(pHeldBmp, 200);
+        pHeldBmp = BitmapPtr();
+
+        cerr << "    Testing readiness" << endl;
+        clearFBO(fbo, 100);
+        TEST(ring.readFBO(fbo));
+        if (pContext->areFencesSupported()) {
+            // Nothing may be returned before the fence has signalled. After glFinish(),
+            // it has.
+            BitmapPtr pBmp = ring.getImage(false);
+            if (!pBmp) {
+                TEST(ring.getNumPending() == 1);
+                glFinish();
+                pBmp = ring.getImage(false);
+            }
+            checkImage(pBmp, 100);
+        } else {
+            // Without fences, a readback counts as finished once numBuffers-1 further 
+            // readbacks have been started.
+            TEST(!ring.getImage(false));
+            clearFBO(fbo, 120);
+            TEST(ring.readFBO(fbo));
+            TEST(!ring.getImage(false));
+            clearFBO(fbo, 140);
+            TEST(ring.readFBO(fbo));
+            checkImage(ring.getImage(false), 100);
+            checkImage(ring.getImage(true), 120);
+            checkImage(ring.getImage(true), 140);
+        }
+        TEST(ring.getNumPending() == 0);
+    }
+
+private:
+    void clearFBO(const FBO& fbo, int value)
+    {
+        fbo.activate();
+        glClearColor(value/255.f, value/255.f, value/255.f, 1.f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        GLContext::checkError("ReadbackRingTest::clearFBO");
+    }
+
+    void checkImage(BitmapPtr pBmp, int value)
+    {
+        TEST(pBmp.get() != NULL);
+        if (pBmp) {
+            TEST(pBmp->getSize() == IntPoint(16, 16));
+            const unsigned char* pPixel = pBmp->getPixels();
+            TEST(abs(int(pPixel[0])-value) <= 1);
+        }
+    }
+};
+#endif
+
+
 class GPUTestSuite: public TestSuite {
 public:
     GPUTestSuite(const string& sVariant) 
@@ -512,6 +650,12 @@ public:
     {
         addTest(TestPtr(new TextureMoverTest));
         addTest(TestPtr(new ImageCacheTest));
+        addTest(TestPtr(new TexUploadBudgetTest));
+#ifndef AVG_ENABLE_EGL
+        if (GLContext::getCurrent()->arePBOsSupported()) {
+            addTest(TestPtr(new ReadbackRingTest));
+        }
+#endif
         addTest(TestPtr(new BrightnessFilterTest));
         addTest(TestPtr(new HueSatFilterTest));
         addTest(TestPtr(new InvertFilterTest));
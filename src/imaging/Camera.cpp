@@ -20,10 +20,12 @@
 //
 
 #include "Camera.h"
+#include "CameraConversion.h"
 
 #include "../base/Logger.h"
 #include "../base/Exception.h"
 #include "../base/ScopeTimer.h"
+#include "../base/TimeSource.h"
 #include "../graphics/Filterfliprgb.h"
 
 #if defined(AVG_ENABLE_1394_2)
@@ -39,9 +41,11 @@
 #include "../imaging/DSCamera.h"
 #endif
 #include "../imaging/FakeCamera.h"
+#include "../imaging/ReplayCamera.h"
 
 #include <cstdlib>
 #include <string.h>
+#include <algorithm>
 
 #ifdef WIN32
 #define strtoll(p, e, b) _strtoi64(p, e, b)
@@ -81,7 +85,10 @@ static ProfilingZoneID CameraConvertProfilingZone("Camera format conversion", tr
 BitmapPtr Camera::convertCamFrameToDestPF(BitmapPtr pCamBmp)
 {
     ScopeTimer Timer(CameraConvertProfilingZone);
-    BitmapPtr pDestBmp = BitmapPtr(new Bitmap(pCamBmp->getSize(), m_DestPF));
+    BitmapPtr pDestBmp = allocDestBmp(pCamBmp->getSize());
+    if (convertCameraFrame(*pCamBmp, *pDestBmp)) {
+        return pDestBmp;
+    }
     pDestBmp->copyPixels(*pCamBmp);
     if (m_CamPF == R8G8B8 && m_DestPF == B8G8R8X8) {
         pDestBmp->setPixelFormat(R8G8B8X8);
@@ -95,7 +102,28 @@ BitmapPtr Camera::convertCamFrameToDestPF(BitmapPtr pCamBmp)
     return pDestBmp;
 }
 
-IntPoint Camera::getImgSize()
+// Enough for the frames in the capture ring plus the ones being displayed.
+static const unsigned MAX_POOLED_BITMAPS = 6;
+
+BitmapPtr Camera::allocDestBmp(const IntPoint& size)
+{
+    // Bitmaps are handed to other threads, but the pool itself is only used by the
+    // thread that fetches images. A bitmap that only the pool references can't be
+    // referenced by anyone else until the pool hands it out again.
+    for (unsigned i = 0; i < m_DestBmpPool.size(); ++i) {
+        if (m_DestBmpPool[i].unique() && m_DestBmpPool[i]->getSize() == size) {
+            m_DestBmpPool[i]->setPixelFormat(m_DestPF);
+            return m_DestBmpPool[i];
+        }
+    }
+    BitmapPtr pBmp(new Bitmap(size, m_DestPF));
+    if (m_DestBmpPool.size() < MAX_POOLED_BITMAPS) {
+        m_DestBmpPool.push_back(pBmp);
+    }
+    return pBmp;
+}
+
+IntPoint Camera::getImgSize() const
 {
     return m_Size;
 }
@@ -105,6 +133,17 @@ float Camera::getFrameRate() const
     return m_FrameRate;
 }
 
+bool Camera::waitForImage(int timeout)
+{
+    msleep(std::min(timeout, 2));
+    return true;
+}
+
+int Camera::getNumFramesMissed() const
+{
+    return 0;
+}
+
 PixelFormat Camera::fwBayerStringToPF(unsigned long reg)
 {
     string sBayerFormat((char*)&reg, 4);
@@ -231,6 +270,9 @@ CameraPtr createCamera(const string& sDriver, const string& sDevice, int unit,
             AVG_LOG_WARNING("DirectShow camera specified, but "
                     "DirectShow is only available under windows.");
 #endif
+        } else if (sDriver == "replay") {
+            pCamera = CameraPtr(new ReplayCamera(sDevice, captureSize, camPF, destPF,
+                    frameRate));
         } else {
             throw Exception(AVG_ERR_INVALID_ARGS,
                     "Unable to set up camera. Camera source '"+sDriver+"' unknown.");
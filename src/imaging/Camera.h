@@ -31,6 +31,7 @@
 #include <string>
 #include <list>
 #include <map>
+#include <vector>
 
 namespace avg {
 
@@ -73,9 +74,16 @@ public:
     PixelFormat getDestPF() const;
     BitmapPtr convertCamFrameToDestPF(BitmapPtr pCamBmp);
 
-    IntPoint getImgSize();
+    IntPoint getImgSize() const;
     float getFrameRate() const;
     virtual BitmapPtr getImage(bool bWait) = 0;
+    // Blocks until getImage(false) can return an image or timeout milliseconds have 
+    // passed. Returns false on timeout. Drivers that can't wait for an image without 
+    // fetching it sleep briefly and return true.
+    virtual bool waitForImage(int timeout);
+    // Number of frames the camera produced that were overwritten before getImage() 
+    // fetched them. Only drivers that can detect this report it.
+    virtual int getNumFramesMissed() const;
 
     virtual const std::string& getDevice() const = 0; 
     virtual const std::string& getDriverName() const = 0; 
@@ -94,11 +102,16 @@ protected:
 
 private:
     Camera();
+    BitmapPtr allocDestBmp(const IntPoint& size);
+
     PixelFormat m_CamPF;
     PixelFormat m_DestPF;
 
     IntPoint m_Size;
     float m_FrameRate;
+
+    // Destination bitmaps are recycled once nobody else holds a reference to them.
+    std::vector<BitmapPtr> m_DestBmpPool;
 };
 
 
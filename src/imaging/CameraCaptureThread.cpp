@@ -0,0 +1,69 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "CameraCaptureThread.h"
+
+#include "../base/ProfilingZoneID.h"
+#include "../base/ScopeTimer.h"
+#include "../base/TimeSource.h"
+#include "../base/ThreadHelper.h"
+
+using namespace std;
+
+namespace avg {
+
+CameraCaptureThread::CameraCaptureThread(CQueue& cmdQ, CameraPtr pCamera,
+        MutexPtr pCameraMutex, CameraFrameRingPtr pFrameRing)
+    : WorkerThread<CameraCaptureThread>("CameraCapture", cmdQ),
+      m_pCamera(pCamera),
+      m_pCameraMutex(pCameraMutex),
+      m_pFrameRing(pFrameRing)
+{
+}
+
+CameraCaptureThread::~CameraCaptureThread()
+{
+}
+
+static ProfilingZoneID CaptureProfilingZone("Camera capture", true);
+
+// Upper bound for the time a stop command waits if the camera stops delivering frames.
+static const int CAPTURE_TIMEOUT = 20;
+
+bool CameraCaptureThread::work()
+{
+    // The wait doesn't hold the mutex, so parameter changes don't have to wait for
+    // the next frame.
+    if (m_pCamera->waitForImage(CAPTURE_TIMEOUT)) {
+        BitmapPtr pBmp;
+        {
+            ScopeTimer timer(CaptureProfilingZone);
+            lock_guard lock(*m_pCameraMutex);
+            pBmp = m_pCamera->getImage(false);
+        }
+        if (pBmp) {
+            m_pFrameRing->push(pBmp, TimeSource::get()->getCurrentMicrosecs());
+        }
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,59 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#ifndef _CameraCaptureThread_H_
+#define _CameraCaptureThread_H_
+
+#include "../api.h"
+#include "Camera.h"
+#include "CameraFrameRing.h"
+
+#include "../base/WorkerThread.h"
+#include "../base/Command.h"
+
+#include <boost/thread.hpp>
+#include <boost/shared_ptr.hpp>
+
+namespace avg {
+
+typedef boost::shared_ptr<boost::mutex> MutexPtr;
+
+// Fetches and converts camera images outside of the render loop and puts them into
+// a CameraFrameRing, timestamped with the time they were captured. pCameraMutex is
+// held while an image is fetched, so other threads that lock it can change camera
+// parameters without racing the capture.
+class AVG_API CameraCaptureThread: public WorkerThread<CameraCaptureThread> {
+    public:
+        CameraCaptureThread(CQueue& cmdQ, CameraPtr pCamera, MutexPtr pCameraMutex,
+                CameraFrameRingPtr pFrameRing);
+        virtual ~CameraCaptureThread();
+
+        bool work();
+
+    private:
+        CameraPtr m_pCamera;
+        MutexPtr m_pCameraMutex;
+        CameraFrameRingPtr m_pFrameRing;
+};
+
+}
+
+#endif
@@ -0,0 +1,302 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "CameraConversion.h"
+
+#include "../base/Exception.h"
+#include "../graphics/Pixel32.h"
+
+#include <cstring>
+
+using namespace std;
+
+namespace avg {
+
+namespace {
+
+// All kernels write 32 bpp pixels with the alpha byte last. Kernels for YCbCr and 
+// Bayer input write B8G8R8X8 byte order, or R8G8B8X8 order if bSwapRB is set. The 
+// 24 bpp kernel keeps the byte order of its input unless bSwapRB is set.
+typedef void (*ConversionFunc)(const Bitmap& srcBmp, Bitmap& destBmp, bool bSwapRB);
+
+inline void setPixel(unsigned char* pDest, int r, int g, int b, bool bSwapRB)
+{
+    if (bSwapRB) {
+        pDest[0] = (unsigned char)r;
+        pDest[2] = (unsigned char)b;
+    } else {
+        pDest[0] = (unsigned char)b;
+        pDest[2] = (unsigned char)r;
+    }
+    pDest[1] = (unsigned char)g;
+    pDest[3] = 255;
+}
+
+inline int clampColor(int c)
+{
+    if (c < 0) {
+        return 0;
+    } else if (c > 255) {
+        return 255;
+    } else {
+        return c;
+    }
+}
+
+// Same coefficients as YUVtoBGR32Pixel().
+inline void setYUVPixel(unsigned char* pDest, int y, int u, int v, bool bSwapRB)
+{
+    int u1 = u - 128;
+    int v1 = v - 128;
+    int tempy = 298*(y-16);
+    int b = clampColor((tempy + 516 * u1           ) >> 8);
+    int g = clampColor((tempy - 100 * u1 - 208 * v1) >> 8);
+    int r = clampColor((tempy            + 409 * v1) >> 8);
+    setPixel(pDest, r, g, b, bSwapRB);
+}
+
+void swapRBLine(unsigned char* pLine, int width)
+{
+    for (int x = 0; x < width; ++x) {
+        unsigned char tmp = pLine[0];
+        pLine[0] = pLine[2];
+        pLine[2] = tmp;
+        pLine += 4;
+    }
+}
+
+// 24 bpp -> 32 bpp. Without swap, the bytes keep their order and only alpha is added.
+void convertRGB24(const Bitmap& srcBmp, Bitmap& destBmp, bool bSwapRB)
+{
+    IntPoint size = srcBmp.getSize();
+    const unsigned char* pSrcLine = srcBmp.getPixels();
+    unsigned char* pDestLine = destBmp.getPixels();
+    for (int y = 0; y < size.y; ++y) {
+        const unsigned char* pSrc = pSrcLine;
+        unsigned char* pDest = pDestLine;
+        if (bSwapRB) {
+            for (int x = 0; x < size.x; ++x) {
+                setPixel(pDest, pSrc[0], pSrc[1], pSrc[2], false);
+                pSrc += 3;
+                pDest += 4;
+            }
+        } else {
+            for (int x = 0; x < size.x; ++x) {
+                setPixel(pDest, pSrc[2], pSrc[1], pSrc[0], false);
+                pSrc += 3;
+                pDest += 4;
+            }
+        }
+        pSrcLine += srcBmp.getStride();
+        pDestLine += destBmp.getStride();
+    }
+}
+
+// UYVY (YCbCr422) and YUYV. Chroma is interpolated the same way as in
+// Bitmap::YCbCrtoBGR().
+void convertYUV422(const Bitmap& srcBmp, Bitmap& destBmp, bool bSwapRB)
+{
+    int yOffset;
+    int uOffset;
+    int vOffset;
+    if (srcBmp.getPixelFormat() == YUYV422) {
+        yOffset = 0;
+        uOffset = 1;
+        vOffset = 3;
+    } else {
+        yOffset = 1;
+        uOffset = 0;
+        vOffset = 2;
+    }
+    IntPoint size = srcBmp.getSize();
+    const unsigned char* pSrcLine = srcBmp.getPixels();
+    unsigned char* pDestLine = destBmp.getPixels();
+    for (int y = 0; y < size.y; ++y) {
+        const unsigned char* pSrc = pSrcLine;
+        unsigned char* pDest = pDestLine;
+        int v = pSrc[vOffset];
+        int v0;
+        int u;
+        int u1;
+        for (int x = 0; x < size.x/2-1; x++) {
+            u = pSrc[uOffset];
+            v0 = v;
+            v = pSrc[vOffset];
+            u1 = pSrc[uOffset+4];
+            setYUVPixel(pDest, pSrc[yOffset], u, (v0+v)/2, bSwapRB);
+            setYUVPixel(pDest+4, pSrc[yOffset+2], (u+u1)/2, v, bSwapRB);
+            pSrc += 4;
+            pDest += 8;
+        }
+        u = pSrc[uOffset];
+        v0 = v;
+        v = pSrc[vOffset];
+        setYUVPixel(pDest, pSrc[yOffset], u, v0/2+v/2, bSwapRB);
+        setYUVPixel(pDest+4, pSrc[yOffset+2], u, v, bSwapRB);
+        pSrcLine += srcBmp.getStride();
+        pDestLine += destBmp.getStride();
+    }
+}
+
+// UYYVYY.
+void convertYUV411(const Bitmap& srcBmp, Bitmap& destBmp, bool bSwapRB)
+{
+    IntPoint size = srcBmp.getSize();
+    const unsigned char* pSrcLine = srcBmp.getPixels();
+    unsigned char* pDestLine = destBmp.getPixels();
+    for (int y = 0; y < size.y; ++y) {
+        const unsigned char* pSrc = pSrcLine;
+        unsigned char* pDest = pDestLine;
+        int v = pSrc[3];
+        int v0;
+        int v1;
+        int u;
+        int u1;
+        for (int x = 0; x < size.x/4; x++) {
+            u = pSrc[0];
+            v0 = v;
+            v = pSrc[3];
+            if (x < size.x/4-1) {
+                u1 = pSrc[6];
+                v1 = pSrc[9];
+            } else {
+                u1 = u;
+                v1 = v;
+            }
+            setYUVPixel(pDest, pSrc[1], u, v0/2+v/2, bSwapRB);
+            setYUVPixel(pDest+4, pSrc[2], (u*3)/4+u1/4, v0/4+(v*3)/4, bSwapRB);
+            setYUVPixel(pDest+8, pSrc[4], u/2+u1/2, v, bSwapRB);
+            setYUVPixel(pDest+12, pSrc[5], u/4+(u1*3)/4, (v*3)/4+v1/4, bSwapRB);
+            pSrc += 6;
+            pDest += 16;
+        }
+        pSrcLine += srcBmp.getStride();
+        pDestLine += destBmp.getStride();
+    }
+}
+
+// I420 in one buffer: Y plane, followed by the U and V planes at half resolution.
+void convertYUV420p(const Bitmap& srcBmp, Bitmap& destBmp, bool bSwapRB)
+{
+    IntPoint size = srcBmp.getSize();
+    int yStride = srcBmp.getStride();
+    int uvStride = yStride/2;
+    unsigned char* pYPlane = const_cast<unsigned char*>(srcBmp.getPixels());
+    unsigned char* pUPlane = pYPlane + yStride*size.y;
+    unsigned char* pVPlane = pUPlane + uvStride*(size.y/2);
+    if (!bSwapRB) {
+        // Bitmap::copyYUVPixels() has a SIMD implementation for this case.
+        IntPoint halfSize(size.x/2, size.y/2);
+        Bitmap yBmp(size, I8, pYPlane, yStride, false);
+        Bitmap uBmp(halfSize, I8, pUPlane, uvStride, false);
+        Bitmap vBmp(halfSize, I8, pVPlane, uvStride, false);
+        destBmp.copyYUVPixels(yBmp, uBmp, vBmp, false);
+        return;
+    }
+    unsigned char* pDestLine = destBmp.getPixels();
+    for (int y = 0; y < size.y; ++y) {
+        const unsigned char* pY = pYPlane + y*yStride;
+        const unsigned char* pU = pUPlane + (y/2)*uvStride;
+        const unsigned char* pV = pVPlane + (y/2)*uvStride;
+        unsigned char* pDest = pDestLine;
+        for (int x = 0; x < size.x; ++x) {
+            setYUVPixel(pDest, pY[x], pU[x/2], pV[x/2], true);
+            pDest += 4;
+        }
+        pDestLine += destBmp.getStride();
+    }
+}
+
+// Demosaicing uses the existing bilinear filter, which writes B8G8R8X8 byte order.
+// For R8G8B8X8, red and blue are swapped in a second pass over the destination.
+void convertBayer(const Bitmap& srcBmp, Bitmap& destBmp, bool bSwapRB)
+{
+    destBmp.copyPixels(srcBmp);
+    if (bSwapRB) {
+        IntPoint size = destBmp.getSize();
+        unsigned char* pLine = destBmp.getPixels();
+        for (int y = 0; y < size.y; ++y) {
+            swapRBLine(pLine, size.x);
+            pLine += destBmp.getStride();
+        }
+    }
+}
+
+struct Conversion {
+    PixelFormat m_CamPF;
+    PixelFormat m_DestPF;
+    ConversionFunc m_pFunc;
+    bool m_bSwapRB;
+};
+
+const Conversion s_Conversions[] = {
+    {R8G8B8, B8G8R8X8, convertRGB24, true},
+    {R8G8B8, R8G8B8X8, convertRGB24, false},
+    {B8G8R8, B8G8R8X8, convertRGB24, false},
+    {B8G8R8, R8G8B8X8, convertRGB24, true},
+    {YCbCr422, B8G8R8X8, convertYUV422, false},
+    {YCbCr422, R8G8B8X8, convertYUV422, true},
+    {YUYV422, B8G8R8X8, convertYUV422, false},
+    {YUYV422, R8G8B8X8, convertYUV422, true},
+    {YCbCr411, B8G8R8X8, convertYUV411, false},
+    {YCbCr411, R8G8B8X8, convertYUV411, true},
+    {YCbCr420p, B8G8R8X8, convertYUV420p, false},
+    {YCbCr420p, R8G8B8X8, convertYUV420p, true},
+    {BAYER8_RGGB, B8G8R8X8, convertBayer, false},
+    {BAYER8_RGGB, R8G8B8X8, convertBayer, true},
+    {BAYER8_GBRG, B8G8R8X8, convertBayer, false},
+    {BAYER8_GBRG, R8G8B8X8, convertBayer, true},
+    {BAYER8_GRBG, B8G8R8X8, convertBayer, false},
+    {BAYER8_GRBG, R8G8B8X8, convertBayer, true},
+    {BAYER8_BGGR, B8G8R8X8, convertBayer, false},
+    {BAYER8_BGGR, R8G8B8X8, convertBayer, true},
+};
+
+const Conversion* findConversion(PixelFormat camPF, PixelFormat destPF)
+{
+    for (unsigned i = 0; i < sizeof(s_Conversions)/sizeof(Conversion); ++i) {
+        if (s_Conversions[i].m_CamPF == camPF && s_Conversions[i].m_DestPF == destPF) {
+            return &s_Conversions[i];
+        }
+    }
+    return 0;
+}
+
+}
+
+bool convertCameraFrame(const Bitmap& camBmp, Bitmap& destBmp)
+{
+    const Conversion* pConversion = findConversion(camBmp.getPixelFormat(), 
+            destBmp.getPixelFormat());
+    if (!pConversion) {
+        return false;
+    }
+    AVG_ASSERT(camBmp.getSize() == destBmp.getSize());
+    pConversion->m_pFunc(camBmp, destBmp, pConversion->m_bSwapRB);
+    return true;
+}
+
+bool isCameraConversionSupported(PixelFormat camPF, PixelFormat destPF)
+{
+    return findConversion(camPF, destPF) != 0;
+}
+
+}
@@ -0,0 +1,40 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#ifndef _CameraConversion_H_
+#define _CameraConversion_H_
+
+#include "../api.h"
+#include "../graphics/Bitmap.h"
+
+namespace avg {
+
+// Converts a raw camera frame into destBmp, which must have the size of the frame,
+// without intermediate bitmaps. The kernels are scalar C++, except for YCbCr420p to
+// B8G8R8X8, which uses Bitmap::copyYUVPixels(). Bayer frames are demosaiced by the 
+// bilinear filter, and for R8G8B8X8 red and blue are swapped in a second pass. 
+// Returns false if the pair of pixel formats isn't supported.
+AVG_API bool convertCameraFrame(const Bitmap& camBmp, Bitmap& destBmp);
+AVG_API bool isCameraConversionSupported(PixelFormat camPF, PixelFormat destPF);
+
+}
+
+#endif
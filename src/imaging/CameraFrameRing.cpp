@@ -0,0 +1,93 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "CameraFrameRing.h"
+
+#include "../base/Exception.h"
+#include "../base/ObjectCounter.h"
+#include "../base/ThreadHelper.h"
+
+using namespace std;
+
+namespace avg {
+
+CameraFrameRing::Frame::Frame(BitmapPtr pBmp, long long captureTime)
+    : m_pBmp(pBmp),
+      m_CaptureTime(captureTime)
+{
+}
+
+CameraFrameRing::CameraFrameRing(unsigned maxFrames)
+    : m_MaxFrames(maxFrames),
+      m_NumFramesCaptured(0),
+      m_NumFramesDropped(0)
+{
+    AVG_ASSERT(maxFrames > 0);
+    ObjectCounter::get()->incRef(&typeid(*this));
+}
+
+CameraFrameRing::~CameraFrameRing()
+{
+    ObjectCounter::get()->decRef(&typeid(*this));
+}
+
+void CameraFrameRing::push(BitmapPtr pBmp, long long captureTime)
+{
+    lock_guard lock(m_Mutex);
+    if (m_Frames.size() == m_MaxFrames) {
+        m_Frames.pop_front();
+        m_NumFramesDropped++;
+    }
+    m_Frames.push_back(Frame(pBmp, captureTime));
+    m_NumFramesCaptured++;
+}
+
+bool CameraFrameRing::popNewest(BitmapPtr& pBmp, long long& captureTime)
+{
+    lock_guard lock(m_Mutex);
+    if (m_Frames.empty()) {
+        return false;
+    }
+    m_NumFramesDropped += m_Frames.size()-1;
+    pBmp = m_Frames.back().m_pBmp;
+    captureTime = m_Frames.back().m_CaptureTime;
+    m_Frames.clear();
+    return true;
+}
+
+unsigned CameraFrameRing::getMaxFrames() const
+{
+    return m_MaxFrames;
+}
+
+int CameraFrameRing::getNumFramesCaptured() const
+{
+    lock_guard lock(m_Mutex);
+    return m_NumFramesCaptured;
+}
+
+int CameraFrameRing::getNumFramesDropped() const
+{
+    lock_guard lock(m_Mutex);
+    return m_NumFramesDropped;
+}
+
+}
@@ -0,0 +1,72 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#ifndef _CameraFrameRing_H_
+#define _CameraFrameRing_H_
+
+#include "../api.h"
+#include "../graphics/Bitmap.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <deque>
+
+namespace avg {
+
+// Hands captured frames from a camera capture thread to the render thread. The ring
+// holds at most a few frames. When it is full, the oldest frame is dropped, and the 
+// reader always gets the newest frame, so stale frames never reach the screen.
+class AVG_API CameraFrameRing {
+public:
+    CameraFrameRing(unsigned maxFrames=3);
+    virtual ~CameraFrameRing();
+
+    // captureTime is in microseconds (TimeSource::getCurrentMicrosecs()).
+    void push(BitmapPtr pBmp, long long captureTime);
+    // Returns the newest frame and discards all older ones. Returns false if no frame 
+    // has arrived since the last call.
+    bool popNewest(BitmapPtr& pBmp, long long& captureTime);
+
+    unsigned getMaxFrames() const;
+    int getNumFramesCaptured() const;
+    int getNumFramesDropped() const;
+
+private:
+    struct Frame {
+        Frame(BitmapPtr pBmp, long long captureTime);
+
+        BitmapPtr m_pBmp;
+        long long m_CaptureTime;
+    };
+
+    unsigned m_MaxFrames;
+    std::deque<Frame> m_Frames;
+    int m_NumFramesCaptured;
+    int m_NumFramesDropped;
+    mutable boost::mutex m_Mutex;
+};
+
+typedef boost::shared_ptr<CameraFrameRing> CameraFrameRingPtr;
+
+}
+
+#endif
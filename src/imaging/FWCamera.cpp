@@ -32,6 +32,9 @@
 #include <string.h>
 #include <sstream>
 #include <iomanip>
+#ifdef AVG_ENABLE_1394_2
+#include <sys/select.h>
+#endif
 
 namespace avg {
 
@@ -252,6 +255,23 @@ BitmapPtr FWCamera::getImage(bool bWait)
 }
     
 
+bool FWCamera::waitForImage(int timeout)
+{
+#ifdef AVG_ENABLE_1394_2
+    // The capture file descriptor becomes readable when a frame is ready to dequeue.
+    int fd = dc1394_capture_get_fileno(m_pCamera);
+    fd_set fds;
+    FD_ZERO(&fds);
+    FD_SET(fd, &fds);
+    struct timeval tv;
+    tv.tv_sec = timeout/1000;
+    tv.tv_usec = (timeout%1000)*1000;
+    return select(fd+1, &fds, NULL, NULL, &tv) > 0;
+#else
+    return Camera::waitForImage(timeout);
+#endif
+}
+
 const string& FWCamera::getDevice() const
 {
     static string deviceInfo;
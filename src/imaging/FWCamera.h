@@ -52,6 +52,7 @@ public:
     virtual void startCapture();
 
     virtual BitmapPtr getImage(bool bWait);
+    virtual bool waitForImage(int timeout);
 
     virtual const std::string& getDevice() const; 
     virtual const std::string& getDriverName() const; 
@@ -0,0 +1,519 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "ReplayCamera.h"
+
+#include "../base/Exception.h"
+#include "../base/Logger.h"
+#include "../base/FileHelper.h"
+#include "../base/TimeSource.h"
+#include "../base/StringHelper.h"
+#include "../base/ThreadHelper.h"
+
+using namespace std;
+
+namespace avg {
+
+namespace {
+
+// Decoded video frames are kept in memory in camPF, so the length of videos is capped.
+const int MAX_VIDEO_FRAMES = 300;
+
+// Inverse of the YCbCr conversion in CameraConversion.cpp.
+inline int rgbToY(const int* pRGB)
+{
+    return ((66*pRGB[0] + 129*pRGB[1] + 25*pRGB[2] + 128) >> 8) + 16;
+}
+
+inline int rgbToU(const int* pRGB)
+{
+    return ((-38*pRGB[0] - 74*pRGB[1] + 112*pRGB[2] + 128) >> 8) + 128;
+}
+
+inline int rgbToV(const int* pRGB)
+{
+    return ((112*pRGB[0] - 94*pRGB[1] - 18*pRGB[2] + 128) >> 8) + 128;
+}
+
+// Reads r, g and b of a pixel in a 32 bpp bitmap.
+inline void getRGB(const Bitmap& bmp, bool bRedFirst, int x, int y, int* pRGB)
+{
+    const unsigned char* pPixel = bmp.getPixels()+y*bmp.getStride()+x*4;
+    if (bRedFirst) {
+        pRGB[0] = pPixel[0];
+        pRGB[2] = pPixel[2];
+    } else {
+        pRGB[0] = pPixel[2];
+        pRGB[2] = pPixel[0];
+    }
+    pRGB[1] = pPixel[1];
+}
+
+// Returns the color channel (0=r, 1=g, 2=b) sampled at each position of a 2x2 block.
+void getBayerChannels(PixelFormat pf, int* pChannels)
+{
+    static const int rggb[] = {0, 1, 1, 2};
+    static const int gbrg[] = {1, 2, 0, 1};
+    static const int grbg[] = {1, 0, 2, 1};
+    static const int bggr[] = {2, 1, 1, 0};
+    const int* pPattern;
+    switch (pf) {
+        case BAYER8_RGGB:
+            pPattern = rggb;
+            break;
+        case BAYER8_GBRG:
+            pPattern = gbrg;
+            break;
+        case BAYER8_GRBG:
+            pPattern = grbg;
+            break;
+        case BAYER8_BGGR:
+            pPattern = bggr;
+            break;
+        default:
+            AVG_ASSERT(false);
+            return;
+    }
+    for (int i = 0; i < 4; ++i) {
+        pChannels[i] = pPattern[i];
+    }
+}
+
+// Converts a 32 bpp video frame to the layout a camera would deliver in camPF. Chroma
+// is averaged over the pixels that share it.
+void encodeFrame(const Bitmap& srcBmp, PixelFormat camPF, const IntPoint& size, 
+        int lineLen, unsigned char* pDest)
+{
+    PixelFormat srcPF = srcBmp.getPixelFormat();
+    bool bRedFirst = (srcPF == R8G8B8X8 || srcPF == R8G8B8A8);
+    int rgb[4][3];
+    switch (camPF) {
+        case I8:
+            for (int y = 0; y < size.y; ++y) {
+                for (int x = 0; x < size.x; ++x) {
+                    getRGB(srcBmp, bRedFirst, x, y, rgb[0]);
+                    pDest[y*lineLen+x] = 
+                            (unsigned char)((54*rgb[0][0] + 183*rgb[0][1] + 19*rgb[0][2]) 
+                            >> 8);
+                }
+            }
+            break;
+        case R8G8B8:
+        case B8G8R8: {
+                int redOffset = (camPF == R8G8B8) ? 0 : 2;
+                for (int y = 0; y < size.y; ++y) {
+                    for (int x = 0; x < size.x; ++x) {
+                        unsigned char* pPixel = pDest+y*lineLen+x*3;
+                        getRGB(srcBmp, bRedFirst, x, y, rgb[0]);
+                        pPixel[redOffset] = (unsigned char)rgb[0][0];
+                        pPixel[1] = (unsigned char)rgb[0][1];
+                        pPixel[2-redOffset] = (unsigned char)rgb[0][2];
+                    }
+                }
+            }
+            break;
+        case BAYER8_RGGB:
+        case BAYER8_GBRG:
+        case BAYER8_GRBG:
+        case BAYER8_BGGR: {
+                int channels[4];
+                getBayerChannels(camPF, channels);
+                for (int y = 0; y < size.y; ++y) {
+                    for (int x = 0; x < size.x; ++x) {
+                        getRGB(srcBmp, bRedFirst, x, y, rgb[0]);
+                        pDest[y*lineLen+x] = 
+                                (unsigned char)rgb[0][channels[(y%2)*2 + x%2]];
+                    }
+                }
+            }
+            break;
+        case YCbCr422:
+        case YUYV422: {
+                // UYVY or YUYV.
+                int yOffset = (camPF == YUYV422) ? 0 : 1;
+                int uOffset = (camPF == YUYV422) ? 1 : 0;
+                for (int y = 0; y < size.y; ++y) {
+                    for (int x = 0; x < size.x; x += 2) {
+                        unsigned char* pPixels = pDest+y*lineLen+x*2;
+                        getRGB(srcBmp, bRedFirst, x, y, rgb[0]);
+                        getRGB(srcBmp, bRedFirst, x+1, y, rgb[1]);
+                        pPixels[yOffset] = (unsigned char)rgbToY(rgb[0]);
+                        pPixels[yOffset+2] = (unsigned char)rgbToY(rgb[1]);
+                        pPixels[uOffset] = (unsigned char)
+                                ((rgbToU(rgb[0]) + rgbToU(rgb[1])) / 2);
+                        pPixels[uOffset+2] = (unsigned char)
+                                ((rgbToV(rgb[0]) + rgbToV(rgb[1])) / 2);
+                    }
+                }
+            }
+            break;
+        case YCbCr411:
+            // UYYVYY.
+            for (int y = 0; y < size.y; ++y) {
+                for (int x = 0; x < size.x; x += 4) {
+                    unsigned char* pPixels = pDest+y*lineLen+(x/4)*6;
+                    int u = 0;
+                    int v = 0;
+                    for (int i = 0; i < 4; ++i) {
+                        getRGB(srcBmp, bRedFirst, x+i, y, rgb[i]);
+                        u += rgbToU(rgb[i]);
+                        v += rgbToV(rgb[i]);
+                    }
+                    pPixels[0] = (unsigned char)(u/4);
+                    pPixels[1] = (unsigned char)rgbToY(rgb[0]);
+                    pPixels[2] = (unsigned char)rgbToY(rgb[1]);
+                    pPixels[3] = (unsigned char)(v/4);
+                    pPixels[4] = (unsigned char)rgbToY(rgb[2]);
+                    pPixels[5] = (unsigned char)rgbToY(rgb[3]);
+                }
+            }
+            break;
+        case YCbCr420p: {
+                // I420: Y plane, followed by the U and V planes at half resolution.
+                int uvStride = lineLen/2;
+                unsigned char* pUPlane = pDest + lineLen*size.y;
+                unsigned char* pVPlane = pUPlane + uvStride*(size.y/2);
+                for (int y = 0; y < size.y; y += 2) {
+                    for (int x = 0; x < size.x; x += 2) {
+                        int u = 0;
+                        int v = 0;
+                        for (int i = 0; i < 4; ++i) {
+                            int curX = x + i%2;
+                            int curY = y + i/2;
+                            getRGB(srcBmp, bRedFirst, curX, curY, rgb[i]);
+                            pDest[curY*lineLen+curX] = (unsigned char)rgbToY(rgb[i]);
+                            u += rgbToU(rgb[i]);
+                            v += rgbToV(rgb[i]);
+                        }
+                        pUPlane[(y/2)*uvStride+x/2] = (unsigned char)(u/4);
+                        pVPlane[(y/2)*uvStride+x/2] = (unsigned char)(v/4);
+                    }
+                }
+            }
+            break;
+        default:
+            AVG_ASSERT(false);
+    }
+}
+
+}
+
+CameraVideoReaderFactory ReplayCamera::s_VideoReaderFactory = 0;
+
+ReplayCamera::ReplayCamera(const string& sFilename, const IntPoint& size, 
+        PixelFormat camPF, PixelFormat destPF, float frameRate)
+    : Camera(camPF, destPF, size, frameRate),
+      m_sFilename(sFilename),
+      m_NumRecordedFrames(0),
+      m_StartTime(-1),
+      m_NextFrameNum(0),
+      m_NumFramesDelivered(0),
+      m_NumFramesMissed(0)
+{
+    if (!isPFSupported(camPF)) {
+        throw Exception(AVG_ERR_INVALID_ARGS, "Replay camera: pixel format " +
+                getPixelFormatString(camPF) + " not supported.");
+    }
+    if (frameRate <= 0) {
+        throw Exception(AVG_ERR_OUT_OF_RANGE, 
+                "Replay camera: frame rate must be positive.");
+    }
+    if (getExtension(sFilename) == "raw") {
+        openRawFile(size);
+    } else {
+        loadVideoFrames(size);
+    }
+    if (m_NumRecordedFrames == 0) {
+        throw Exception(AVG_ERR_VIDEO_GENERAL, 
+                "Replay camera: " + sFilename + " contains no frames.");
+    }
+    AVG_TRACE(Logger::category::CONFIG, Logger::severity::INFO, 
+            "Replay camera: " << m_NumRecordedFrames << " frames of size " << 
+            getImgSize() << " from " << sFilename << ".");
+}
+
+ReplayCamera::~ReplayCamera()
+{
+}
+
+void ReplayCamera::startCapture()
+{
+    lock_guard lock(m_Mutex);
+    // The clock starts when the first image is requested.
+    m_StartTime = -1;
+    m_NextFrameNum = 0;
+    m_NumFramesDelivered = 0;
+    m_NumFramesMissed = 0;
+}
+
+BitmapPtr ReplayCamera::getImage(bool bWait)
+{
+    if (bWait) {
+        while (!waitForImage(1000)) {
+        }
+    }
+    int frameIndex;
+    {
+        lock_guard lock(m_Mutex);
+        long long now = TimeSource::get()->getCurrentMicrosecs();
+        if (m_StartTime == -1) {
+            m_StartTime = now;
+        }
+        if (now < getFrameTime(m_NextFrameNum)) {
+            return BitmapPtr();
+        }
+        // Only the newest frame that is due survives. Older ones have been 
+        // overwritten by the camera.
+        long long newestFrameNum = 
+                (long long)((now-m_StartTime)*double(getFrameRate())/1000000);
+        if (newestFrameNum > m_NextFrameNum) {
+            m_NumFramesMissed += int(newestFrameNum-m_NextFrameNum);
+            m_NextFrameNum = newestFrameNum;
+        }
+        frameIndex = int(m_NextFrameNum % m_NumRecordedFrames);
+        m_NextFrameNum++;
+    }
+
+    unsigned char* pFrameData = getFrameData(frameIndex);
+    if (!pFrameData) {
+        return BitmapPtr();
+    }
+    BitmapPtr pCamBmp(new Bitmap(getImgSize(), getCamPF(), pFrameData, getLineLen(),
+            false, "ReplayCameraBmp"));
+    BitmapPtr pDestBmp = convertCamFrameToDestPF(pCamBmp);
+    lock_guard lock(m_Mutex);
+    m_NumFramesDelivered++;
+    return pDestBmp;
+}
+
+bool ReplayCamera::waitForImage(int timeout)
+{
+    long long waitTime;
+    {
+        lock_guard lock(m_Mutex);
+        long long now = TimeSource::get()->getCurrentMicrosecs();
+        if (m_StartTime == -1) {
+            m_StartTime = now;
+        }
+        waitTime = getFrameTime(m_NextFrameNum) - now;
+    }
+    // Sleeping without the lock keeps startCapture() and the statistics responsive.
+    if (waitTime <= 0) {
+        return true;
+    } else if (waitTime > timeout*1000LL) {
+        msleep(timeout);
+        return false;
+    } else {
+        msleep(int((waitTime+999)/1000));
+        return true;
+    }
+}
+
+int ReplayCamera::getNumFramesMissed() const
+{
+    lock_guard lock(m_Mutex);
+    return m_NumFramesMissed;
+}
+
+const string& ReplayCamera::getDevice() const
+{
+    return m_sFilename;
+}
+
+const std::string& ReplayCamera::getDriverName() const
+{
+    static string sDriverName = "replay";
+    return sDriverName;
+}
+
+int ReplayCamera::getFeature(CameraFeature feature) const
+{
+    return 0;
+}
+
+void ReplayCamera::setFeature(CameraFeature feature, int value, bool bIgnoreOldValue)
+{
+}
+
+void ReplayCamera::setFeatureOneShot(CameraFeature feature)
+{
+}
+
+int ReplayCamera::getWhitebalanceU() const
+{
+    return 0;
+}
+
+int ReplayCamera::getWhitebalanceV() const
+{
+    return 0;
+}
+
+void ReplayCamera::setWhitebalance(int u, int v, bool bIgnoreOldValue)
+{
+}
+
+int ReplayCamera::getNumRecordedFrames() const
+{
+    return m_NumRecordedFrames;
+}
+
+int ReplayCamera::getNumFramesDelivered() const
+{
+    lock_guard lock(m_Mutex);
+    return m_NumFramesDelivered;
+}
+
+bool ReplayCamera::isPFSupported(PixelFormat pf)
+{
+    switch (pf) {
+        case I8:
+        case R8G8B8:
+        case B8G8R8:
+        case YCbCr411:
+        case YCbCr422:
+        case YUYV422:
+        case YCbCr420p:
+        case BAYER8_RGGB:
+        case BAYER8_GBRG:
+        case BAYER8_GRBG:
+        case BAYER8_BGGR:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void ReplayCamera::openRawFile(const IntPoint& size)
+{
+    if (size.x <= 0 || size.y <= 0 || size.x%4 != 0 || size.y%2 != 0) {
+        throw Exception(AVG_ERR_OUT_OF_RANGE, "Replay camera: capture size " + 
+                toString(size) + 
+                " invalid for raw frames. Width must be a multiple of 4, height even.");
+    }
+    m_RawFile.open(m_sFilename.c_str(), ios::in | ios::binary);
+    if (!m_RawFile) {
+        throw Exception(AVG_ERR_FILEIO, "Opening " + m_sFilename + 
+                " for reading failed.");
+    }
+    m_RawFile.seekg(0, ios::end);
+    long long fileSize = m_RawFile.tellg();
+    int frameBytes = getFrameBytes();
+    m_NumRecordedFrames = int(fileSize/frameBytes);
+    if (fileSize%frameBytes != 0) {
+        AVG_LOG_WARNING("Replay camera: " << m_sFilename << 
+                " ends with an incomplete frame. Ignoring it.");
+    }
+    // Holds the frame that was read last.
+    m_FrameData.resize(frameBytes);
+}
+
+void ReplayCamera::setVideoReaderFactory(CameraVideoReaderFactory factory)
+{
+    s_VideoReaderFactory = factory;
+}
+
+void ReplayCamera::loadVideoFrames(const IntPoint& size)
+{
+    if (!s_VideoReaderFactory) {
+        throw Exception(AVG_ERR_UNSUPPORTED, 
+                "Replay camera: No video decoder available for " + m_sFilename + ".");
+    }
+    CameraVideoReaderPtr pReader = s_VideoReaderFactory(m_sFilename);
+    // The video determines the image size. It is cropped so all camera pixel formats
+    // can represent it.
+    IntPoint videoSize = pReader->getSize();
+    IntPoint imgSize(videoSize.x - videoSize.x%4, videoSize.y - videoSize.y%2);
+    if (imgSize.x == 0 || imgSize.y == 0) {
+        throw Exception(AVG_ERR_VIDEO_GENERAL, 
+                "Replay camera: " + m_sFilename + " is too small.");
+    }
+    if (imgSize != size) {
+        AVG_TRACE(Logger::category::CONFIG, Logger::severity::INFO,
+                "Replay camera: Using video size " << imgSize << 
+                " instead of capture size " << size << ".");
+    }
+    setImgSize(imgSize);
+
+    int frameBytes = getFrameBytes();
+    while (m_NumRecordedFrames < MAX_VIDEO_FRAMES) {
+        BitmapPtr pFrameBmp = pReader->readFrame();
+        if (!pFrameBmp) {
+            break;
+        }
+        m_FrameData.resize(size_t(m_NumRecordedFrames+1)*frameBytes);
+        encodeFrame(*pFrameBmp, getCamPF(), imgSize, getLineLen(), 
+                &(m_FrameData[size_t(m_NumRecordedFrames)*frameBytes]));
+        m_NumRecordedFrames++;
+    }
+    if (m_NumRecordedFrames == MAX_VIDEO_FRAMES && pReader->readFrame()) {
+        AVG_LOG_WARNING("Replay camera: " << m_sFilename << " is longer than " <<
+                MAX_VIDEO_FRAMES << " frames. Only the first " << MAX_VIDEO_FRAMES <<
+                " frames are replayed.");
+    }
+}
+
+unsigned char* ReplayCamera::getFrameData(int frameIndex)
+{
+    int frameBytes = getFrameBytes();
+    if (!m_RawFile.is_open()) {
+        return &(m_FrameData[size_t(frameIndex)*frameBytes]);
+    }
+    m_RawFile.clear();
+    m_RawFile.seekg(streamoff(frameIndex)*frameBytes, ios::beg);
+    m_RawFile.read((char*)&(m_FrameData[0]), frameBytes);
+    if (!m_RawFile) {
+        AVG_LOG_WARNING("Replay camera: Reading frame " << frameIndex << " from " <<
+                m_sFilename << " failed.");
+        return 0;
+    }
+    return &(m_FrameData[0]);
+}
+
+int ReplayCamera::getLineLen() const
+{
+    IntPoint size = getImgSize();
+    switch (getCamPF()) {
+        case YCbCr411:
+            return size.x*3/2;
+        case YCbCr420p:
+            return size.x;
+        default:
+            return size.x*getBytesPerPixel(getCamPF());
+    }
+}
+
+int ReplayCamera::getFrameBytes() const
+{
+    IntPoint size = getImgSize();
+    if (getCamPF() == YCbCr420p) {
+        return size.x*size.y*3/2;
+    } else {
+        return getLineLen()*size.y;
+    }
+}
+
+long long ReplayCamera::getFrameTime(long long frameNum) const
+{
+    return m_StartTime + (long long)(frameNum*1000000.0/getFrameRate());
+}
+
+}
@@ -0,0 +1,112 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#ifndef _ReplayCamera_H_
+#define _ReplayCamera_H_
+
+#include "../api.h"
+#include "Camera.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace avg {
+
+// Source of decoded video frames for ReplayCamera. The imaging library doesn't link
+// the video decoder, so the player registers a factory for readers.
+class AVG_API CameraVideoReader {
+public:
+    virtual ~CameraVideoReader() {};
+
+    virtual IntPoint getSize() const = 0;
+    // Returns an empty BitmapPtr at the end of the video.
+    virtual BitmapPtr readFrame() = 0;
+};
+
+typedef boost::shared_ptr<CameraVideoReader> CameraVideoReaderPtr;
+typedef CameraVideoReaderPtr (*CameraVideoReaderFactory)(const std::string& sFilename);
+
+// Camera driver that replays recorded frames instead of talking to hardware. Frames 
+// come from a raw dump (a file with the extension .raw that contains consecutive 
+// frames of the capture size in camPF), which is read one frame at a time, or from a
+// video file, which is decoded and converted to camPF when the camera is created. 
+// Frames are delivered at the configured frame rate and the recording loops. Frames 
+// that become due while nobody calls getImage() are lost, the same way a real camera 
+// overruns its buffers. getImage() must only be called from one thread at a time.
+class AVG_API ReplayCamera: public Camera
+{
+public:
+    ReplayCamera(const std::string& sFilename, const IntPoint& size, PixelFormat camPF,
+            PixelFormat destPF, float frameRate);
+    virtual ~ReplayCamera();
+    virtual void startCapture();
+
+    virtual BitmapPtr getImage(bool bWait);
+    virtual bool waitForImage(int timeout);
+    virtual int getNumFramesMissed() const;
+
+    virtual const std::string& getDevice() const; 
+    virtual const std::string& getDriverName() const; 
+
+    virtual int getFeature(CameraFeature feature) const;
+    virtual void setFeature(CameraFeature feature, int Value, bool bIgnoreOldValue=false);
+    virtual void setFeatureOneShot(CameraFeature feature);
+    virtual int getWhitebalanceU() const;
+    virtual int getWhitebalanceV() const;
+    virtual void setWhitebalance(int u, int v, bool bIgnoreOldValue=false);
+
+    int getNumRecordedFrames() const;
+    int getNumFramesDelivered() const;
+
+    static bool isPFSupported(PixelFormat pf);
+    static void setVideoReaderFactory(CameraVideoReaderFactory factory);
+
+private:
+    void openRawFile(const IntPoint& size);
+    void loadVideoFrames(const IntPoint& size);
+    unsigned char* getFrameData(int frameIndex);
+    int getLineLen() const;
+    int getFrameBytes() const;
+    long long getFrameTime(long long frameNum) const;
+
+    std::string m_sFilename;
+    // Raw dumps stay on disk. Video frames are kept in m_FrameData.
+    std::ifstream m_RawFile;
+    std::vector<unsigned char> m_FrameData;
+    int m_NumRecordedFrames;
+
+    // Protected by m_Mutex: startCapture() and getImage() run in different threads.
+    long long m_StartTime;
+    long long m_NextFrameNum;
+    int m_NumFramesDelivered;
+    int m_NumFramesMissed;
+    mutable boost::mutex m_Mutex;
+
+    static CameraVideoReaderFactory s_VideoReaderFactory;
+};
+
+}
+
+#endif
@@ -166,36 +166,32 @@ int V4LCamera::getV4LPF(PixelFormat pf)
     }
 }
 
+bool V4LCamera::waitForImage(int timeout)
+{
+    fd_set fds;
+    FD_ZERO(&fds);
+    FD_SET(m_Fd, &fds);
+    struct timeval tv;
+    tv.tv_sec = timeout/1000;
+    tv.tv_usec = (timeout%1000)*1000;
+
+    int rc = select(m_Fd+1, &fds, NULL, NULL, &tv);
+    // caught signal or something else
+    if (rc == -1 && errno != EINTR) {
+        AVG_LOG_WARNING("V4L2: select failed.");
+    }
+    return rc > 0;
+}
+
 BitmapPtr V4LCamera::getImage(bool bWait)
 {
     struct v4l2_buffer buf;
     CLEAR(buf);
 
     // wait for incoming data blocking, timeout 2s
-    if (bWait) {
-        fd_set fds;
-        struct timeval tv;
-        int rc;
-
-        FD_ZERO(&fds);
-        FD_SET(m_Fd, &fds);
-
-        /* Timeout. */
-        tv.tv_sec = 2;
-        tv.tv_usec = 0;
-
-        rc = select (m_Fd+1, &fds, NULL, NULL, &tv);
-
-        // caught signal or something else
-        if (rc == -1) {
-            AVG_LOG_WARNING("V4L2: select failed.");
-            return BitmapPtr();
-        }
-        // timeout
-        if (rc == 0) {
-            AVG_LOG_WARNING("V4L2: Timeout while waiting for image data");
-            return BitmapPtr();
-        }
+    if (bWait && !waitForImage(2000)) {
+        AVG_LOG_WARNING("V4L2: Timeout while waiting for image data");
+        return BitmapPtr();
     }
 
     buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
@@ -46,6 +46,7 @@ public:
     virtual ~V4LCamera();
 
     virtual BitmapPtr getImage(bool bWait);
+    virtual bool waitForImage(int timeout);
     virtual bool isCameraAvailable();
 
     virtual const std::string& getDevice() const;
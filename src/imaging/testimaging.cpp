@@ -0,0 +1,247 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "CameraFrameRing.h"
+#include "CameraConversion.h"
+
+#include "../base/TestSuite.h"
+#include "../graphics/Bitmap.h"
+#include "../graphics/Filterfliprgb.h"
+#include "../graphics/Pixel32.h"
+
+#include <iostream>
+#include <vector>
+#include <stdlib.h>
+
+using namespace avg;
+using namespace std;
+
+class CameraFrameRingTest: public Test {
+public:
+    CameraFrameRingTest()
+        : Test("CameraFrameRingTest", 2)
+    {
+    }
+
+    void runTests()
+    {
+        BitmapPtr pBmp;
+        long long captureTime;
+        {
+            CameraFrameRing ring(3);
+            TEST(ring.getMaxFrames() == 3);
+            TEST(!ring.popNewest(pBmp, captureTime));
+            TEST(ring.getNumFramesCaptured() == 0);
+            TEST(ring.getNumFramesDropped() == 0);
+
+            BitmapPtr pBmp1 = createBmp();
+            ring.push(pBmp1, 1000);
+            TEST(ring.popNewest(pBmp, captureTime));
+            TEST(pBmp == pBmp1);
+            TEST(captureTime == 1000);
+            TEST(!ring.popNewest(pBmp, captureTime));
+            TEST(ring.getNumFramesCaptured() == 1);
+            TEST(ring.getNumFramesDropped() == 0);
+        }
+        {
+            // popNewest() returns the last frame pushed and drops all older ones.
+            CameraFrameRing ring(3);
+            BitmapPtr pBmp2 = createBmp();
+            ring.push(createBmp(), 1000);
+            ring.push(pBmp2, 2000);
+            TEST(ring.popNewest(pBmp, captureTime));
+            TEST(pBmp == pBmp2);
+            TEST(captureTime == 2000);
+            TEST(ring.getNumFramesCaptured() == 2);
+            TEST(ring.getNumFramesDropped() == 1);
+            TEST(!ring.popNewest(pBmp, captureTime));
+        }
+        {
+            // Pushing into a full ring drops the oldest frame.
+            CameraFrameRing ring(2);
+            for (int i = 0; i < 5; ++i) {
+                ring.push(createBmp(), i*1000);
+            }
+            TEST(ring.getNumFramesCaptured() == 5);
+            TEST(ring.getNumFramesDropped() == 3);
+            TEST(ring.popNewest(pBmp, captureTime));
+            TEST(captureTime == 4000);
+            TEST(ring.getNumFramesDropped() == 4);
+            TEST(ring.getNumFramesCaptured() == 5);
+        }
+    }
+
+private:
+    BitmapPtr createBmp()
+    {
+        return BitmapPtr(new Bitmap(IntPoint(4, 4), I8));
+    }
+};
+
+class CameraConversionTest: public Test {
+public:
+    CameraConversionTest()
+        : Test("CameraConversionTest", 2)
+    {
+    }
+
+    void runTests()
+    {
+        PixelFormat camPFs[] = {R8G8B8, B8G8R8, YCbCr422, YUYV422, YCbCr411, 
+                YCbCr420p, BAYER8_RGGB, BAYER8_GBRG, BAYER8_GRBG, BAYER8_BGGR};
+        PixelFormat destPFs[] = {B8G8R8X8, R8G8B8X8};
+        for (unsigned i = 0; i < sizeof(camPFs)/sizeof(PixelFormat); ++i) {
+            for (unsigned j = 0; j < sizeof(destPFs)/sizeof(PixelFormat); ++j) {
+                TEST(isCameraConversionSupported(camPFs[i], destPFs[j]));
+                testConversion(camPFs[i], destPFs[j]);
+            }
+        }
+        TEST(!isCameraConversionSupported(I8, B8G8R8X8));
+        TEST(!isCameraConversionSupported(R8G8B8, I8));
+    }
+
+private:
+    void testConversion(PixelFormat camPF, PixelFormat destPF)
+    {
+        // The SIMD path of Bitmap::copyYUVPixels() processes eight pixels at a time.
+        IntPoint size(24, 6);
+        int lineLen = getLineLen(camPF, size.x);
+        int numBytes;
+        if (camPF == YCbCr420p) {
+            numBytes = size.x*size.y*3/2;
+        } else {
+            numBytes = lineLen*size.y;
+        }
+        vector<unsigned char> data(numBytes);
+        srand(int(camPF));
+        for (int i = 0; i < numBytes; ++i) {
+            if (camPF == YCbCr420p) {
+                // Stay in video range: The SIMD path of Bitmap::copyYUVPixels() clamps
+                // y values below 16.
+                data[i] = (unsigned char)(16+rand()%220);
+            } else {
+                data[i] = (unsigned char)(rand()%256);
+            }
+        }
+        Bitmap camBmp(size, camPF, &(data[0]), lineLen, false);
+
+        Bitmap destBmp(size, destPF);
+        TEST(convertCameraFrame(camBmp, destBmp));
+        BitmapPtr pRefBmp = convertReference(camBmp, destPF);
+        // YCbCr420p to B8G8R8X8 uses Bitmap::copyYUVPixels(), which rounds differently
+        // when it uses SIMD instructions. Everything else has to match exactly.
+        int maxDiff = 0;
+        if (camPF == YCbCr420p && destPF == B8G8R8X8) {
+            maxDiff = 4;
+        }
+        bool bEqual = true;
+        for (int y = 0; y < size.y; ++y) {
+            const unsigned char* pDest = destBmp.getPixels() + y*destBmp.getStride();
+            const unsigned char* pRef = pRefBmp->getPixels() + y*pRefBmp->getStride();
+            for (int x = 0; x < size.x; ++x) {
+                // The fourth byte is unused in both destination formats.
+                for (int c = 0; c < 3; ++c) {
+                    if (abs(int(pDest[x*4+c])-int(pRef[x*4+c])) > maxDiff) {
+                        bEqual = false;
+                    }
+                }
+            }
+        }
+        TEST(bEqual);
+    }
+
+    // The conversion camera drivers did before convertCameraFrame() existed: 
+    // Bitmap::copyPixels() followed by a red/blue swap where needed. copyPixels()
+    // doesn't handle planar input, so YCbCr420p is converted pixel by pixel.
+    BitmapPtr convertReference(const Bitmap& camBmp, PixelFormat destPF)
+    {
+        PixelFormat camPF = camBmp.getPixelFormat();
+        IntPoint size = camBmp.getSize();
+        BitmapPtr pBmp(new Bitmap(size, destPF));
+        if (camPF == YCbCr420p) {
+            int yStride = camBmp.getStride();
+            int uvStride = yStride/2;
+            const unsigned char* pYPlane = camBmp.getPixels();
+            const unsigned char* pUPlane = pYPlane + yStride*size.y;
+            const unsigned char* pVPlane = pUPlane + uvStride*(size.y/2);
+            for (int y = 0; y < size.y; ++y) {
+                Pixel32* pDest = (Pixel32*)(pBmp->getPixels() + y*pBmp->getStride());
+                for (int x = 0; x < size.x; ++x) {
+                    YUVtoBGR32Pixel(pDest+x, pYPlane[y*yStride+x],
+                            pUPlane[(y/2)*uvStride+x/2], pVPlane[(y/2)*uvStride+x/2]);
+                }
+            }
+        } else {
+            pBmp->copyPixels(camBmp);
+        }
+        bool bSwap;
+        if (camPF == R8G8B8) {
+            bSwap = (destPF == B8G8R8X8);
+        } else {
+            bSwap = (destPF == R8G8B8X8);
+        }
+        if (bSwap) {
+            FilterFlipRGB().applyInPlace(pBmp);
+        }
+        return pBmp;
+    }
+
+    int getLineLen(PixelFormat camPF, int width)
+    {
+        switch (camPF) {
+            case R8G8B8:
+            case B8G8R8:
+                return width*3;
+            case YCbCr422:
+            case YUYV422:
+                return width*2;
+            case YCbCr411:
+                return width*3/2;
+            default:
+                return width;
+        }
+    }
+};
+
+class ImagingTestSuite: public TestSuite {
+public:
+    ImagingTestSuite() 
+        : TestSuite("ImagingTestSuite")
+    {
+        addTest(TestPtr(new CameraFrameRingTest));
+        addTest(TestPtr(new CameraConversionTest));
+    }
+};
+
+
+int main(int nargs, char** args)
+{
+    ImagingTestSuite suite;
+    suite.runTests();
+    bool bOK = suite.isOk();
+
+    if (bOK) {
+        return 0;
+    } else {
+        return 1;
+    }
+}
@@ -246,6 +246,9 @@ void AreaNode::preRender(const VertexArrayPtr& pVA, bool bIsParentActive,
 {
     Node::preRender(pVA, bIsParentActive, parentEffectiveOpacity);
     if (isVisible()) {
+        if (m_bTransformChanged) {
+            setCanvasContentChanged();
+        }
         calcTransform();
     }
 }
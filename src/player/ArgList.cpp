@@ -40,6 +40,7 @@ namespace avg {
 typedef std::vector<std::vector<glm::vec2> > CollVec2Vector;
 
 ArgList::ArgList()
+    : m_pArgIndexMap(new ArgIndexMap())
 {
 }
 
@@ -59,13 +60,13 @@ ArgList::ArgList(const ArgList& argTemplates, const py::dict& PyDict)
 {
     // TODO: Check if all required args are being set.
     copyArgsFrom(argTemplates);
-    py::list keys = PyDict.keys();
-    int nKeys = py::len(keys);
-    for (int i = 0; i < nKeys; i++)
-    {
-        py::object keyObj = keys[i];
-        py::object valObj = PyDict[keyObj];
-        
+    PyObject* pKey;
+    PyObject* pValue;
+    Py_ssize_t pos = 0;
+    while (PyDict_Next(PyDict.ptr(), &pos, &pKey, &pValue)) {
+        py::object keyObj(py::handle<>(py::borrowed(pKey)));
+        py::object valObj(py::handle<>(py::borrowed(pValue)));
+
         py::extract<string> keyStrProxy(keyObj);
         if (!keyStrProxy.check()) {
             throw Exception(AVG_ERR_INVALID_ARGS, "Argument name must be a string.");
@@ -82,18 +83,29 @@ ArgList::~ArgList()
 
 bool ArgList::hasArg(const std::string& sName) const
 {
-    ArgMap::const_iterator it = m_Args.find(sName);
-    return (it != m_Args.end() && !(it->second->isDefault()));
+    int i = getArgIndex(sName);
+    return (i != -1 && !(m_Args[i]->isDefault()));
 }
 
-const ArgBasePtr ArgList::getArg(const string& sName) const
+const ArgBasePtr& ArgList::getArg(const string& sName) const
 {
-    ArgMap::const_iterator valIt = m_Args.find(sName);
-    if (valIt == m_Args.end()) {
+    int i = getArgIndex(sName);
+    if (i == -1) {
         // TODO: The error message should mention line number and node type.
         throw Exception(AVG_ERR_INVALID_ARGS, string("Argument ")+sName+" is not valid.");
     }
-    return valIt->second;
+    return m_Args[i];
+}
+
+unsigned ArgList::getNumArgs() const
+{
+    return m_Args.size();
+}
+
+const ArgBasePtr& ArgList::getArg(unsigned i) const
+{
+    AVG_ASSERT(i < m_Args.size());
+    return m_Args[i];
 }
 
 void ArgList::getOverlayedArgVal(glm::vec2* pResult, const string& sName, 
@@ -109,35 +121,74 @@ void ArgList::getOverlayedArgVal(glm::vec2* pResult, const string& sName,
     }
 }
 
-const ArgMap& ArgList::getArgMap() const
-{
-    return m_Args;
-}
-
 void ArgList::setArg(const ArgBase& newArg)
 {
-    m_Args[newArg.getName()] =  ArgBasePtr(newArg.createCopy());
+    ArgBasePtr pArg(newArg.createCopy());
+    int i = getArgIndex(newArg.getName());
+    if (i != -1) {
+        m_Args[i] = pArg;
+    } else {
+        // Only happens while types are being defined, so rebuilding the index is ok.
+        vector<ArgBasePtr>::iterator it = m_Args.begin();
+        while (it != m_Args.end() && (*it)->getName() < newArg.getName()) {
+            ++it;
+        }
+        m_Args.insert(it, pArg);
+        ArgIndexMap* pIndexMap = new ArgIndexMap();
+        for (unsigned j=0; j<m_Args.size(); ++j) {
+            (*pIndexMap)[m_Args[j]->getName()] = j;
+        }
+        m_pArgIndexMap = ArgIndexMapPtr(pIndexMap);
+    }
 }
 
 void ArgList::setArgs(const ArgList& args)
 {
-    for (ArgMap::const_iterator it = args.m_Args.begin(); it != args.m_Args.end(); it++) {
-        m_Args.insert(*it);
+    for (unsigned i=0; i<args.m_Args.size(); ++i) {
+        if (getArgIndex(args.m_Args[i]->getName()) == -1) {
+            setArg(*args.m_Args[i]);
+        }
     }
 }
     
 void ArgList::setMembers(ExportedObject * pObj) const
 {
-    for (ArgMap::const_iterator it = m_Args.begin(); it != m_Args.end(); it++) {
-        const ArgBasePtr pCurArg = it->second;
-        pCurArg->setMember(pObj);
+    for (unsigned i=0; i<m_Args.size(); ++i) {
+        m_Args[i]->setMember(pObj);
     }
     pObj->setArgs(*this);
 }
 
+int ArgList::getArgIndex(const string& sName) const
+{
+    ArgIndexMap::const_iterator it = m_pArgIndexMap->find(sName);
+    if (it == m_pArgIndexMap->end()) {
+        return -1;
+    } else {
+        return it->second;
+    }
+}
+
+ArgBase* ArgList::getWritableArg(const string& sName)
+{
+    int i = getArgIndex(sName);
+    if (i == -1) {
+        throw Exception(AVG_ERR_INVALID_ARGS, string("Argument ")+sName+" is not valid.");
+    }
+    if (m_Args[i]->isDefault()) {
+        // Still shared with the argument templates.
+        m_Args[i] = ArgBasePtr(m_Args[i]->createCopy());
+    }
+    return m_Args[i].get();
+}
+
 template<class T>
-void setArgValue(Arg<T>* pArg, const std::string & sName, const py::object& value)
+bool setArgValue(ArgBase* pBaseArg, const std::string & sName, const py::object& value)
 {
+    Arg<T>* pArg = dynamic_cast<Arg<T>* >(pBaseArg);
+    if (!pArg) {
+        return false;
+    }
     py::extract<T> valProxy(value);
     if (!valProxy.check()) {
         string sTypeName = getFriendlyTypeName(pArg->getValue());
@@ -145,73 +196,36 @@ void setArgValue(Arg<T>* pArg, const std::string & sName, const py::object& valu
                 +sTypeName+" expected.");
     }
     pArg->setValue(valProxy());
+    return true;
 }
 
 void ArgList::setArgValue(const std::string & sName, const py::object& value)
 {
-    ArgBasePtr pArg = getArg(sName);
-    Arg<string>* pStringArg = dynamic_cast<Arg<string>* >(&*pArg);
-    Arg<UTF8String>* pUTF8StringArg = dynamic_cast<Arg<UTF8String>* >(&*pArg);
-    Arg<int>* pIntArg = dynamic_cast<Arg<int>* >(&*pArg);
-    Arg<float>* pFloatArg = dynamic_cast<Arg<float>* >(&*pArg);
-    Arg<bool>* pBoolArg = dynamic_cast<Arg<bool>* >(&*pArg);
-    Arg<glm::vec2>* pVec2Arg = dynamic_cast<Arg<glm::vec2>* >(&*pArg);
-    Arg<glm::vec3>* pVec3Arg = dynamic_cast<Arg<glm::vec3>* >(&*pArg);
-    Arg<glm::ivec3>* pIVec3Arg = dynamic_cast<Arg<glm::ivec3>* >(&*pArg);
-    Arg<vector<float> >* pFVectorArg = dynamic_cast<Arg<vector<float> >* >(&*pArg);
-    Arg<vector<int> >* pIVectorArg = dynamic_cast<Arg<vector<int> >* >(&*pArg);
-    Arg<vector<glm::vec2> >* pVec2VectorArg = 
-            dynamic_cast<Arg<vector<glm::vec2> >* >(&*pArg);
-    Arg<vector<glm::ivec3> >* pIVec3VectorArg = 
-            dynamic_cast<Arg<vector<glm::ivec3> >* >(&*pArg);
-    Arg<CollVec2Vector>* pCollVec2VectorArg =
-            dynamic_cast<Arg<CollVec2Vector>* >(&*pArg);
-    Arg<vector<string> >* pStrVectorArg = dynamic_cast<Arg<vector<string> >* >(&*pArg);
-    Arg<FontStyle>* pFontStyleArg = dynamic_cast<Arg<FontStyle>* >(&*pArg);
-    Arg<FontStylePtr>* pFontStylePtrArg = dynamic_cast<Arg<FontStylePtr>* >(&*pArg);
-    Arg<Color>* pColorArg = dynamic_cast<Arg<Color>* >(&*pArg);
-    if(pStringArg) {
-        avg::setArgValue(pStringArg, sName, value);
-    } else if (pUTF8StringArg) {
-        avg::setArgValue(pUTF8StringArg, sName, value);
-    } else if (pIntArg) {
-        avg::setArgValue(pIntArg, sName, value);
-    } else if (pFloatArg) {
-        avg::setArgValue(pFloatArg, sName, value);
-    } else if (pBoolArg) {
-        avg::setArgValue(pBoolArg, sName, value);
-    } else if (pVec2Arg) {
-        avg::setArgValue(pVec2Arg, sName, value);
-    } else if (pVec3Arg) {
-        avg::setArgValue(pVec3Arg, sName, value);
-    } else if (pIVec3Arg) {
-        avg::setArgValue(pIVec3Arg, sName, value);
-    } else if (pFVectorArg) {
-        avg::setArgValue(pFVectorArg, sName, value);
-    } else if (pIVectorArg) {
-        avg::setArgValue(pIVectorArg, sName, value);
-    } else if (pVec2VectorArg) {
-        avg::setArgValue(pVec2VectorArg, sName, value);
-    } else if (pIVec3VectorArg) {
-        avg::setArgValue(pIVec3VectorArg, sName, value);
-    } else if (pCollVec2VectorArg) {
-        avg::setArgValue(pCollVec2VectorArg, sName, value);
-    } else if (pStrVectorArg) {
-        avg::setArgValue(pStrVectorArg, sName, value);
-    } else if (pFontStyleArg) {
-        avg::setArgValue(pFontStyleArg, sName, value);
-    } else if (pFontStylePtrArg) {
-        avg::setArgValue(pFontStylePtrArg, sName, value);
-    } else if (pColorArg) {
-        avg::setArgValue(pColorArg, sName, value);
-    } else {
-        AVG_ASSERT(false);
-    }
+    // Casts are tried one after the other, most common types first.
+    ArgBase* pArg = getWritableArg(sName);
+    bool bOK = avg::setArgValue<float>(pArg, sName, value) ||
+            avg::setArgValue<glm::vec2>(pArg, sName, value) ||
+            avg::setArgValue<UTF8String>(pArg, sName, value) ||
+            avg::setArgValue<string>(pArg, sName, value) ||
+            avg::setArgValue<int>(pArg, sName, value) ||
+            avg::setArgValue<bool>(pArg, sName, value) ||
+            avg::setArgValue<Color>(pArg, sName, value) ||
+            avg::setArgValue<glm::vec3>(pArg, sName, value) ||
+            avg::setArgValue<glm::ivec3>(pArg, sName, value) ||
+            avg::setArgValue<vector<float> >(pArg, sName, value) ||
+            avg::setArgValue<vector<int> >(pArg, sName, value) ||
+            avg::setArgValue<vector<glm::vec2> >(pArg, sName, value) ||
+            avg::setArgValue<vector<glm::ivec3> >(pArg, sName, value) ||
+            avg::setArgValue<CollVec2Vector>(pArg, sName, value) ||
+            avg::setArgValue<vector<string> >(pArg, sName, value) ||
+            avg::setArgValue<FontStyle>(pArg, sName, value) ||
+            avg::setArgValue<FontStylePtr>(pArg, sName, value);
+    AVG_ASSERT(bOK);
 }
 
 void ArgList::setArgValue(const std::string & sName, const std::string & sValue)
 {
-    ArgBasePtr pArg = getArg(sName);
+    ArgBase* pArg = getWritableArg(sName);
     Arg<string>* pStringArg = dynamic_cast<Arg<string>* >(&*pArg);
     Arg<UTF8String>* pUTF8StringArg = dynamic_cast<Arg<UTF8String>* >(&*pArg);
     Arg<int>* pIntArg = dynamic_cast<Arg<int>* >(&*pArg);
@@ -274,13 +288,8 @@ void ArgList::setArgValue(const std::string & sName, const std::string & sValue)
 
 void ArgList::copyArgsFrom(const ArgList& argTemplates)
 {
-    for (ArgMap::const_iterator it = argTemplates.m_Args.begin();
-            it != argTemplates.m_Args.end(); it++)
-    {
-        string sKey = it->first;
-        ArgBasePtr pArg = ArgBasePtr(it->second->createCopy());
-        m_Args[sKey] = pArg;
-    }
+    m_pArgIndexMap = argTemplates.m_pArgIndexMap;
+    m_Args = argTemplates.m_Args;
 }
 
 }
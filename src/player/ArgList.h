@@ -31,15 +31,20 @@
 
 #include <libxml/parser.h>
 
+#include <boost/unordered_map.hpp>
+
 #include <string>
-#include <map>
+#include <vector>
 
 namespace avg {
 
-typedef std::map<std::string, ArgBasePtr> ArgMap;
-
 class ExportedObject;
 
+// Arguments are stored in a flat vector sorted by name. The name->index table is
+// built once per type and shared by all ArgLists created from the type's argument
+// templates. Constructing an ArgList from templates shares the template args; an arg
+// is only copied when its value is set.
+
 class AVG_API ArgList
 {
 public:
@@ -49,7 +54,9 @@ public:
     virtual ~ArgList();
 
     bool hasArg(const std::string& sName) const;
-    const ArgBasePtr getArg(const std::string& sName) const;
+    const ArgBasePtr& getArg(const std::string& sName) const;
+    unsigned getNumArgs() const;
+    const ArgBasePtr& getArg(unsigned i) const;
    
     template<class T>
     const T& getArgVal(const std::string& sName) const;
@@ -58,8 +65,6 @@ public:
             const std::string& sOverlay1, const std::string& sOverlay2,
             const std::string& sID) const;
 
-    const ArgMap& getArgMap() const;
-    
     void setArg(const ArgBase& newArg);
     void setArgs(const ArgList& args);
     void setMembers(ExportedObject * pObj) const;
@@ -67,9 +72,15 @@ public:
     void copyArgsFrom(const ArgList& argTemplates);
 
 private:
+    int getArgIndex(const std::string& sName) const;
+    ArgBase* getWritableArg(const std::string& sName);
     void setArgValue(const std::string & sName, const py::object& value);
     void setArgValue(const std::string & sName, const std::string & sValue);
-    ArgMap m_Args;
+
+    typedef boost::unordered_map<std::string, unsigned> ArgIndexMap;
+    typedef boost::shared_ptr<const ArgIndexMap> ArgIndexMapPtr;
+    ArgIndexMapPtr m_pArgIndexMap;
+    std::vector<ArgBasePtr> m_Args;
 };
     
 template<class T>
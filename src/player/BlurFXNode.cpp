@@ -27,14 +27,16 @@
 #include "../graphics/GPUBlurFilter.h"
 
 #include <string>
+#include <sstream>
 
 using namespace std;
 
 namespace avg {
 
-BlurFXNode::BlurFXNode(float radius) 
+BlurFXNode::BlurFXNode(float radius, bool bFast) 
     : FXNode(false),
-      m_StdDev(radius)
+      m_StdDev(radius),
+      m_bFast(bFast)
 {
     ObjectCounter::get()->incRef(&typeid(*this));
 }
@@ -70,10 +72,31 @@ float BlurFXNode::getRadius() const
     return m_StdDev;
 }
 
+void BlurFXNode::setFast(bool bFast)
+{
+    m_bFast = bFast;
+    if (m_pFilter) {
+        m_pFilter->setFast(bFast);
+    }
+    setDirty();
+}
+
+bool BlurFXNode::getFast() const
+{
+    return m_bFast;
+}
+
+string BlurFXNode::getCacheKey() const
+{
+    stringstream ss;
+    ss << "BlurFXNode(" << m_StdDev << ", " << m_bFast << ")";
+    return ss.str();
+}
+
 GPUFilterPtr BlurFXNode::createFilter(const IntPoint& size)
 {
     m_pFilter = GPUBlurFilterPtr(new GPUBlurFilter(size, B8G8R8A8, B8G8R8A8, m_StdDev, 
-            false, false));
+            false, false, false, m_bFast));
     return m_pFilter;
 }
 
@@ -27,6 +27,7 @@
 #include "FXNode.h"
 
 #include <boost/shared_ptr.hpp>
+#include <string>
 
 namespace avg {
 
@@ -35,7 +36,7 @@ typedef boost::shared_ptr<GPUBlurFilter> GPUBlurFilterPtr;
 
 class AVG_API BlurFXNode: public FXNode {
 public:
-    BlurFXNode(float radius=1.f);
+    BlurFXNode(float radius=1.f, bool bFast=false);
     virtual ~BlurFXNode();
 
     void connect();
@@ -43,6 +44,10 @@ public:
 
     void setRadius(float stdDev);
     float getRadius() const;
+    void setFast(bool bFast);
+    bool getFast() const;
+
+    virtual std::string getCacheKey() const;
 
 private:
     virtual GPUFilterPtr createFilter(const IntPoint& size);
@@ -50,6 +55,7 @@ private:
     GPUBlurFilterPtr m_pFilter;
 
     float m_StdDev;
+    bool m_bFast;
 };
 
 typedef boost::shared_ptr<BlurFXNode> BlurFXNodePtr;
@@ -28,7 +28,9 @@
 #include "../base/Logger.h"
 #include "../base/Exception.h"
 #include "../base/ScopeTimer.h"
+#include "../base/TimeSource.h"
 #include "../base/XMLHelper.h"
+#include "../base/ThreadHelper.h"
 
 #include "../graphics/Filterfill.h"
 #include "../graphics/TextureMover.h"
@@ -39,6 +41,9 @@
 #include "../imaging/Camera.h"
 #include "../imaging/FWCamera.h"
 #include "../imaging/FakeCamera.h"
+#include "../imaging/ReplayCamera.h"
+
+#include "../video/SyncVideoDecoder.h"
 
 #include <iostream>
 #include <sstream>
@@ -51,8 +56,55 @@ using namespace boost;
 
 namespace avg {
 
+namespace {
+
+// Decodes video files for the replay camera driver.
+class DecoderVideoReader: public CameraVideoReader {
+public:
+    DecoderVideoReader(const string& sFilename)
+    {
+        m_Decoder.open(sFilename, false);
+        if (!m_Decoder.getVideoInfo().m_bHasVideo) {
+            throw Exception(AVG_ERR_VIDEO_GENERAL, 
+                    "Replay camera: " + sFilename + " has no video stream.");
+        }
+        m_Decoder.startDecoding(false, 0);
+    }
+
+    virtual ~DecoderVideoReader()
+    {
+        m_Decoder.close();
+    }
+
+    virtual IntPoint getSize() const
+    {
+        return m_Decoder.getSize();
+    }
+
+    virtual BitmapPtr readFrame()
+    {
+        BitmapPtr pBmp;
+        if (m_Decoder.getRenderedBmp(pBmp, -1) != FA_NEW_FRAME) {
+            return BitmapPtr();
+        }
+        return pBmp;
+    }
+
+private:
+    SyncVideoDecoder m_Decoder;
+};
+
+CameraVideoReaderPtr createVideoReader(const string& sFilename)
+{
+    return CameraVideoReaderPtr(new DecoderVideoReader(sFilename));
+}
+
+}
+
 void CameraNode::registerType()
 {
+    ReplayCamera::setVideoReaderFactory(createVideoReader);
+
     TypeDefinition def = TypeDefinition("camera", "rasternode", 
             ExportedObject::buildObject<CameraNode>)
         .addArg(Arg<string>("driver", "firewire"))
@@ -80,7 +132,11 @@ CameraNode::CameraNode(const ArgList& args, const string& sPublisherName)
       m_FrameNum(0),
       m_bAutoUpdateCameraImage(true),
       m_bNewBmp(false),
-      m_bNewSurface(false)
+      m_bNewSurface(false),
+      m_pCameraMutex(new boost::mutex),
+      m_pCaptureThread(0),
+      m_CurCaptureTime(0),
+      m_CaptureLatency(0)
 {
     args.setMembers(this);
     string sDriver = args.getArgVal<string>("driver");
@@ -126,6 +182,7 @@ CameraNode::CameraNode(const ArgList& args, const string& sPublisherName)
 
 CameraNode::~CameraNode()
 {
+    stopCaptureThread();
     m_pCamera = CameraPtr();
 }
 
@@ -148,6 +205,7 @@ void CameraNode::connect(CanvasPtr pCanvas)
 
 void CameraNode::disconnect(bool bKill)
 {
+    stopCaptureThread();
     if (bKill) {
         m_pCamera = CameraPtr();
     }
@@ -164,6 +222,7 @@ void CameraNode::play()
 
 void CameraNode::stop()
 {
+    stopCaptureThread();
     m_bIsPlaying = false;
 }
 
@@ -238,21 +297,25 @@ void CameraNode::setGain(int value)
 
 int CameraNode::getWhitebalanceU() const
 {
+    lock_guard lock(*m_pCameraMutex);
     return m_pCamera->getWhitebalanceU();
 }
 
 int CameraNode::getWhitebalanceV() const
 {
+    lock_guard lock(*m_pCameraMutex);
     return m_pCamera->getWhitebalanceV();
 }
 
 void CameraNode::setWhitebalance(int u, int v)
 {
+    lock_guard lock(*m_pCameraMutex);
     m_pCamera->setWhitebalance(u, v);
 }
 
 void CameraNode::doOneShotWhitebalance()
 {
+    lock_guard lock(*m_pCameraMutex);
     // The first line turns off auto white balance.
     m_pCamera->setWhitebalance(m_pCamera->getWhitebalanceU(), 
             m_pCamera->getWhitebalanceV());
@@ -304,6 +367,7 @@ float CameraNode::getFPS() const
 void CameraNode::open()
 {
     m_pCamera->startCapture();
+    startCaptureThread();
     setViewport(-32767, -32767, -32767, -32767);
     PixelFormat pf = getPixelFormat();
     IntPoint size = getMediaSize();
@@ -318,11 +382,13 @@ void CameraNode::open()
 
 int CameraNode::getFeature(CameraFeature feature) const
 {
+    lock_guard lock(*m_pCameraMutex);
     return m_pCamera->getFeature(feature);
 }
 
 void CameraNode::setFeature(CameraFeature feature, int value)
 {
+    lock_guard lock(*m_pCameraMutex);
     m_pCamera->setFeature(feature, value);
 }
 
@@ -331,6 +397,35 @@ int CameraNode::getFrameNum() const
     return m_FrameNum;
 }
 
+float CameraNode::getCaptureLatency() const
+{
+    return m_CaptureLatency;
+}
+
+int CameraNode::getNumFramesCaptured() const
+{
+    if (m_pFrameRing) {
+        return m_pFrameRing->getNumFramesCaptured();
+    } else {
+        return 0;
+    }
+}
+
+int CameraNode::getNumFramesDropped() const
+{
+    if (m_pFrameRing) {
+        return m_pFrameRing->getNumFramesDropped();
+    } else {
+        return 0;
+    }
+}
+
+int CameraNode::getNumFramesMissed() const
+{
+    lock_guard lock(*m_pCameraMutex);
+    return m_pCamera->getNumFramesMissed();
+}
+
 static ProfilingZoneID CameraFetchImage("Camera fetch image");
 static ProfilingZoneID CameraDownloadProfilingZone("Camera tex download");
 
@@ -347,7 +442,9 @@ void CameraNode::preRender(const VertexArrayPtr& pVA, bool bIsParentActive,
             if (m_bNewBmp) {
                 ScopeTimer Timer(CameraDownloadProfilingZone);
                 m_FrameNum++;
-                GLContextManager::get()->scheduleTexUpload(m_pTex, m_pCurBmp);
+                m_CaptureLatency = 
+                        (TimeSource::get()->getCurrentMicrosecs()-m_CurCaptureTime)/1000.f;
+                GLContextManager::get()->scheduleTexUpload(m_pTex, m_pCurBmp, true);
                 scheduleFXRender();
                 m_bNewBmp = false;
             } else if (m_bNewSurface) {
@@ -359,7 +456,7 @@ void CameraNode::preRender(const VertexArrayPtr& pVA, bool bIsParentActive,
                 } else if (pf == I8) {
                     FilterFill<Pixel8>(0).applyInPlace(pBmp);
                 }
-                GLContextManager::get()->scheduleTexUpload(m_pTex, pBmp);
+                GLContextManager::get()->scheduleTexUpload(m_pTex, pBmp, true);
                 scheduleFXRender();
             }
             m_bNewSurface = false;
@@ -386,18 +483,42 @@ PixelFormat CameraNode::getPixelFormat()
 
 void CameraNode::updateToLatestCameraImage()
 {
-    BitmapPtr pTmpBmp = m_pCamera->getImage(false);
-    while (pTmpBmp) {
+    if (m_pFrameRing && m_pFrameRing->popNewest(m_pCurBmp, m_CurCaptureTime)) {
         m_bNewBmp = true;
-        m_pCurBmp = pTmpBmp;
-        pTmpBmp = m_pCamera->getImage(false);
     }
 }
 
 void CameraNode::updateCameraImage()
 {
-    if (!m_bAutoUpdateCameraImage) {
-        m_pCurBmp = m_pCamera->getImage(false);
+    if (!m_bAutoUpdateCameraImage && m_pFrameRing) {
+        BitmapPtr pBmp;
+        if (m_pFrameRing->popNewest(pBmp, m_CurCaptureTime)) {
+            m_pCurBmp = pBmp;
+        } else {
+            m_pCurBmp = BitmapPtr();
+        }
+    }
+}
+
+void CameraNode::startCaptureThread()
+{
+    if (m_pCaptureThread) {
+        return;
+    }
+    m_pFrameRing = CameraFrameRingPtr(new CameraFrameRing());
+    m_pCaptureCmdQ = CameraCaptureThread::CQueuePtr(new CameraCaptureThread::CQueue);
+    m_pCaptureThread = new boost::thread(CameraCaptureThread(*m_pCaptureCmdQ, 
+            m_pCamera, m_pCameraMutex, m_pFrameRing));
+}
+
+void CameraNode::stopCaptureThread()
+{
+    if (m_pCaptureThread) {
+        m_pCaptureCmdQ->pushCmd(boost::bind(&CameraCaptureThread::stop, _1));
+        m_pCaptureThread->join();
+        delete m_pCaptureThread;
+        m_pCaptureThread = 0;
+        m_pCaptureCmdQ = CameraCaptureThread::CQueuePtr();
     }
 }
 
@@ -29,6 +29,7 @@
 
 #include "../imaging/Camera.h"
 #include "../imaging/CameraInfo.h"
+#include "../imaging/CameraCaptureThread.h"
 
 #include <boost/thread/thread.hpp>
 
@@ -102,6 +103,10 @@ class AVG_API CameraNode : public RasterNode
         virtual void render(GLContext* pContext, const glm::mat4& transform);
 
         int getFrameNum() const;
+        float getCaptureLatency() const;
+        int getNumFramesCaptured() const;
+        int getNumFramesDropped() const;
+        int getNumFramesMissed() const;
         IntPoint getMediaSize();
         virtual BitmapPtr getBitmap();
 
@@ -118,6 +123,8 @@ class AVG_API CameraNode : public RasterNode
         void setFeature(int FeatureID);
 
         void updateToLatestCameraImage();
+        void startCaptureThread();
+        void stopCaptureThread();
 
         bool m_bIsPlaying;
     
@@ -128,6 +135,14 @@ class AVG_API CameraNode : public RasterNode
         bool m_bNewBmp;
         bool m_bNewSurface;
 
+        // Serializes camera parameter access with image capture in the capture thread.
+        MutexPtr m_pCameraMutex;
+        CameraFrameRingPtr m_pFrameRing;
+        CameraCaptureThread::CQueuePtr m_pCaptureCmdQ;
+        boost::thread* m_pCaptureThread;
+        long long m_CurCaptureTime;
+        float m_CaptureLatency;
+
         MCTexturePtr m_pTex;
 };
 
@@ -34,6 +34,7 @@
 #include "../graphics/StandardShader.h"
 #include "../graphics/GLContextManager.h"
 #include "../graphics/MCFBO.h"
+#include "../graphics/RenderStats.h"
 
 #include <iostream>
 
@@ -49,7 +50,8 @@ Canvas::Canvas(Player * pPlayer)
       m_PlaybackEndSignal(&IPlaybackEndListener::onPlaybackEnd),
       m_FrameEndSignal(&IFrameEndListener::onFrameEnd),
       m_PreRenderSignal(&IPreRenderListener::onPreRender),
-      m_ClipLevel(0)
+      m_ClipLevel(0),
+      m_bContentChanged(true)
 {
 }
 
@@ -241,6 +243,7 @@ void Canvas::preRender()
     m_pVertexArray->reset();
     createStdSubVA();
     m_pRootNode->preRender(m_pVertexArray, true, 1.0f);
+    planFXRender();
 }
 
 static ProfilingZoneID RootRenderProfilingZone("RootNode: render");
@@ -292,6 +295,21 @@ SubVertexArray& Canvas::getStdSubVA()
     return m_StdSubVA;
 }
 
+void Canvas::setContentChanged()
+{
+    m_bContentChanged = true;
+}
+
+bool Canvas::isContentChanged() const
+{
+    return m_bContentChanged;
+}
+
+void Canvas::resetContentChanged()
+{
+    m_bContentChanged = false;
+}
+
 void Canvas::renderOutlines(GLContext* pContext, const glm::mat4& transform)
 {
     VertexArrayPtr pVA = GLContextManager::get()->createVertexArray();
@@ -319,11 +337,68 @@ void Canvas::createStdSubVA()
     m_StdSubVA.appendQuadIndexes(1, 0, 2, 3);
 }
 
-void Canvas::renderFX(GLContext* pContext)
+static ProfilingZoneID PlanFXProfilingZone("Plan FX render");
+
+void Canvas::planFXRender()
 {
+    ScopeTimer Timer(PlanFXProfilingZone);
+    m_pFXRenderNodes.clear();
+
+    // Effect results that are valid this frame, indexed by cache key. Nodes with the 
+    // same key display the same result instead of rendering their own.
+    typedef map<string, FXNodePtr> FXResultMap;
+    FXResultMap results;
+    vector<RasterNodePtr> pInvalidNodes;
     vector<RasterNodePtr>::iterator it;
     for (it=m_pScheduledFXNodes.begin(); it!=m_pScheduledFXNodes.end(); ++it) {
+        RasterNodePtr pNode = *it;
+        const string& sKey = pNode->updateFXCacheKey();
+        if (pNode->needsFXRender()) {
+            pInvalidNodes.push_back(pNode);
+        } else {
+            pNode->setFXResultSource(pNode->getEffect());
+            if (!sKey.empty()) {
+                results.insert(make_pair(sKey, pNode->getEffect()));
+            }
+        }
+    }
+
+    if (!pInvalidNodes.empty()) {
+        setContentChanged();
+    }
+
+    int budget = m_pPlayer->getFXBudget();
+    for (it=pInvalidNodes.begin(); it!=pInvalidNodes.end(); ++it) {
+        RasterNodePtr pNode = *it;
+        const string& sKey = pNode->getFXCacheKey();
+        if (!sKey.empty()) {
+            FXResultMap::iterator resultIt = results.find(sKey);
+            if (resultIt != results.end()) {
+                pNode->setFXResultSource(resultIt->second);
+                continue;
+            }
+        }
+        pNode->setFXResultSource(pNode->getEffect());
+        if (budget != 0 && int(m_pFXRenderNodes.size()) >= budget && 
+                pNode->canDeferFXRender())
+        {
+            // Keep displaying the old result for now.
+            pNode->deferFXRender();
+        } else {
+            m_pFXRenderNodes.push_back(pNode);
+            if (!sKey.empty()) {
+                results.insert(make_pair(sKey, pNode->getEffect()));
+            }
+        }
+    }
+}
+
+void Canvas::renderFX(GLContext* pContext)
+{
+    vector<RasterNodePtr>::iterator it;
+    for (it=m_pFXRenderNodes.begin(); it!=m_pFXRenderNodes.end(); ++it) {
         (*it)->renderFX(pContext);
+        RenderStats::countFXRender();
     }
 }
 
@@ -334,6 +409,7 @@ void Canvas::resetFXSchedule()
         (*it)->resetFXDirty();
     }
     m_pScheduledFXNodes.clear();
+    m_pFXRenderNodes.clear();
 }
 
 
@@ -106,14 +106,20 @@ class AVG_API Canvas: public ExportedObject
         void scheduleFXRender(const RasterNodePtr& pNode);
         SubVertexArray& getStdSubVA();
 
+        // Set whenever something that affects the rendered image changes.
+        void setContentChanged();
+        bool isContentChanged() const;
+
     protected:
         Player * getPlayer() const;
         void preRender();
         void emitPreRenderSignal(); 
         void emitFrameEndSignal();
+        void resetContentChanged();
 
     private:
         virtual void renderTree()=0;
+        void planFXRender();
         void renderFX(GLContext* pContext);
         void resetFXSchedule();
         void renderOutlines(GLContext* pContext, const glm::mat4& transform);
@@ -136,8 +142,10 @@ class AVG_API Canvas: public ExportedObject
 
         int m_MultiSampleSamples;
         int m_ClipLevel;
+        bool m_bContentChanged;
 
         std::vector<RasterNodePtr> m_pScheduledFXNodes;
+        std::vector<RasterNodePtr> m_pFXRenderNodes;
 };
 
 }
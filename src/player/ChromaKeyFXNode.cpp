@@ -26,6 +26,7 @@
 #include "../graphics/GPUChromaKeyFilter.h"
 
 #include <string>
+#include <sstream>
 
 using namespace std;
 
@@ -133,6 +134,15 @@ float ChromaKeyFXNode::getSpillThreshold() const
     return m_SpillThreshold;
 }
 
+string ChromaKeyFXNode::getCacheKey() const
+{
+    stringstream ss;
+    ss << "ChromaKeyFXNode(" << m_Color << ", " << m_HTolerance << ", " << m_STolerance 
+            << ", " << m_LTolerance << ", " << m_Softness << ", " << m_Erosion << ", " 
+            << m_SpillThreshold << ")";
+    return ss.str();
+}
+
 GPUFilterPtr ChromaKeyFXNode::createFilter(const IntPoint& size)
 {
     m_pFilter = GPUChromaKeyFilterPtr(new GPUChromaKeyFilter(size, false));
@@ -29,6 +29,7 @@
 #include "../graphics/Color.h"
 
 #include <boost/shared_ptr.hpp>
+#include <string>
 
 namespace avg {
 
@@ -57,6 +58,8 @@ public:
     void setSpillThreshold(float spillThreshold);
     float getSpillThreshold() const;
 
+    virtual std::string getCacheKey() const;
+
 private:
     virtual GPUFilterPtr createFilter(const IntPoint& size);
     void updateFilter();
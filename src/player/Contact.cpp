@@ -122,10 +122,28 @@ vector<CursorEventPtr> Contact::getEvents() const
 }
 
 void Contact::addEvent(CursorEventPtr pEvent)
+{
+    // Events that were coalesced into this one are not delivered but belong to the 
+    // history.
+    CursorEventPtr pPrevFrameEvent = m_Events.back();
+    const vector<CursorEventPtr>& pCoalescedEvents = pEvent->getCoalescedEvents();
+    for (unsigned i = 0; i < pCoalescedEvents.size(); ++i) {
+        appendEvent(pCoalescedEvents[i], pPrevFrameEvent);
+    }
+    appendEvent(pEvent, pPrevFrameEvent);
+}
+
+void Contact::appendEvent(CursorEventPtr pEvent, CursorEventPtr pPrevFrameEvent)
 {
     pEvent->setCursorID(m_CursorID);
     pEvent->setContact(boost::dynamic_pointer_cast<Contact>(shared_from_this()));
-    calcSpeed(pEvent, m_Events.back());
+    // Coalesced events usually carry the timestamp of the frame they were delivered 
+    // in. Their speed is measured against the last event of the previous frame then.
+    CursorEventPtr pOldEvent = m_Events.back();
+    if (pOldEvent->getWhen() == pEvent->getWhen()) {
+        pOldEvent = pPrevFrameEvent;
+    }
+    calcSpeed(pEvent, pOldEvent);
     updateDistanceTravelled(m_Events.back(), pEvent);
     m_Events.back()->clearNodeData();
     m_Events.push_back(pEvent);
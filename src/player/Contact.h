@@ -72,6 +72,7 @@ public:
     int getID() const;
     
 private:
+    void appendEvent(CursorEventPtr pEvent, CursorEventPtr pPrevFrameEvent);
     void calcSpeed(CursorEventPtr pEvent, CursorEventPtr pOldEvent);
     void updateDistanceTravelled(CursorEventPtr pEvent1, CursorEventPtr pEvent2);
     void dumpListeners(std::string sFuncName);
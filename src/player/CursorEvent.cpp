@@ -42,7 +42,8 @@ CursorEvent::CursorEvent(int id, Type eventType, const IntPoint& pos, Source sou
       m_ID(id),
       m_UserID(-1),
       m_JointID(-1),
-      m_Speed(0,0)
+      m_Speed(0,0),
+      m_NumDroppedEvents(0)
 {
 }
 
@@ -61,6 +62,8 @@ CursorEventPtr CursorEvent::cloneAs(Type eventType) const
     if (eventType != UNKNOWN) {
         pClone->m_Type = eventType;
     }
+    pClone->m_pCoalescedEvents.clear();
+    pClone->m_NumDroppedEvents = 0;
     return pClone;
 }
 
@@ -147,6 +150,23 @@ ContactPtr CursorEvent::getContact() const
     return m_pContact.lock();
 }
 
+void CursorEvent::setCoalescedEvents(const vector<CursorEventPtr>& pEvents, 
+        int numDropped)
+{
+    m_pCoalescedEvents = pEvents;
+    m_NumDroppedEvents = numDropped;
+}
+
+const vector<CursorEventPtr>& CursorEvent::getCoalescedEvents() const
+{
+    return m_pCoalescedEvents;
+}
+
+int CursorEvent::getNumCoalescedEvents() const
+{
+    return int(m_pCoalescedEvents.size())+m_NumDroppedEvents;
+}
+
 bool operator ==(const CursorEvent& event1, const CursorEvent& event2)
 {
     return (event1.m_Pos == event2.m_Pos && 
@@ -32,6 +32,8 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/weak_ptr.hpp>
 
+#include <vector>
+
 namespace avg {
 
 const int MOUSECURSORID=-1;
@@ -73,6 +75,15 @@ class AVG_API CursorEvent: public Event
         void setContact(ContactPtr pContact);
         ContactPtr getContact() const;
 
+        // Motion events of the same contact that arrived since the last delivered 
+        // event and were merged into this one.
+        void setCoalescedEvents(const std::vector<CursorEventPtr>& pEvents, 
+                int numDropped);
+        const std::vector<CursorEventPtr>& getCoalescedEvents() const;
+        // Number of events merged into this one, including duplicates that were 
+        // discarded.
+        int getNumCoalescedEvents() const;
+
         friend bool operator ==(const CursorEvent& event1, const CursorEvent& event2);
         virtual void trace();
 
@@ -84,6 +95,8 @@ class AVG_API CursorEvent: public Event
         int m_JointID;
         NodePtr m_pNode;
         glm::vec2 m_Speed;
+        std::vector<CursorEventPtr> m_pCoalescedEvents;
+        int m_NumDroppedEvents;
 };
 
 bool operator ==(const CursorEvent& event1, const CursorEvent& event2);
@@ -87,6 +87,9 @@ DisplayEngine::DisplayEngine()
     : InputDevice("DisplayEngine"),
       m_Size(0,0),
       m_NumFrames(0),
+      m_LastWaitDuration(0),
+      m_LastSwapDuration(0),
+      m_LastSwapTime(0),
       m_VBRate(0),
       m_Framerate(60),
       m_bInitialized(false),
@@ -263,7 +266,9 @@ const WindowPtr DisplayEngine::getWindow(unsigned i) const
 
 void DisplayEngine::endFrame()
 {
+    long long waitStartTime = TimeSource::get()->getCurrentMicrosecs();
     frameWait();
+    long long swapStartTime = TimeSource::get()->getCurrentMicrosecs();
     swapBuffers();
 #ifdef __APPLE__
     // Hack/Workaround for bug #661: When the window is completely occluded, mac
@@ -276,6 +281,9 @@ void DisplayEngine::endFrame()
         }
     }
 #endif
+    m_LastSwapTime = TimeSource::get()->getCurrentMicrosecs();
+    m_LastWaitDuration = swapStartTime-waitStartTime;
+    m_LastSwapDuration = m_LastSwapTime-swapStartTime;
     checkJitter();
 }
 
@@ -341,6 +349,26 @@ long long DisplayEngine::getDisplayTime()
     return (m_LastFrameTime-m_StartTime)/1000;
 }
 
+float DisplayEngine::toDisplayTime(long long microsecs) const
+{
+    return (microsecs-m_StartTime)/1000.f;
+}
+
+long long DisplayEngine::getLastWaitDuration() const
+{
+    return m_LastWaitDuration;
+}
+
+long long DisplayEngine::getLastSwapDuration() const
+{
+    return m_LastSwapDuration;
+}
+
+long long DisplayEngine::getLastSwapTime() const
+{
+    return m_LastSwapTime;
+}
+
 const IntPoint& DisplayEngine::getSize() const
 {
     return m_Size;
@@ -73,6 +73,11 @@ class AVG_API DisplayEngine: public InputDevice
         void swapBuffers();
         void checkJitter();
         long long getDisplayTime();
+        // Converts a TimeSource timestamp to display time in milliseconds.
+        float toDisplayTime(long long microsecs) const;
+        long long getLastWaitDuration() const;
+        long long getLastSwapDuration() const;
+        long long getLastSwapTime() const;
 
         const IntPoint& getSize() const;
         IntPoint getWindowSize() const;
@@ -100,6 +105,9 @@ class AVG_API DisplayEngine: public InputDevice
         long long m_LastFrameTime;
         long long m_FrameWaitStartTime;
         long long m_TargetTime;
+        long long m_LastWaitDuration;
+        long long m_LastSwapDuration;
+        long long m_LastSwapTime;
         int m_VBRate;
         float m_Framerate;
         bool m_bInitialized;
@@ -192,6 +192,7 @@ void DivNode::reorderChild(NodePtr pChild, unsigned j)
     m_Children.erase(m_Children.begin()+i);
     std::vector<NodePtr>::iterator pos = m_Children.begin()+j;
     m_Children.insert(pos, pChild);
+    setCanvasContentChanged();
 }
 
 void DivNode::reorderChild(unsigned i, unsigned j)
@@ -204,6 +205,7 @@ void DivNode::reorderChild(unsigned i, unsigned j)
     m_Children.erase(m_Children.begin()+i);
     std::vector<NodePtr>::iterator pos = m_Children.begin()+j;
     m_Children.insert(pos, pChild);
+    setCanvasContentChanged();
 }
 
 unsigned DivNode::indexOf(NodePtr pChild)
@@ -264,6 +266,7 @@ bool DivNode::getCrop() const
 void DivNode::setCrop(bool bCrop)
 {
     m_bCrop = bCrop;
+    setCanvasContentChanged();
 }
 
 const UTF8String& DivNode::getMediaDir() const
@@ -39,7 +39,8 @@ namespace avg {
 EventDispatcher::EventDispatcher(Player* pPlayer, bool bMouseEnabled)
     : m_pPlayer(pPlayer),
       m_NumMouseButtonsDown(0),
-      m_bMouseEnabled(bMouseEnabled)
+      m_bMouseEnabled(bMouseEnabled),
+      m_NumCoalescedEvents(0)
 {
 }
 
@@ -60,6 +61,15 @@ void EventDispatcher::dispatch()
 
         for ( ; eventIt != curEvents.end(); eventIt++) {
             (*eventIt)->setInputDevice(pCurInputDevice);
+            CursorEventPtr pCursorEvent = dynamic_pointer_cast<CursorEvent>(*eventIt);
+            if (pCursorEvent) {
+                const vector<CursorEventPtr>& pCoalescedEvents = 
+                        pCursorEvent->getCoalescedEvents();
+                for (unsigned j = 0; j < pCoalescedEvents.size(); ++j) {
+                    pCoalescedEvents[j]->setInputDevice(pCurInputDevice);
+                }
+                m_NumCoalescedEvents += pCursorEvent->getNumCoalescedEvents();
+            }
         }
     }
 
@@ -101,6 +111,11 @@ ContactPtr EventDispatcher::getContact(int id)
     }
 }
 
+long long EventDispatcher::getNumCoalescedEvents() const
+{
+    return m_NumCoalescedEvents;
+}
+
 void EventDispatcher::handleEvent(EventPtr pEvent)
 {
     m_pPlayer->handleEvent(pEvent);
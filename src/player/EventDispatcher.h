@@ -49,6 +49,7 @@ class AVG_API EventDispatcher {
         void sendEvent(EventPtr pEvent);
         void enableMouse(bool bEnabled);
         ContactPtr getContact(int id);
+        long long getNumCoalescedEvents() const;
 
     private:
         void handleEvent(EventPtr pEvent);
@@ -61,6 +62,7 @@ class AVG_API EventDispatcher {
         std::map<int, ContactPtr> m_ContactMap;
         int m_NumMouseButtonsDown;
         bool m_bMouseEnabled;
+        long long m_NumCoalescedEvents;
 };
 typedef boost::shared_ptr<EventDispatcher> EventDispatcherPtr;
 
@@ -99,6 +99,11 @@ void FXNode::resetDirty()
     m_bDirty = false;
 }
 
+string FXNode::getCacheKey() const
+{
+    return "";
+}
+
 FBOPtr FXNode::getFBO(GLContext* pContext)
 {
     return m_pFilter->getFBO(pContext);
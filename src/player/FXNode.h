@@ -28,6 +28,7 @@
 #include "../base/Rect.h"
 
 #include <boost/shared_ptr.hpp>
+#include <string>
 
 namespace avg {
 
@@ -59,6 +60,10 @@ public:
     bool isDirty() const;
     void resetDirty();
 
+    // Identifies the effect and its parameters. Nodes with identical sources and 
+    // identical keys can share one result. An empty key disables sharing.
+    virtual std::string getCacheKey() const;
+
 protected:
     FBOPtr getFBO(GLContext* pContext);
     void setDirty();
@@ -154,6 +154,9 @@ void FilledVectorNode::preRender(const VertexArrayPtr& pVA, bool bIsParentActive
         if ((m_EffectiveOpacity <= 0.01) && (curOpacity > 0.01)) {
             setDrawNeeded();
         }
+        if (curOpacity != m_EffectiveOpacity) {
+            setCanvasContentChanged();
+        }
         m_EffectiveOpacity = curOpacity;
         checkRedraw();
     }
@@ -0,0 +1,254 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "FrameStats.h"
+
+#include "DisplayEngine.h"
+
+#include "../base/Exception.h"
+#include "../base/TimeSource.h"
+#include "../graphics/RenderStats.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace avg {
+
+FrameRecord::FrameRecord()
+    : m_FrameNum(0),
+      m_Duration(0),
+      m_TimersTime(0),
+      m_EventsTime(0),
+      m_OffscreenTime(0),
+      m_RenderTime(0),
+      m_WaitTime(0),
+      m_SwapTime(0),
+      m_NumDrawCalls(0),
+      m_NumTexUploads(0),
+      m_BytesMoved(0),
+      m_NumFXRenders(0),
+      m_MissedVBlanks(0)
+{
+}
+
+FrameStats::PhaseTimer::PhaseTimer(long long& phaseTime)
+    : m_PhaseTime(phaseTime),
+      m_StartTime(TimeSource::get()->getCurrentMicrosecs())
+{
+}
+
+FrameStats::PhaseTimer::~PhaseTimer()
+{
+    m_PhaseTime += TimeSource::get()->getCurrentMicrosecs()-m_StartTime;
+}
+
+FrameStats::FrameStats()
+    : m_WindowSize(300),
+      m_LastSwapTime(0),
+      m_bGPUTimersEnabled(true)
+{
+}
+
+FrameStats::~FrameStats()
+{
+}
+
+FrameRecord& FrameStats::startFrame(long long frameNum)
+{
+    m_CurFrame = FrameRecord();
+    m_CurFrame.m_FrameNum = frameNum;
+    return m_CurFrame;
+}
+
+void FrameStats::endFrame(DisplayEngine* pDisplayEngine)
+{
+    m_CurFrame.m_WaitTime = pDisplayEngine->getLastWaitDuration();
+    m_CurFrame.m_SwapTime = pDisplayEngine->getLastSwapDuration();
+
+    long long swapTime = pDisplayEngine->getLastSwapTime();
+    if (m_LastSwapTime != 0) {
+        m_CurFrame.m_Duration = swapTime-m_LastSwapTime;
+        float framerate = pDisplayEngine->getFramerate();
+        if (framerate > 0) {
+            float frameInterval = 1000000/framerate;
+            int numIntervals = int(m_CurFrame.m_Duration/frameInterval+0.5f);
+            m_CurFrame.m_MissedVBlanks = max(numIntervals-1, 0);
+        }
+    }
+    m_LastSwapTime = swapTime;
+
+    float swapDisplayTime = pDisplayEngine->toDisplayTime(swapTime);
+    for (unsigned i=0; i<m_PendingInputTimes.size(); ++i) {
+        m_CurFrame.m_InputLatencies.push_back(swapDisplayTime-m_PendingInputTimes[i]);
+    }
+    m_PendingInputTimes.clear();
+
+    RenderStats::Counters counters = RenderStats::getAndReset();
+    m_CurFrame.m_NumDrawCalls = counters.m_NumDrawCalls;
+    m_CurFrame.m_NumTexUploads = counters.m_NumTexUploads;
+    m_CurFrame.m_BytesMoved = counters.m_BytesMoved;
+    m_CurFrame.m_NumFXRenders = counters.m_NumFXRenders;
+
+    for (GPUTimerMap::iterator it = m_GPUTimers.begin(); it != m_GPUTimers.end(); ++it) 
+    {
+        long long gpuTime = it->second->getLastResult();
+        if (gpuTime != -1) {
+            m_CurFrame.m_GPUTimes[it->first] = gpuTime;
+        }
+    }
+
+    m_Frames.push_back(m_CurFrame);
+    while (int(m_Frames.size()) > m_WindowSize) {
+        m_Frames.pop_front();
+    }
+}
+
+void FrameStats::reset()
+{
+    m_Frames.clear();
+    m_PendingInputTimes.clear();
+    m_LastSwapTime = 0;
+    // The timers belong to the GL context, so this must be called while it's alive.
+    m_GPUTimers.clear();
+    RenderStats::getAndReset();
+}
+
+void FrameStats::beginGPUTimer(const string& sCanvasID)
+{
+    if (!m_bGPUTimersEnabled) {
+        return;
+    }
+    GPUTimerMap::iterator it = m_GPUTimers.find(sCanvasID);
+    if (it == m_GPUTimers.end()) {
+        if (!GPUTimer::isSupported()) {
+            m_bGPUTimersEnabled = false;
+            return;
+        }
+        it = m_GPUTimers.insert(make_pair(sCanvasID, GPUTimerPtr(new GPUTimer))).first;
+    }
+    it->second->begin();
+}
+
+void FrameStats::endGPUTimer(const string& sCanvasID)
+{
+    if (!m_bGPUTimersEnabled) {
+        return;
+    }
+    m_GPUTimers[sCanvasID]->end();
+}
+
+void FrameStats::addInputEvent(long long when)
+{
+    m_PendingInputTimes.push_back(when);
+}
+
+void FrameStats::setWindowSize(int numFrames)
+{
+    if (numFrames < 1) {
+        throw Exception(AVG_ERR_OUT_OF_RANGE, 
+                "FrameStats.windowSize must be at least 1.");
+    }
+    m_WindowSize = numFrames;
+    while (int(m_Frames.size()) > m_WindowSize) {
+        m_Frames.pop_front();
+    }
+}
+
+int FrameStats::getWindowSize() const
+{
+    return m_WindowSize;
+}
+
+void FrameStats::setGPUTimersEnabled(bool bEnabled)
+{
+    m_bGPUTimersEnabled = bEnabled;
+    if (!bEnabled) {
+        m_GPUTimers.clear();
+    }
+}
+
+bool FrameStats::getGPUTimersEnabled() const
+{
+    return m_bGPUTimersEnabled;
+}
+
+FrameRecordVector FrameStats::getFrames() const
+{
+    return FrameRecordVector(m_Frames.begin(), m_Frames.end());
+}
+
+FrameRecord FrameStats::getLastFrame() const
+{
+    if (m_Frames.empty()) {
+        throw Exception(AVG_ERR_UNSUPPORTED, 
+                "FrameStats.getLastFrame(): No frame has been rendered yet.");
+    }
+    return m_Frames.back();
+}
+
+int FrameStats::getNumMissedVBlanks() const
+{
+    int numMissed = 0;
+    for (deque<FrameRecord>::const_iterator it = m_Frames.begin(); 
+            it != m_Frames.end(); ++it)
+    {
+        numMissed += it->m_MissedVBlanks;
+    }
+    return numMissed;
+}
+
+vector<int> FrameStats::getFrameTimeHistogram() const
+{
+    vector<int> histogram(NUM_HISTOGRAM_BUCKETS, 0);
+    for (deque<FrameRecord>::const_iterator it = m_Frames.begin(); 
+            it != m_Frames.end(); ++it)
+    {
+        // The first frame has no previous swap to measure against. Its duration is 0
+        // and it's left out.
+        if (it->m_Duration > 0) {
+            addToHistogram(histogram, it->m_Duration/1000.f);
+        }
+    }
+    return histogram;
+}
+
+vector<int> FrameStats::getLatencyHistogram() const
+{
+    vector<int> histogram(NUM_HISTOGRAM_BUCKETS, 0);
+    for (deque<FrameRecord>::const_iterator it = m_Frames.begin(); 
+            it != m_Frames.end(); ++it)
+    {
+        for (unsigned i=0; i<it->m_InputLatencies.size(); ++i) {
+            addToHistogram(histogram, it->m_InputLatencies[i]);
+        }
+    }
+    return histogram;
+}
+
+void FrameStats::addToHistogram(vector<int>& histogram, float millisecs)
+{
+    int bucket = min(max(int(millisecs), 0), NUM_HISTOGRAM_BUCKETS-1);
+    histogram[bucket]++;
+}
+
+}
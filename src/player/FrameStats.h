@@ -0,0 +1,122 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _FrameStats_H_
+#define _FrameStats_H_
+
+#include "../api.h"
+
+#include "../graphics/GPUTimer.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace avg {
+
+class DisplayEngine;
+
+// Statistics for one frame. Times are in microseconds, latencies in milliseconds.
+struct AVG_API FrameRecord {
+    FrameRecord();
+
+    long long m_FrameNum;
+    long long m_Duration;
+    long long m_TimersTime;
+    long long m_EventsTime;
+    long long m_OffscreenTime;
+    long long m_RenderTime;
+    long long m_WaitTime;
+    long long m_SwapTime;
+    // GPU time per canvas, keyed by canvas id. The main canvas has the id "".
+    std::map<std::string, long long> m_GPUTimes;
+    int m_NumDrawCalls;
+    int m_NumTexUploads;
+    long long m_BytesMoved;
+    int m_NumFXRenders;
+    int m_MissedVBlanks;
+    std::vector<float> m_InputLatencies;
+};
+
+typedef std::vector<FrameRecord> FrameRecordVector;
+
+// Per-frame instrumentation maintained by the Player. The statistics of the last
+// getWindowSize() frames are kept so apps can detect stutter in production.
+class AVG_API FrameStats {
+public:
+    // Adds the time spent in its scope to a field of the current frame record.
+    class PhaseTimer {
+    public:
+        PhaseTimer(long long& phaseTime);
+        ~PhaseTimer();
+
+    private:
+        long long& m_PhaseTime;
+        long long m_StartTime;
+    };
+
+    static const int NUM_HISTOGRAM_BUCKETS = 100;
+
+    FrameStats();
+    virtual ~FrameStats();
+
+    FrameRecord& startFrame(long long frameNum);
+    void endFrame(DisplayEngine* pDisplayEngine);
+    void reset();
+
+    void beginGPUTimer(const std::string& sCanvasID);
+    void endGPUTimer(const std::string& sCanvasID);
+    void addInputEvent(long long when);
+
+    void setWindowSize(int numFrames);
+    int getWindowSize() const;
+    void setGPUTimersEnabled(bool bEnabled);
+    bool getGPUTimersEnabled() const;
+
+    FrameRecordVector getFrames() const;
+    FrameRecord getLastFrame() const;
+    int getNumMissedVBlanks() const;
+    // Frame durations and input latencies of the window in 1 ms buckets. The last
+    // bucket contains everything above.
+    std::vector<int> getFrameTimeHistogram() const;
+    std::vector<int> getLatencyHistogram() const;
+
+private:
+    static void addToHistogram(std::vector<int>& histogram, float millisecs);
+
+    FrameRecord m_CurFrame;
+    std::deque<FrameRecord> m_Frames;
+    int m_WindowSize;
+    long long m_LastSwapTime;
+    std::vector<long long> m_PendingInputTimes;
+
+    bool m_bGPUTimersEnabled;
+    typedef std::map<std::string, GPUTimerPtr> GPUTimerMap;
+    GPUTimerMap m_GPUTimers;
+};
+
+}
+
+#endif
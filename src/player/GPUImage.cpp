@@ -41,12 +41,16 @@ using namespace std;
 
 namespace avg {
 
-GPUImage::GPUImage(OGLSurface * pSurface, bool bUseMipmaps)
+GPUImage::GPUImage(OGLSurface * pSurface, bool bUseMipmaps, bool bUseLOD)
     : m_sFilename(""),
       m_pSurface(pSurface),
       m_State(CPU),
       m_Source(NONE),
-      m_bUseMipmaps(bUseMipmaps)
+      m_bUseMipmaps(bUseMipmaps),
+      m_bUseLOD(bUseLOD),
+      m_Level(0),
+      m_DisplaySize(0,0),
+      m_Compression(TEXCOMPRESSION_NONE)
 {
     ObjectCounter::get()->incRef(&typeid(*this));
     assertValid();
@@ -107,7 +111,12 @@ void GPUImage::setEmpty()
 void GPUImage::setFilename(const std::string& sFilename, TexCompression comp)
 {
     assertValid();
-    CachedImagePtr pImage = ImageCache::get()->getImage(sFilename, comp);
+    ImageCache* pCache = ImageCache::get();
+    int level = 0;
+    if (m_bUseLOD) {
+        level = calcLevel(pCache->getImageSize(sFilename));
+    }
+    CachedImagePtr pImage = pCache->getImage(sFilename, comp, level);
     BitmapPtr pBmp = pImage->getBmp();
     if (comp == TEXCOMPRESSION_B5G6R5 && pBmp->hasAlpha()) {
         pImage->decBmpRef();
@@ -120,6 +129,8 @@ void GPUImage::setFilename(const std::string& sFilename, TexCompression comp)
     changeSource(FILE);
 
     m_sFilename = sFilename;
+    m_Level = level;
+    m_Compression = comp;
 
     if (m_State == GPU) {
         m_pSurface->destroy();
@@ -182,6 +193,44 @@ const string& GPUImage::getFilename() const
     return m_sFilename;
 }
 
+bool GPUImage::setDisplaySize(const glm::vec2& size)
+{
+    m_DisplaySize = size;
+    if (!m_bUseLOD || m_Source != FILE) {
+        return false;
+    }
+    int level = calcLevel(m_pImage->getFullSize());
+    if (level == m_Level) {
+        return false;
+    }
+    ImageCache* pCache = ImageCache::get();
+    CachedImagePtr pImage = pCache->getImageIfLoaded(m_sFilename, m_Compression, level);
+    if (!pImage) {
+        // Keep displaying the current level until the new one has been loaded.
+        pCache->requestImage(m_sFilename, m_Compression, level);
+        return false;
+    }
+    assertValid();
+    if (m_State == GPU) {
+        m_pImage->decTexRef();
+        m_pSurface->destroy();
+    }
+    m_pImage->decBmpRef();
+    m_pImage = pImage;
+    m_pBmp = m_pImage->getBmp();
+    m_Level = level;
+    if (m_State == GPU) {
+        setupImageSurface();
+    }
+    assertValid();
+    return true;
+}
+
+int GPUImage::getLevel() const
+{
+    return m_Level;
+}
+
 BitmapPtr GPUImage::getBitmap()
 {
     if (m_Source == NONE || m_Source == SCENE) {
@@ -199,6 +248,7 @@ IntPoint GPUImage::getSize()
         case SCENE:
             return m_pCanvas->getSize();
         case FILE:
+            return m_pImage->getFullSize();
         case BITMAP:
             return m_pBmp->getSize();
         default:
@@ -290,6 +340,27 @@ void GPUImage::unload()
     }
 }
 
+int GPUImage::calcLevel(const IntPoint& fullSize) const
+{
+    // Choose the smallest level that is still at least as large as the display size.
+    // Axes with a display size of 0 (i.e. unknown) don't constrain the level.
+    if (m_DisplaySize.x <= 0 && m_DisplaySize.y <= 0) {
+        return 0;
+    }
+    int level = 0;
+    while (true) {
+        IntPoint levelSize = CachedImage::getLevelSize(fullSize, level+1);
+        IntPoint curSize = CachedImage::getLevelSize(fullSize, level);
+        if (levelSize == curSize || 
+                (m_DisplaySize.x > 0 && levelSize.x < m_DisplaySize.x) ||
+                (m_DisplaySize.y > 0 && levelSize.y < m_DisplaySize.y))
+        {
+            return level;
+        }
+        level++;
+    }
+}
+
 void GPUImage::assertValid() const
 {
     AVG_ASSERT(m_pSurface);
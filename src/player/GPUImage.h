@@ -48,7 +48,7 @@ class AVG_API GPUImage
         enum State {CPU, GPU};
         enum Source {NONE, FILE, BITMAP, SCENE};
 
-        GPUImage(OGLSurface * pSurface, bool bUseMipmaps);
+        GPUImage(OGLSurface * pSurface, bool bUseMipmaps, bool bUseLOD=false);
         virtual ~GPUImage();
 
         virtual void moveToGPU();
@@ -63,6 +63,11 @@ class AVG_API GPUImage
         OffscreenCanvasPtr getCanvas() const;
         const std::string& getFilename() const;
 
+        // With LOD enabled, file images are loaded at the smallest level that covers
+        // the display size. Returns true if the level and thus the surface changed.
+        bool setDisplaySize(const glm::vec2& size);
+        int getLevel() const;
+
         BitmapPtr getBitmap();
         IntPoint getSize();
         PixelFormat getPixelFormat();
@@ -76,6 +81,7 @@ class AVG_API GPUImage
         bool changeSource(Source newSource);
         void unload();
         void assertValid() const;
+        int calcLevel(const IntPoint& fullSize) const;
 
         std::string m_sFilename;
         CachedImagePtr m_pImage;
@@ -87,6 +93,10 @@ class AVG_API GPUImage
         State m_State;
         Source m_Source;
         bool m_bUseMipmaps;
+        bool m_bUseLOD;
+        int m_Level;
+        glm::vec2 m_DisplaySize;
+        TexCompression m_Compression;
 };
 
 typedef boost::shared_ptr<GPUImage> GPUImagePtr;
@@ -138,6 +138,14 @@ std::string HueSatFXNode::toString()
     return s.str();
 }
 
+std::string HueSatFXNode::getCacheKey() const
+{
+    stringstream s;
+    s << "HueSatFXNode(" << m_fHue << ", " << m_fSaturation << ", " 
+            << m_fLightnessOffset << ", " << m_bColorize << ")";
+    return s.str();
+}
+
 int HueSatFXNode::clamp(int val, int min, int max)
 {
     int result = val;
@@ -52,6 +52,7 @@ public:
     bool isColorizing();
 
     std::string toString();
+    virtual std::string getCacheKey() const;
 
 private:
     virtual GPUFilterPtr createFilter(const IntPoint& size);
@@ -52,7 +52,8 @@ void ImageNode::registerType()
     TypeDefinition def = TypeDefinition("image", "rasternode", 
             ExportedObject::buildObject<ImageNode>)
         .addArg(Arg<UTF8String>("href", "", false, offsetof(ImageNode, m_href)))
-        .addArg(Arg<string>("compression", "none"));
+        .addArg(Arg<string>("compression", "none"))
+        .addArg(Arg<bool>("lod", false, false, offsetof(ImageNode, m_bUseLOD)));
     TypeRegistry::get()->registerType(def);
 }
 
@@ -61,8 +62,9 @@ ImageNode::ImageNode(const ArgList& args, const string& sPublisherName)
       m_Compression(TEXCOMPRESSION_NONE)
 {
     args.setMembers(this);
-    m_pGPUImage = GPUImagePtr(new GPUImage(getSurface(), getMipmap()));
+    m_pGPUImage = GPUImagePtr(new GPUImage(getSurface(), getMipmap(), m_bUseLOD));
     m_Compression = string2TexCompression(args.getArgVal<string>("compression"));
+    m_pGPUImage->setDisplaySize(getUserSize());
     setHRef(m_href);
     ObjectCounter::get()->incRef(&typeid(*this));
 }
@@ -102,7 +104,7 @@ void ImageNode::disconnect(bool bKill)
     }
     if (bKill) {
         RasterNode::disconnect(bKill);
-        m_pGPUImage = GPUImagePtr(new GPUImage(getSurface(), getMipmap()));
+        m_pGPUImage = GPUImagePtr(new GPUImage(getSurface(), getMipmap(), m_bUseLOD));
         m_href = "";
     } else {
         m_pGPUImage->moveToCPU();
@@ -140,6 +142,16 @@ const string ImageNode::getCompression() const
     return texCompression2String(m_Compression);
 }
 
+bool ImageNode::getLOD() const
+{
+    return m_bUseLOD;
+}
+
+int ImageNode::getLODLevel() const
+{
+    return m_pGPUImage->getLevel();
+}
+
 void ImageNode::setBitmap(BitmapPtr pBmp)
 {
     if (m_pGPUImage->getSource() == GPUImage::SCENE && getState() == Node::NS_CANRENDER) {
@@ -161,6 +173,9 @@ void ImageNode::preRender(const VertexArrayPtr& pVA, bool bIsParentActive,
     ScopeTimer timer(PrerenderProfilingZone);
     AreaNode::preRender(pVA, bIsParentActive, parentEffectiveOpacity);
     if (isVisible() && m_pGPUImage->getSource() != GPUImage::NONE) {
+        if (m_pGPUImage->setDisplaySize(getSize())) {
+            newSurface();
+        }
         if (m_pGPUImage->getCanvas()) {
             // Force FX render every frame for canvas nodes.
             getSurface()->setDirty();
@@ -190,6 +205,20 @@ GPUImage::Source ImageNode::getSource() const
     return m_pGPUImage->getSource();
 }
 
+string ImageNode::getFXSourceKey()
+{
+    // Images loaded from the same file have separate textures with identical 
+    // contents, so their effect results can be shared.
+    if (getSource() == GPUImage::FILE) {
+        stringstream ss;
+        ss << "file:" << m_pGPUImage->getFilename() << ":" << getLODLevel() << ":" 
+                << getCompression() << ":" << getSurface()->getParamCacheKey();
+        return ss.str();
+    } else {
+        return RasterNode::getFXSourceKey();
+    }
+}
+
 string ImageNode::dump(int indent)
 {
     string dumpStr = AreaNode::dump(indent);
@@ -51,6 +51,8 @@ class AVG_API ImageNode : public RasterNode
         const UTF8String& getHRef() const;
         void setHRef(const UTF8String& href);
         const std::string getCompression() const;
+        bool getLOD() const;
+        int getLODLevel() const;
         void setBitmap(BitmapPtr pBmp);
         
         virtual void preRender(const VertexArrayPtr& pVA, bool bIsParentActive, 
@@ -63,6 +65,7 @@ class AVG_API ImageNode : public RasterNode
         virtual BitmapPtr getBitmap();
         virtual IntPoint getMediaSize();
         GPUImage::Source getSource() const;
+        virtual std::string getFXSourceKey();
 
         virtual std::string dump(int indent = 0);
 
@@ -72,6 +75,7 @@ class AVG_API ImageNode : public RasterNode
 
         UTF8String m_href;
         TexCompression m_Compression;
+        bool m_bUseLOD;
         GPUImagePtr m_pGPUImage;
 };
 
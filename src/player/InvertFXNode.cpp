@@ -63,5 +63,10 @@ std::string InvertFXNode::toString()
     return s.str();
 }
 
+std::string InvertFXNode::getCacheKey() const
+{
+    return "InvertFXNode";
+}
+
 }
 
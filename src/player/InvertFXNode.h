@@ -43,6 +43,7 @@ public:
     virtual void disconnect();
 
     std::string toString();
+    virtual std::string getCacheKey() const;
 
 private:
     virtual GPUFilterPtr createFilter(const IntPoint& size);
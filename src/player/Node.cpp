@@ -70,6 +70,8 @@ void Node::registerType()
     pPubDef->addMessage("PEN_OVER");
     pPubDef->addMessage("PEN_OUT");
     pPubDef->addMessage("END_OF_FILE");
+    pPubDef->addMessage("STREAM_READY");
+    pPubDef->addMessage("STREAM_ERROR");
     pPubDef->addMessage("SIZE_CHANGED");
     pPubDef->addMessage("KILLED");
 
@@ -85,7 +87,9 @@ Node::Node(const string& sPublisherName)
     : Publisher(sPublisherName),
       m_pParent(0),
       m_pCanvas(),
-      m_State(NS_UNCONNECTED)
+      m_State(NS_UNCONNECTED),
+      m_EffectiveOpacity(0),
+      m_bEffectiveActive(false)
 {
     ObjectCounter::get()->incRef(&typeid(*this));
 }
@@ -162,12 +166,15 @@ void Node::connect(CanvasPtr pCanvas)
 {
     m_pCanvas = pCanvas;
     setState(NS_CONNECTED);
+    pCanvas->setContentChanged();
 }
 
 void Node::disconnect(bool bKill)
 {
     AVG_ASSERT(getState() != NS_UNCONNECTED);
-    m_pCanvas.lock()->removeNodeID(getID());
+    CanvasPtr pCanvas = m_pCanvas.lock();
+    pCanvas->removeNodeID(getID());
+    pCanvas->setContentChanged();
     setState(NS_UNCONNECTED);
     if (bKill) {
         m_EventHandlerMap.clear();
@@ -371,8 +378,15 @@ void Node::getElementsByPos(const glm::vec2& pos, NodeChainPtr& pElements)
 void Node::preRender(const VertexArrayPtr& pVA, bool bIsParentActive, 
         float parentEffectiveOpacity)
 {
-    m_EffectiveOpacity = m_Opacity*parentEffectiveOpacity;
-    m_bEffectiveActive = bIsParentActive && m_bActive;
+    float effectiveOpacity = m_Opacity*parentEffectiveOpacity;
+    bool bEffectiveActive = bIsParentActive && m_bActive;
+    if (effectiveOpacity != m_EffectiveOpacity || 
+            bEffectiveActive != m_bEffectiveActive)
+    {
+        setCanvasContentChanged();
+    }
+    m_EffectiveOpacity = effectiveOpacity;
+    m_bEffectiveActive = bEffectiveActive;
 }
 
 Node::NodeState Node::getState() const
@@ -385,6 +399,14 @@ CanvasPtr Node::getCanvas() const
     return m_pCanvas.lock();
 }
 
+void Node::setCanvasContentChanged()
+{
+    CanvasPtr pCanvas = m_pCanvas.lock();
+    if (pCanvas) {
+        pCanvas->setContentChanged();
+    }
+}
+
 bool Node::handleEvent(EventPtr pEvent)
 {
     if (pEvent->getSource() != Event::NONE && pEvent->getSource() != Event::CUSTOM) {
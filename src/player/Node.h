@@ -146,6 +146,7 @@ class AVG_API Node: public Publisher
         virtual bool isVisible() const;
         bool getEffectiveActive() const;
         NodePtr getSharedThis();
+        void setCanvasContentChanged();
 
         void logFileNotFoundWarning(const std::string& sWarn) const;
 
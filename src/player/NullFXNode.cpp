@@ -53,6 +53,11 @@ void NullFXNode::disconnect()
     FXNode::disconnect();
 }
 
+string NullFXNode::getCacheKey() const
+{
+    return "NullFXNode";
+}
+
 GPUFilterPtr NullFXNode::createFilter(const IntPoint& size)
 {
     m_pFilter = GPUNullFilterPtr(new GPUNullFilter(size, false));
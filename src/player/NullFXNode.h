@@ -27,6 +27,7 @@
 #include "FXNode.h"
 
 #include <boost/shared_ptr.hpp>
+#include <string>
 
 namespace avg {
 
@@ -41,6 +42,8 @@ public:
     virtual void connect();
     virtual void disconnect();
 
+    virtual std::string getCacheKey() const;
+
 private:
     virtual GPUFilterPtr createFilter(const IntPoint& size);
 
@@ -53,7 +53,8 @@ OGLSurface::OGLSurface(const WrapMode& wrapMode)
       m_Gamma(1,1,1,1),
       m_Brightness(1,1,1),
       m_Contrast(1,1,1),
-      m_bIsDirty(true)
+      m_bIsDirty(true),
+      m_Version(0)
 {
     ObjectCounter::get()->incRef(&typeid(*this));
 }
@@ -66,6 +67,9 @@ OGLSurface::~OGLSurface()
 void OGLSurface::create(PixelFormat pf, MCTexturePtr pTex0, MCTexturePtr pTex1, 
         MCTexturePtr pTex2, MCTexturePtr pTex3, bool bPremultipliedAlpha)
 {
+    // Fold in the versions of the textures we're replacing so the content version
+    // keeps increasing.
+    m_Version += getTextureVersions()+1;
     m_pf = pf;
     m_Size = pTex0->getSize();
     m_pMCTextures[0] = pTex0;
@@ -90,12 +94,14 @@ void OGLSurface::create(PixelFormat pf, MCTexturePtr pTex0, MCTexturePtr pTex1,
 
 void OGLSurface::setMask(MCTexturePtr pTex)
 {
+    m_Version += getTextureVersions()+1;
     m_pMaskMCTexture = pTex;
     m_bIsDirty = true;
 }
 
 void OGLSurface::destroy()
 {
+    m_Version += getTextureVersions()+1;
     m_pMCTextures[0] = MCTexturePtr();
     m_pMCTextures[1] = MCTexturePtr();
     m_pMCTextures[2] = MCTexturePtr();
@@ -177,6 +183,7 @@ void OGLSurface::setMaskCoords(glm::vec2 maskPos, glm::vec2 maskSize)
     m_MaskPos = maskPos;
     m_MaskSize = maskSize;
     m_bIsDirty = true;
+    m_Version++;
 }
 
 PixelFormat OGLSurface::getPixelFormat()
@@ -215,12 +222,14 @@ void OGLSurface::setColorParams(const glm::vec3& gamma, const glm::vec3& brightn
             fabs(m_Contrast.x-1.0) > 0.00001 || fabs(m_Contrast.y-1.0) > 0.00001 ||
             fabs(m_Contrast.z-1.0) > 0.00001);
     m_bIsDirty = true;
+    m_Version++;
 }
 
 void OGLSurface::setAlphaGamma(float gamma)
 {
     m_Gamma.w = 1.f/gamma;
     m_bIsDirty = true;
+    m_Version++;
 }
 
 bool OGLSurface::isDirty() const
@@ -236,6 +245,8 @@ bool OGLSurface::isDirty() const
 
 void OGLSurface::setDirty()
 {
+    // Doesn't change the content version: Callers use this to force an FX update of 
+    // canvas images, and canvas changes are tracked by the canvas dependency graph.
     m_bIsDirty = true;
 }
 
@@ -247,6 +258,56 @@ void OGLSurface::resetDirty()
     }
 }
 
+bool OGLSurface::isReady() const
+{
+    for (unsigned i=0; i<4; ++i) {
+        if (m_pMCTextures[i] && !m_pMCTextures[i]->isReady()) {
+            return false;
+        }
+    }
+    return !m_pMaskMCTexture || m_pMaskMCTexture->isReady();
+}
+
+string OGLSurface::getCacheKey() const
+{
+    stringstream ss;
+    for (unsigned i=0; i<getNumPixelFormatPlanes(m_pf); ++i) {
+        ss << m_pMCTextures[i].get() << ",";
+    }
+    ss << getParamCacheKey();
+    return ss.str();
+}
+
+string OGLSurface::getParamCacheKey() const
+{
+    stringstream ss;
+    ss << m_pf << ":" << m_pMaskMCTexture.get();
+    if (m_pMaskMCTexture) {
+        ss << m_MaskPos << m_MaskSize;
+    }
+    ss << ":" << m_bPremultipliedAlpha << ":" << m_Gamma << m_Brightness << m_Contrast;
+    return ss.str();
+}
+
+unsigned OGLSurface::getContentVersion() const
+{
+    return m_Version+getTextureVersions();
+}
+
+unsigned OGLSurface::getTextureVersions() const
+{
+    unsigned version = 0;
+    for (unsigned i=0; i<4; ++i) {
+        if (m_pMCTextures[i]) {
+            version += m_pMCTextures[i]->getContentVersion();
+        }
+    }
+    if (m_pMaskMCTexture) {
+        version += m_pMaskMCTexture->getContentVersion();
+    }
+    return version;
+}
+
 glm::mat4 OGLSurface::calcColorspaceMatrix() const
 {
     glm::mat4 mat;
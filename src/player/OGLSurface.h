@@ -29,6 +29,7 @@
 #include "../graphics/WrapMode.h"
 
 #include <boost/shared_ptr.hpp>
+#include <string>
 
 namespace avg {
 
@@ -63,9 +64,19 @@ public:
     bool isDirty() const;
     void setDirty();
     void resetDirty();
+    // False while the initial upload of a texture is pending.
+    bool isReady() const;
+
+    // Identifies the textures and rendering parameters of the surface.
+    std::string getCacheKey() const;
+    // Identifies the rendering parameters only.
+    std::string getParamCacheKey() const;
+    // Changes whenever the surface displays something different.
+    unsigned getContentVersion() const;
 
 private:
     glm::mat4 calcColorspaceMatrix() const;
+    unsigned getTextureVersions() const;
 
     MCTexturePtr m_pMCTextures[4];
     IntPoint m_Size;
@@ -82,7 +93,7 @@ private:
     glm::vec3 m_Contrast;
 
     bool m_bIsDirty;
-
+    unsigned m_Version;
 };
 
 }
@@ -31,6 +31,7 @@
 #include "../base/ProfilingZoneID.h"
 #include "../base/ObjectCounter.h"
 #include "../base/ScopeTimer.h"
+#include "../base/TimeSource.h"
 
 #include "../graphics/FilterUnmultiplyAlpha.h"
 #include "../graphics/BitmapLoader.h"
@@ -49,7 +50,10 @@ namespace avg {
 OffscreenCanvas::OffscreenCanvas(Player * pPlayer)
     : Canvas(pPlayer),
       m_bIsRendered(false),
-      m_pCameraNodeRef(0)
+      m_pCameraNodeRef(0),
+      m_NumRenders(0),
+      m_NumSkippedFrames(0),
+      m_LastRenderTime(0)
 {
     ObjectCounter::get()->incRef(&typeid(*this));
 }
@@ -94,6 +98,7 @@ void OffscreenCanvas::initPlayback()
     }
     Canvas::initPlayback(numSamples);
     m_bIsRendered = false;
+    setContentChanged();
 }
 
 void OffscreenCanvas::stopPlayback(bool bIsAbort)
@@ -140,13 +145,41 @@ void OffscreenCanvas::setAutoRender(bool bAutoRender)
     dynamic_pointer_cast<OffscreenCanvasNode>(getRootNode())->setAutoRender(bAutoRender);
 }
 
+bool OffscreenCanvas::getSkipUnchanged() const
+{
+    return dynamic_pointer_cast<OffscreenCanvasNode>(getRootNode())->getSkipUnchanged();
+}
+
+void OffscreenCanvas::setSkipUnchanged(bool bSkipUnchanged)
+{
+    dynamic_pointer_cast<OffscreenCanvasNode>(getRootNode())->setSkipUnchanged(
+            bSkipUnchanged);
+}
+
 void OffscreenCanvas::manualRender()
 {
+    // An explicit render request always renders.
+    setContentChanged();
     emitPreRenderSignal(); 
     renderTree(); 
     emitFrameEndSignal(); 
 }
 
+int OffscreenCanvas::getNumRenders() const
+{
+    return m_NumRenders;
+}
+
+int OffscreenCanvas::getNumSkippedFrames() const
+{
+    return m_NumSkippedFrames;
+}
+
+float OffscreenCanvas::getLastRenderTime() const
+{
+    return m_LastRenderTime;
+}
+
 std::string OffscreenCanvas::getID() const
 {
     return getRootNode()->getID();
@@ -256,7 +289,9 @@ bool OffscreenCanvas::isMultisampleSupported()
 
 void OffscreenCanvas::dump() const
 {
-    cerr << "Canvas: " << getRootNode()->getID() << endl;
+    cerr << "Canvas: " << getRootNode()->getID() << " (renders: " << m_NumRenders 
+            << ", skipped: " << m_NumSkippedFrames << ", last render time: " 
+            << m_LastRenderTime << " ms)" << endl;
     for (unsigned i = 0; i < m_pDependentCanvases.size(); ++i) {
         cerr << " " << m_pDependentCanvases[i]->getRootNode()->getID() << endl;
     }
@@ -270,7 +305,13 @@ void OffscreenCanvas::renderTree()
         throw(Exception(AVG_ERR_UNSUPPORTED, 
                 "OffscreenCanvas::renderTree(): Player.play() needs to be called before rendering offscreen canvases."));
     }
+    long long startTime = TimeSource::get()->getCurrentMicrosecs();
     preRender();
+    if (m_bIsRendered && getSkipUnchanged() && !isContentChanged()) {
+        // Nothing visible changed since the last render, so the FBO is still valid.
+        m_NumSkippedFrames++;
+        return;
+    }
     DisplayEngine* pDisplayEngine = getPlayer()->getDisplayEngine();
     unsigned numWindows = pDisplayEngine->getNumWindows();
     for (unsigned i=0; i<numWindows; ++i) {
@@ -284,6 +325,15 @@ void OffscreenCanvas::renderTree()
     }
     GLContextManager::get()->reset();
     m_bIsRendered = true;
+    resetContentChanged();
+
+    // Canvases that display this one need to be rendered again. They come later in 
+    // the render order.
+    for (unsigned i = 0; i < m_pDependentCanvases.size(); ++i) {
+        m_pDependentCanvases[i]->setContentChanged();
+    }
+    m_NumRenders++;
+    m_LastRenderTime = (TimeSource::get()->getCurrentMicrosecs()-startTime)/1000.f;
 }
 
 }
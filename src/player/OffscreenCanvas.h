@@ -53,8 +53,14 @@ class AVG_API OffscreenCanvas: public Canvas
         bool getMipmap() const;
         bool getAutoRender() const;
         void setAutoRender(bool bAutoRender);
+        bool getSkipUnchanged() const;
+        void setSkipUnchanged(bool bSkipUnchanged);
         void manualRender(); // This is the render that can be called from python.
 
+        int getNumRenders() const;
+        int getNumSkippedFrames() const;
+        float getLastRenderTime() const;
+
         std::string getID() const;
         bool isRunning() const;
         MCTexturePtr getTex() const;
@@ -85,6 +91,10 @@ class AVG_API OffscreenCanvas: public Canvas
 
         bool m_bIsRendered;
         CameraNode* m_pCameraNodeRef;
+
+        int m_NumRenders;
+        int m_NumSkippedFrames;
+        float m_LastRenderTime;
 };
 
 typedef boost::shared_ptr<OffscreenCanvas> OffscreenCanvasPtr;
@@ -42,7 +42,9 @@ void OffscreenCanvasNode::registerType()
         .addArg(Arg<bool>("mipmap", false, false, 
                 offsetof(OffscreenCanvasNode, m_bMipmap)))
         .addArg(Arg<bool>("autorender", true, false,
-                offsetof(OffscreenCanvasNode, m_bAutoRender)));
+                offsetof(OffscreenCanvasNode, m_bAutoRender)))
+        .addArg(Arg<bool>("skipunchanged", false, false,
+                offsetof(OffscreenCanvasNode, m_bSkipUnchanged)));
     TypeRegistry::get()->registerType(def);
 }
 
@@ -82,4 +84,14 @@ void OffscreenCanvasNode::setAutoRender(bool bAutoRender)
     m_bAutoRender = bAutoRender;
 }
 
+bool OffscreenCanvasNode::getSkipUnchanged() const
+{
+    return m_bSkipUnchanged;
+}
+
+void OffscreenCanvasNode::setSkipUnchanged(bool bSkipUnchanged)
+{
+    m_bSkipUnchanged = bSkipUnchanged;
+}
+
 }
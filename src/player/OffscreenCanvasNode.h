@@ -41,12 +41,15 @@ class AVG_API OffscreenCanvasNode : public CanvasNode
         bool getMipmap() const;
         bool getAutoRender() const;
         void setAutoRender(bool bAutoRender);
+        bool getSkipUnchanged() const;
+        void setSkipUnchanged(bool bSkipUnchanged);
 
     private:
         bool m_bHandleEvents;
         int m_MultiSampleSamples;
         bool m_bMipmap;
         bool m_bAutoRender;
+        bool m_bSkipUnchanged;
 };
 
 typedef boost::shared_ptr<OffscreenCanvasNode> OffscreenCanvasNodePtr;
@@ -72,6 +72,7 @@
 #include "../base/XMLHelper.h"
 #include "../base/ScopeTimer.h"
 #include "../base/WorkerThread.h"
+#include "../base/TaskPool.h"
 #include "../base/DAG.h"
 
 #include "../graphics/BitmapLoader.h"
@@ -115,6 +116,7 @@ Player::Player()
       m_bIsTraversingTree(false),
       m_pMultitouchInputDevice(),
       m_bInHandleTimers(false),
+      m_pCurrentTimeout(0),
       m_bCurrentTimeoutDeleted(false),
       m_bKeepWindowOpen(false),
       m_bStopOnEscape(true),
@@ -123,6 +125,7 @@ Player::Player()
       m_FakeFPS(0),
       m_FrameTime(0),
       m_Volume(1),
+      m_FXBudget(0),
       m_bPythonAvailable(true),
       m_pLastMouseEvent(new MouseEvent(Event::CURSOR_MOTION, false, false, false, 
             IntPoint(-1, -1), MouseEvent::NO_BUTTON, glm::vec2(-1, -1), 0)),
@@ -566,6 +569,7 @@ void Player::initPlayback()
 
     m_FrameTime = 0;
     m_NumFrames = 0;
+    m_FrameStats.reset();
 }
 
 bool Player::isPlaying()
@@ -631,6 +635,14 @@ void Player::addInputDevice(InputDevicePtr pSource)
     m_pEventDispatcher->addInputDevice(pSource);
 }
 
+long long Player::getNumCoalescedEvents() const
+{
+    if (!m_pEventDispatcher) {
+        return 0;
+    }
+    return m_pEventDispatcher->getNumCoalescedEvents();
+}
+
 long long Player::getFrameTime()
 {
     return m_FrameTime;
@@ -750,25 +762,21 @@ int Player::setOnFrameHandler(PyObject * pyfunc)
 
 bool Player::clearInterval(int id)
 {
-    vector<Timeout*>::iterator it;
-    for (it = m_PendingTimeouts.begin(); it != m_PendingTimeouts.end(); it++) {
-        if (id == (*it)->getID()) {
-            if (it == m_PendingTimeouts.begin() && m_bInHandleTimers) {
-                m_bCurrentTimeoutDeleted = true;
-            }
-            delete *it;
-            m_PendingTimeouts.erase(it);
-            return true;
+    if (m_pCurrentTimeout && m_pCurrentTimeout->getID() == id) {
+        // The timeout is firing at the moment. It's deleted in handleTimers().
+        if (m_bCurrentTimeoutDeleted) {
+            return false;
         }
+        m_bCurrentTimeoutDeleted = true;
+        return true;
     }
-    for (it = m_NewTimeouts.begin(); it != m_NewTimeouts.end(); it++) {
-        if (id == (*it)->getID()) {
-            delete *it;
-            m_NewTimeouts.erase(it);
-            return true;
-        }
+    Timeout* pTimeout = m_Timeouts.remove(id);
+    if (pTimeout) {
+        delete pTimeout;
+        return true;
+    } else {
+        return false;
     }
-    return false;
 }
 
 void Player::callFromThread(PyObject * pyfunc)
@@ -936,6 +944,9 @@ bool Player::handleEvent(EventPtr pEvent)
     }
 
     if (CursorEventPtr pCursorEvent = boost::dynamic_pointer_cast<CursorEvent>(pEvent)) {
+        if (pEvent->getSource() == Event::TOUCH) {
+            m_FrameStats.addInputEvent(pEvent->getWhen());
+        }
         if (pEvent->getType() == Event::CURSOR_OUT ||
                 pEvent->getType() == Event::CURSOR_OVER)
         {
@@ -988,8 +999,14 @@ void Player::doFrame(bool bFirstFrame)
 {
     {
         ScopeTimer Timer(MainProfilingZone);
+        FrameRecord& frameRecord = m_FrameStats.startFrame(m_NumFrames);
+        m_pContextManager->startFrame();
+        if (ImageCache::exists()) {
+            ImageCache::get()->processLoadedImages();
+        }
         if (!bFirstFrame) {
             m_NumFrames++;
+            frameRecord.m_FrameNum = m_NumFrames;
             if (m_bFakeFPS) {
                 m_FrameTime = (long long)((m_NumFrames*1000.0)/m_FakeFPS);
             } else {
@@ -997,22 +1014,40 @@ void Player::doFrame(bool bFirstFrame)
             }
             {
                 ScopeTimer Timer(TimersProfilingZone);
+                FrameStats::PhaseTimer phaseTimer(frameRecord.m_TimersTime);
                 handleTimers();
             }
             {
                 ScopeTimer Timer(EventsProfilingZone);
+                FrameStats::PhaseTimer phaseTimer(frameRecord.m_EventsTime);
                 m_pEventDispatcher->dispatch();
                 sendFakeEvents();
                 removeDeadEventCaptures();
             }
         }
-        for (unsigned i = 0; i < m_pCanvases.size(); ++i) {
-            ScopeTimer Timer(OffscreenProfilingZone);
-            dispatchOffscreenRendering(m_pCanvases[i].get());
+        {
+            FrameStats::PhaseTimer phaseTimer(frameRecord.m_OffscreenTime);
+            for (unsigned i = 0; i < m_pCanvases.size(); ++i) {
+                ScopeTimer Timer(OffscreenProfilingZone);
+                OffscreenCanvas* pCanvas = m_pCanvases[i].get();
+                m_FrameStats.beginGPUTimer(pCanvas->getID());
+                dispatchOffscreenRendering(pCanvas);
+                m_FrameStats.endGPUTimer(pCanvas->getID());
+            }
         }
         {
             ScopeTimer Timer(MainCanvasProfilingZone);
+            FrameStats::PhaseTimer phaseTimer(frameRecord.m_RenderTime);
+            // With several windows, the main canvas is rendered in several GL 
+            // contexts and a single timer query can't span them.
+            bool bTimeGPU = (m_DP.getNumWindows() == 1);
+            if (bTimeGPU) {
+                m_FrameStats.beginGPUTimer("");
+            }
             m_pMainCanvas->doFrame(m_bPythonAvailable);
+            if (bTimeGPU) {
+                m_FrameStats.endGPUTimer("");
+            }
         }
         GLContext::mandatoryCheckError("End of frame");
         if (m_bPythonAvailable) {
@@ -1027,6 +1062,7 @@ void Player::doFrame(bool bFirstFrame)
         } else {
             m_pDisplayEngine->endFrame();
         }
+        m_FrameStats.endFrame(m_pDisplayEngine.get());
     }
     ThreadProfiler::get()->reset();
     if (m_NumFrames == 5) {
@@ -1066,6 +1102,16 @@ size_t Player::getVideoMemUsed()
     return GLContext::getCurrent()->getVideoMemUsed();
 }
 
+MemUsageMap Player::getResourceMemUsage()
+{
+    return ObjectCounter::get()->getMemUsage();
+}
+
+FrameStats& Player::getFrameStats()
+{
+    return m_FrameStats;
+}
+
 void Player::setGamma(float red, float green, float blue)
 {
     if (m_pDisplayEngine) {
@@ -1514,32 +1560,37 @@ void Player::errorIfMultiDisplay(const string& sFunc) const
 
 void Player::handleTimers()
 {
-    vector<Timeout *>::iterator it;
     m_bInHandleTimers = true;
 
-    it = m_PendingTimeouts.begin();
-    while (it != m_PendingTimeouts.end() && (*it)->isReady(getFrameTime())
+    while (!m_Timeouts.empty() && m_Timeouts.top()->isReady(getFrameTime())
             && !m_bStopping)
     {
+        Timeout* pTimeout = m_Timeouts.pop();
+        m_pCurrentTimeout = pTimeout;
         m_bCurrentTimeoutDeleted = false;
-        (*it)->fire(getFrameTime());
-        if (m_bCurrentTimeoutDeleted) {
-            it = m_PendingTimeouts.begin();
-        } else {
-            if ((*it)->isInterval()) {
-                Timeout* pTempTimeout = *it;
-                it = m_PendingTimeouts.erase(it);
-                m_NewTimeouts.insert(m_NewTimeouts.begin(), pTempTimeout);
+        try {
+            pTimeout->fire(getFrameTime());
+        } catch (...) {
+            m_pCurrentTimeout = 0;
+            if (m_bCurrentTimeoutDeleted) {
+                delete pTimeout;
             } else {
-                delete *it;
-                it = m_PendingTimeouts.erase(it);
+                m_Timeouts.push(pTimeout);
             }
+            m_Timeouts.commitDeferred();
+            m_bInHandleTimers = false;
+            throw;
+        }
+        m_pCurrentTimeout = 0;
+        if (!m_bCurrentTimeoutDeleted && pTimeout->isInterval()) {
+            // Intervals fired this frame are rescheduled before timeouts that were
+            // added this frame.
+            m_Timeouts.pushDeferred(pTimeout, true);
+        } else {
+            delete pTimeout;
         }
     }
-    for (it = m_NewTimeouts.begin(); it != m_NewTimeouts.end(); ++it) {
-        addTimeout(*it);
-    }
-    m_NewTimeouts.clear();
+    m_Timeouts.commitDeferred();
     
     notifySubscribers("ON_FRAME");
     
@@ -1554,6 +1605,7 @@ void Player::handleTimers()
             m_AsyncCalls.clear();
         }
         Py_END_ALLOW_THREADS;
+        vector<Timeout *>::iterator it;
         for (it = tempAsyncCalls.begin(); it != tempAsyncCalls.end(); ++it) {
             (*it)->fire(getFrameTime());
             delete *it;
@@ -1594,6 +1646,39 @@ float Player::getVolume() const
     return m_Volume;
 }
 
+void Player::setFXBudget(int budget)
+{
+    if (budget < 0) {
+        throw Exception(AVG_ERR_OUT_OF_RANGE, 
+                "Player.fxBudget must be >= 0, is "+toString(budget)+".");
+    }
+    m_FXBudget = budget;
+}
+
+int Player::getFXBudget() const
+{
+    return m_FXBudget;
+}
+
+void Player::setTexUploadBudget(long long budget)
+{
+    if (budget < 0) {
+        throw Exception(AVG_ERR_OUT_OF_RANGE, 
+                "Player.texUploadBudget must be >= 0, is "+toString(budget)+".");
+    }
+    m_pContextManager->setTexUploadBudget(budget);
+}
+
+long long Player::getTexUploadBudget() const
+{
+    return m_pContextManager->getTexUploadBudget();
+}
+
+int Player::getNumDeferredTexUploads() const
+{
+    return m_pContextManager->getNumDeferredTexUploads();
+}
+
 string Player::getConfigOption(const string& sSubsys, const string& sName) const
 {
     const string* psValue = ConfigMgr::get()->getOption(sSubsys, sName);
@@ -1638,15 +1723,22 @@ OffscreenCanvasPtr Player::getCanvasFromURL(const std::string& sURL)
 void Player::cleanup(bool bIsAbort)
 {
     // Kill all timeouts.
-    vector<Timeout*>::iterator it;
-    for (it = m_PendingTimeouts.begin(); it != m_PendingTimeouts.end(); it++) {
-        delete *it;
-    }
-    m_PendingTimeouts.clear();
+    m_Timeouts.clear();
+    m_FrameStats.reset();
     m_EventCaptureInfoMap.clear();
     m_pLastCursorStates.clear();
     m_pTestHelper->reset();
     ThreadProfiler::get()->dumpStatistics();
+    if (TaskPool::exists()) {
+        TaskPool::get()->dumpStatistics();
+    }
+    if (TaskPool::backgroundExists()) {
+        TaskPool::getBackground()->dumpStatistics();
+    }
+    if (ThreadProfiler::get()->getNumZones() > 0) {
+        AVG_TRACE(Logger::category::PROFILE, Logger::severity::INFO,
+                ObjectCounter::get()->dumpMemUsage());
+    }
     for (unsigned i = 0; i < m_pCanvases.size(); ++i) {
         m_pCanvases[i]->stopPlayback(bIsAbort);
     }
@@ -1687,27 +1779,27 @@ void Player::cleanup(bool bIsAbort)
     m_CurDirName = getCWD();
 
     removeSubscribers();
+
+    if (Logger::get()->isAsync()) {
+        if (m_bPythonAvailable) {
+            Py_BEGIN_ALLOW_THREADS;
+            Logger::get()->flush();
+            Py_END_ALLOW_THREADS;
+        } else {
+            Logger::get()->flush();
+        }
+    }
 }
 
 int Player::internalSetTimeout(int time, PyObject * pyfunc, bool bIsInterval)
 {
     Timeout* pTimeout = new Timeout(time, pyfunc, bIsInterval, getFrameTime());
     if (m_bInHandleTimers) {
-        m_NewTimeouts.push_back(pTimeout);
+        // Timeouts added while handling timers don't fire before the next frame.
+        m_Timeouts.pushDeferred(pTimeout);
     } else {
-        addTimeout(pTimeout);
-    }
-    return pTimeout->getID();
-}
-
-
-int Player::addTimeout(Timeout* pTimeout)
-{
-    vector<Timeout*>::iterator it = m_PendingTimeouts.begin();
-    while (it != m_PendingTimeouts.end() && (**it)<*pTimeout) {
-        it++;
+        m_Timeouts.push(pTimeout);
     }
-    m_PendingTimeouts.insert(it, pTimeout);
     return pTimeout->getID();
 }
 
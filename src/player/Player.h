@@ -27,7 +27,10 @@
 #include "DisplayParams.h"
 #include "BoostPython.h"
 #include "Event.h"
+#include "TimeoutQueue.h"
+#include "FrameStats.h"
 
+#include "../base/ObjectCounter.h"
 #include "../audio/AudioParams.h"
 #include "../graphics/GLConfig.h"
 
@@ -150,6 +153,7 @@ class AVG_API Player: public Publisher
         void callFromThread(PyObject * pyfunc);
 
         void addInputDevice(InputDevicePtr pSource);
+        long long getNumCoalescedEvents() const;
         MouseEventPtr getMouseState() const;
         EventPtr getCurrentEvent() const;
         BitmapPtr getTouchUserBmp() const;
@@ -173,6 +177,8 @@ class AVG_API Player: public Publisher
         float getVideoRefreshRate();
         size_t getVideoMemInstalled();
         size_t getVideoMemUsed();
+        MemUsageMap getResourceMemUsage();
+        FrameStats& getFrameStats();
         void setGamma(float red, float green, float blue);
         DisplayEngine * getDisplayEngine() const;
         void keepWindowOpen();
@@ -180,6 +186,11 @@ class AVG_API Player: public Publisher
         bool getStopOnEscape() const;
         void setVolume(float volume);
         float getVolume() const;
+        void setFXBudget(int budget);
+        int getFXBudget() const;
+        void setTexUploadBudget(long long budget);
+        long long getTexUploadBudget() const;
+        int getNumDeferredTexUploads() const;
         std::string getConfigOption(const std::string& sSubsys, const std::string& sName)
                 const;
         bool isUsingGLES() const;
@@ -241,6 +252,7 @@ class AVG_API Player: public Publisher
 
         GLContextManagerPtr m_pContextManager;
         MainCanvasPtr m_pMainCanvas;
+        FrameStats m_FrameStats;
 
         DisplayEnginePtr m_pDisplayEngine;
         bool m_bDisplayEngineBroken;
@@ -254,13 +266,12 @@ class AVG_API Player: public Publisher
 
         // Timeout handling
         int internalSetTimeout(int time, PyObject * pyfunc, bool bIsInterval);
-        int addTimeout(Timeout* pTimeout);
         void handleTimers();
         bool m_bInHandleTimers;
+        Timeout* m_pCurrentTimeout;
         bool m_bCurrentTimeoutDeleted;
 
-        std::vector<Timeout *> m_PendingTimeouts;
-        std::vector<Timeout *> m_NewTimeouts; // Timeouts to be added this frame.
+        TimeoutQueue m_Timeouts;
         std::vector<Timeout *> m_AsyncCalls;
         boost::mutex m_AsyncCallMutex;
 
@@ -281,6 +292,7 @@ class AVG_API Player: public Publisher
         long long m_NumFrames;
 
         float m_Volume;
+        int m_FXBudget;
 
         bool m_bPythonAvailable;
 
@@ -38,6 +38,8 @@ PythonLogSink::PythonLogSink(PyObject *pyLogger):
 
 PythonLogSink::~PythonLogSink()
 {
+    // The last reference might be released by the log flusher thread.
+    aquirePyGIL aquireGil;
     Py_DecRef(m_pyLogger);
 }
 
@@ -44,6 +44,8 @@
 #include "../base/Exception.h"
 #include "../base/ScopeTimer.h"
 
+#include <sstream>
+
 using namespace std;
 using namespace boost;
 
@@ -81,7 +83,10 @@ RasterNode::RasterNode(const string& sPublisherName)
       m_Color(0,0,0,0),
       m_TileSize(-1,-1),
       m_pSubVA(0),
-      m_bFXDirty(true)
+      m_bFXDirty(true),
+      m_bFXDeferred(false),
+      m_bHasFXResult(false),
+      m_LastSurfaceVersion(0)
 {
 }
 
@@ -128,6 +133,8 @@ void RasterNode::disconnect(bool bKill)
     }
     m_pFBO = MCFBOPtr();
     m_pImagingProjection = ImagingProjectionPtr();
+    m_pSharedFXNode = FXNodePtr();
+    m_bHasFXResult = false;
     if (bKill) {
         m_pFXNode = FXNodePtr();
     } else {
@@ -207,6 +214,7 @@ void RasterNode::setWarpedVertexCoords(const VertexGrid& grid)
         m_pSubVA = new SubVertexArray();
     }
     m_TileVertices = grid;
+    setCanvasContentChanged();
 }
 
 void RasterNode::setMirror(MirrorType mirrorType)
@@ -257,6 +265,7 @@ void RasterNode::setBlendModeStr(const string& sBlendMode)
     }
     m_sBlendMode = sBlendMode;
     m_BlendMode = blendMode;
+    setCanvasContentChanged();
 }
 
 const UTF8String& RasterNode::getMaskHRef() const
@@ -365,53 +374,114 @@ void RasterNode::setEffect(FXNodePtr pFXNode)
         m_pFBO = MCFBOPtr();
     }
     m_pFXNode = pFXNode;
+    m_pSharedFXNode = FXNodePtr();
     if (getState() == NS_CANRENDER) {
         setupFX();
     }
+    setCanvasContentChanged();
+}
+
+FXNodePtr RasterNode::getEffect() const
+{
+    return m_pFXNode;
+}
+
+const string& RasterNode::updateFXCacheKey()
+{
+    string sFXKey = m_pFXNode->getCacheKey();
+    if (sFXKey.empty()) {
+        m_sFXCacheKey = "";
+    } else {
+        stringstream ss;
+        ss << getFXSourceKey() << "|" << getMediaSize() << "|" << m_Color << "|" 
+                << sFXKey;
+        m_sFXCacheKey = ss.str();
+    }
+    return m_sFXCacheKey;
+}
+
+string RasterNode::getFXSourceKey()
+{
+    return m_pSurface->getCacheKey();
+}
+
+const string& RasterNode::getFXCacheKey() const
+{
+    return m_sFXCacheKey;
+}
+
+bool RasterNode::needsFXRender() const
+{
+    return !m_bHasFXResult || m_bFXDirty || m_pSurface->isDirty() || 
+            m_pFXNode->isDirty() || m_sFXCacheKey != m_sFXResultKey;
+}
+
+bool RasterNode::canDeferFXRender() const
+{
+    // Changed effect parameters may have reconfigured the filter, so the old result 
+    // is only usable if the effect itself is unchanged.
+    return m_bHasFXResult && !m_pFXNode->isDirty();
+}
+
+void RasterNode::deferFXRender()
+{
+    m_bFXDeferred = true;
+}
+
+void RasterNode::setFXResultSource(FXNodePtr pFXNode)
+{
+    if (pFXNode == m_pFXNode) {
+        m_pSharedFXNode = FXNodePtr();
+    } else {
+        m_pSharedFXNode = pFXNode;
+        m_bHasFXResult = false;
+    }
 }
 
 static ProfilingZoneID FXProfilingZone("RasterNode::renderFX");
 
 void RasterNode::renderFX(GLContext* pContext)
 {
-    if (m_bFXDirty || m_pSurface->isDirty() || m_pFXNode->isDirty()) {
-        ScopeTimer Timer(FXProfilingZone);
-        StandardShader* pSShader = pContext->getStandardShader();
-        pSShader->setAlpha(1.0f);
-        m_pSurface->activate(pContext, getMediaSize());
-        pSShader->activate();
+    ScopeTimer Timer(FXProfilingZone);
+    StandardShader* pSShader = pContext->getStandardShader();
+    pSShader->setAlpha(1.0f);
+    m_pSurface->activate(pContext, getMediaSize());
+    pSShader->activate();
 
-        m_pFBO->activate(pContext);
-        clearGLBuffers(GL_COLOR_BUFFER_BIT, false);
+    m_pFBO->activate(pContext);
+    clearGLBuffers(GL_COLOR_BUFFER_BIT, false);
 
-        bool bPremultipliedAlpha = m_pSurface->isPremultipliedAlpha();
-        if (bPremultipliedAlpha) {
-            glproc::BlendColor(1.0f, 1.0f, 1.0f, 1.0f);
-        }
-        pContext->setBlendMode(GLContext::BLEND_BLEND, bPremultipliedAlpha);
-        m_pImagingProjection->setColor(m_Color);
-        m_pImagingProjection->draw(pContext, pSShader->getShader());
+    bool bPremultipliedAlpha = m_pSurface->isPremultipliedAlpha();
+    if (bPremultipliedAlpha) {
+        glproc::BlendColor(1.0f, 1.0f, 1.0f, 1.0f);
+    }
+    pContext->setBlendMode(GLContext::BLEND_BLEND, bPremultipliedAlpha);
+    m_pImagingProjection->setColor(m_Color);
+    m_pImagingProjection->draw(pContext, pSShader->getShader());
 /*
-        static int i=0;
-        stringstream ss;
-        ss << "node" << i << ".png";
-        BitmapPtr pBmp = m_pFBO->getImage(0);
-        pBmp->save(ss.str());
+    static int i=0;
+    stringstream ss;
+    ss << "node" << i << ".png";
+    BitmapPtr pBmp = m_pFBO->getImage(0);
+    pBmp->save(ss.str());
 */  
-        m_pFXNode->apply(pContext, m_pFBO->getTex()->getTex(pContext));
+    m_pFXNode->apply(pContext, m_pFBO->getTex()->getTex(pContext));
+    m_bHasFXResult = true;
+    m_sFXResultKey = m_sFXCacheKey;
         
 /*        
-        stringstream ss1;
-        ss1 << "nodefx" << i << ".png";
-        i++;
-        m_pFXNode->getImage()->save(ss1.str());
+    stringstream ss1;
+    ss1 << "nodefx" << i << ".png";
+    i++;
+    m_pFXNode->getImage()->save(ss1.str());
 */
-    }
 }
 
 void RasterNode::resetFXDirty()
 {
-    m_bFXDirty = false;
+    // Deferred nodes stay dirty until they have been rendered.
+    m_bFXDirty = m_bFXDeferred;
+    m_bFXDeferred = false;
     m_pSurface->resetDirty();
     if (m_pFXNode) {
         m_pFXNode->resetDirty();
@@ -420,7 +490,7 @@ void RasterNode::resetFXDirty()
 
 void RasterNode::scheduleFXRender()
 {
-    if (m_pFXNode) {
+    if (m_pFXNode && m_pSurface->isReady()) {
         getCanvas()->scheduleFXRender(
                 dynamic_pointer_cast<RasterNode>(shared_from_this()));
     }
@@ -428,6 +498,11 @@ void RasterNode::scheduleFXRender()
 
 void RasterNode::calcVertexArray(const VertexArrayPtr& pVA)
 {
+    unsigned surfaceVersion = m_pSurface->getContentVersion();
+    if (surfaceVersion != m_LastSurfaceVersion) {
+        m_LastSurfaceVersion = surfaceVersion;
+        setCanvasContentChanged();
+    }
     if (m_pSurface->isCreated() && !m_bHasStdVertices && isVisible()) {
         pVA->startSubVA(*m_pSubVA);
         for (unsigned y = 0; y < m_TileVertices.size()-1; y++) {
@@ -455,6 +530,10 @@ void RasterNode::blt32(GLContext* pContext, const glm::mat4& transform)
 void RasterNode::blt(GLContext* pContext, const glm::mat4& transform,
         const glm::vec2& destSize)
 {
+    if (!m_pSurface->isReady()) {
+        // The texture upload has been deferred to a later frame.
+        return;
+    }
     FRect destRect;
 
     StandardShader* pShader = pContext->getStandardShader();
@@ -462,20 +541,21 @@ void RasterNode::blt(GLContext* pContext, const glm::mat4& transform,
     pContext->setBlendColor(glm::vec4(1.0f, 1.0f, 1.0f, opacity));
     pShader->setAlpha(opacity);
     if (m_pFXNode) {
+        FXNodePtr pFXNode = m_pSharedFXNode ? m_pSharedFXNode : m_pFXNode;
         pContext->setBlendMode(m_BlendMode, true);
 #ifdef AVG_ENABLE_EGL
         WrapMode wrapMode;
 #else
         WrapMode wrapMode(GL_CLAMP_TO_BORDER, GL_CLAMP_TO_BORDER);
 #endif
-        m_pFXNode->getTex(pContext)->activate(wrapMode, GL_TEXTURE0);
+        pFXNode->getTex(pContext)->activate(wrapMode, GL_TEXTURE0);
         pShader->setColorModel(0);
         pShader->disableColorspaceMatrix();
         pShader->setGamma(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
         pShader->setPremultipliedAlpha(true);
         pShader->setMask(false);
 
-        FRect relDestRect = m_pFXNode->getRelDestRect();
+        FRect relDestRect = pFXNode->getRelDestRect();
         destRect = FRect(relDestRect.tl.x*destSize.x, relDestRect.tl.y*destSize.y,
                 relDestRect.br.x*destSize.x, relDestRect.br.y*destSize.y);
     } else {
@@ -541,7 +621,10 @@ void RasterNode::downloadMask()
         
 void RasterNode::setRenderColor(const Pixel32& color)
 {
-    m_Color = color;
+    if (color != m_Color) {
+        m_Color = color;
+        setCanvasContentChanged();
+    }
 }
 
 void RasterNode::checkDisplayAvailable(std::string sMsg)
@@ -579,6 +662,7 @@ void RasterNode::setupFX()
         m_pFXNode->setSize(m_pSurface->getSize());
         m_pFXNode->connect();
         m_bFXDirty = true;
+        m_bHasFXResult = false;
         if (!m_pFBO || m_pFBO->getSize() != m_pSurface->getSize()) {
             PixelFormat pf = BitmapLoader::get()->getDefaultPixelFormat(true);
             GLContextManager* pCM = GLContextManager::get();
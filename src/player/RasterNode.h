@@ -98,7 +98,19 @@ class AVG_API RasterNode: public AreaNode
         void setContrast(const glm::vec3& contrast);
 
         void setEffect(FXNodePtr pFXNode);
+        FXNodePtr getEffect() const;
+
+        // FX scheduling, called by Canvas.
+        const std::string& updateFXCacheKey();
+        const std::string& getFXCacheKey() const;
+        bool needsFXRender() const;
+        bool canDeferFXRender() const;
+        void deferFXRender();
+        void setFXResultSource(FXNodePtr pFXNode);
         virtual void renderFX(GLContext* pContext);
+        // Identifies the image the effect is applied to. Nodes with equal keys 
+        // display identical images.
+        virtual std::string getFXSourceKey();
         void resetFXDirty();
 
     protected:
@@ -156,7 +168,15 @@ class AVG_API RasterNode: public AreaNode
         MCFBOPtr m_pFBO;
         FXNodePtr m_pFXNode;
         bool m_bFXDirty;
+        bool m_bFXDeferred;
+        bool m_bHasFXResult;
+        std::string m_sFXCacheKey;
+        std::string m_sFXResultKey;
+        // Set if another node renders an identical effect result that is displayed 
+        // instead of m_pFXNode's.
+        FXNodePtr m_pSharedFXNode;
         ImagingProjectionPtr m_pImagingProjection;
+        unsigned m_LastSurfaceVersion;
 };
 
 }
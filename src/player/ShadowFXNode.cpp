@@ -25,17 +25,20 @@
 #include "../base/Exception.h"
 
 #include <string>
+#include <sstream>
 
 using namespace std;
 
 namespace avg {
 
-ShadowFXNode::ShadowFXNode(glm::vec2 offset, float radius, float opacity, Color color)
+ShadowFXNode::ShadowFXNode(glm::vec2 offset, float radius, float opacity, Color color,
+        bool bFast)
     : FXNode(false),
       m_Offset(offset),
       m_StdDev(radius),
       m_Opacity(opacity),
-      m_Color(color)
+      m_Color(color),
+      m_bFast(bFast)
 {
     ObjectCounter::get()->incRef(&typeid(*this));
 }
@@ -100,10 +103,32 @@ Color ShadowFXNode::getColor() const
     return m_Color;
 }
 
+void ShadowFXNode::setFast(bool bFast)
+{
+    m_bFast = bFast;
+    if (m_pFilter) {
+        m_pFilter->setFast(bFast);
+        setDirty();
+    }
+}
+
+bool ShadowFXNode::getFast() const
+{
+    return m_bFast;
+}
+
+string ShadowFXNode::getCacheKey() const
+{
+    stringstream ss;
+    ss << "ShadowFXNode(" << m_Offset << ", " << m_StdDev << ", " << m_Opacity << ", "
+            << m_Color << ", " << m_bFast << ")";
+    return ss.str();
+}
+
 GPUFilterPtr ShadowFXNode::createFilter(const IntPoint& size)
 {
     m_pFilter = GPUShadowFilterPtr(new GPUShadowFilter(size, m_Offset, m_StdDev, 
-            m_Opacity, m_Color));
+            m_Opacity, m_Color, m_bFast));
     setDirty();
     return m_pFilter;
 }
@@ -37,7 +37,7 @@ namespace avg {
 class AVG_API ShadowFXNode: public FXNode {
 public:
     ShadowFXNode(glm::vec2 offset=glm::vec2(0,0), float radius=1.f, float opacity=1.f,
-            Color color=Color("FFFFFF"));
+            Color color=Color("FFFFFF"), bool bFast=false);
     virtual ~ShadowFXNode();
 
     virtual void connect();
@@ -51,6 +51,10 @@ public:
     float getOpacity() const;
     void setColor(const Color& sColor);
     Color getColor() const;
+    void setFast(bool bFast);
+    bool getFast() const;
+
+    virtual std::string getCacheKey() const;
 
 private:
     virtual GPUFilterPtr createFilter(const IntPoint& size);
@@ -62,6 +66,7 @@ private:
     float m_StdDev;
     float m_Opacity;
     Color m_Color;
+    bool m_bFast;
 };
 
 typedef boost::shared_ptr<ShadowFXNode> ShadowFXNodePtr;
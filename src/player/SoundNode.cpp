@@ -71,6 +71,7 @@ SoundNode::SoundNode(const ArgList& args, const string& sPublisherName)
     m_Filename = m_href;
     initFilename(m_Filename);
     m_pDecoder = new AsyncVideoDecoder(8);
+    m_pDecoder->setLoopPreroll(m_bLoop);
 
     ObjectCounter::get()->incRef(&typeid(*this));
 }
@@ -338,8 +339,14 @@ void SoundNode::exceptionIfUnloaded(const std::string& sFuncName) const
 
 void SoundNode::onEOF()
 {
-    seek(0);
-    if (!m_bLoop) {
+    if (m_bLoop) {
+        // Decoding has already continued at the start of the file.
+        m_pDecoder->loop();
+        m_StartTime = Player::get()->getFrameTime();
+        m_PauseTime = 0;
+        m_PauseStartTime = Player::get()->getFrameTime();
+    } else {
+        seek(0);
         changeSoundState(Paused);
     }
     if (m_pEOFCallback) {
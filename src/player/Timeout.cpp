@@ -38,7 +38,10 @@ int Timeout::s_LastID = 100000;
 Timeout::Timeout(int time, PyObject * pyfunc, bool isInterval, long long startTime)
     : m_Interval(time),
       m_PyFunc(pyfunc),
-      m_IsInterval(isInterval)
+      m_IsInterval(isInterval),
+      m_pQueueVector(0),
+      m_QueueIndex(0),
+      m_QueueSeqNum(0)
 {
     ObjectCounter::get()->incRef(&typeid(*this));
     m_NextTimeout = m_Interval+startTime;
@@ -71,8 +74,7 @@ void Timeout::fire(long long curTime)
     }
     PyObject * arglist = Py_BuildValue("()");
     PyObject * result = PyEval_CallObject(m_PyFunc, arglist);
-    // XXX: After the call to python, this might have been deleted 
-    // by a call to clearTimeout()!
+    // clearInterval() on this timeout during the call only marks it as deleted.
     Py_DECREF(arglist);    
     if (!result) {
         throw py::error_already_set();
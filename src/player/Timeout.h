@@ -26,6 +26,8 @@
 #include "WrapPython.h" 
 #include "../api.h"
 
+#include <vector>
+
 namespace avg {
 
 class AVG_API Timeout
@@ -41,11 +43,19 @@ class AVG_API Timeout
         bool operator <(const Timeout& other) const;
 
     private:
+        friend class TimeoutQueue;
+
         long long m_Interval;
         long long m_NextTimeout;
         PyObject * m_PyFunc;
         bool m_IsInterval;
         int m_ID;
+
+        // Position in the TimeoutQueue.
+        std::vector<Timeout*>* m_pQueueVector;
+        unsigned m_QueueIndex;
+        long long m_QueueSeqNum;
+
         static int s_LastID;
 };
 
@@ -0,0 +1,205 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "TimeoutQueue.h"
+#include "Timeout.h"
+
+#include "../base/Exception.h"
+
+using namespace std;
+
+namespace avg {
+
+TimeoutQueue::TimeoutQueue()
+    : m_NextSeqNum(0)
+{
+}
+
+TimeoutQueue::~TimeoutQueue()
+{
+    clear();
+}
+
+void TimeoutQueue::push(Timeout* pTimeout)
+{
+    AVG_ASSERT(m_IDMap.find(pTimeout->getID()) == m_IDMap.end());
+    m_IDMap[pTimeout->getID()] = pTimeout;
+    pTimeout->m_QueueSeqNum = m_NextSeqNum;
+    m_NextSeqNum++;
+    pTimeout->m_pQueueVector = &m_Heap;
+    m_Heap.push_back(pTimeout);
+    setHeapEntry(m_Heap.size()-1, pTimeout);
+    siftUp(m_Heap.size()-1);
+}
+
+void TimeoutQueue::pushDeferred(Timeout* pTimeout, bool bFront)
+{
+    AVG_ASSERT(m_IDMap.find(pTimeout->getID()) == m_IDMap.end());
+    m_IDMap[pTimeout->getID()] = pTimeout;
+    vector<Timeout*>& deferred = bFront ? m_DeferredFront : m_Deferred;
+    pTimeout->m_pQueueVector = &deferred;
+    pTimeout->m_QueueIndex = deferred.size();
+    deferred.push_back(pTimeout);
+}
+
+void TimeoutQueue::commitDeferred()
+{
+    vector<Timeout*> front;
+    vector<Timeout*> back;
+    front.swap(m_DeferredFront);
+    back.swap(m_Deferred);
+    for (vector<Timeout*>::reverse_iterator it = front.rbegin(); it != front.rend();
+            ++it)
+    {
+        if (*it) {
+            m_IDMap.erase((*it)->getID());
+            push(*it);
+        }
+    }
+    for (vector<Timeout*>::iterator it = back.begin(); it != back.end(); ++it) {
+        if (*it) {
+            m_IDMap.erase((*it)->getID());
+            push(*it);
+        }
+    }
+}
+
+bool TimeoutQueue::empty() const
+{
+    return m_Heap.empty();
+}
+
+Timeout* TimeoutQueue::top() const
+{
+    AVG_ASSERT(!m_Heap.empty());
+    return m_Heap[0];
+}
+
+Timeout* TimeoutQueue::pop()
+{
+    Timeout* pTimeout = top();
+    m_IDMap.erase(pTimeout->getID());
+    removeHeapEntry(0);
+    return pTimeout;
+}
+
+Timeout* TimeoutQueue::remove(int id)
+{
+    TimeoutIDMap::iterator it = m_IDMap.find(id);
+    if (it == m_IDMap.end()) {
+        return 0;
+    }
+    Timeout* pTimeout = it->second;
+    m_IDMap.erase(it);
+    if (pTimeout->m_pQueueVector == &m_Heap) {
+        removeHeapEntry(pTimeout->m_QueueIndex);
+    } else {
+        (*pTimeout->m_pQueueVector)[pTimeout->m_QueueIndex] = 0;
+        pTimeout->m_pQueueVector = 0;
+    }
+    return pTimeout;
+}
+
+void TimeoutQueue::clear()
+{
+    clearVector(m_Heap);
+    clearVector(m_DeferredFront);
+    clearVector(m_Deferred);
+    m_IDMap.clear();
+}
+
+int TimeoutQueue::size() const
+{
+    return m_IDMap.size();
+}
+
+bool TimeoutQueue::isBefore(const Timeout* pTimeout1, const Timeout* pTimeout2) const
+{
+    if (pTimeout1->m_NextTimeout != pTimeout2->m_NextTimeout) {
+        return pTimeout1->m_NextTimeout < pTimeout2->m_NextTimeout;
+    } else {
+        return pTimeout1->m_QueueSeqNum > pTimeout2->m_QueueSeqNum;
+    }
+}
+
+void TimeoutQueue::setHeapEntry(unsigned i, Timeout* pTimeout)
+{
+    m_Heap[i] = pTimeout;
+    pTimeout->m_QueueIndex = i;
+}
+
+void TimeoutQueue::removeHeapEntry(unsigned i)
+{
+    m_Heap[i]->m_pQueueVector = 0;
+    Timeout* pLast = m_Heap.back();
+    m_Heap.pop_back();
+    if (i < m_Heap.size()) {
+        setHeapEntry(i, pLast);
+        siftUp(i);
+        siftDown(pLast->m_QueueIndex);
+    }
+}
+
+void TimeoutQueue::siftUp(unsigned i)
+{
+    Timeout* pTimeout = m_Heap[i];
+    while (i > 0) {
+        unsigned parent = (i-1)/2;
+        if (!isBefore(pTimeout, m_Heap[parent])) {
+            break;
+        }
+        setHeapEntry(i, m_Heap[parent]);
+        i = parent;
+    }
+    setHeapEntry(i, pTimeout);
+}
+
+void TimeoutQueue::siftDown(unsigned i)
+{
+    Timeout* pTimeout = m_Heap[i];
+    unsigned size = m_Heap.size();
+    while (true) {
+        unsigned child = 2*i+1;
+        if (child >= size) {
+            break;
+        }
+        if (child+1 < size && isBefore(m_Heap[child+1], m_Heap[child])) {
+            child++;
+        }
+        if (!isBefore(m_Heap[child], pTimeout)) {
+            break;
+        }
+        setHeapEntry(i, m_Heap[child]);
+        i = child;
+    }
+    setHeapEntry(i, pTimeout);
+}
+
+void TimeoutQueue::clearVector(vector<Timeout*>& timeouts)
+{
+    for (vector<Timeout*>::iterator it = timeouts.begin(); it != timeouts.end(); ++it) {
+        delete *it;
+    }
+    timeouts.clear();
+}
+
+}
@@ -0,0 +1,81 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _TimeoutQueue_H_
+#define _TimeoutQueue_H_
+
+#include "../api.h"
+
+#include <boost/unordered_map.hpp>
+
+#include <vector>
+
+namespace avg {
+
+class Timeout;
+
+// Priority queue of pending timeouts, ordered by firing time. Timeouts with the
+// same firing time fire in reverse order of insertion. Timeouts can be looked up and
+// removed by id in O(log n). Deferred timeouts are held back until commitDeferred()
+// is called, so timeouts added while timers are being handled don't fire in the same
+// pass. The queue owns all timeouts it contains.
+class AVG_API TimeoutQueue
+{
+    public:
+        TimeoutQueue();
+        virtual ~TimeoutQueue();
+
+        void push(Timeout* pTimeout);
+        void pushDeferred(Timeout* pTimeout, bool bFront=false);
+        void commitDeferred();
+
+        bool empty() const;
+        Timeout* top() const;
+        // pop() and remove() pass ownership of the timeout to the caller.
+        Timeout* pop();
+        Timeout* remove(int id);
+        void clear();
+
+        int size() const;
+
+    private:
+        bool isBefore(const Timeout* pTimeout1, const Timeout* pTimeout2) const;
+        void setHeapEntry(unsigned i, Timeout* pTimeout);
+        void removeHeapEntry(unsigned i);
+        void siftUp(unsigned i);
+        void siftDown(unsigned i);
+        void clearVector(std::vector<Timeout*>& timeouts);
+
+        std::vector<Timeout*> m_Heap;
+        // Deferred timeouts. m_DeferredFront is committed in reverse order and
+        // before m_Deferred. Removed entries are set to 0.
+        std::vector<Timeout*> m_DeferredFront;
+        std::vector<Timeout*> m_Deferred;
+
+        typedef boost::unordered_map<int, Timeout*> TimeoutIDMap;
+        TimeoutIDMap m_IDMap;
+        long long m_NextSeqNum;
+};
+
+}
+
+#endif
@@ -34,7 +34,8 @@ using namespace std;
 namespace avg {
 
 TouchStatus::TouchStatus(CursorEventPtr pEvent)
-    : m_bFirstFrame(true),
+    : m_NumDroppedEvents(0),
+      m_bFirstFrame(true),
       m_CursorID(pEvent->getCursorID())
 {
     m_pNewEvents.push_back(pEvent);
@@ -57,19 +58,24 @@ void TouchStatus::pushEvent(CursorEventPtr pEvent, bool bCheckMotion)
             // messages must be delivered. This is the only time that m_pNewEvents
             // has more than one entry.
             m_pNewEvents.push_back(pEvent);
+        } else {
+            m_pCoalescedEvents.push_back(pEvent);
         }
     } else {
         if (bCheckMotion && pEvent->getType() == Event::CURSOR_MOTION && 
                 getLastEvent()->getPos() == pEvent->getPos())
         {
             // Ignore motion events without motion.
+            m_NumDroppedEvents++;
             return;
         } else {
             if (m_pNewEvents.empty()) {
                 // No pending events: schedule for delivery.
                 m_pNewEvents.push_back(pEvent);
             } else {
-                // More than one event per poll: Deliver only the last one.
+                // More than one event per poll: Deliver only the last one, but keep
+                // the others in the contact history.
+                m_pCoalescedEvents.push_back(m_pNewEvents[0]);
                 m_pNewEvents[0] = pEvent;
             }
         }
@@ -83,6 +89,11 @@ CursorEventPtr TouchStatus::pollEvent()
     } else {
         CursorEventPtr pEvent = m_pNewEvents[0];
         m_pNewEvents.erase(m_pNewEvents.begin());
+        if (pEvent->getType() != Event::CURSOR_DOWN) {
+            pEvent->setCoalescedEvents(m_pCoalescedEvents, m_NumDroppedEvents);
+            m_pCoalescedEvents.clear();
+            m_NumDroppedEvents = 0;
+        }
         m_bFirstFrame = false;
         m_pLastEvent = pEvent;
         return pEvent;
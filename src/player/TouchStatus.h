@@ -47,6 +47,9 @@ public:
 private:
     CursorEventPtr m_pLastEvent;
     std::vector<CursorEventPtr> m_pNewEvents;
+    // Events that were merged into the next delivered event.
+    std::vector<CursorEventPtr> m_pCoalescedEvents;
+    int m_NumDroppedEvents;
 
     bool m_bFirstFrame;
     int m_CursorID;
@@ -37,6 +37,7 @@ namespace avg {
 TypeRegistry* TypeRegistry::s_pInstance = 0;
 
 TypeRegistry::TypeRegistry()
+    : m_bDTDValid(false)
 {
 }
 
@@ -55,6 +56,7 @@ TypeRegistry* TypeRegistry::get()
 void TypeRegistry::registerType(const TypeDefinition& def, const char* pParentNames[])
 {
     m_TypeDefs.insert(TypeDefMap::value_type(def.getName(), def));
+    m_bDTDValid = false;
 
     if (pParentNames) {
         string sChildArray[1];
@@ -75,6 +77,7 @@ void TypeRegistry::registerType(const TypeDefinition& def, const char* pParentNa
 void TypeRegistry::updateDefinition(const TypeDefinition& def)
 {
     m_TypeDefs[def.getName()] = def;
+    m_bDTDValid = false;
 }
 
 ExportedObjectPtr TypeRegistry::createObject(const string& sType, 
@@ -100,10 +103,15 @@ ExportedObjectPtr TypeRegistry::createObject(const string& sType, const py::dict
     return pObj;
 }
 
-string TypeRegistry::getDTD() const
+const string& TypeRegistry::getDTD() const
 {
+    if (m_bDTDValid) {
+        return m_sDTD;
+    }
     if (m_TypeDefs.empty()) {
-        return string("");
+        m_sDTD = "";
+        m_bDTDValid = true;
+        return m_sDTD;
     }
     
     stringstream ss;
@@ -126,7 +134,9 @@ string TypeRegistry::getDTD() const
         }
     }
    
-    return ss.str();
+    m_sDTD = ss.str();
+    m_bDTDValid = true;
+    return m_sDTD;
 }
 
 TypeDefinition& TypeRegistry::getTypeDef(const string& sType)
@@ -142,14 +152,13 @@ TypeDefinition& TypeRegistry::getTypeDef(const string& sType)
 void TypeRegistry::writeTypeDTD(const TypeDefinition& def, stringstream& ss) const
 {
     ss << "<!ELEMENT " << def.getName() << " " << def.getDTDChildrenString() << " >\n";
-    if (!def.getDefaultArgs().getArgMap().empty()) {
+    const ArgList& args = def.getDefaultArgs();
+    if (args.getNumArgs() != 0) {
         ss << "<!ATTLIST " << def.getName();
-        for (ArgMap::const_iterator argIt = def.getDefaultArgs().getArgMap().begin(); 
-            argIt != def.getDefaultArgs().getArgMap().end(); argIt++)
-        {
-            string argName = argIt->first;
+        for (unsigned i=0; i<args.getNumArgs(); ++i) {
+            string argName = args.getArg(i)->getName();
             string argType = (argName == "id") ? "ID" : "CDATA";
-            string argRequired = def.getDefaultArgs().getArg(argName)->isRequired() ?
+            string argRequired = args.getArg(i)->isRequired() ?
                     "#REQUIRED" : "#IMPLIED";
             ss << "\n    " << argName << " " << argType << " " << argRequired;
         }
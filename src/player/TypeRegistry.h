@@ -45,7 +45,8 @@ public:
     ExportedObjectPtr createObject(const std::string& Type, const xmlNodePtr xmlNode);
     ExportedObjectPtr createObject(const std::string& Type, const py::dict& PyDict);
     
-    std::string getDTD() const;
+    // The DTD is cached until the next type is registered or updated.
+    const std::string& getDTD() const;
     
 private:
     TypeRegistry();
@@ -53,6 +54,8 @@ private:
     
     typedef std::map<std::string, TypeDefinition> TypeDefMap;
     TypeDefMap m_TypeDefs;
+    mutable std::string m_sDTD;
+    mutable bool m_bDTDValid;
 
     static TypeRegistry* s_pInstance;
 };
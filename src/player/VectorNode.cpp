@@ -140,6 +140,7 @@ void VectorNode::setBlendModeStr(const string& sBlendMode)
 {
     m_sBlendMode = sBlendMode;
     m_BlendMode = GLContext::stringToBlendMode(sBlendMode);
+    setCanvasContentChanged();
 }
 
 static ProfilingZoneID PrerenderProfilingZone("VectorNode::prerender");
@@ -519,6 +520,7 @@ int VectorNode::getNumDifferentPts(const vector<glm::vec2>& pts)
 void VectorNode::setTranslate(const glm::vec2& trans)
 {
     m_Translate = trans;
+    setCanvasContentChanged();
 }
 
 bool VectorNode::isInside(const glm::vec2& pos)
@@ -536,6 +538,7 @@ void VectorNode::checkRedraw()
         calcVertexes(pShapeVD, m_Color);
         m_bDrawNeeded = false;
         m_pShape->setVertexData(pShapeVD);
+        setCanvasContentChanged();
     }
 }
 
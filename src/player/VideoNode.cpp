@@ -39,6 +39,7 @@
 
 #include "../video/AsyncVideoDecoder.h"
 #include "../video/SyncVideoDecoder.h"
+#include "../video/SharedVideoDecoder.h"
 
 #include <iostream>
 #include <sstream>
@@ -52,6 +53,8 @@ using namespace std;
 
 namespace avg {
 
+static const int SCRUB_THUMBNAIL_WIDTH = 320;
+
 void VideoNode::registerType()
 {
     TypeDefinition def = TypeDefinition("video", "rasternode", 
@@ -59,6 +62,14 @@ void VideoNode::registerType()
         .addArg(Arg<UTF8String>("href", "", false, offsetof(VideoNode, m_href)))
         .addArg(Arg<bool>("loop", false, false, offsetof(VideoNode, m_bLoop)))
         .addArg(Arg<bool>("threaded", true, false, offsetof(VideoNode, m_bThreaded)))
+        .addArg(Arg<bool>("fastseek", false, false, offsetof(VideoNode, m_bFastSeek)))
+        .addArg(Arg<bool>("shared", false, false, offsetof(VideoNode, m_bShared)))
+        .addArg(Arg<bool>("asyncopen", false, false, offsetof(VideoNode, m_bAsyncOpen)))
+        .addArg(Arg<bool>("adaptivedecode", false, false, 
+                offsetof(VideoNode, m_bAdaptiveDecode)))
+        .addArg(Arg<bool>("scrub", false, false, offsetof(VideoNode, m_bScrub)))
+        .addArg(Arg<float>("scrubinterval", 1.0, false, 
+                offsetof(VideoNode, m_ScrubInterval)))
         .addArg(Arg<float>("fps", 0.0, false, offsetof(VideoNode, m_FPS)))
         .addArg(Arg<int>("queuelength", 8, false, 
                 offsetof(VideoNode, m_QueueLength)))
@@ -76,6 +87,8 @@ VideoNode::VideoNode(const ArgList& args,const string& sPublisherName)
       m_bFirstFrameDecoded(false),
       m_Filename(""),
       m_bEOFPending(false),
+      m_bOpenPending(false),
+      m_PendingVideoState(Unloaded),
       m_pEOFCallback(0),
       m_FramesTooLate(0),
       m_FramesPlayed(0),
@@ -92,17 +105,33 @@ VideoNode::VideoNode(const ArgList& args,const string& sPublisherName)
         throw Exception(AVG_ERR_INVALID_ARGS, 
                 "Can't set queue length for unthreaded videos because there is no decoder queue in this case.");
     }
-    if (m_bThreaded) {
+    if (m_bShared && !m_bThreaded) {
+        throw Exception(AVG_ERR_INVALID_ARGS, 
+                "Shared decoding is only supported for threaded videos.");
+    }
+    if (m_ScrubInterval < 0) {
+        throw Exception(AVG_ERR_OUT_OF_RANGE, 
+                "scrubinterval must not be negative.");
+    }
+    if (m_bShared) {
+        m_pDecoder = new SharedVideoDecoder(m_QueueLength);
+    } else if (m_bThreaded) {
         m_pDecoder = new AsyncVideoDecoder(m_QueueLength);
     } else {
         m_pDecoder = new SyncVideoDecoder();
     }
+    m_pDecoder->setFastSeek(m_bFastSeek);
+    m_pDecoder->setLoopPreroll(m_bThreaded && m_bLoop && !m_bShared);
+    m_pDecoder->setAdaptiveDecode(m_bThreaded && m_bAdaptiveDecode && !m_bShared);
 
     ObjectCounter::get()->incRef(&typeid(*this));
 }
 
 VideoNode::~VideoNode()
 {
+    if (m_bOpenPending) {
+        cancelAsyncOpen();
+    }
     if (m_pDecoder) {
         delete m_pDecoder;
         m_pDecoder = 0;
@@ -184,6 +213,30 @@ int VideoNode::getNumFramesQueued() const
     return m_pDecoder->getNumFramesQueued();
 }
 
+int VideoNode::getNumFramesDecoded() const
+{
+    exceptionIfUnloaded("getNumFramesDecoded");
+    return m_pDecoder->getNumFramesDecoded();
+}
+
+int VideoNode::getNumFramesSkipped() const
+{
+    exceptionIfUnloaded("getNumFramesSkipped");
+    return m_pDecoder->getNumFramesSkipped();
+}
+
+int VideoNode::getNumFramesDroppedLate() const
+{
+    exceptionIfUnloaded("getNumFramesDroppedLate");
+    return m_pDecoder->getNumFramesDroppedLate();
+}
+
+int VideoNode::getNumFramesTooLate() const
+{
+    exceptionIfUnloaded("getNumFramesTooLate");
+    return m_FramesTooLate;
+}
+
 void VideoNode::seekToFrame(int frameNum)
 {
     if (frameNum < 0) {
@@ -202,6 +255,12 @@ bool VideoNode::isSeeking() const
     return m_bSeekPending;
 }
 
+bool VideoNode::isSkippingFrames() const
+{
+    exceptionIfUnloaded("isSkippingFrames");
+    return m_pDecoder->isSkippingFrames();
+}
+
 std::string VideoNode::getStreamPixelFormat() const
 {
     exceptionIfUnloaded("getStreamPixelFormat");
@@ -300,6 +359,52 @@ bool VideoNode::isThreaded() const
     return m_bThreaded;
 }
 
+bool VideoNode::isShared() const
+{
+    return m_bShared;
+}
+
+bool VideoNode::isAsyncOpen() const
+{
+    return m_bAsyncOpen;
+}
+
+bool VideoNode::isAdaptiveDecode() const
+{
+    return m_bAdaptiveDecode;
+}
+
+bool VideoNode::isScrub() const
+{
+    return m_bScrub;
+}
+
+float VideoNode::getScrubInterval() const
+{
+    return m_ScrubInterval;
+}
+
+ThumbnailCachePtr VideoNode::getScrubCache() const
+{
+    return m_pScrubCache;
+}
+
+bool VideoNode::isOpenPending() const
+{
+    return m_bOpenPending;
+}
+
+bool VideoNode::getFastSeek() const
+{
+    return m_bFastSeek;
+}
+
+void VideoNode::setFastSeek(bool bFastSeek)
+{
+    m_bFastSeek = bFastSeek;
+    m_pDecoder->setFastSeek(bFastSeek);
+}
+
 bool VideoNode::hasAudio() const
 {
     exceptionIfUnloaded("hasAudio");
@@ -335,8 +440,45 @@ const UTF8String& VideoNode::getHRef() const
 
 void VideoNode::setHRef(const UTF8String& href)
 {
-    m_href = href;
-    checkReload();
+    if (m_pDataSource) {
+        // The href replaces the data source.
+        bool bWasLoaded = (m_VideoState != Unloaded || m_bOpenPending);
+        changeVideoState(Unloaded);
+        m_pDataSource = VideoDataSourcePtr();
+        m_href = href;
+        checkReload();
+        if (bWasLoaded && m_href != "") {
+            changeVideoState(Paused);
+        }
+    } else {
+        m_href = href;
+        checkReload();
+    }
+}
+
+VideoDataSourcePtr VideoNode::getDataSource() const
+{
+    return m_pDataSource;
+}
+
+void VideoNode::setDataSource(VideoDataSourcePtr pDataSource)
+{
+    if (!pDataSource) {
+        setHRef("");
+        return;
+    }
+    if (m_bShared) {
+        throw Exception(AVG_ERR_UNSUPPORTED, 
+                "Shared videos can't be read from data sources.");
+    }
+    bool bWasLoaded = (m_VideoState != Unloaded || m_bOpenPending);
+    changeVideoState(Unloaded);
+    m_pDataSource = pDataSource;
+    m_href = "";
+    m_Filename = pDataSource->getName();
+    if (bWasLoaded) {
+        changeVideoState(Paused);
+    }
 }
 
 float VideoNode::getVolume()
@@ -358,9 +500,11 @@ void VideoNode::setVolume(float volume)
 void VideoNode::checkReload()
 {
     string fileName (m_href);
-    if (m_href != "") {
+    if (m_pDataSource) {
+        // Nothing to reload.
+    } else if (m_href != "") {
         initFilename(fileName);
-        if (fileName != m_Filename && m_VideoState != Unloaded) {
+        if (fileName != m_Filename && (m_VideoState != Unloaded || m_bOpenPending)) {
             changeVideoState(Unloaded);
             m_Filename = fileName;
             changeVideoState(Paused);
@@ -380,6 +524,10 @@ void VideoNode::onFrameEnd()
     if (pAsyncDecoder && (m_VideoState == Playing || m_VideoState == Paused)) {
         pAsyncDecoder->updateAudioStatus();
     }
+    if (m_bOpenPending && !m_pDecoder->isOpenPending()) {
+        NodePtr pTempThis = getSharedThis();
+        finishAsyncOpen();
+    }
     if (m_bEOFPending) {
         // If the VideoNode is unlinked by python in onEOF, the following line prevents
         // the object from being deleted until we return from this function.
@@ -392,9 +540,28 @@ void VideoNode::onFrameEnd()
 void VideoNode::changeVideoState(VideoState newVideoState)
 {
     long long curTime = Player::get()->getFrameTime(); 
+    if (m_bOpenPending) {
+        // The decoder is still opening the file. The new state is applied when it's
+        // done.
+        if (newVideoState == Unloaded) {
+            cancelAsyncOpen();
+        } else {
+            m_PendingVideoState = newVideoState;
+        }
+        return;
+    }
     if (m_VideoState == newVideoState) {
         return;
     }
+    if (m_VideoState == Unloaded && m_bAsyncOpen && 
+            m_pDecoder->getState() == VideoDecoder::CLOSED)
+    {
+        m_pDecoder->setDataSource(m_pDataSource);
+        m_pDecoder->openAsync(m_Filename, m_bEnableSound);
+        m_bOpenPending = true;
+        m_PendingVideoState = newVideoState;
+        return;
+    }
     if (m_VideoState == Unloaded) {
         m_PauseStartTime = curTime;
         open();
@@ -441,6 +608,9 @@ void VideoNode::seek(long long destTime)
         m_PauseStartTime = Player::get()->getFrameTime();
         m_bFrameAvailable = false;
         m_bSeekPending = true;
+        if (m_pScrubCache && m_bFirstFrameDecoded) {
+            renderScrubFrame(destTime);
+        }
     } else {
         // If we get a seek command before decoding has really started, we need to defer 
         // the actual seek until the decoder is ready.
@@ -453,13 +623,26 @@ void VideoNode::open()
     m_FramesTooLate = 0;
     m_FramesInRowTooLate = 0;
     m_FramesPlayed = 0;
-    m_pDecoder->open(m_Filename, m_bEnableSound);
+    if (m_pDecoder->getState() == VideoDecoder::CLOSED) {
+        m_pDecoder->setDataSource(m_pDataSource);
+        m_pDecoder->open(m_Filename, m_bEnableSound);
+    }
     VideoInfo videoInfo = m_pDecoder->getVideoInfo();
     if (!videoInfo.m_bHasVideo) {
         m_pDecoder->close();
         throw Exception(AVG_ERR_VIDEO_GENERAL, 
                 string("Video: Opening "+m_Filename+" failed. No video stream found."));
     }
+    if (m_bScrub) {
+        if (m_pDataSource) {
+            m_pScrubCache = ThumbnailCachePtr(new ThumbnailCache(m_Filename,
+                    m_ScrubInterval, SCRUB_THUMBNAIL_WIDTH, m_pDataSource));
+        } else {
+            m_pScrubCache = ThumbnailCache::get(m_Filename, m_ScrubInterval, 
+                    SCRUB_THUMBNAIL_WIDTH);
+        }
+        m_pScrubCache->requestBuild();
+    }
     m_StartTime = Player::get()->getFrameTime();
     m_JitterCompensation = 0.5;
     m_PauseTime = 0;
@@ -523,7 +706,7 @@ void VideoNode::createTextures(IntPoint size)
     if (pf == B8G8R8X8 || pf == B8G8R8A8) {
         BitmapPtr pBmp = BitmapPtr(new Bitmap(size, pf));
         FilterFill<Pixel32>(Pixel32(0,0,0,255)).applyInPlace(pBmp);
-        pCM->scheduleTexUpload(m_pTextures[0], pBmp);
+        pCM->scheduleTexUpload(m_pTextures[0], pBmp, true);
     }
     if (pixelFormatIsPlanar(pf)) {
         if (pixelFormatHasAlpha(pf)) {
@@ -538,6 +721,31 @@ void VideoNode::createTextures(IntPoint size)
     newSurface();
 }
 
+void VideoNode::finishAsyncOpen()
+{
+    m_bOpenPending = false;
+    try {
+        m_pDecoder->finishOpen();
+        changeVideoState(m_PendingVideoState);
+    } catch (const Exception& ex) {
+        AVG_LOG_ERROR(m_href << ": " << ex.getStr());
+        notifySubscribers("STREAM_ERROR", ex.getStr());
+        return;
+    }
+    notifySubscribers("STREAM_READY");
+}
+
+void VideoNode::cancelAsyncOpen()
+{
+    m_bOpenPending = false;
+    try {
+        m_pDecoder->finishOpen();
+        m_pDecoder->close();
+    } catch (const Exception&) {
+        // The file couldn't be opened, so there is nothing to close.
+    }
+}
+
 void VideoNode::close()
 {
     AudioEngine* pAudioEngine = AudioEngine::get();
@@ -546,6 +754,8 @@ void VideoNode::close()
         m_AudioID = -1;
     }
     m_pDecoder->close();
+    m_pScrubCache = ThumbnailCachePtr();
+    m_pScrubRenderer = ThumbnailRendererPtr();
     if (m_FramesTooLate > 0) {
         string sID;
         if (getID() == "") {
@@ -567,7 +777,8 @@ PixelFormat VideoNode::getPixelFormat() const
 
 IntPoint VideoNode::getMediaSize()
 {
-    if (m_pDecoder && m_pDecoder->getState() != VideoDecoder::CLOSED) {
+    if (m_pDecoder && !m_bOpenPending && m_pDecoder->getState() != VideoDecoder::CLOSED)
+    {
         return m_pDecoder->getSize();
     } else {
         return IntPoint(0,0);
@@ -584,6 +795,17 @@ int VideoNode::getQueueLength() const
     return m_QueueLength;
 }
 
+bool VideoNode::isRefiningFastSeek() const
+{
+    // After a fast seek, the frame displayed can be before the seek destination.
+    // When paused, we need to continue decoding until the destination is reached.
+    if (!m_bFastSeek || m_pDecoder->isEOF()) {
+        return false;
+    }
+    float timePerFrame = 1000.f/m_pDecoder->getFPS();
+    return m_pDecoder->getCurTime()*1000 < getNextFrameTime()-0.5f*timePerFrame;
+}
+
 long long VideoNode::getNextFrameTime() const
 {
     switch (m_VideoState) {
@@ -647,6 +869,8 @@ void VideoNode::preRender(const VertexArrayPtr& pVA, bool bIsParentActive,
             } else { // Paused
                 if (!m_bFrameAvailable) {
                     m_bFrameAvailable = renderFrame();
+                } else if (isRefiningFastSeek()) {
+                    renderFrame();
                 }
             }
             m_bFirstFrameDecoded |= m_bFrameAvailable;
@@ -745,6 +969,24 @@ bool VideoNode::renderFrame()
     return (frameAvailable == FA_NEW_FRAME);
 }
 
+void VideoNode::renderScrubFrame(long long destTime)
+{
+    // Show the cached frame closest to the seek destination until the decoder 
+    // delivers the real one.
+    BitmapPtr pThumbBmp = m_pScrubCache->getThumbnail(float(destTime)/1000.0f);
+    if (pThumbBmp) {
+        if (!m_pScrubRenderer) {
+            m_pScrubRenderer = ThumbnailRendererPtr(new ThumbnailRenderer(
+                    getPixelFormat(), m_pDecoder->getSize()));
+        }
+        vector<BitmapPtr> pBmps;
+        m_pScrubRenderer->render(pThumbBmp, pBmps);
+        for (unsigned i=0; i<pBmps.size(); ++i) {
+            GLContextManager::get()->scheduleTexUpload(m_pTextures[i], pBmps[i], true);
+        }
+    }
+}
+
 FrameAvailableCode VideoNode::renderToSurface()
 {
     FrameAvailableCode frameAvailable;
@@ -760,7 +1002,7 @@ FrameAvailableCode VideoNode::renderToSurface()
     }
     if (frameAvailable == FA_NEW_FRAME) {
         for (unsigned i=0; i<getNumPixelFormatPlanes(pf); ++i) {
-            GLContextManager::get()->scheduleTexUpload(m_pTextures[i], pBmps[i]);
+            GLContextManager::get()->scheduleTexUpload(m_pTextures[i], pBmps[i], true);
         }
     }
 
@@ -803,7 +1045,7 @@ void VideoNode::updateStatusDueToDecoderEOF()
         m_PauseTime = 0;
         m_FramesInRowTooLate = 0;
         m_bFrameAvailable = false;
-        if (m_AudioID != -1) {
+        if (m_AudioID != -1 && !m_pDecoder->getLoopPreroll()) {
             AudioEngine::get()->notifySeek(m_AudioID);
         }
         m_pDecoder->loop();
@@ -34,6 +34,8 @@
 #include "../base/UTF8String.h"
 
 #include "../video/VideoDecoder.h"
+#include "../video/ThumbnailCache.h"
+#include "../video/ThumbnailRenderer.h"
 
 namespace avg {
 
@@ -61,6 +63,8 @@ class AVG_API VideoNode: public RasterNode, IFrameEndListener
 
         const UTF8String& getHRef() const;
         void setHRef(const UTF8String& href);
+        VideoDataSourcePtr getDataSource() const;
+        void setDataSource(VideoDataSourcePtr pDataSource);
         float getVolume();
         void setVolume(float volume);
         float getFPS() const;
@@ -70,8 +74,13 @@ class AVG_API VideoNode: public RasterNode, IFrameEndListener
         int getNumFrames() const;
         int getCurFrame() const;
         int getNumFramesQueued() const;
+        int getNumFramesDecoded() const;
+        int getNumFramesSkipped() const;
+        int getNumFramesDroppedLate() const;
+        int getNumFramesTooLate() const;
         void seekToFrame(int frameNum);
         bool isSeeking() const;
+        bool isSkippingFrames() const;
         std::string getStreamPixelFormat() const;
         long long getDuration() const;
         long long getVideoDuration() const;
@@ -87,6 +96,15 @@ class AVG_API VideoNode: public RasterNode, IFrameEndListener
         void seekToTime(long long time);
         bool getLoop() const;
         bool isThreaded() const;
+        bool isShared() const;
+        bool isAsyncOpen() const;
+        bool isOpenPending() const;
+        bool isAdaptiveDecode() const;
+        bool isScrub() const;
+        float getScrubInterval() const;
+        ThumbnailCachePtr getScrubCache() const;
+        bool getFastSeek() const;
+        void setFastSeek(bool bFastSeek);
         bool hasAudio() const;
         bool hasAlpha() const;
         void setEOFCallback(PyObject * pEOFCallback);
@@ -101,12 +119,15 @@ class AVG_API VideoNode: public RasterNode, IFrameEndListener
     private:
         bool renderFrame();
         FrameAvailableCode renderToSurface();
+        void renderScrubFrame(long long destTime);
         void seek(long long destTime);
         void onEOF();
         void updateStatusDueToDecoderEOF();
         void dumpFramesTooLate();
 
         void open();
+        void finishAsyncOpen();
+        void cancelAsyncOpen();
         void startDecoding();
         void createTextures(IntPoint size);
         void close();
@@ -114,6 +135,7 @@ class AVG_API VideoNode: public RasterNode, IFrameEndListener
         void changeVideoState(VideoState NewVideoState);
         PixelFormat getPixelFormat() const;
         long long getNextFrameTime() const;
+        bool isRefiningFastSeek() const;
         void exceptionIfNoAudio(const std::string& sFuncName) const;
         void exceptionIfUnloaded(const std::string& sFuncName) const;
 
@@ -124,11 +146,22 @@ class AVG_API VideoNode: public RasterNode, IFrameEndListener
 
         UTF8String m_href;
         std::string m_Filename;
+        VideoDataSourcePtr m_pDataSource;
         bool m_bLoop;
         bool m_bThreaded;
+        bool m_bShared;
+        bool m_bAsyncOpen;
+        bool m_bAdaptiveDecode;
+        bool m_bScrub;
+        float m_ScrubInterval;
+        ThumbnailCachePtr m_pScrubCache;
+        ThumbnailRendererPtr m_pScrubRenderer;
+        bool m_bFastSeek;
         float m_FPS;
         int m_QueueLength;
         bool m_bEOFPending;
+        bool m_bOpenPending;
+        VideoState m_PendingVideoState;
         PyObject * m_pEOFCallback;
         int m_FramesTooLate;
         int m_FramesInRowTooLate;
@@ -29,6 +29,9 @@
 #include "../graphics/GPURGB2YUVFilter.h"
 #include "../graphics/Filterfill.h"
 #include "../graphics/GLContext.h"
+#ifndef AVG_ENABLE_EGL
+    #include "../graphics/ReadbackRing.h"
+#endif
 #include "../base/StringHelper.h"
 
 #include <boost/bind.hpp>
@@ -48,14 +51,14 @@ VideoWriter::VideoWriter(CanvasPtr pCanvas, const string& sOutFileName, int fram
       m_FrameRate(frameRate),
       m_QMin(qMin),
       m_QMax(qMax),
+      m_bReadbackFlipped(false),
       m_bHasValidData(false),
       m_bSyncToPlayback(bSyncToPlayback),
       m_bPaused(false),
       m_PauseTime(0),
       m_bStopped(false),
       m_CurFrame(0),
-      m_StartTime(-1),
-      m_bFramePending(false)
+      m_StartTime(-1)
 {
     if (!pCanvas) {
         throw Exception(AVG_ERR_INVALID_ARGS, "VideoWriter needs a canvas to write to.");
@@ -83,20 +86,34 @@ VideoWriter::VideoWriter(CanvasPtr pCanvas, const string& sOutFileName, int fram
     remove(m_sOutFileName.c_str());
     CanvasPtr pMainCanvas = Player::get()->getMainCanvas();
     DisplayEngine* pDisplayEngine = Player::get()->getDisplayEngine();
+    GLContext* pOldContext = GLContext::getCurrent();
+    m_pMainGLContext = pDisplayEngine->getWindow(0)->getGLContext();
+    m_pMainGLContext->activate();
     if (pMainCanvas == m_pCanvas) {
         m_FrameSize = pDisplayEngine->getWindowSize();
+#ifndef AVG_ENABLE_EGL
+        if (pDisplayEngine->getNumWindows() == 1 && 
+                m_pMainGLContext->getMemoryMode() == MM_PBO)
+        {
+            m_pReadbackRing = ReadbackRingPtr(new ReadbackRing(m_FrameSize, B8G8R8X8));
+            m_bReadbackFlipped = true;
+        }
+#endif
     } else {
         m_FrameSize = m_pCanvas->getSize();
-        GLContext* pOldContext = GLContext::getCurrent();
-        m_pMainGLContext = pDisplayEngine->getWindow(0)->getGLContext();
-        m_pMainGLContext->activate();
         m_pFBO = dynamic_pointer_cast<OffscreenCanvas>(m_pCanvas)->
                 getFBO(m_pMainGLContext);
+        FBOPtr pReadFBO = m_pFBO;
         if (GLContext::getCurrent()->useGPUYUVConversion()) {
             m_pFilter = GPURGB2YUVFilterPtr(new GPURGB2YUVFilter(m_FrameSize));
+            pReadFBO = m_pFilter->getFBO(m_pMainGLContext);
         }
-        pOldContext->activate();
+#ifndef AVG_ENABLE_EGL
+        m_pReadbackRing = ReadbackRingPtr(new ReadbackRing(pReadFBO->getSize(), 
+                pReadFBO->getTex()->getPF()));
+#endif
     }
+    pOldContext->activate();
     VideoWriterThread writer(m_CmdQueue, m_sOutFileName, m_FrameSize, m_FrameRate, 
             qMin, qMax);
     m_pThread = new boost::thread(writer);
@@ -111,12 +128,13 @@ VideoWriter::~VideoWriter()
         m_pThread->join();
         delete m_pThread;
     }
+    deleteReadbackRing();
 }
 
 void VideoWriter::stop()
 {
     if (!m_bStopped) {
-        getFrameFromPBO();
+        getFramesFromPBO(true);
         if (!m_bHasValidData) {
             writeDummyFrame();
         }
@@ -129,6 +147,8 @@ void VideoWriter::stop()
 
         m_pFBO = FBOPtr();
         m_pFilter = GPURGB2YUVFilterPtr();
+        // The readback ring stays alive until the encoder thread has finished, since
+        // the encoder may still be working on bitmaps in mapped buffers.
     }
 }
 
@@ -176,19 +196,13 @@ int VideoWriter::getQMax() const
 
 void VideoWriter::onFrameEnd()
 {
-    // The VideoWriter handles OffscreenCanvas and MainCanvas differently:
-    // For MainCanvas, it simply does a screenshot onFrameEnd and sends that to the 
-    // VideoWriterThread immediately.
-    // For OffscreenCanvas, an asynchronous PBO readback is started in onFrameEnd.
-    // In the next frame's onFrameEnd, the data is read into a bitmap and sent to 
-    // the VideoWriterThread.
-    if (m_pFBO) {
-        // Read last frame's bitmap.
-        GLContext* pOldContext = GLContext::getCurrent();
-        m_pMainGLContext->activate();
-        getFrameFromPBO();
-        pOldContext->activate();
-    }
+    // Frames are read back asynchronously using a ring of PBOs: In onFrameEnd, all 
+    // readbacks that have completed in the meantime (usually the ones started two or
+    // three frames earlier) are sent to the VideoWriterThread, and a readback of the
+    // current frame is started. The VideoWriterThread gets the mapped buffers directly.
+    // If PBOs are not available for the main canvas, a synchronous screenshot is 
+    // taken and sent to the VideoWriterThread immediately.
+    getFramesFromPBO(false);
     if (m_StartTime == -1) {
         m_StartTime = Player::get()->getFrameTime();
     }
@@ -200,65 +214,104 @@ void VideoWriter::onFrameEnd()
                     - m_PauseTime;
             float timePerFrame = 1000.f/m_FrameRate;
             int wantedFrame = int(movieTime/timePerFrame+0.1);
-            if (wantedFrame > m_CurFrame) {
+            if (wantedFrame > m_CurFrame + (int)getNumPendingFrames()) {
                 getFrameFromFBO();
-                if (wantedFrame > m_CurFrame + 1) {
-                    m_CurFrame = wantedFrame - 1;
+                if (wantedFrame > m_CurFrame + (int)getNumPendingFrames()) {
+                    m_CurFrame = wantedFrame - getNumPendingFrames();
                 }
             }
         }
     }
-    
-    if (!m_pFBO) {
-        getFrameFromPBO();
-    }
 }
 
 void VideoWriter::getFrameFromFBO()
 {
-    if (m_pFBO) {
+    if (m_pReadbackRing) {
         GLContext* pOldContext = GLContext::getCurrent();
         m_pMainGLContext->activate();
         if (m_pFilter) {
             m_pFilter->apply(m_pMainGLContext, m_pFBO->getTex());
-            FBOPtr pYUVFBO = m_pFilter->getFBO(m_pMainGLContext);
-            pYUVFBO->moveToPBO();
-        } else {
-            m_pFBO->moveToPBO();
+        }
+        if (!startReadback()) {
+            // All buffers are in use: Wait for the oldest readback to free one.
+            BitmapPtr pBmp = m_pReadbackRing->getImage(true);
+            sendFrameToEncoder(pBmp, m_bReadbackFlipped);
+            bool bOk = startReadback();
+            AVG_ASSERT(bOk);
         }
         pOldContext->activate();
-        m_bFramePending = true;
     } else {
         BitmapPtr pBmp = Player::get()->getDisplayEngine()->screenshot(GL_BACK);
         sendFrameToEncoder(pBmp);
     }
 }
 
-void VideoWriter::getFrameFromPBO()
+bool VideoWriter::startReadback()
 {
-    if (m_bFramePending) {
-        BitmapPtr pBmp;
+#ifdef AVG_ENABLE_EGL
+    AVG_ASSERT(false);
+    return false;
+#else
+    if (m_pFilter) {
+        return m_pReadbackRing->readFBO(*m_pFilter->getFBO(m_pMainGLContext));
+    } else if (m_pFBO) {
+        return m_pReadbackRing->readFBO(*m_pFBO);
+    } else {
+        return m_pReadbackRing->readWindow(GL_BACK);
+    }
+#endif
+}
+
+void VideoWriter::getFramesFromPBO(bool bWait)
+{
+#ifndef AVG_ENABLE_EGL
+    if (m_pReadbackRing) {
         GLContext* pOldContext = GLContext::getCurrent();
         m_pMainGLContext->activate();
-        if (m_pFilter) {
-            pBmp = m_pFilter->getFBO(m_pMainGLContext)->getImageFromPBO();
-        } else {
-            pBmp = m_pFBO->getImageFromPBO();
+        BitmapPtr pBmp = m_pReadbackRing->getImage(bWait);
+        while (pBmp) {
+            sendFrameToEncoder(pBmp, m_bReadbackFlipped);
+            pBmp = m_pReadbackRing->getImage(bWait);
         }
+        pOldContext->activate();
+    }
+#endif
+}
+
+unsigned VideoWriter::getNumPendingFrames() const
+{
+#ifdef AVG_ENABLE_EGL
+    return 0;
+#else
+    if (m_pReadbackRing) {
+        return m_pReadbackRing->getNumPending();
+    } else {
+        return 0;
+    }
+#endif
+}
+
+void VideoWriter::deleteReadbackRing()
+{
+    if (m_pReadbackRing) {
+        GLContext* pOldContext = GLContext::getCurrent();
+        m_pMainGLContext->activate();
+        m_pReadbackRing = ReadbackRingPtr();
+        if (pOldContext) {
             pOldContext->activate();
-        sendFrameToEncoder(pBmp);
-        m_bFramePending = false;
+        }
     }
 }
 
-void VideoWriter::sendFrameToEncoder(BitmapPtr pBitmap)
+void VideoWriter::sendFrameToEncoder(BitmapPtr pBitmap, bool bFlip)
 {
     m_CurFrame++;
     m_bHasValidData = true;
     if (m_pFilter) {
         m_CmdQueue.pushCmd(boost::bind(&VideoWriterThread::encodeYUVFrame, _1, pBitmap));
     } else {
-        m_CmdQueue.pushCmd(boost::bind(&VideoWriterThread::encodeFrame, _1, pBitmap));
+        m_CmdQueue.pushCmd(boost::bind(&VideoWriterThread::encodeFrame, _1, pBitmap,
+                bFlip));
     }
 }
 
@@ -268,6 +321,7 @@ void VideoWriter::onPlaybackEnd()
     m_pThread->join();
     delete m_pThread;
     m_pThread = 0;
+    deleteReadbackRing();
 }
 
 void VideoWriter::writeDummyFrame()
@@ -43,6 +43,8 @@ class FBO;
 typedef boost::shared_ptr<FBO> FBOPtr;
 class GPURGB2YUVFilter;
 typedef boost::shared_ptr<GPURGB2YUVFilter> GPURGB2YUVFilterPtr;
+class ReadbackRing;
+typedef boost::shared_ptr<ReadbackRing> ReadbackRingPtr;
 class GLContext;
 
 class AVG_API VideoWriter : public IFrameEndListener, IPlaybackEndListener  
@@ -65,15 +67,20 @@ class AVG_API VideoWriter : public IFrameEndListener, IPlaybackEndListener
 
     private:
         void getFrameFromFBO();
-        void getFrameFromPBO();
+        bool startReadback();
+        void getFramesFromPBO(bool bWait);
+        unsigned getNumPendingFrames() const;
+        void deleteReadbackRing();
 
-        void sendFrameToEncoder(BitmapPtr pBitmap);
+        void sendFrameToEncoder(BitmapPtr pBitmap, bool bFlip=false);
         void writeDummyFrame();
 
         CanvasPtr m_pCanvas;
         GLContext* m_pMainGLContext;
         FBOPtr m_pFBO;
         GPURGB2YUVFilterPtr m_pFilter;
+        ReadbackRingPtr m_pReadbackRing;
+        bool m_bReadbackFlipped;
         std::string m_sOutFileName;
         int m_FrameRate;
         int m_QMin;
@@ -94,7 +101,6 @@ class AVG_API VideoWriter : public IFrameEndListener, IPlaybackEndListener
 
         int m_CurFrame;
         long long m_StartTime;
-        bool m_bFramePending;
 };
 
 }
@@ -67,10 +67,10 @@ void VideoWriterThread::encodeYUVFrame(BitmapPtr pBmp)
     ThreadProfiler::get()->reset();
 }
 
-void VideoWriterThread::encodeFrame(BitmapPtr pBmp)
+void VideoWriterThread::encodeFrame(BitmapPtr pBmp, bool bFlip)
 {
     ScopeTimer timer(ProfilingZoneEncodeFrame);
-    convertRGBImage(pBmp);
+    convertRGBImage(pBmp, bFlip);
     writeFrame(m_pConvertedFrame);
     ThreadProfiler::get()->reset();
 }
@@ -228,11 +228,16 @@ AVFrame* VideoWriterThread::createFrame(AVPixelFormat pixelFormat, IntPoint size
 
 static ProfilingZoneID ProfilingZoneConvertImage(" Convert image", true);
 
-void VideoWriterThread::convertRGBImage(BitmapPtr pSrcBmp)
+void VideoWriterThread::convertRGBImage(BitmapPtr pSrcBmp, bool bFlip)
 {
     ScopeTimer timer(ProfilingZoneConvertImage);
     unsigned char* rgbData[3] = {pSrcBmp->getPixels(), NULL, NULL};
     int rgbStride[3] = {pSrcBmp->getLineLen(), 0, 0};
+    if (bFlip) {
+        // Bottom-up image (e.g. read back from the window): Let swscale flip it.
+        rgbData[0] += (m_Size.y-1)*pSrcBmp->getStride();
+        rgbStride[0] = -pSrcBmp->getStride();
+    }
 
     sws_scale(m_pFrameConversionContext, rgbData, rgbStride,
               0, m_Size.y, m_pConvertedFrame->data, m_pConvertedFrame->linesize);
@@ -43,7 +43,7 @@ class AVG_API VideoWriterThread : public WorkerThread<VideoWriterThread>  {
         virtual ~VideoWriterThread();
 
         void encodeYUVFrame(BitmapPtr pBmp);
-        void encodeFrame(BitmapPtr pBmp);
+        void encodeFrame(BitmapPtr pBmp, bool bFlip);
         void close();
 
     private:
@@ -59,7 +59,7 @@ class AVG_API VideoWriterThread : public WorkerThread<VideoWriterThread>  {
 
         AVFrame* createFrame(AVPixelFormat pixelFormat, IntPoint size);
 
-        void convertRGBImage(BitmapPtr pSrcBmp);
+        void convertRGBImage(BitmapPtr pSrcBmp, bool bFlip);
         void convertYUVImage(BitmapPtr pSrcBmp);
         void writeFrame(AVFrame* pFrame);
 
@@ -20,6 +20,8 @@
 # Current versions can be found at www.libavg.de
 #
 
+import time
+
 from libavg import avg, player
 from libavg.testcase import *
 
@@ -155,6 +157,190 @@ class AVTestCase(AVGTestCase):
                 sys.stderr.write("    threaded: "+str(isThreaded)+"\n")
                 testVideoFile(filename, isThreaded)
 
+    def testVideoDataSource(self):
+        def testSource(source):
+            def setDataSource():
+                node.datasource = source
+                self.assertEqual(node.href, "")
+                node.play()
+
+            def setHRef():
+                node.href = "mpeg1-48x48.mov"
+                self.assertEqual(node.datasource, None)
+
+            self.assertEqual(source.size, len(videoData))
+            root = self.loadEmptyScene()
+            node = avg.VideoNode(size=(96,96), threaded=False, parent=root)
+            self.start(False,
+                    (setDataSource,
+                     lambda: self.compareImage("testVideo-mpeg1-48x48.mov1"),
+                     lambda: node.seekToFrame(20),
+                     None,
+                     lambda: self.assertEqual(node.getCurFrame(), 20),
+                     setHRef,
+                     None,
+                    ))
+
+        videoData = open("media/mpeg1-48x48.mov", "rb").read()
+        archiveName = "videoarchive.tmp"
+        archive = open(archiveName, "wb")
+        archive.write("x"*5000 + videoData + "x"*100)
+        archive.close()
+        regionSource = avg.FileRegionDataSource(archiveName, 5000, len(videoData))
+        self.assertEqual(regionSource.offset, 5000)
+        self.assertRaises(avg.Exception, 
+                lambda: avg.FileRegionDataSource(archiveName, 5000, 10**9))
+        sources = (avg.MemoryDataSource(videoData, "mpeg1-48x48.mov"),
+                avg.MemoryDataSource(open("media/mpeg1-48x48.mov", "rb")),
+                regionSource)
+        for source in sources:
+            testSource(source)
+        sharedNode = avg.VideoNode(shared=True)
+        self.assertRaises(avg.Exception, 
+                lambda: setattr(sharedNode, "datasource", sources[0]))
+        sources = None
+        regionSource = None
+        os.remove(archiveName)
+
+    def testVideoScrub(self):
+        def waitForCache(cache):
+            while not cache.isComplete():
+                time.sleep(0.01)
+
+        def captureFrame():
+            self.startBmp = player.screenshot()
+
+        def seek():
+            videoNode.seekToFrame(26)
+            self.assert_(videoNode.isSeeking())
+
+        def captureScrubFrame():
+            # The decoder thread usually hasn't delivered the real frame yet, so the 
+            # upscaled thumbnail is displayed.
+            if videoNode.isSeeking():
+                self.scrubBmp = player.screenshot()
+
+        def checkScrubFrame():
+            self.assert_(not videoNode.isSeeking())
+            if self.scrubBmp:
+                seekBmp = player.screenshot()
+                self.assert_(self.scrubBmp.subtract(seekBmp).getAvg() < 
+                        self.scrubBmp.subtract(self.startBmp).getAvg())
+
+        def checkUnloaded():
+            videoNode.stop()
+            self.assertEqual(videoNode.scrubcache, None)
+
+        cache = avg.VideoThumbnailCache("media/mpeg1-48x48.mov", interval=0, width=16)
+        self.assertEqual(cache.interval, 0)
+        self.assertEqual(cache.width, 16)
+        waitForCache(cache)
+        self.assert_(cache.getNumThumbnails() > 0)
+        bmp = cache.getBitmap(0)
+        self.assertEqual(bmp.getSize(), (16,16))
+        self.assertNotEqual(cache.getBitmap(100000), None)
+        sameCache = avg.VideoThumbnailCache("media/mpeg1-48x48.mov", interval=0, 
+                width=16)
+        self.assertEqual(sameCache.getNumThumbnails(), cache.getNumThumbnails())
+        self.assertRaises(avg.Exception, 
+                lambda: avg.VideoThumbnailCache("media/mpeg1-48x48.mov", width=0))
+        self.assertRaises(avg.Exception, lambda: avg.VideoNode(scrubinterval=-1))
+
+        # Every frame of an mjpeg file is a keyframe, so there is a thumbnail for the
+        # seek destination. The setup matches testVideoSeek.
+        player.setFakeFPS(25)
+        self.scrubBmp = None
+        root = self.loadEmptyScene()
+        videoNode = avg.VideoNode(href="mjpeg-48x48.avi", size=(96,96), scrub=True, 
+                scrubinterval=0, parent=root)
+        self.assert_(videoNode.scrub)
+        self.assertEqual(videoNode.scrubinterval, 0)
+        self.assertEqual(videoNode.scrubcache, None)
+        videoNode.pause()
+        self.assertNotEqual(videoNode.scrubcache, None)
+        self.start(False,
+                (lambda: waitForCache(videoNode.scrubcache),
+                 captureFrame,
+                 seek,
+                 captureScrubFrame,
+                 None,
+                 None,
+                 checkScrubFrame,
+                 lambda: self.compareImage("testVideoSeek2"),
+                 lambda: videoNode.seekToTime(0),
+                 None,
+                 None,
+                 lambda: self.assertEqual(videoNode.getCurTime(), 0),
+                 checkUnloaded,
+                ))
+
+    def testReplayCamera(self):
+        FRAME_RATE = 100
+        NUM_FRAMES = 20
+        WAIT_TIMEOUT = 10000
+        def createCamera(device, pixelformat, parent):
+            node = avg.CameraNode(driver="replay", device=device, capturewidth=16, 
+                    captureheight=8, pixelformat=pixelformat, framerate=FRAME_RATE, 
+                    parent=parent)
+            node.play()
+            return node
+
+        def getNumFramesDue():
+            return rawNode.getNumFramesCaptured() + rawNode.getNumFramesMissed()
+
+        def checkBitmap(bmp):
+            # y=128, u=128, v=200. The tolerance covers the SIMD YCbCr conversion.
+            self.assertEqual(bmp.getSize(), (16,8))
+            for pos in ((0,0), (8,4), (15,7)):
+                pixel = bmp.getPixel(pos)
+                for value, expected in zip(pixel[:3], (245,71,130)):
+                    self.assert_(abs(value-expected) <= 4)
+
+        def onFrame():
+            if self.startTime is None:
+                if rawNode.getNumFramesCaptured() > 0:
+                    self.startTime = time.time()
+                    self.numStartFramesCaptured = rawNode.getNumFramesCaptured()
+                    self.numStartFramesDue = getNumFramesDue()
+            elif (rawNode.getNumFramesCaptured() >= NUM_FRAMES and 
+                    videoNode.getNumFramesCaptured() > 0):
+                # The camera can't deliver frames faster than its frame rate, and 
+                # frames that weren't fetched in time are counted as missed.
+                expectedFrames = (time.time()-self.startTime)*FRAME_RATE
+                numFramesCaptured = (rawNode.getNumFramesCaptured()-
+                        self.numStartFramesCaptured)
+                self.assert_(numFramesCaptured <= expectedFrames+2)
+                self.assert_(getNumFramesDue()-self.numStartFramesDue >= 
+                        expectedFrames/2)
+                checkBitmap(rawNode.getBitmap())
+                self.assertEqual(videoNode.getBitmap().getSize(), (48,48))
+                self.done = True
+                player.stop()
+
+        def reportStuck():
+            self.fail("Replay camera delivered %d frames in %dms"
+                    %(rawNode.getNumFramesCaptured(), WAIT_TIMEOUT))
+
+        # Two identical YCbCr420p frames: y plane, then u and v planes.
+        rawName = "replaycamera.raw"
+        rawFile = open(rawName, "wb")
+        rawFile.write((chr(128)*16*8 + chr(128)*8*4 + chr(200)*8*4)*2)
+        rawFile.close()
+
+        root = self.loadEmptyScene()
+        rawNode = createCamera(rawName, "YCbCr420p", root)
+        videoNode = createCamera("media/mpeg1-48x48.mov", "BAYER8_RGGB", root)
+        self.assertEqual(videoNode.driver, "replay")
+        self.assertRaises(avg.Exception, 
+                lambda: createCamera(rawName, "R8G8B8X8", root))
+        self.startTime = None
+        self.done = False
+        player.subscribe(player.ON_FRAME, onFrame)
+        player.setTimeout(WAIT_TIMEOUT, reportStuck)
+        player.play()
+        self.assert_(self.done)
+        os.remove(rawName)
+
     def testPlayBeforeConnect(self):
         node = avg.VideoNode(href="media/mpeg1-48x48.mov", threaded=False)
         node.play()
@@ -307,6 +493,182 @@ class AVTestCase(AVGTestCase):
                      lambda: self.compareImage("testVideoSeek3")
                     ))
 
+    def testVideoFastSeek(self):
+        def checkCurFrame(frame):
+            self.assertEqual(videoNode.getCurFrame(), frame)
+
+        def setFastSeek(fastSeek):
+            videoNode.fastseek = fastSeek
+            self.assertEqual(videoNode.fastseek, fastSeek)
+
+        def seek(frame):
+            videoNode.seekToFrame(frame)
+            self.shownFrames = []
+
+        def recordFrame():
+            self.shownFrames.append(videoNode.getCurFrame())
+
+        def checkKeyframeShown(destFrame):
+            # The keyframe before the destination is displayed first, then decoding
+            # continues to the destination.
+            checkCurFrame(destFrame)
+            self.assert_(self.shownFrames[0] < destFrame)
+            self.assert_(self.shownFrames == sorted(self.shownFrames))
+
+        player.setFakeFPS(25)
+        root = self.loadEmptyScene()
+        videoNode = avg.VideoNode(parent=root, threaded=False, fastseek=True,
+                href="mpeg1-48x48.mov")
+        self.assert_(videoNode.fastseek)
+        videoNode.pause()
+        # When paused, decoding continues after the keyframe has been displayed until 
+        # the destination frame is reached. Neither destination is a keyframe.
+        self.start(False,
+                (lambda: seek(20),
+                 recordFrame,
+                 recordFrame,
+                 lambda: checkKeyframeShown(20),
+                 lambda: seek(5),
+                 recordFrame,
+                 recordFrame,
+                 lambda: checkKeyframeShown(5),
+                 lambda: setFastSeek(False),
+                 lambda: videoNode.seekToFrame(25),
+                 None,
+                 lambda: checkCurFrame(25),
+                ))
+
+    def testSharedVideo(self):
+        def checkFrames():
+            curFrame = nodes[0].getCurFrame()
+            self.assert_(curFrame > 0)
+            for node in nodes:
+                self.assertEqual(node.getCurFrame(), curFrame)
+
+        def seekAll(frame):
+            for node in nodes:
+                node.seekToFrame(frame)
+
+        def checkNumSources(numSources):
+            self.assertEqual(avg.SharedVideoSource.getNumSources(), numSources)
+
+        def checkOneSeeked():
+            # The seek only moves the node that was seeked.
+            self.assertEqual(nodes[1].getCurFrame(), nodes[2].getCurFrame())
+            self.assert_(nodes[0].getCurFrame() < nodes[1].getCurFrame())
+
+        player.setFakeFPS(25)
+        root = self.loadEmptyScene()
+        nodes = [avg.VideoNode(parent=root, shared=True, pos=(i*48,0), 
+                href="mpeg1-48x48.mov") for i in range(3)]
+        self.assert_(nodes[0].shared)
+        self.assertRaises(avg.Exception, 
+                lambda: avg.VideoNode(shared=True, threaded=False, 
+                        href="mpeg1-48x48.mov"))
+        for node in nodes:
+            node.play()
+        self.start(False,
+                (None,
+                 None,
+                 None,
+                 None,
+                 checkFrames,
+                 lambda: checkNumSources(1),
+                 lambda: seekAll(10),
+                 lambda: checkNumSources(1),
+                 None,
+                 checkFrames,
+                 lambda: nodes[0].seekToFrame(2),
+                 None,
+                 None,
+                 checkOneSeeked,
+                 lambda: checkNumSources(2),
+                ))
+
+    def testVideoAsyncOpen(self):
+        def onReady():
+            self.assert_(not videoNode.isOpenPending())
+            self.assertEqual(videoNode.getMediaSize(), (48,48))
+            self.assert_(videoNode.getDuration() > 0)
+            player.stop()
+
+        player.setFakeFPS(25)
+        root = self.loadEmptyScene()
+        videoNode = avg.VideoNode(parent=root, asyncopen=True, href="mpeg1-48x48.mov")
+        self.assert_(videoNode.asyncopen)
+        videoNode.subscribe(avg.Node.STREAM_READY, onReady)
+        videoNode.play()
+        self.assert_(videoNode.isOpenPending())
+        self.assertRaises(avg.Exception, videoNode.getDuration)
+        player.play()
+        self.assert_(not videoNode.isOpenPending())
+
+        # Unloading the node while the open is pending cancels it.
+        root = self.loadEmptyScene()
+        videoNode = avg.VideoNode(parent=root, asyncopen=True, href="mpeg1-48x48.mov")
+        videoNode.play()
+        videoNode.stop()
+        self.assert_(not videoNode.isOpenPending())
+
+        # Files that can't be opened cause an error message.
+        def onError(message):
+            self.assert_(not videoNode.isOpenPending())
+            self.assertNotEqual(message, "")
+            self.errorReceived = True
+            player.stop()
+
+        def onNoError():
+            self.fail("No STREAM_ERROR")
+
+        self.errorReceived = False
+        root = self.loadEmptyScene()
+        videoNode = avg.VideoNode(parent=root, asyncopen=True, href="nonexistent.mov")
+        videoNode.subscribe(avg.Node.STREAM_ERROR, onError)
+        videoNode.subscribe(avg.Node.STREAM_READY, lambda: self.fail("STREAM_READY"))
+        videoNode.play()
+        player.setTimeout(10000, onNoError)
+        player.play()
+        self.assert_(self.errorReceived)
+
+    def testVideoAdaptiveDecode(self):
+        # A low player frame rate simulates a machine that can only display every 
+        # fifth frame of the video. Skipping should start and stop again when the 
+        # player is back at the video's frame rate.
+        WAIT_TIMEOUT = 10000
+        def onFrame():
+            if self.phase == "overload":
+                if videoNode.isSkippingFrames():
+                    # Most decoded frames are too late to be displayed.
+                    self.assert_(videoNode.getNumFramesDroppedLate() > 0)
+                    self.phase = "skipping"
+            elif self.phase == "skipping":
+                # Skipped frames are counted when the next decoded frame arrives.
+                if videoNode.getNumFramesSkipped() > 0:
+                    self.phase = "recover"
+                    self.numFramesDecoded = videoNode.getNumFramesDecoded()
+                    player.setFakeFPS(25)
+            elif not videoNode.isSkippingFrames():
+                self.assert_(videoNode.getNumFramesDecoded() > self.numFramesDecoded)
+                self.phase = "done"
+                player.stop()
+
+        def reportStuck():
+            self.fail("Adaptive decoding still in phase '%s' after %dms"
+                    %(self.phase, WAIT_TIMEOUT))
+
+        player.setFakeFPS(5)
+        root = self.loadEmptyScene()
+        videoNode = avg.VideoNode(parent=root, adaptivedecode=True, loop=True, 
+                href="mpeg1-48x48.mov")
+        self.assert_(videoNode.adaptivedecode)
+        self.assertRaises(avg.Exception, videoNode.getNumFramesDecoded)
+        videoNode.play()
+        self.phase = "overload"
+        player.subscribe(player.ON_FRAME, onFrame)
+        player.setTimeout(WAIT_TIMEOUT, reportStuck)
+        player.play()
+        self.assertEqual(self.phase, "done")
+
     def testVideoFPS(self):
         player.setFakeFPS(25)
         root = self.loadEmptyScene()
@@ -347,6 +709,56 @@ class AVTestCase(AVGTestCase):
             player.subscribe(player.ON_FRAME, onFrame)
             player.play()
 
+    def testLoopPreroll(self):
+        # Threaded looping videos keep decoding across the end of the file, so the 
+        # first frame of the next iteration is available immediately and no frames
+        # are missed around the loop point.
+        def onEOF():
+            self.assert_(node.getCurFrame() <= 1)
+            self.eofFrames.append(len(self.lateCounts))
+
+        def onFrame():
+            self.lateCounts.append(
+                    (node.getNumFramesTooLate(), node.getNumFramesDroppedLate()))
+            if len(self.eofFrames) == 2 and len(self.lateCounts) > self.eofFrames[1]+2:
+                player.stop()
+
+        def onSoundEOF():
+            self.numSoundEOFs += 1
+            if self.numSoundEOFs == 2:
+                player.stop()
+
+        def reportStuck():
+            self.fail("Looping SoundNode didn't report END_OF_FILE")
+
+        for filename in ("mpeg1-48x48.mov", "mpeg1-48x48-sound.avi"):
+            self.eofFrames = []
+            self.lateCounts = []
+            player.setFakeFPS(25)
+            root = self.loadEmptyScene()
+            node = avg.VideoNode(parent=root, loop=True, fps=25, href=filename)
+            node.subscribe(avg.Node.END_OF_FILE, onEOF)
+            node.play()
+            player.subscribe(player.ON_FRAME, onFrame)
+            player.play()
+            self.assertEqual(len(self.eofFrames), 2)
+            for eofFrame in self.eofFrames:
+                self.assertEqual(self.lateCounts[eofFrame-2], 
+                        self.lateCounts[eofFrame+2])
+
+        # Audio-only files loop in the audio decoder and still need to report EOF.
+        WAIT_TIMEOUT = 10000
+        self.numSoundEOFs = 0
+        player.setFakeFPS(-1)
+        player.volume = 0
+        root = self.loadEmptyScene()
+        node = avg.SoundNode(parent=root, loop=True, href="48kHz_16bit_mono.wav")
+        node.subscribe(avg.Node.END_OF_FILE, onSoundEOF)
+        node.play()
+        player.setTimeout(WAIT_TIMEOUT, reportStuck)
+        player.play()
+        self.assertEqual(self.numSoundEOFs, 2)
+
     def testVideoMask(self):
         def testWithFile(filename, testImgName):
             def setMask(href):
@@ -659,14 +1071,22 @@ def AVTestSuite(tests):
             "testSoundEOF",
             "testVideoInfo",
             "testVideoFiles",
+            "testVideoDataSource",
+            "testVideoScrub",
+            "testReplayCamera",
             "testPlayBeforeConnect",
             "testVideoState",
             "testVideoActive",
             "testVideoHRef",
             "testVideoOpacity",
             "testVideoSeek",
+            "testVideoFastSeek",
+            "testSharedVideo",
+            "testVideoAsyncOpen",
+            "testVideoAdaptiveDecode",
             "testVideoFPS",
             "testLoop",
+            "testLoopPreroll",
             "testVideoMask",
             "testVideoEOF",
             "testVideoSeekAfterEOF",
@@ -510,6 +510,67 @@ class AnimTestCase(AVGTestCase):
         genericObject3 = None
 
 
+    def testManyAnims(self):
+        def startAnims():
+            for i, node in enumerate(self.__nodes):
+                avg.LinearAnim(node, "pos", 200, (0,0), (i,100)).start()
+                avg.EaseInOutAnim(node, "opacity", 300, 1, 0, 100, 100, False, None,
+                        onStop).start()
+
+        def onStop():
+            self.__numStopCalls += 1
+
+        def checkResult():
+            self.assertEqual(self.__numStopCalls, len(self.__nodes))
+            for i, node in enumerate(self.__nodes):
+                self.assertEqual(node.pos, (i,100))
+                self.assertEqual(node.opacity, 0)
+
+        root = self.loadEmptyScene()
+        player.setFakeFPS(10)
+        self.__nodes = [avg.RectNode(size=(10,10), parent=root) for i in range(500)]
+        self.__numStopCalls = 0
+        self.start(False,
+                (startAnims,
+                 lambda: self.assertEqual(avg.Anim.getNumRunningAnims(), 1000),
+                 None,
+                 lambda: self.assertEqual(avg.Anim.getNumRunningAnims(), 500),
+                 None,
+                 checkResult,
+                 lambda: self.assertEqual(avg.Anim.getNumRunningAnims(), 0),
+                ))
+        self.__nodes = None
+
+    def testOverriddenAttrAnim(self):
+        # Attributes overridden in python must still be set through python.
+        class CustomDivNode(avg.DivNode):
+            def __init__(self, parent=None, **kwargs):
+                avg.DivNode.__init__(self, **kwargs)
+                self.registerInstance(self, parent)
+                self.numSets = 0
+
+            def getX(self):
+                return avg.DivNode.x.__get__(self)
+
+            def setX(self, x):
+                self.numSets += 1
+                avg.DivNode.x.__set__(self, x)
+
+            x = property(getX, setX)
+
+        root = self.loadEmptyScene()
+        player.setFakeFPS(10)
+        self.__node = CustomDivNode(parent=root)
+        anim = avg.LinearAnim(self.__node, "x", 200, 0, 100)
+        self.start(False,
+                (anim.start,
+                 None,
+                 None,
+                 lambda: self.assertEqual(self.__node.x, 100),
+                 lambda: self.assert_(self.__node.numSets >= 3),
+                ))
+        self.__node = None
+
     def _testPointAnim(self, startPos, endPos, keepAttrPos, startPosImgSrc, endPosImgSrc,
             keepAttrPosImgSrc):
         def startAnim():
@@ -554,7 +615,9 @@ def animTestSuite(tests):
         "testParallelAnimRegistry",
         "testStateAnim",
         "testStateAnimRegistry",
-        "testNonNodeAttrAnim"
+        "testNonNodeAttrAnim",
+        "testManyAnims",
+        "testOverriddenAttrAnim",
         )
     return createAVGTestSuite(availableTests, AnimTestCase, tests)
 
@@ -374,6 +374,41 @@ class DynamicsTestCase(AVGTestCase):
         testNodePythonSubclass()
         testRegisterInstanceException()
 
+    def testNodeCreationSpeed(self):
+        # Benchmark for node construction from python args and from xml.
+        NUM_NODES = 10000
+        root = self.loadEmptyScene()
+
+        with LogDuration("%i nodes created from args"%NUM_NODES):
+            for i in xrange(NUM_NODES):
+                attrs = {"pos": (i%100, i/100), "size": (10, 10), "color": "FF0000",
+                        "strokewidth": 2, "opacity": 0.5}
+                avg.RectNode(parent=root, **attrs)
+
+        with LogDuration("%i nodes created from xml"%NUM_NODES):
+            for i in xrange(NUM_NODES):
+                node = player.createNode(
+                        "<rect pos='(%i, 3)' size='(10, 10)' color='00FF00'/>"%i)
+        self.assertEqual(node.pos, (NUM_NODES-1, 3))
+
+        with LogDuration("div with %i children created from xml"%NUM_NODES):
+            div = player.createNode("<div>" + 
+                    "<rect pos='(1,2)' size='(10, 10)' fillopacity='0.5'/>"*NUM_NODES +
+                    "</div>")
+
+        self.assertEqual(root.getNumChildren(), NUM_NODES)
+        lastNode = root.getChild(NUM_NODES-1)
+        self.assertEqual(lastNode.pos, (99, 99))
+        self.assertEqual(lastNode.strokewidth, 2)
+        self.assertEqual(div.getNumChildren(), NUM_NODES)
+        self.assertEqual(div.getChild(0).fillopacity, 0.5)
+        # Setting args must not change the defaults of the node type.
+        node = avg.RectNode()
+        self.assertEqual(node.pos, (0, 0))
+        self.assertEqual(node.strokewidth, 1)
+        self.assertEqual(node.fillopacity, 0)
+        self.assertRaises(avg.Exception, lambda: avg.RectNode(foo=1))
+
     def testDynamicMediaDir(self):
         def attachNode():
             root.appendChild(imageNode1)
@@ -403,6 +438,7 @@ def dynamicsTestSuite(tests):
             "testComplexDiv",
             "testNodeCustomization",
             "testDynamicMediaDir",
+            "testNodeCreationSpeed",
             )
 
     return createAVGTestSuite(availableTests, DynamicsTestCase, tests)
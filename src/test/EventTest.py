@@ -971,6 +971,48 @@ class EventTestCase(AVGTestCase):
         self.assertEqual(self.numContactCallbacks, 1)
         self.assertEqual(self.numMotionCallbacks, 1)
         
+    def testCoalescedTouchEvents(self):
+
+        def onMotion(event):
+            self.numMotionCallbacks += 1
+            self.assertEqual(event.pos, (40,10))
+            events = event.contact.events
+            positions = [e.pos for e in events]
+            self.assertEqual(positions, [(10,10), (20,10), (30,10), (40,10)])
+            self.assertEqual(event.contact.distancetravelled, 30)
+            # All motion events arrived in one frame, 40 ms after the down event.
+            for i, expectedSpeed in ((1, 0.25), (2, 0.5), (3, 0.75)):
+                self.assertAlmostEqual(events[i].speed.x, expectedSpeed)
+                self.assertEqual(events[i].speed.y, 0)
+                self.assertNotEqual(events[i].inputdevice, None)
+                self.assertEqual(events[i].inputdevicename, event.inputdevicename)
+
+        def sendMotions():
+            self.numCoalescedEvents = player.getNumCoalescedEvents()
+            self._sendTouchEvents((
+                    (1, avg.Event.CURSOR_MOTION, 20, 10),
+                    (1, avg.Event.CURSOR_MOTION, 30, 10),
+                    (1, avg.Event.CURSOR_MOTION, 40, 10),
+                    (1, avg.Event.CURSOR_MOTION, 40, 10),
+                    ))
+
+        def checkNumCoalescedEvents():
+            # Two motion events merged, one without motion dropped.
+            self.assertEqual(player.getNumCoalescedEvents(), 
+                    self.numCoalescedEvents+3)
+
+        root = self.loadEmptyScene()
+        root.subscribe(avg.Node.CURSOR_MOTION, onMotion)
+        self.numMotionCallbacks = 0
+        player.setFakeFPS(25)
+        self.start(False,
+                (lambda: self._sendTouchEvent(1, avg.Event.CURSOR_DOWN, 10, 10),
+                 sendMotions,
+                 checkNumCoalescedEvents,
+                 lambda: self._sendTouchEvent(1, avg.Event.CURSOR_UP, 40, 10),
+                ))
+        self.assertEqual(self.numMotionCallbacks, 1)
+
     def testMultiContactRegistration(self):
 
         def onDown(event):
@@ -1147,6 +1189,7 @@ def eventTestSuite(tests):
             "testException",
             "testContacts",
             "testContactRegistration",
+            "testCoalescedTouchEvents",
             "testMultiContactRegistration",
             "testPlaybackMessages",
             "testImageSizeChanged",
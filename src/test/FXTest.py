@@ -212,6 +212,88 @@ class FXTestCase(AVGTestCase):
                  lambda: setRadius(300),
                 ))
 
+    def testBlurFXFast(self):
+       
+        def setRadius(radius):
+            self.effect.radius = radius
+
+        def setFast(fast):
+            self.effect.fast = fast
+
+        root = self.loadEmptyScene()
+        self.node = avg.ImageNode(parent=root, pos=(10,10), href="rgb24-64x64.png")
+        self.effect = avg.BlurFXNode(fast=True)
+        self.assert_(self.effect.fast)
+        self.start(False,
+                (self.skipIfMinimalShader,
+                 lambda: self.node.setEffect(self.effect),
+                 lambda: self.compareImage("testBlurFX1"),
+                 lambda: setRadius(8),
+                 lambda: self.compareImage("testBlurFX2"),
+                 lambda: setFast(False),
+                 lambda: self.compareImage("testBlurFX2"),
+                 lambda: setFast(True),
+                 lambda: self.compareImage("testBlurFX2"),
+                 lambda: setRadius(40),
+                 self._compareFastToLegacy(self.effect),
+                 lambda: setRadius(300),
+                 self._compareFastToLegacy(self.effect),
+                ))
+
+    def testSharedFX(self):
+       
+        def setRadius(radius):
+            self.effect.radius = radius
+
+        def invalidateAll():
+            for node in (self.node, self.sharedNode):
+                node.intensity = (1,1,1)
+
+        def setBudget(budget):
+            player.fxBudget = budget
+
+        def checkNumFXRenders(numRenders):
+            frame = player.getFrameStats().getLastFrame()
+            self.assertEqual(frame.numFXRenders, numRenders)
+
+        root = self.loadEmptyScene()
+        # Identical image and effect, but outside of the window. Only one of the 
+        # nodes renders the effect, the other one displays the shared result.
+        self.sharedNode = avg.ImageNode(parent=root, pos=(200,10), 
+                href="rgb24-64x64.png")
+        self.sharedEffect = avg.BlurFXNode(8)
+        self.sharedNode.setEffect(self.sharedEffect)
+        self.node = avg.ImageNode(parent=root, pos=(10,10), href="rgb24-64x64.png")
+        self.effect = avg.BlurFXNode(8)
+        self.node.setEffect(self.effect)
+        self.assertEqual(player.fxBudget, 0)
+        self.assertRaises(avg.Exception, lambda: setBudget(-1))
+        self.start(False,
+                (self.skipIfMinimalShader,
+                 lambda: self.compareImage("testBlurFX2"),
+                 invalidateAll,
+                 lambda: checkNumFXRenders(1),
+                 lambda: self.compareImage("testBlurFX2"),
+                 lambda: setRadius(1),
+                 lambda: checkNumFXRenders(1),
+                 lambda: self.compareImage("testBlurFX1"),
+                 invalidateAll,
+                 lambda: checkNumFXRenders(2),
+                 lambda: setRadius(8),
+                 lambda: self.compareImage("testBlurFX2"),
+                 # Different effects, so the budget defers one of the renders.
+                 lambda: setattr(self.sharedEffect, "radius", 4),
+                 lambda: setBudget(1),
+                 invalidateAll,
+                 lambda: checkNumFXRenders(1),
+                 lambda: checkNumFXRenders(1),
+                 lambda: checkNumFXRenders(0),
+                 lambda: self.compareImage("testBlurFX2"),
+                 lambda: self.sharedNode.unlink(True),
+                 lambda: self.compareImage("testBlurFX2"),
+                 lambda: setBudget(0),
+                ))
+
     def testHueSatFX(self):
 
         def resetFX(**kwargs):
@@ -313,6 +395,53 @@ class FXTestCase(AVGTestCase):
                  lambda: self.compareImage("testShadowFX6"),
                 ))
 
+    def testShadowFXFast(self):
+        
+        def setParams(offset, radius, opacity, color):
+            effect.offset = offset
+            effect.radius = radius
+            effect.opacity = opacity
+            effect.color =  color
+
+        root = self.loadEmptyScene()
+        rect = avg.RectNode(parent=root, pos=(9.5,9.5), color="0000FF")
+        self.node = avg.ImageNode(parent=root, pos=(10,10), href="shadow.png")
+        rect.size = self.node.size + (1, 1)
+        effect = avg.ShadowFXNode((0,0), 1, 1, "FFFFFF", fast=True)
+        self.start(False,
+                (self.skipIfMinimalShader,
+                 lambda: self.node.setEffect(effect),
+                 lambda: self.compareImage("testShadowFX1"),
+                 lambda: setParams((0,0), 3, 2, "00FFFF"),
+                 lambda: self.compareImage("testShadowFX2"),
+                 lambda: setParams((-2,-2), 3, 1, "FFFFFF"),
+                 lambda: self.compareImage("testShadowFX5"),
+                 lambda: setParams((0,0), 0, 1, "FFFFFF"),
+                 lambda: self.compareImage("testShadowFX6"),
+                 lambda: setParams((0,0), 40, 1, "FFFFFF"),
+                 self._compareFastToLegacy(effect),
+                 lambda: setParams((0,0), 40, 3, "FFFFFF"),
+                 self._compareFastToLegacy(effect),
+                ))
+
+    def _compareFastToLegacy(self, effect):
+        # There are no baseline images for large radii, so the output of the legacy
+        # filter is used as reference.
+        def storeFastBmp():
+            self.__fastBmp = player.screenshot()
+
+        def setFast(fast):
+            effect.fast = fast
+
+        def compareLegacyBmp():
+            self.assert_(self.areSimilarBmps(self.__fastBmp, player.screenshot(), 2, 6))
+
+        return (storeFastBmp,
+                lambda: setFast(False),
+                compareLegacyBmp,
+                lambda: setFast(True),
+               )
+
     def testWordsShadowFX(self):
 
         def setParams(offset, radius, opacity, color):
@@ -497,9 +626,12 @@ def fxTestSuite(tests):
             "testNodeInCanvasNullFX",
             "testRenderPipeline",
             "testBlurFX",
+            "testBlurFXFast",
             "testHueSatFX",
             "testInvertFX",
             "testShadowFX",
+            "testShadowFXFast",
+            "testSharedFX",
             "testWordsShadowFX",
             "testGamma",
             "testIntensity",
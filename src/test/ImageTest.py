@@ -165,6 +165,88 @@ class ImageTestCase(AVGTestCase):
         self.assert_(cache.getMemUsed() == (0,0))
         cache.capacity = oldCapacity
 
+    def testTexUploadBudget(self):
+        def setBudget(budget):
+            player.texUploadBudget = budget
+
+        def addNodes():
+            for i, href in enumerate(("rgb24-64x64.png", "rgb24alpha-64x64.png",
+                    "rgb24-32x32.png", "rgb24alpha-32x32.png")):
+                avg.ImageNode(pos=(i*64,0), href=href, parent=root)
+
+        def checkDeferred(numDeferred):
+            self.assertEqual(player.getNumDeferredTexUploads(), numDeferred)
+
+        root = self.loadEmptyScene()
+        self.assertEqual(player.texUploadBudget, 0)
+        self.assertRaises(avg.Exception, lambda: setBudget(-1))
+        # Budget allows for one upload per frame.
+        setBudget(1)
+        self.start(False,
+                (addNodes,
+                 lambda: checkDeferred(3),
+                 lambda: checkDeferred(2),
+                 lambda: checkDeferred(1),
+                 lambda: checkDeferred(0),
+                 lambda: setBudget(0),
+                 addNodes,
+                 lambda: checkDeferred(0),
+                ))
+
+    def testLOD(self):
+        def checkLevel(node, level, bmpSize):
+            self.assertEqual(node.lodlevel, level)
+            self.assertEqual(node.getMediaSize(), (64,64))
+            self.assertEqual(node.getBitmap().getSize(), bmpSize)
+
+        def setSize(size):
+            lodNode.size = size
+
+        root = self.loadEmptyScene()
+        lodNode = avg.ImageNode(href="rgb24-64x64.png", size=(16,16), lod=True, 
+                parent=root)
+        self.assert_(lodNode.lod)
+        checkLevel(lodNode, 2, (16,16))
+        # Loads the full-resolution level into the cache.
+        fullNode = avg.ImageNode(href="rgb24-64x64.png", pos=(64,0), parent=root)
+        self.assert_(not(fullNode.lod))
+        self.assertEqual(fullNode.lodlevel, 0)
+        self.start(False,
+                (lambda: checkLevel(lodNode, 2, (16,16)),
+                 lambda: setSize((64,64)),
+                 lambda: checkLevel(lodNode, 0, (64,64)),
+                 lambda: setSize((16,16)),
+                 lambda: checkLevel(lodNode, 2, (16,16)),
+                ))
+
+    def testLODAsync(self):
+        WAIT_TIMEOUT = 5000
+        def onFrame():
+            if lodNode.lodlevel == 0:
+                self.assertEqual(lodNode.getBitmap().getSize(), (64,64))
+                player.stop()
+            else:
+                # The current level stays on screen until the new one is loaded.
+                self.assertEqual(lodNode.lodlevel, 2)
+                self.assertEqual(lodNode.getBitmap().getSize(), (16,16))
+
+        def reportStuck():
+            raise RuntimeError("Level 0 wasn't loaded within %dms"%WAIT_TIMEOUT)
+
+        root = self.loadEmptyScene()
+        # Evict unused images so the full-resolution level has to be loaded in the
+        # background.
+        capacity = player.imageCache.capacity
+        player.imageCache.capacity = (0, 0)
+        player.imageCache.capacity = capacity
+        lodNode = avg.ImageNode(href="rgb24-64x64.png", size=(16,16), lod=True, 
+                parent=root)
+        self.assertEqual(lodNode.lodlevel, 2)
+        lodNode.size = (64,64)
+        player.subscribe(player.ON_FRAME, onFrame)
+        player.setTimeout(WAIT_TIMEOUT, reportStuck)
+        player.play()
+
     def testBitmap(self):
         def getBitmap(node):
             bmp = node.getBitmap()
@@ -578,6 +660,9 @@ def imageTestSuite(tests):
             "testImagePos",
             "testImageSize",
             "testImageCache",
+            "testTexUploadBudget",
+            "testLOD",
+            "testLODAsync",
             "testBitmap",
             "testBitmapManager",
             "testBitmapManagerException",
@@ -85,6 +85,16 @@ class LoggerTestCase(AVGTestCase):
     def testUnknownCategoryWarning(self):
         self.assertRaises(RuntimeError, lambda: logger.error("Foo", "Bar"))
 
+    def testAsync(self):
+        logger.configureCategory(logger.Category.APP, logger.Severity.INFO)
+        logger.async = True
+        self.assert_(logger.async)
+        logger.info(self.testMsg)
+        logger.flush()
+        logger.async = False
+        self.assert_(not(logger.async))
+        self._assertMsg()
+
 
 def loggerTestSuite(tests):
     availableTests = (
@@ -94,5 +104,6 @@ def loggerTestSuite(tests):
             "testOmitCategory",
             "testLogCategory",
             "testUnknownCategoryWarning",
+            "testAsync",
             )
     return createAVGTestSuite(availableTests, LoggerTestCase, tests)
@@ -309,6 +309,38 @@ class OffscreenTestCase(AVGTestCase):
                  lambda: self.compareImage("testOffscreenAutoRender2")
                 ))
 
+    def testCanvasSkipUnchanged(self):
+        def createCanvas():
+            canvas = self.__createOffscreenCanvas("testcanvas", False)
+            canvas.skipunchanged = True
+            avg.ImageNode(href="canvas:testcanvas", parent=root)
+            return canvas
+
+        def storeNumRenders():
+            self.__numRenders = self.__offscreenCanvas.numrenders
+
+        def checkSkipped():
+            self.assertEqual(self.__offscreenCanvas.numrenders, self.__numRenders)
+            self.assert_(self.__offscreenCanvas.numskippedframes > 0)
+            self.assert_(self.__offscreenCanvas.lastrendertime >= 0)
+
+        def changeContent():
+            self.__offscreenCanvas.getElementByID("test1").x = 42
+
+        root = self.loadEmptyScene()
+        self.__offscreenCanvas = createCanvas()
+        self.start(False,
+                (lambda: self.assert_(self.__offscreenCanvas.skipunchanged),
+                 lambda: self.compareImage("testOffscreenAutoRender1"),
+                 storeNumRenders,
+                 None,
+                 checkSkipped,
+                 changeContent,
+                 lambda: self.compareImage("testOffscreenAutoRender2"),
+                 lambda: self.assertEqual(self.__offscreenCanvas.numrenders, 
+                        self.__numRenders+1),
+                ))
+
     def testCanvasCrop(self):
         root = self.loadEmptyScene()
         canvas = player.createCanvas(id="testcanvas", size=(160,120), 
@@ -506,6 +538,7 @@ def offscreenTestSuite(tests):
                 "testCanvasEventCapture",
                 "testCanvasRender",
                 "testCanvasAutoRender",
+                "testCanvasSkipUnchanged",
                 "testCanvasCrop",
                 "testCanvasAlpha",
                 "testCanvasBackface",
@@ -21,8 +21,9 @@
 
 import math
 import threading
+import time
 
-from libavg import avg, player
+from libavg import avg, player, logger
 from libavg.testcase import *
 
 class PlayerTestCase(AVGTestCase):
@@ -438,6 +439,60 @@ class PlayerTestCase(AVGTestCase):
                 ))
 
 
+    def testManyTimeouts(self):
+        # Benchmark for timeout handling with many short-lived timeouts.
+        NUM_TIMEOUTS = 50000
+
+        def getTimeout(i):
+            return (i*7919)%100
+
+        def onTimeout(batch, i):
+            self.fired.append((batch, i, player.getFrameTime()))
+
+        def setupTimeouts(batch):
+            startTime = time.time()
+            ids = []
+            for i in xrange(NUM_TIMEOUTS):
+                ids.append(player.setTimeout(getTimeout(i),
+                        lambda i=i: onTimeout(batch, i)))
+            numCleared = 0
+            for i in xrange(NUM_TIMEOUTS):
+                if i%3 != 0 and player.clearInterval(ids[i]):
+                    numCleared += 1
+            self.assert_(numCleared == NUM_TIMEOUTS - len(expected))
+            self.assert_(not(player.clearInterval(ids[1])))
+            logger.info("%s: %i timeouts added, %i cleared in %.1f ms"%
+                    (batch, NUM_TIMEOUTS, numCleared, (time.time()-startTime)*1000))
+
+        def setupBothBatches():
+            self.setupTime = player.getFrameTime()
+            # Timeouts added in ON_FRAME are queued until the next frame, so these are
+            # cleared from the deferred list.
+            setupTimeouts("deferred")
+            # Async calls run outside of frame dispatch, so these timeouts go to the
+            # heap directly and are cleared from there.
+            player.callFromThread(lambda: setupTimeouts("heap"))
+
+        def checkFired():
+            for batch in ("deferred", "heap"):
+                self.assert_([i for (b, i, t) in self.fired if b == batch] == expected)
+            # Deferred timeouts may fire one frame late, but never early.
+            for (b, i, t) in self.fired:
+                dueTime = self.setupTime + getTimeout(i)
+                self.assert_(dueTime <= t <= dueTime + 20)
+
+        # Timeouts fire sorted by time. Timeouts with the same time fire in reverse
+        # order of creation.
+        expected = sorted(xrange(0, NUM_TIMEOUTS, 3), key=lambda i: (getTimeout(i), -i))
+        self.fired = []
+        self.initDefaultImageScene()
+        player.setFakeFPS(100)
+        self.start(False,
+                (setupBothBatches,
+                 lambda: self.delay(150),
+                 checkFired,
+                ))
+
     def testCallFromThread(self):
 
         def onAsyncCall():
@@ -728,6 +783,55 @@ class PlayerTestCase(AVGTestCase):
 
     def testMemoryQuery(self):
         self.assertNotEqual(player.getMemoryUsage(), 0)
+        memUsage = player.getResourceMemUsage()
+        for key in ("bitmap", "texture", "vertexdata", "imagecache_cpu", 
+                "imagecache_gpu"):
+            self.assert_(key in memUsage)
+        bmp = avg.Bitmap((64,64), avg.B8G8R8A8, "bmp")
+        self.assertEqual(player.getResourceMemUsage()["bitmap"], 
+                memUsage["bitmap"]+64*64*4)
+        del bmp
+        self.assertEqual(player.getResourceMemUsage()["bitmap"], memUsage["bitmap"])
+
+    def testFrameStats(self):
+        def checkStats():
+            frameStats = player.getFrameStats()
+            frames = frameStats.getFrames()
+            self.assert_(len(frames) > 0)
+            lastFrame = frameStats.getLastFrame()
+            self.assertEqual(lastFrame.frameNum, frames[-1].frameNum)
+            for frame in frames:
+                self.assert_(frame.duration >= 0)
+                self.assert_(frame.renderTime >= 0)
+                self.assert_(frame.numDrawCalls >= 0)
+            self.assertEqual(len(frameStats.getFrameTimeHistogram()), 100)
+            numMeasuredFrames = len([frame for frame in frames if frame.duration > 0])
+            self.assertEqual(sum(frameStats.getFrameTimeHistogram()), numMeasuredFrames)
+            self.assertEqual(len(frameStats.getLatencyHistogram()), 100)
+            self.assert_(frameStats.getNumMissedVBlanks() >= 0)
+
+        def setWindowSize():
+            frameStats = player.getFrameStats()
+            frameStats.windowSize = 2
+            self.assertEqual(frameStats.windowSize, 2)
+            self.assert_(len(frameStats.getFrames()) <= 2)
+            self.assertRaises(avg.Exception, lambda: setattr(frameStats, "windowSize", 0))
+
+        def checkLatency():
+            frame = player.getFrameStats().getLastFrame()
+            self.assertEqual(len(frame.inputLatencies), 1)
+
+        root = self.loadEmptyScene()
+        avg.ImageNode(href="rgb24-64x64.png", parent=root)
+        self.start(False,
+                (checkStats,
+                 checkStats,
+                 setWindowSize,
+                 lambda: self._sendTouchEvent(1, avg.Event.CURSOR_DOWN, 10, 10),
+                 checkLatency,
+                 lambda: self._sendTouchEvent(1, avg.Event.CURSOR_UP, 10, 10),
+                 checkStats,
+                ))
 
     def testStopOnEscape(self):
         def pressEscape():
@@ -920,6 +1024,7 @@ def playerTestSuite(tests):
             "testInvalidVideoFilename",
             "testTimeouts",
             "testTimeoutOnFrameHandling",
+            "testManyTimeouts",
             "testCallFromThread",
             "testAVGFile",
             "testBroken",
@@ -929,6 +1034,7 @@ def playerTestSuite(tests):
             "testWarp",
             "testMediaDir",
             "testMemoryQuery",
+            "testFrameStats",
             "testStopOnEscape",
             "testScreenDimensions",
             "testSVG",
@@ -23,6 +23,7 @@
 
 #include "../base/ObjectCounter.h"
 #include "../base/Exception.h"
+#include "../base/Logger.h"
 #include "../base/ScopeTimer.h"
 
 #include "../audio/AudioParams.h"
@@ -71,8 +72,13 @@ void AsyncVideoDecoder::open(const std::string& sFilename,
     m_bVideoEOF = false;
     m_bWasVSeeking = false;
     m_bWasSeeking = false;
+    m_bShowSeekFrame = false;
     m_CurVideoFrameTime = -1;
     m_LastAudioFrameTime = 0;
+    m_bAfterSeek = false;
+    m_NumLoops = 0;
+    m_DropRate = 0;
+    m_bSkippingFrames = false;
     
     VideoDecoder::open(sFilename, bEnableSound);
 
@@ -158,6 +164,7 @@ void AsyncVideoDecoder::seek(float destTime)
     m_bAudioEOF = false;
     m_bVideoEOF = false;
     m_NumSeeksSent++;
+    m_NumLoops = 0;
     m_pDemuxCmdQ->pushCmd(boost::bind(&VideoDemuxerThread::seek, _1, m_NumSeeksSent,
             destTime));
 }
@@ -167,7 +174,9 @@ void AsyncVideoDecoder::loop()
     m_LastVideoFrameTime = -1;
     m_bAudioEOF = false;
     m_bVideoEOF = false;
-    seek(0);
+    if (!getLoopPreroll()) {
+        seek(0);
+    }
 }
 
 int AsyncVideoDecoder::getCurFrame() const
@@ -248,6 +257,11 @@ void AsyncVideoDecoder::updateAudioStatus()
 bool AsyncVideoDecoder::isEOF() const
 {
     AVG_ASSERT(getState() == DECODING);
+    if (getLoopPreroll() && getVideoInfo().m_bHasVideo) {
+        // Audio wraps around on its own in this case and never reports EOF. In 
+        // audio-only files, the audio loop point sets m_bAudioEOF instead.
+        return m_bVideoEOF;
+    }
     bool bEOF = true;
     if (getVideoInfo().m_bHasAudio && !m_bAudioEOF) {
         bEOF = false;
@@ -283,7 +297,7 @@ void AsyncVideoDecoder::setupDemuxer(vector<int> streamIndexes)
         m_PacketQs[streamIndexes[i]] = pPacketQ;
     }
     m_pDemuxThread = new boost::thread(VideoDemuxerThread(*m_pDemuxCmdQ,
-            getFormatContext(), m_PacketQs));
+            getFormatContext(), m_PacketQs, getKeyframeIndex(), getLoopPreroll()));
 }
 
 void AsyncVideoDecoder::deleteDemuxer()
@@ -311,6 +325,7 @@ VideoMsgPtr AsyncVideoDecoder::getBmpsForTime(float timeWanted,
     }
     VideoMsgPtr pFrameMsg;
     float timePerFrame = 1.0f/getFPS();
+    int numDropped = 0;
 
     checkForSeekDone();
     bool bVSeekDone = (!isVSeeking() && m_bWasVSeeking);
@@ -333,23 +348,35 @@ VideoMsgPtr AsyncVideoDecoder::getBmpsForTime(float timeWanted,
     } else {
         float frameTime = -1;
         while (frameTime-timeWanted < -0.5*timePerFrame && !m_bVideoEOF) {
-            if (pFrameMsg) {
-                returnFrame(pFrameMsg);
-            }
-            pFrameMsg = getNextBmps(false);
-            if (pFrameMsg) {
-                frameTime = pFrameMsg->getFrameTime();
-            } else {
+            VideoMsgPtr pNextFrameMsg = getNextBmps(false);
+            if (!pNextFrameMsg) {
+                if (pFrameMsg && m_bShowSeekFrame) {
+                    // Fast seek: Show the first frames after the keyframe while 
+                    // decoding up to the time wanted continues.
+                    m_bShowSeekFrame = false;
+                    updateDecodeLoad(numDropped, timeWanted);
+                    m_bAfterSeek = false;
+                    frameAvailable = FA_NEW_FRAME;
+                    return pFrameMsg;
+                }
+                dropFrame(pFrameMsg, numDropped);
+                updateDecodeLoad(numDropped, timeWanted);
                 frameAvailable = FA_STILL_DECODING;
                 return VideoMsgPtr();
             }
+            dropFrame(pFrameMsg, numDropped);
+            pFrameMsg = pNextFrameMsg;
+            frameTime = pFrameMsg->getFrameTime();
         }
+        m_bShowSeekFrame = false;
         if (!pFrameMsg) {
             cerr << "frameTime=" << frameTime << ", timeWanted=" << timeWanted 
                     << ", timePerFrame=" << timePerFrame << ", m_bVideoEOF=" 
                     << m_bVideoEOF << endl;
             AVG_ASSERT(false);
         }
+        updateDecodeLoad(numDropped, timeWanted);
+        m_bAfterSeek = false;
         frameAvailable = FA_NEW_FRAME;
     }
     return pFrameMsg;
@@ -361,11 +388,18 @@ VideoMsgPtr AsyncVideoDecoder::getNextBmps(bool bWait)
     if (pMsg) {
         switch (pMsg->getType()) {
             case VideoMsg::FRAME:
+                addFramesDecoded(1);
+                addFramesSkipped(pMsg->getNumFramesSkipped());
                 return pMsg;
             case VideoMsg::END_OF_FILE:
                 m_NumVSeeksDone = m_NumSeeksSent;
                 m_bVideoEOF = true;
                 return VideoMsgPtr();
+            case VideoMsg::LOOP:
+                // The frames of the next iteration are queued behind this message.
+                m_bVideoEOF = true;
+                m_NumLoops++;
+                return VideoMsgPtr();
             case VideoMsg::ERROR:
                 m_bVideoEOF = true;
                 return VideoMsgPtr();
@@ -415,6 +449,8 @@ void AsyncVideoDecoder::handleVSeekMsg(VideoMsgPtr pMsg)
             m_NumVSeeksDone = m_NumSeeksSent;
             m_bVideoEOF = true;
             break;
+        case VideoMsg::LOOP:
+            break;
         default:
             // TODO: Handle ERROR messages here.
             AVG_ASSERT(false);
@@ -424,6 +460,8 @@ void AsyncVideoDecoder::handleVSeekMsg(VideoMsgPtr pMsg)
 void AsyncVideoDecoder::handleVSeekDone(AudioMsgPtr pMsg)
 {
     m_LastVideoFrameTime = pMsg->getSeekTime() - 1/m_FPS;
+    m_bShowSeekFrame = getFastSeek();
+    m_bAfterSeek = true;
     if (m_NumVSeeksDone < pMsg->getSeekSeqNum()) {
         m_NumVSeeksDone = pMsg->getSeekSeqNum();
     }
@@ -447,6 +485,13 @@ void AsyncVideoDecoder::handleAudioMsg(AudioMsgPtr pMsg)
         case AudioMsg::AUDIO_TIME:
             m_LastAudioFrameTime = pMsg->getAudioTime();
             break;
+        case AudioMsg::LOOP:
+            // The audio stream has been played to the end and continues at the start.
+            // If there is video, the video stream reports the loop instead.
+            if (!getVideoInfo().m_bHasVideo) {
+                m_bAudioEOF = true;
+            }
+            break;
         default:
             // Unhandled message type.
             pMsg->dump();
@@ -462,6 +507,50 @@ void AsyncVideoDecoder::returnFrame(VideoMsgPtr pFrameMsg)
     }
 }
 
+void AsyncVideoDecoder::dropFrame(VideoMsgPtr pFrameMsg, int& numDropped)
+{
+    if (pFrameMsg) {
+        returnFrame(pFrameMsg);
+        if (!m_bAfterSeek) {
+            // Frames between the keyframe and the seek destination aren't late.
+            addFramesDroppedLate(1);
+            numDropped++;
+        }
+    }
+}
+
+void AsyncVideoDecoder::updateDecodeLoad(int numDropped, float timeWanted)
+{
+    if (!getAdaptiveDecode() || m_bAfterSeek) {
+        return;
+    }
+    // Average number of frames dropped per frame displayed. Switching happens with
+    // some hysteresis so short hiccups don't degrade the video.
+    m_DropRate = 0.9f*m_DropRate + 0.1f*numDropped;
+    bool bSkipFrames = m_bSkippingFrames;
+    if (m_DropRate > 0.5f) {
+        bSkipFrames = true;
+    } else if (m_DropRate < 0.1f) {
+        bSkipFrames = false;
+    }
+    if (bSkipFrames != m_bSkippingFrames) {
+        m_bSkippingFrames = bSkipFrames;
+        AVG_TRACE(Logger::category::PLAYER, Logger::severity::DEBUG,
+                "Adaptive decode: Skipping frames " << (bSkipFrames ? "on" : "off"));
+        m_pVCmdQ->pushCmd(boost::bind(&VideoDecoderThread::setSkipFrames, _1, 
+                bSkipFrames));
+    }
+    if (m_bSkippingFrames) {
+        m_pVCmdQ->pushCmd(boost::bind(&VideoDecoderThread::setTimeWanted, _1, 
+                timeWanted, m_NumSeeksSent, m_NumLoops));
+    }
+}
+
+bool AsyncVideoDecoder::isSkippingFrames() const
+{
+    return m_bSkippingFrames;
+}
+
 bool AsyncVideoDecoder::isSeeking() const
 {
     return (m_NumSeeksSent > m_NumVSeeksDone || m_NumSeeksSent > m_NumASeeksDone);
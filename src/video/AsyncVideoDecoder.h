@@ -59,6 +59,7 @@ public:
     void updateAudioStatus();
     virtual bool isEOF() const;
     virtual void throwAwayFrame(float timeWanted);
+    virtual bool isSkippingFrames() const;
    
     AudioMsgQueuePtr getAudioMsgQ();
     AudioMsgQueuePtr getAudioStatusQ() const;
@@ -74,6 +75,8 @@ private:
     void handleVSeekDone(AudioMsgPtr pMsg);
     void handleAudioMsg(AudioMsgPtr pMsg);
     void returnFrame(VideoMsgPtr pFrameMsg);
+    void dropFrame(VideoMsgPtr pFrameMsg, int& numDropped);
+    void updateDecodeLoad(int numDropped, float timeWanted);
     bool isSeeking() const;
     bool isVSeeking() const;
 
@@ -100,6 +103,7 @@ private:
     int m_NumASeeksDone;
     bool m_bWasVSeeking;
     bool m_bWasSeeking;
+    bool m_bShowSeekFrame;
 
     bool m_bAudioEOF;
     bool m_bVideoEOF;
@@ -107,6 +111,12 @@ private:
     float m_LastVideoFrameTime;
     float m_CurVideoFrameTime;
     float m_LastAudioFrameTime;
+
+    // Adaptive decoding
+    bool m_bAfterSeek;
+    int m_NumLoops;
+    float m_DropRate;
+    bool m_bSkippingFrames;
 };
 
 typedef boost::shared_ptr<AsyncVideoDecoder> AsyncVideoDecoderPtr;
@@ -111,6 +111,9 @@ bool AudioDecoderThread::work()
         case VideoMsg::END_OF_FILE:
             pushEOF();
             break;
+        case VideoMsg::LOOP:
+            handleLoop();
+            break;
         case VideoMsg::CLOSED:
             m_MsgQ.clear();
             stop();
@@ -232,6 +235,21 @@ void AudioDecoderThread::discardPacket(AVPacket* pPacket)
     }
 }
 
+void AudioDecoderThread::handleLoop()
+{
+    // The packets that follow are from the start of the file. Decoding just continues,
+    // so only the time needs to be reset.
+    m_LastFrameTime = 0;
+    if (m_State != DECODING) {
+        // The seek destination was behind the end of the file.
+        pushSeekDone(m_LastFrameTime, m_SeekSeqNum);
+        m_State = DECODING;
+    }
+    // Audio-only decoders have no video stream to report the end of the iteration, 
+    // so the marker is passed on to the audio source.
+    pushLoop();
+}
+
 AudioBufferPtr AudioDecoderThread::resampleAudio(char* pDecodedData, int framesDecoded,
         int currentSampleFormat)
 {
@@ -333,6 +351,13 @@ void AudioDecoderThread::pushEOF()
     m_MsgQ.push(pMsg);
 }
 
+void AudioDecoderThread::pushLoop()
+{
+    VideoMsgPtr pMsg(new VideoMsg());
+    pMsg->setLoop();
+    m_MsgQ.push(pMsg);
+}
+
 int AudioDecoderThread::getBytesPerSample(int sampleFormat)
 {
     switch (sampleFormat) {
@@ -50,6 +50,7 @@ class AVG_API AudioDecoderThread : public WorkerThread<AudioDecoderThread> {
         void decodePacket(AVPacket* pPacket);
         void handleSeekDone(AVPacket* pPacket);
         void discardPacket(AVPacket* pPacket);
+        void handleLoop();
         AudioBufferPtr resampleAudio(char* pDecodedData, int framesDecoded,
                 int currentSampleFormat);
         void insertSilence(float duration);
@@ -58,6 +59,7 @@ class AVG_API AudioDecoderThread : public WorkerThread<AudioDecoderThread> {
         void pushAudioMsg(AudioBufferPtr pBuffer, float time);
         void pushSeekDone(float time, int seqNum);
         void pushEOF();
+        void pushLoop();
         int getBytesPerSample(int sampleFormat);
 
         AudioMsgQueue& m_MsgQ;
@@ -34,7 +34,10 @@ using namespace std;
 namespace avg {
 
 FFMpegDemuxer::FFMpegDemuxer(AVFormatContext * pFormatContext, vector<int> streamIndexes)
-    : m_pFormatContext(pFormatContext)
+    : m_pFormatContext(pFormatContext),
+      m_bLoop(false),
+      m_bLoopPoint(false),
+      m_bPacketSinceLoop(false)
 {
     ObjectCounter::get()->incRef(&typeid(*this));
     for (unsigned i = 0; i < streamIndexes.size(); ++i) {
@@ -48,6 +51,11 @@ FFMpegDemuxer::~FFMpegDemuxer()
     ObjectCounter::get()->decRef(&typeid(*this));
 }
 
+void FFMpegDemuxer::setKeyframeIndex(KeyframeIndexPtr pIndex)
+{
+    m_pKeyframeIndex = pIndex;
+}
+
 AVPacket * FFMpegDemuxer::getPacket(int streamIndex)
 {
     // Make sure enableStream was called on streamIndex.
@@ -62,10 +70,15 @@ AVPacket * FFMpegDemuxer::getPacket(int streamIndex)
 
     PacketList& curPacketList = m_PacketLists.find(streamIndex)->second;
     AVPacket* pPacket;
+    m_bLoopPoint = false;
     if (!curPacketList.empty()) {
         // The stream has packets queued already.
         pPacket = curPacketList.front();
         curPacketList.pop_front();
+        if (!pPacket) {
+            // Loop marker queued by rewind().
+            m_bLoopPoint = true;
+        }
     } else {
         // No packets queued for this stream -> read and queue packets until we get one
         // that is meant for this stream.
@@ -74,6 +87,12 @@ AVPacket * FFMpegDemuxer::getPacket(int streamIndex)
             memset(pPacket, 0, sizeof(AVPacket));
             int err = av_read_frame(m_pFormatContext, pPacket);
             if (err < 0) {
+                if (err == int(AVERROR_EOF) && m_bLoop && m_bPacketSinceLoop) {
+                    av_free_packet(pPacket);
+                    delete pPacket;
+                    rewind(streamIndex);
+                    return 0;
+                }
                 // EOF or error
                 if (err != int(AVERROR_EOF)) {
                     char sz[256];
@@ -86,6 +105,7 @@ AVPacket * FFMpegDemuxer::getPacket(int streamIndex)
                 pPacket = 0;
                 return 0;
             }
+            m_bPacketSinceLoop = true;
             if (pPacket->stream_index != streamIndex) {
                 if (m_PacketLists.find(pPacket->stream_index) != m_PacketLists.end()) {
                     // Relevant stream, but not ours
@@ -109,13 +129,56 @@ AVPacket * FFMpegDemuxer::getPacket(int streamIndex)
     return pPacket;
 }
         
+static ProfilingZoneID SeekProfilingZone("FFMpegDemuxer: seek", true);
+
 void FFMpegDemuxer::seek(float destTime)
 {
-    av_seek_frame(m_pFormatContext, -1, (long long)(destTime*AV_TIME_BASE),
-            AVSEEK_FLAG_BACKWARD);
+    ScopeTimer timer(SeekProfilingZone);
+    if (!seekToKeyframe(destTime)) {
+        av_seek_frame(m_pFormatContext, -1, (long long)(destTime*AV_TIME_BASE),
+                AVSEEK_FLAG_BACKWARD);
+    }
     clearPacketCache();
 }
 
+void FFMpegDemuxer::setLoop(bool bLoop)
+{
+    m_bLoop = bLoop;
+}
+
+bool FFMpegDemuxer::isLoopPoint() const
+{
+    return m_bLoopPoint;
+}
+
+bool FFMpegDemuxer::seekToKeyframe(float destTime)
+{
+    if (!m_pKeyframeIndex) {
+        return false;
+    }
+    m_pKeyframeIndex->requestBuild();
+    KeyframeIndex::Entry entry;
+    if (!m_pKeyframeIndex->findKeyframe(destTime, entry)) {
+        return false;
+    }
+    return m_pKeyframeIndex->seek(m_pFormatContext, entry) >= 0;
+}
+
+void FFMpegDemuxer::rewind(int streamIndex)
+{
+    // Packets that are already queued for the other streams still belong to the end 
+    // of the file, so the loop marker goes behind them.
+    map<int, PacketList>::iterator it;
+    for (it = m_PacketLists.begin(); it != m_PacketLists.end(); ++it) {
+        if (it->first != streamIndex) {
+            it->second.push_back(0);
+        }
+    }
+    av_seek_frame(m_pFormatContext, -1, 0, AVSEEK_FLAG_BACKWARD);
+    m_bPacketSinceLoop = false;
+    m_bLoopPoint = true;
+}
+
 void FFMpegDemuxer::clearPacketCache()
 {
     map<int, PacketList>::iterator it;
@@ -123,8 +186,10 @@ void FFMpegDemuxer::clearPacketCache()
         PacketList::iterator it2;
         PacketList* pPacketList = &(it->second);
         for (it2 = pPacketList->begin(); it2 != pPacketList->end(); ++it2) {
-            av_free_packet(*it2);
-            delete *it2;
+            if (*it2) {
+                av_free_packet(*it2);
+                delete *it2;
+            }
         }
         pPacketList->clear();
     }
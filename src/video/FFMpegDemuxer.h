@@ -25,6 +25,7 @@
 #include "../avgconfigwrapper.h"
 
 #include "WrapFFMpeg.h"
+#include "KeyframeIndex.h"
 
 #include <list>
 #include <vector>
@@ -39,18 +40,36 @@ class AVG_API FFMpegDemuxer {
         FFMpegDemuxer(AVFormatContext * pFormatContext, std::vector<int> streamIndexes);
         virtual ~FFMpegDemuxer();
        
+        // If an index is set, seeks go directly to the keyframe before the 
+        // destination once the index has been built.
+        void setKeyframeIndex(KeyframeIndexPtr pIndex);
+
+        // In loop mode, the demuxer continues at the start of the file when it reaches
+        // the end. Instead of signalling EOF, getPacket() returns 0 once per stream at
+        // the loop point and isLoopPoint() returns true directly afterwards.
+        void setLoop(bool bLoop);
+        bool isLoopPoint() const;
+
         AVPacket * getPacket(int streamIndex);
         void seek(float destTime);
         void dump();
         
     private:
         void clearPacketCache();
+        bool seekToKeyframe(float destTime);
+        void rewind(int streamIndex);
 
-        // Packets that haven't been delivered yet.
+        // Packets that haven't been delivered yet. In loop mode, 0 entries mark the
+        // loop point.
         typedef std::list<AVPacket *> PacketList;
         std::map<int, PacketList> m_PacketLists;
        
         AVFormatContext * m_pFormatContext;
+        KeyframeIndexPtr m_pKeyframeIndex;
+
+        bool m_bLoop;
+        bool m_bLoopPoint;
+        bool m_bPacketSinceLoop;
 };
 
 typedef boost::shared_ptr<FFMpegDemuxer> FFMpegDemuxerPtr;
@@ -47,7 +47,8 @@ FFMpegFrameDecoder::FFMpegFrameDecoder(AVStream* pStream)
       m_bEOF(false),
       m_StartTimestamp(-1),
       m_LastFrameTime(-1),
-      m_bUseStreamFPS(true)
+      m_bUseStreamFPS(true),
+      m_bSkipNonRefFrames(false)
 {
     m_TimeUnitsPerSecond = float(1.0/av_q2d(pStream->time_base));
     m_FPS = getStreamFPS(pStream);
@@ -204,6 +205,17 @@ void FFMpegFrameDecoder::handleSeek()
     }
 }
 
+void FFMpegFrameDecoder::setSkipNonRefFrames(bool bSkip)
+{
+    m_bSkipNonRefFrames = bSkip;
+    applySkipMode();
+}
+
+bool FFMpegFrameDecoder::isSkippingFrames() const
+{
+    return m_bSkipNonRefFrames && m_bUseStreamFPS;
+}
+
 float FFMpegFrameDecoder::getCurTime() const
 {
     return m_LastFrameTime;
@@ -222,6 +234,7 @@ void FFMpegFrameDecoder::setFPS(float fps)
     } else {
         m_FPS = fps;
     }
+    applySkipMode();
 }
 
 bool FFMpegFrameDecoder::isEOF() const
@@ -252,5 +265,17 @@ float FFMpegFrameDecoder::getFrameTime(long long dts, bool bFrameAfterSeek)
     return frameTime;
 }
 
+void FFMpegFrameDecoder::applySkipMode()
+{
+    AVCodecContext* pContext = m_pStream->codec;
+    if (isSkippingFrames()) {
+        pContext->skip_frame = AVDISCARD_NONREF;
+        pContext->skip_loop_filter = AVDISCARD_ALL;
+    } else {
+        pContext->skip_frame = AVDISCARD_DEFAULT;
+        pContext->skip_loop_filter = AVDISCARD_DEFAULT;
+    }
+}
+
 }
 
@@ -46,6 +46,12 @@ class AVG_API FFMpegFrameDecoder
 
         void handleSeek();
 
+        // Tells libavcodec to skip non-reference frames and the loop filter. This is
+        // only done if frame times come from the stream, since skipped frames would
+        // otherwise speed up playback.
+        void setSkipNonRefFrames(bool bSkip);
+        bool isSkippingFrames() const;
+
         virtual float getCurTime() const;
         virtual float getFPS() const;
         virtual void setFPS(float fps);
@@ -54,6 +60,7 @@ class AVG_API FFMpegFrameDecoder
         
     private:
         float getFrameTime(long long dts, bool bFrameAfterSeek);
+        void applySkipMode();
 
         SwsContext * m_pSwsContext;
         AVStream* m_pStream;
@@ -66,6 +73,7 @@ class AVG_API FFMpegFrameDecoder
 
         bool m_bUseStreamFPS;
         float m_FPS;
+        bool m_bSkipNonRefFrames;
 };
 
 typedef boost::shared_ptr<FFMpegFrameDecoder> FFMpegFrameDecoderPtr;
@@ -0,0 +1,297 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "KeyframeIndex.h"
+#include "StreamInfoCache.h"
+
+#include "../base/Exception.h"
+#include "../base/FileHelper.h"
+#include "../base/Logger.h"
+#include "../base/ObjectCounter.h"
+#include "../base/ProfilingZoneID.h"
+#include "../base/StringHelper.h"
+#include "../base/TaskPool.h"
+#include "../base/ThreadHelper.h"
+
+#include <boost/bind.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace std;
+
+namespace avg {
+
+KeyframeIndex::IndexList KeyframeIndex::s_Indexes;
+boost::mutex KeyframeIndex::s_IndexesMutex;
+
+static const unsigned MAX_CACHED_INDEXES = 16;
+
+KeyframeIndex::Entry::Entry()
+    : m_PTS(0),
+      m_Pos(-1)
+{
+}
+
+KeyframeIndex::Entry::Entry(long long pts, long long pos)
+    : m_PTS(pts),
+      m_Pos(pos)
+{
+}
+
+bool KeyframeIndex::Entry::operator <(const Entry& other) const
+{
+    return m_PTS < other.m_PTS;
+}
+
+KeyframeIndexPtr KeyframeIndex::get(const string& sFilename, int streamIndex, 
+        AVRational timeBase)
+{
+    string sKey = getCacheKey(sFilename, streamIndex);
+    lock_guard lock(s_IndexesMutex);
+    for (IndexList::iterator it = s_Indexes.begin(); it != s_Indexes.end(); ++it) {
+        if (it->first == sKey) {
+            s_Indexes.splice(s_Indexes.begin(), s_Indexes, it);
+            return s_Indexes.front().second;
+        }
+    }
+    KeyframeIndexPtr pIndex(new KeyframeIndex(sFilename, streamIndex, timeBase));
+    s_Indexes.push_front(make_pair(sKey, pIndex));
+    if (s_Indexes.size() > MAX_CACHED_INDEXES) {
+        // Decoders that still use the index keep it alive.
+        s_Indexes.pop_back();
+    }
+    return pIndex;
+}
+
+void KeyframeIndex::clearCache()
+{
+    lock_guard lock(s_IndexesMutex);
+    s_Indexes.clear();
+}
+
+int KeyframeIndex::getNumCachedIndexes()
+{
+    lock_guard lock(s_IndexesMutex);
+    return int(s_Indexes.size());
+}
+
+string KeyframeIndex::getCacheKey(const string& sFilename, int streamIndex)
+{
+    string sKey = sFilename + "|" + toString(streamIndex);
+    long long fileSize;
+    long long modTime;
+    if (getFileStamp(sFilename, fileSize, modTime)) {
+        // A changed file gets a new key. The stale entry ages out of the cache.
+        sKey += "|" + toString(fileSize) + "|" + toString(modTime);
+    }
+    return sKey;
+}
+
+KeyframeIndex::KeyframeIndex(const string& sFilename, int streamIndex, 
+        AVRational timeBase, VideoDataSourcePtr pDataSource)
+    : m_sFilename(sFilename),
+      m_pDataSource(pDataSource),
+      m_StreamIndex(streamIndex),
+      m_TimeBase(av_q2d(timeBase)),
+      m_bBuildRequested(false),
+      m_bBuildStarted(false),
+      m_bComplete(false)
+{
+    ObjectCounter::get()->incRef(&typeid(*this));
+}
+
+KeyframeIndex::~KeyframeIndex()
+{
+    ObjectCounter::get()->decRef(&typeid(*this));
+}
+
+static ProfilingZoneID BuildIndexProfilingZone("KeyframeIndex: build");
+
+void KeyframeIndex::requestBuild()
+{
+    {
+        lock_guard lock(m_Mutex);
+        if (m_bBuildRequested) {
+            return;
+        }
+        m_bBuildRequested = true;
+    }
+    // The task holds a reference, so the index stays alive even if the cache is 
+    // cleared while it is being built. Building reads the whole file, so it runs on 
+    // the low-priority background pool.
+    TaskPool::getBackground()->submit(
+            boost::bind(&KeyframeIndex::build, shared_from_this()),
+            &BuildIndexProfilingZone);
+}
+
+void KeyframeIndex::waitForBuild()
+{
+    {
+        boost::unique_lock<boost::mutex> lock(m_Mutex);
+        if (m_bBuildStarted) {
+            while (!m_bComplete) {
+                m_BuildCondition.wait(lock);
+            }
+            return;
+        }
+        m_bBuildRequested = true;
+        m_bBuildStarted = true;
+    }
+    scan();
+}
+
+bool KeyframeIndex::isComplete() const
+{
+    lock_guard lock(m_Mutex);
+    return m_bComplete;
+}
+
+int KeyframeIndex::getNumKeyframes() const
+{
+    lock_guard lock(m_Mutex);
+    return m_Entries.size();
+}
+
+int KeyframeIndex::getStreamIndex() const
+{
+    return m_StreamIndex;
+}
+
+bool KeyframeIndex::findKeyframe(float destTime, Entry& entry) const
+{
+    lock_guard lock(m_Mutex);
+    if (!m_bComplete || m_Entries.empty()) {
+        return false;
+    }
+    // Round to the nearest timestamp so float errors don't select the keyframe before
+    // one that is exactly at destTime.
+    Entry destEntry((long long)(floor(destTime/m_TimeBase+0.5)), -1);
+    vector<Entry>::const_iterator it = upper_bound(m_Entries.begin(), m_Entries.end(),
+            destEntry);
+    if (it != m_Entries.begin()) {
+        --it;
+    }
+    entry = *it;
+    return true;
+}
+
+float KeyframeIndex::getTime(const Entry& entry) const
+{
+    return float(entry.m_PTS*m_TimeBase);
+}
+
+void KeyframeIndex::getEntries(vector<Entry>& entries) const
+{
+    lock_guard lock(m_Mutex);
+    entries = m_Entries;
+}
+
+int KeyframeIndex::seek(AVFormatContext* pFormatContext, const Entry& entry) const
+{
+    AVStream* pStream = pFormatContext->streams[m_StreamIndex];
+    if (pStream->nb_index_entries == 0 && entry.m_Pos != -1 &&
+            !(pFormatContext->iformat->flags & AVFMT_NO_BYTE_SEEK))
+    {
+        // The container has no index of its own, so timestamp-based seeking would 
+        // need to search the file. Go to the packet directly instead.
+        return av_seek_frame(pFormatContext, m_StreamIndex, entry.m_Pos, 
+                AVSEEK_FLAG_BYTE);
+    } else {
+        return av_seek_frame(pFormatContext, m_StreamIndex, entry.m_PTS,
+                AVSEEK_FLAG_BACKWARD);
+    }
+}
+
+void KeyframeIndex::build()
+{
+    {
+        lock_guard lock(m_Mutex);
+        if (m_bBuildStarted) {
+            // waitForBuild() got there first.
+            return;
+        }
+        m_bBuildStarted = true;
+    }
+    scan();
+}
+
+void KeyframeIndex::scan()
+{
+    // Demux the whole file without decoding anything and remember where the
+    // keyframes are. This uses a format context of its own so it doesn't interfere
+    // with playback.
+    AVFormatContext* pFormatContext = 0;
+    AVIOContext* pIOContext = 0;
+    AVInputFormat* pInputFormat = 0;
+    if (m_pDataSource) {
+        pIOContext = VideoDataSource::createIOContext(m_pDataSource);
+        pFormatContext = avformat_alloc_context();
+        pFormatContext->pb = pIOContext;
+    } else {
+        pInputFormat = StreamInfoCache::getInputFormat(m_sFilename);
+    }
+    int err = avformat_open_input(&pFormatContext, m_sFilename.c_str(), pInputFormat,
+            0);
+    if (err < 0) {
+        if (pIOContext) {
+            VideoDataSource::freeIOContext(pIOContext);
+        }
+        AVG_TRACE(Logger::category::PLAYER, Logger::severity::WARNING,
+                "Could not build keyframe index for " << m_sFilename);
+        lock_guard lock(m_Mutex);
+        m_bComplete = true;
+        m_BuildCondition.notify_all();
+        return;
+    }
+    vector<Entry> entries;
+    AVPacket packet;
+    memset(&packet, 0, sizeof(AVPacket));
+    while (av_read_frame(pFormatContext, &packet) >= 0) {
+        if (packet.stream_index == m_StreamIndex && (packet.flags & AV_PKT_FLAG_KEY)) {
+            long long pts = packet.pts;
+            if (pts == (long long)AV_NOPTS_VALUE) {
+                pts = packet.dts;
+            }
+            if (pts != (long long)AV_NOPTS_VALUE) {
+                entries.push_back(Entry(pts, packet.pos));
+            }
+        }
+        av_free_packet(&packet);
+    }
+    avformat_close_input(&pFormatContext);
+    if (pIOContext) {
+        VideoDataSource::freeIOContext(pIOContext);
+    }
+    sort(entries.begin(), entries.end());
+    AVG_TRACE(Logger::category::PLAYER, Logger::severity::DEBUG,
+            "Keyframe index for " << m_sFilename << ": " << entries.size() << 
+            " keyframes.");
+
+    lock_guard lock(m_Mutex);
+    m_Entries.swap(entries);
+    m_bComplete = true;
+    m_BuildCondition.notify_all();
+}
+
+}
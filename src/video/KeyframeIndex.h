@@ -0,0 +1,118 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _KeyframeIndex_H_
+#define _KeyframeIndex_H_
+
+#include "../api.h"
+#include "WrapFFMpeg.h"
+#include "VideoDataSource.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include <list>
+#include <string>
+#include <vector>
+
+namespace avg {
+
+class KeyframeIndex;
+typedef boost::shared_ptr<KeyframeIndex> KeyframeIndexPtr;
+
+// Positions of all keyframes of one video stream. The index is built in the
+// background the first time a seek is requested and is shared by all decoders that 
+// open the same file, so later seeks can go directly to the keyframe that precedes 
+// the destination instead of relying on the container's seek heuristics. Cached 
+// indexes are invalidated if the file changes on disk, and only the most recently
+// used ones are kept.
+class AVG_API KeyframeIndex: public boost::enable_shared_from_this<KeyframeIndex> {
+    public:
+        struct Entry {
+            Entry();
+            Entry(long long pts, long long pos);
+            bool operator <(const Entry& other) const;
+
+            long long m_PTS;
+            long long m_Pos;
+        };
+
+        static KeyframeIndexPtr get(const std::string& sFilename, int streamIndex,
+                AVRational timeBase);
+        static void clearCache();
+        static int getNumCachedIndexes();
+
+        // Indexes for data sources aren't cached, since the filename doesn't identify
+        // the data.
+        KeyframeIndex(const std::string& sFilename, int streamIndex, 
+                AVRational timeBase, 
+                VideoDataSourcePtr pDataSource=VideoDataSourcePtr());
+        virtual ~KeyframeIndex();
+
+        // Starts building the index if that hasn't happened yet.
+        void requestBuild();
+        // Builds the index in the calling thread if that hasn't happened yet or 
+        // waits until a build that is already running is done.
+        void waitForBuild();
+        bool isComplete() const;
+        int getNumKeyframes() const;
+        int getStreamIndex() const;
+
+        // Finds the last keyframe at or before destTime (in seconds). Returns false if
+        // the index isn't complete or empty.
+        bool findKeyframe(float destTime, Entry& entry) const;
+        float getTime(const Entry& entry) const;
+        void getEntries(std::vector<Entry>& entries) const;
+
+        // Positions pFormatContext so the next packet read from the stream is the 
+        // keyframe. Returns the av_seek_frame() result.
+        int seek(AVFormatContext* pFormatContext, const Entry& entry) const;
+
+    private:
+        void build();
+        void scan();
+
+        std::string m_sFilename;
+        VideoDataSourcePtr m_pDataSource;
+        int m_StreamIndex;
+        double m_TimeBase;
+
+        mutable boost::mutex m_Mutex;
+        std::vector<Entry> m_Entries;
+        bool m_bBuildRequested;
+        bool m_bBuildStarted;
+        bool m_bComplete;
+        boost::condition_variable m_BuildCondition;
+
+        static std::string getCacheKey(const std::string& sFilename, int streamIndex);
+
+        // Most recently used first.
+        typedef std::list<std::pair<std::string, KeyframeIndexPtr> > IndexList;
+        static IndexList s_Indexes;
+        static boost::mutex s_IndexesMutex;
+};
+
+}
+
+#endif
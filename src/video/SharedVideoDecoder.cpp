@@ -0,0 +1,225 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "SharedVideoDecoder.h"
+
+#include "../base/ObjectCounter.h"
+#include "../base/Exception.h"
+
+using namespace std;
+
+namespace avg {
+
+SharedVideoDecoder::SharedVideoDecoder(int queueLength)
+    : m_QueueLength(queueLength),
+      m_bDeliverYCbCr(false),
+      m_FPS(0),
+      m_SeekTime(-1),
+      m_CurTime(-1),
+      m_Iteration(0),
+      m_bEOF(false)
+{
+    ObjectCounter::get()->incRef(&typeid(*this));
+}
+
+SharedVideoDecoder::~SharedVideoDecoder()
+{
+    ObjectCounter::get()->decRef(&typeid(*this));
+}
+
+void SharedVideoDecoder::open(const string& sFilename, bool bEnableSound)
+{
+    // Only the stream information is needed here. Decoding is done by the source.
+    AVG_ASSERT(!getDataSource());
+    VideoDecoder::open(sFilename, false);
+    m_sFilename = sFilename;
+}
+
+void SharedVideoDecoder::startDecoding(bool bDeliverYCbCr, const AudioParams* pAP)
+{
+    VideoDecoder::startDecoding(bDeliverYCbCr, 0);
+    m_bDeliverYCbCr = bDeliverYCbCr;
+    m_FPS = 0;
+    m_SeekTime = -1;
+    m_pSource = SharedVideoSourcePtr();
+    m_pCurFrame = SharedVideoSource::FramePtr();
+    m_CurTime = -1;
+    m_Iteration = 0;
+    m_bEOF = false;
+}
+
+void SharedVideoDecoder::close()
+{
+    m_pCurFrame = SharedVideoSource::FramePtr();
+    m_pSource = SharedVideoSourcePtr();
+    VideoDecoder::close();
+}
+
+int SharedVideoDecoder::getCurFrame() const
+{
+    AVG_ASSERT(getState() != CLOSED);
+    return int(getCurTime()*getVideoInfo().m_StreamFPS+0.5);
+}
+
+int SharedVideoDecoder::getNumFramesQueued() const
+{
+    AVG_ASSERT(getState() == DECODING);
+    if (m_pSource) {
+        return m_pSource->getNumFramesQueued();
+    } else {
+        return 0;
+    }
+}
+
+float SharedVideoDecoder::getCurTime() const
+{
+    AVG_ASSERT(getState() != CLOSED);
+    return m_CurTime;
+}
+
+float SharedVideoDecoder::getFPS() const
+{
+    AVG_ASSERT(getState() != CLOSED);
+    if (m_pSource) {
+        return m_pSource->getFPS();
+    } else if (m_FPS != 0) {
+        return m_FPS;
+    } else {
+        return getStreamFPS();
+    }
+}
+
+void SharedVideoDecoder::setFPS(float fps)
+{
+    AVG_ASSERT(getState() == DECODING);
+    m_FPS = fps;
+    if (m_SeekTime != -1 && m_pSource && m_pSource.use_count() == 1) {
+        // Nobody else plays the seeked source, so it can change speed.
+        m_pSource->setFPS(fps);
+    } else if (m_pSource) {
+        // All subscribers of a source play at the same speed.
+        if (m_SeekTime != -1 && m_CurTime >= 0) {
+            m_SeekTime = m_CurTime;
+        }
+        m_pSource = SharedVideoSourcePtr();
+        attachSource();
+    }
+}
+
+FrameAvailableCode SharedVideoDecoder::getRenderedBmps(vector<BitmapPtr>& pBmps,
+        float timeWanted)
+{
+    AVG_ASSERT(getState() == DECODING);
+    FrameAvailableCode frameAvailable = updateCurFrame(timeWanted);
+    if (frameAvailable == FA_NEW_FRAME) {
+        for (unsigned i = 0; i < pBmps.size(); ++i) {
+            pBmps[i] = m_pCurFrame->m_pBmps[i];
+        }
+    }
+    return frameAvailable;
+}
+
+void SharedVideoDecoder::throwAwayFrame(float timeWanted)
+{
+    AVG_ASSERT(getState() == DECODING);
+    updateCurFrame(timeWanted);
+}
+
+void SharedVideoDecoder::seek(float destTime)
+{
+    AVG_ASSERT(getState() == DECODING);
+    m_SeekTime = destTime;
+    // Decoders that seek to the same time share a source. If there is none yet and 
+    // nobody else plays the current one, moving it is cheaper than opening a new one.
+    SharedVideoSourcePtr pSource = SharedVideoSource::find(m_sFilename, 
+            m_bDeliverYCbCr, m_QueueLength, m_FPS, destTime);
+    if (!pSource && m_pSource && m_pSource.use_count() == 1) {
+        m_pSource->seek(destTime);
+        pSource = m_pSource;
+    }
+    if (pSource) {
+        setSource(pSource);
+    } else {
+        m_pSource = SharedVideoSourcePtr();
+        attachSource();
+    }
+}
+
+void SharedVideoDecoder::loop()
+{
+    AVG_ASSERT(getState() == DECODING);
+    attachSource();
+    m_Iteration++;
+    m_pSource->loop(m_Iteration);
+    m_pCurFrame = SharedVideoSource::FramePtr();
+    m_bEOF = false;
+}
+
+bool SharedVideoDecoder::isEOF() const
+{
+    AVG_ASSERT(getState() == DECODING);
+    return m_bEOF;
+}
+
+SharedVideoSourcePtr SharedVideoDecoder::getSource()
+{
+    attachSource();
+    return m_pSource;
+}
+
+void SharedVideoDecoder::attachSource()
+{
+    if (!m_pSource) {
+        setSource(SharedVideoSource::get(m_sFilename, m_bDeliverYCbCr, m_QueueLength,
+                m_FPS, m_SeekTime));
+    }
+}
+
+void SharedVideoDecoder::setSource(SharedVideoSourcePtr pSource)
+{
+    m_pSource = pSource;
+    m_pCurFrame = SharedVideoSource::FramePtr();
+    m_Iteration = m_pSource->getIteration();
+    m_bEOF = false;
+}
+
+FrameAvailableCode SharedVideoDecoder::updateCurFrame(float timeWanted)
+{
+    attachSource();
+    SharedVideoSource::FramePtr pFrame = m_pSource->getFrame(timeWanted, m_Iteration,
+            m_bEOF);
+    if (!pFrame) {
+        if (m_pCurFrame) {
+            return FA_USE_LAST_FRAME;
+        } else {
+            return FA_STILL_DECODING;
+        }
+    }
+    if (pFrame == m_pCurFrame) {
+        return FA_USE_LAST_FRAME;
+    }
+    m_pCurFrame = pFrame;
+    m_CurTime = pFrame->m_Time;
+    return FA_NEW_FRAME;
+}
+
+}
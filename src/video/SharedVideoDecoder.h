@@ -0,0 +1,82 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _SharedVideoDecoder_H_
+#define _SharedVideoDecoder_H_
+
+#include "../avgconfigwrapper.h"
+#include "VideoDecoder.h"
+#include "SharedVideoSource.h"
+
+namespace avg {
+
+// Decoder that gets its frames from a SharedVideoSource. All SharedVideoDecoders that
+// open the same file with the same settings use the same source, so the file is only
+// decoded once. Audio is not supported. A decoder that seeks or changes the frame rate
+// moves to a source that matches the new settings, so the other subscribers aren't
+// affected.
+class AVG_API SharedVideoDecoder: public VideoDecoder
+{
+    public:
+        SharedVideoDecoder(int queueLength);
+        virtual ~SharedVideoDecoder();
+        virtual void open(const std::string& sFilename, bool bEnableSound);
+        virtual void startDecoding(bool bDeliverYCbCr, const AudioParams* pAP);
+        virtual void close();
+
+        virtual int getCurFrame() const;
+        virtual int getNumFramesQueued() const;
+        virtual float getCurTime() const;
+        virtual float getFPS() const;
+        virtual void setFPS(float fps);
+        virtual FrameAvailableCode getRenderedBmps(std::vector<BitmapPtr>& pBmps,
+                float timeWanted);
+        virtual void throwAwayFrame(float timeWanted);
+
+        virtual void seek(float destTime);
+        virtual void loop();
+        virtual bool isEOF() const;
+
+        SharedVideoSourcePtr getSource();
+
+    private:
+        // The source is looked up when it's first needed, so settings made right 
+        // after startDecoding() don't cause a source to be opened in vain.
+        void attachSource();
+        void setSource(SharedVideoSourcePtr pSource);
+        FrameAvailableCode updateCurFrame(float timeWanted);
+
+        std::string m_sFilename;
+        int m_QueueLength;
+        bool m_bDeliverYCbCr;
+        float m_FPS;
+        float m_SeekTime;
+        SharedVideoSourcePtr m_pSource;
+        SharedVideoSource::FramePtr m_pCurFrame;
+        float m_CurTime;
+        int m_Iteration;
+        bool m_bEOF;
+};
+
+}
+
+#endif
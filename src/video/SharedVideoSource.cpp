@@ -0,0 +1,260 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "SharedVideoSource.h"
+#include "AsyncVideoDecoder.h"
+
+#include "../base/ObjectCounter.h"
+#include "../base/Exception.h"
+#include "../base/StringHelper.h"
+
+#include "../graphics/PixelFormat.h"
+
+using namespace std;
+
+#define SHARED_FRAME_CACHE_LENGTH 32
+
+namespace avg {
+
+SharedVideoSource::SourceList SharedVideoSource::s_Sources;
+
+SharedVideoSource::Frame::Frame(float time, int iteration, 
+        const vector<BitmapPtr>& pBmps)
+    : m_Time(time),
+      m_Iteration(iteration),
+      m_pBmps(pBmps)
+{
+}
+
+SharedVideoSourcePtr SharedVideoSource::get(const string& sFilename, 
+        bool bDeliverYCbCr, int queueLength, float fps, float seekTime)
+{
+    SharedVideoSourcePtr pSource = find(sFilename, bDeliverYCbCr, queueLength, fps,
+            seekTime);
+    if (!pSource) {
+        pSource = SharedVideoSourcePtr(new SharedVideoSource(sFilename, bDeliverYCbCr,
+                queueLength, fps, seekTime));
+        s_Sources.push_back(pSource);
+    }
+    return pSource;
+}
+
+SharedVideoSourcePtr SharedVideoSource::find(const string& sFilename, 
+        bool bDeliverYCbCr, int queueLength, float fps, float seekTime)
+{
+    string sKey = getKey(sFilename, bDeliverYCbCr, queueLength, fps, seekTime);
+    SourceList::iterator it = s_Sources.begin();
+    while (it != s_Sources.end()) {
+        SharedVideoSourcePtr pSource = it->lock();
+        if (!pSource) {
+            it = s_Sources.erase(it);
+        } else if (pSource->isAvailable(sKey)) {
+            return pSource;
+        } else {
+            ++it;
+        }
+    }
+    return SharedVideoSourcePtr();
+}
+
+int SharedVideoSource::getNumSources()
+{
+    SourceList::iterator it = s_Sources.begin();
+    while (it != s_Sources.end()) {
+        if (it->expired()) {
+            it = s_Sources.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return int(s_Sources.size());
+}
+
+SharedVideoSource::SharedVideoSource(const string& sFilename, bool bDeliverYCbCr,
+        int queueLength, float fps, float seekTime)
+    : m_sFilename(sFilename),
+      m_bDeliverYCbCr(bDeliverYCbCr),
+      m_QueueLength(queueLength),
+      m_FPS(fps),
+      m_SeekTime(-1),
+      m_bSeekFrameCached(false),
+      m_pDecoder(new AsyncVideoDecoder(queueLength)),
+      m_Iteration(0)
+{
+    try {
+        m_pDecoder->open(sFilename, false);
+        m_pDecoder->startDecoding(bDeliverYCbCr, 0);
+        if (fps != 0) {
+            m_pDecoder->setFPS(fps);
+        }
+        if (seekTime != -1) {
+            seek(seekTime);
+        }
+    } catch (const Exception&) {
+        delete m_pDecoder;
+        throw;
+    }
+    ObjectCounter::get()->incRef(&typeid(*this));
+}
+
+SharedVideoSource::~SharedVideoSource()
+{
+    m_Frames.clear();
+    delete m_pDecoder;
+    ObjectCounter::get()->decRef(&typeid(*this));
+}
+
+SharedVideoSource::FramePtr SharedVideoSource::getFrame(float timeWanted, 
+        int iteration, bool& bEOF)
+{
+    bEOF = false;
+    float timePerFrame = 1.0f/getFPS();
+    if (iteration == m_Iteration && !m_pDecoder->isEOF()) {
+        if (timeWanted == -1) {
+            if (!m_pNewestFrame) {
+                decodeFrame(timeWanted);
+            }
+            return m_pNewestFrame;
+        }
+        if (!m_pNewestFrame || 
+                timeWanted > m_pNewestFrame->m_Time + 0.5f*timePerFrame)
+        {
+            // This subscriber is furthest ahead.
+            decodeFrame(timeWanted);
+        }
+    }
+
+    FramePtr pBestFrame;
+    FramePtr pOldestFrame;
+    float lastFrameTime = -1;
+    deque<FramePtr>::iterator it;
+    for (it = m_Frames.begin(); it != m_Frames.end(); ++it) {
+        FramePtr pFrame = *it;
+        if (pFrame->m_Iteration != iteration) {
+            continue;
+        }
+        if (!pOldestFrame) {
+            pOldestFrame = pFrame;
+        }
+        if (pFrame->m_Time <= timeWanted + 0.5f*timePerFrame &&
+                (!pBestFrame || pFrame->m_Time > pBestFrame->m_Time))
+        {
+            pBestFrame = pFrame;
+        }
+        if (pFrame->m_Time > lastFrameTime) {
+            lastFrameTime = pFrame->m_Time;
+        }
+    }
+
+    bool bIterationDone = (iteration < m_Iteration || m_pDecoder->isEOF());
+    if (bIterationDone && timeWanted > lastFrameTime + 0.5f*timePerFrame) {
+        bEOF = true;
+    }
+    if (!pBestFrame) {
+        // The subscriber lags behind by more frames than the cache holds.
+        pBestFrame = pOldestFrame;
+    }
+    return pBestFrame;
+}
+
+void SharedVideoSource::seek(float destTime)
+{
+    m_pDecoder->seek(destTime);
+    m_Frames.clear();
+    m_pNewestFrame = FramePtr();
+    m_SeekTime = destTime;
+    m_bSeekFrameCached = true;
+}
+
+void SharedVideoSource::loop(int iteration)
+{
+    if (iteration > m_Iteration) {
+        m_Iteration = iteration;
+        m_pDecoder->loop();
+        m_pNewestFrame = FramePtr();
+        m_bSeekFrameCached = false;
+    }
+}
+
+int SharedVideoSource::getIteration() const
+{
+    return m_Iteration;
+}
+
+float SharedVideoSource::getFPS() const
+{
+    return m_pDecoder->getFPS();
+}
+
+void SharedVideoSource::setFPS(float fps)
+{
+    m_pDecoder->setFPS(fps);
+    m_FPS = fps;
+}
+
+int SharedVideoSource::getNumFramesQueued() const
+{
+    return m_pDecoder->getNumFramesQueued();
+}
+
+int SharedVideoSource::getNumCachedFrames() const
+{
+    return int(m_Frames.size());
+}
+
+string SharedVideoSource::getKey(const string& sFilename, bool bDeliverYCbCr,
+        int queueLength, float fps, float seekTime)
+{
+    return sFilename + "|" + toString(bDeliverYCbCr) + "|" + toString(queueLength) + 
+            "|" + toString(fps) + "|" + toString(seekTime);
+}
+
+bool SharedVideoSource::isAvailable(const string& sKey) const
+{
+    if (m_SeekTime != -1 && !m_bSeekFrameCached) {
+        // A subscriber that seeks here wouldn't get the frame it seeked to.
+        return false;
+    }
+    return getKey(m_sFilename, m_bDeliverYCbCr, m_QueueLength, m_FPS, m_SeekTime) ==
+            sKey;
+}
+
+void SharedVideoSource::decodeFrame(float timeWanted)
+{
+    vector<BitmapPtr> pBmps(getNumPixelFormatPlanes(m_pDecoder->getPixelFormat()));
+    FrameAvailableCode frameAvailable = m_pDecoder->getRenderedBmps(pBmps, timeWanted);
+    if (frameAvailable == FA_NEW_FRAME) {
+        addFrame(FramePtr(new Frame(m_pDecoder->getCurTime(), m_Iteration, pBmps)));
+    }
+}
+
+void SharedVideoSource::addFrame(FramePtr pFrame)
+{
+    m_Frames.push_back(pFrame);
+    m_pNewestFrame = pFrame;
+    if (m_Frames.size() > SHARED_FRAME_CACHE_LENGTH) {
+        m_Frames.pop_front();
+        m_bSeekFrameCached = false;
+    }
+}
+
+}
@@ -0,0 +1,114 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _SharedVideoSource_H_
+#define _SharedVideoSource_H_
+
+#include "../api.h"
+#include "VideoDecoder.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include <deque>
+#include <list>
+#include <string>
+#include <vector>
+
+namespace avg {
+
+class AsyncVideoDecoder;
+class SharedVideoSource;
+typedef boost::shared_ptr<SharedVideoSource> SharedVideoSourcePtr;
+
+// One decoding pipeline for a video file that is played by several VideoNodes at the
+// same time. Decoded frames are kept in a cache of recent frames so subscribers that 
+// lag behind the one driving the decoder by a few frames are served from memory.
+// Subscribers that seek to the same time share a source as well. Sources are created
+// and used in the main thread only.
+class AVG_API SharedVideoSource {
+    public:
+        struct Frame {
+            Frame(float time, int iteration, const std::vector<BitmapPtr>& pBmps);
+
+            float m_Time;
+            int m_Iteration;
+            std::vector<BitmapPtr> m_pBmps;
+        };
+        typedef boost::shared_ptr<Frame> FramePtr;
+
+        // Returns a source that plays the file with the given settings, creating
+        // it if necessary. fps == 0 plays the file at the stream frame rate. 
+        // seekTime == -1 plays the file from the start, anything else returns a source
+        // that has been seeked to seekTime and still has the frame there.
+        static SharedVideoSourcePtr get(const std::string& sFilename, 
+                bool bDeliverYCbCr, int queueLength, float fps, float seekTime=-1);
+        // Like get(), but returns an empty pointer instead of creating a source.
+        static SharedVideoSourcePtr find(const std::string& sFilename, 
+                bool bDeliverYCbCr, int queueLength, float fps, float seekTime=-1);
+        static int getNumSources();
+
+        SharedVideoSource(const std::string& sFilename, bool bDeliverYCbCr,
+                int queueLength, float fps, float seekTime=-1);
+        virtual ~SharedVideoSource();
+
+        // Returns the most recent frame at or before timeWanted that belongs to the 
+        // given loop iteration. Decodes new frames if the caller is the subscriber 
+        // furthest ahead. bEOF is set if the iteration has no frames after timeWanted.
+        FramePtr getFrame(float timeWanted, int iteration, bool& bEOF);
+        void seek(float destTime);
+        // Restarts the video if iteration hasn't been started yet.
+        void loop(int iteration);
+        int getIteration() const;
+
+        float getFPS() const;
+        void setFPS(float fps);
+        int getNumFramesQueued() const;
+        int getNumCachedFrames() const;
+
+    private:
+        static std::string getKey(const std::string& sFilename, bool bDeliverYCbCr,
+                int queueLength, float fps, float seekTime);
+        bool isAvailable(const std::string& sKey) const;
+        void decodeFrame(float timeWanted);
+        void addFrame(FramePtr pFrame);
+
+        std::string m_sFilename;
+        bool m_bDeliverYCbCr;
+        int m_QueueLength;
+        float m_FPS;
+        float m_SeekTime;
+        // False once the first frame after the seek has left the cache.
+        bool m_bSeekFrameCached;
+
+        AsyncVideoDecoder* m_pDecoder;
+        std::deque<FramePtr> m_Frames;
+        FramePtr m_pNewestFrame;
+        int m_Iteration;
+
+        typedef std::list<boost::weak_ptr<SharedVideoSource> > SourceList;
+        static SourceList s_Sources;
+};
+
+}
+
+#endif
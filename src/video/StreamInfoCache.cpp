@@ -0,0 +1,157 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "StreamInfoCache.h"
+
+#include "../base/FileHelper.h"
+#include "../base/Logger.h"
+#include "../base/ThreadHelper.h"
+
+using namespace std;
+
+namespace avg {
+
+StreamInfoCache::EntryMap StreamInfoCache::s_Entries;
+boost::mutex StreamInfoCache::s_Mutex;
+
+AVInputFormat* StreamInfoCache::getInputFormat(const string& sFilename)
+{
+    lock_guard lock(s_Mutex);
+    Entry* pEntry = findEntry(sFilename);
+    if (pEntry) {
+        return pEntry->m_pInputFormat;
+    } else {
+        return 0;
+    }
+}
+
+bool StreamInfoCache::restore(const string& sFilename, AVFormatContext* pContext)
+{
+    lock_guard lock(s_Mutex);
+    Entry* pEntry = findEntry(sFilename);
+    if (!pEntry || pEntry->m_pInputFormat != pContext->iformat ||
+            pEntry->m_Streams.size() != pContext->nb_streams)
+    {
+        // Formats that only discover streams while reading packets end up here.
+        return false;
+    }
+    for (unsigned i = 0; i < pContext->nb_streams; ++i) {
+        AVCodecContext* pCodec = pContext->streams[i]->codec;
+        const StreamInfo& info = pEntry->m_Streams[i];
+        if (int(pCodec->codec_type) != info.m_CodecType || 
+                int(pCodec->codec_id) != info.m_CodecID)
+        {
+            return false;
+        }
+    }
+
+    for (unsigned i = 0; i < pContext->nb_streams; ++i) {
+        AVStream* pStream = pContext->streams[i];
+        AVCodecContext* pCodec = pStream->codec;
+        const StreamInfo& info = pEntry->m_Streams[i];
+        pCodec->width = info.m_Width;
+        pCodec->height = info.m_Height;
+        pCodec->pix_fmt = (AVPixelFormat)info.m_PixelFormat;
+        pCodec->sample_rate = info.m_SampleRate;
+        pCodec->channels = info.m_Channels;
+        pCodec->sample_fmt = (AVSampleFormat)info.m_SampleFormat;
+        pCodec->channel_layout = info.m_ChannelLayout;
+        pCodec->bit_rate = info.m_BitRate;
+        pStream->r_frame_rate = info.m_RFrameRate;
+        pStream->avg_frame_rate = info.m_AvgFrameRate;
+        pStream->duration = info.m_Duration;
+        pStream->start_time = info.m_StartTime;
+        pStream->nb_frames = info.m_NumFrames;
+    }
+    pContext->duration = pEntry->m_Duration;
+    pContext->start_time = pEntry->m_StartTime;
+    pContext->bit_rate = pEntry->m_BitRate;
+    return true;
+}
+
+void StreamInfoCache::store(const string& sFilename, AVFormatContext* pContext)
+{
+    Entry entry;
+    if (!getFileStamp(sFilename, entry.m_FileSize, entry.m_ModTime)) {
+        return;
+    }
+    entry.m_pInputFormat = pContext->iformat;
+    entry.m_Duration = pContext->duration;
+    entry.m_StartTime = pContext->start_time;
+    entry.m_BitRate = pContext->bit_rate;
+    for (unsigned i = 0; i < pContext->nb_streams; ++i) {
+        AVStream* pStream = pContext->streams[i];
+        AVCodecContext* pCodec = pStream->codec;
+        StreamInfo info;
+        info.m_CodecType = int(pCodec->codec_type);
+        info.m_CodecID = int(pCodec->codec_id);
+        info.m_Width = pCodec->width;
+        info.m_Height = pCodec->height;
+        info.m_PixelFormat = int(pCodec->pix_fmt);
+        info.m_SampleRate = pCodec->sample_rate;
+        info.m_Channels = pCodec->channels;
+        info.m_SampleFormat = int(pCodec->sample_fmt);
+        info.m_ChannelLayout = pCodec->channel_layout;
+        info.m_BitRate = pCodec->bit_rate;
+        info.m_RFrameRate = pStream->r_frame_rate;
+        info.m_AvgFrameRate = pStream->avg_frame_rate;
+        info.m_Duration = pStream->duration;
+        info.m_StartTime = pStream->start_time;
+        info.m_NumFrames = pStream->nb_frames;
+        entry.m_Streams.push_back(info);
+    }
+    lock_guard lock(s_Mutex);
+    s_Entries[sFilename] = entry;
+}
+
+void StreamInfoCache::clear()
+{
+    lock_guard lock(s_Mutex);
+    s_Entries.clear();
+}
+
+int StreamInfoCache::getNumEntries()
+{
+    lock_guard lock(s_Mutex);
+    return int(s_Entries.size());
+}
+
+StreamInfoCache::Entry* StreamInfoCache::findEntry(const string& sFilename)
+{
+    EntryMap::iterator it = s_Entries.find(sFilename);
+    if (it == s_Entries.end()) {
+        return 0;
+    }
+    long long fileSize;
+    long long modTime;
+    if (!getFileStamp(sFilename, fileSize, modTime) || 
+            fileSize != it->second.m_FileSize || modTime != it->second.m_ModTime)
+    {
+        AVG_TRACE(Logger::category::PLAYER, Logger::severity::DEBUG,
+                sFilename << " changed on disk, probing again.");
+        s_Entries.erase(it);
+        return 0;
+    }
+    return &(it->second);
+}
+
+}
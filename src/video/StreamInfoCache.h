@@ -0,0 +1,96 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _StreamInfoCache_H_
+#define _StreamInfoCache_H_
+
+#include "../api.h"
+#include "WrapFFMpeg.h"
+
+#include <boost/thread/mutex.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace avg {
+
+// Remembers the results of probing video files, so opening the same file again 
+// only needs a short avformat_find_stream_info() run that initializes the codecs.
+// Durations and frame rates, which need long probing, come from the cache. Entries
+// are invalidated if the file changes on disk.
+// All methods are thread-safe.
+class AVG_API StreamInfoCache {
+    public:
+        // Returns the container format found the last time the file was opened or 0 
+        // if it is unknown.
+        static AVInputFormat* getInputFormat(const std::string& sFilename);
+
+        // Copies the cached stream parameters into pContext, which must already have
+        // been probed with reduced limits. Returns false if there is no valid entry 
+        // for the file or the streams found don't match the cached ones. In that 
+        // case, the streams need to be probed completely.
+        static bool restore(const std::string& sFilename, AVFormatContext* pContext);
+        static void store(const std::string& sFilename, AVFormatContext* pContext);
+
+        static void clear();
+        static int getNumEntries();
+
+    private:
+        struct StreamInfo {
+            int m_CodecType;
+            int m_CodecID;
+            int m_Width;
+            int m_Height;
+            int m_PixelFormat;
+            int m_SampleRate;
+            int m_Channels;
+            int m_SampleFormat;
+            uint64_t m_ChannelLayout;
+            int m_BitRate;
+            AVRational m_RFrameRate;
+            AVRational m_AvgFrameRate;
+            long long m_Duration;
+            long long m_StartTime;
+            long long m_NumFrames;
+        };
+
+        struct Entry {
+            long long m_FileSize;
+            long long m_ModTime;
+            AVInputFormat* m_pInputFormat;
+            long long m_Duration;
+            long long m_StartTime;
+            int m_BitRate;
+            std::vector<StreamInfo> m_Streams;
+        };
+
+        static Entry* findEntry(const std::string& sFilename);
+
+        typedef std::map<std::string, Entry> EntryMap;
+        static EntryMap s_Entries;
+        static boost::mutex s_Mutex;
+};
+
+}
+
+#endif
@@ -78,6 +78,7 @@ void SyncVideoDecoder::startDecoding(bool bDeliverYCbCr, const AudioParams* pAP)
     vector<int> streamIndexes;
     streamIndexes.push_back(getVStreamIndex());
     m_pDemuxer = new FFMpegDemuxer(getFormatContext(), streamIndexes);
+    m_pDemuxer->setKeyframeIndex(getKeyframeIndex());
 
     m_pFrameDecoder = FFMpegFrameDecoderPtr(new FFMpegFrameDecoder(getVideoStream()));
     m_pFrameDecoder->setFPS(m_FPS);
@@ -212,12 +213,21 @@ FrameAvailableCode SyncVideoDecoder::readFrameForTime(AVFrame* pFrame, float tim
     {
         // The last frame is still current. Display it again.
         return FA_USE_LAST_FRAME;
+    } else if (m_bVideoSeekDone && getFastSeek()) {
+        // Deliver the keyframe the demuxer landed on. The next calls decode up to
+        // the time wanted.
+        readFrame(pFrame);
     } else {
         bool bInvalidFrame = true;
+        int numFramesRead = 0;
         while (bInvalidFrame && !isEOF()) {
             readFrame(pFrame);
+            numFramesRead++;
             bInvalidFrame = m_pFrameDecoder->getCurTime()-timeWanted < -0.5f*timePerFrame;
         }
+        if (!m_bVideoSeekDone && numFramesRead > 1) {
+            addFramesDroppedLate(numFramesRead-1);
+        }
     }
     if (m_bVideoSeekDone) {
         m_bVideoSeekDone = false;
@@ -235,7 +245,9 @@ void SyncVideoDecoder::readFrame(AVFrame* pFrame)
     if (m_bProcessingLastFrames) {
         // EOF received, but last frames still need to be decoded.
         bool bGotPicture = m_pFrameDecoder->decodeLastFrame(pFrame);
-        if (!bGotPicture) {
+        if (bGotPicture) {
+            addFramesDecoded(1);
+        } else {
             m_bProcessingLastFrames = false;
         }
     } else {        
@@ -253,6 +265,9 @@ void SyncVideoDecoder::readFrame(AVFrame* pFrame)
             if (bGotPicture && m_pFrameDecoder->isEOF()) {
                 m_bProcessingLastFrames = true;
             }
+            if (bGotPicture) {
+                addFramesDecoded(1);
+            }
             if (bGotPicture || m_pFrameDecoder->isEOF()) {
                 bDone = true;
             }
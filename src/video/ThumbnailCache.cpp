@@ -0,0 +1,357 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "ThumbnailCache.h"
+#include "StreamInfoCache.h"
+#include "KeyframeIndex.h"
+#include "VideoDecoder.h"
+
+#include "../base/Exception.h"
+#include "../base/Logger.h"
+#include "../base/ObjectCounter.h"
+#include "../base/ProfilingZoneID.h"
+#include "../base/StringHelper.h"
+#include "../base/TaskPool.h"
+#include "../base/ThreadHelper.h"
+
+#include "../graphics/PixelFormat.h"
+
+#include <boost/bind.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+namespace avg {
+
+ThumbnailCache::CacheMap ThumbnailCache::s_Caches;
+boost::mutex ThumbnailCache::s_CachesMutex;
+
+ThumbnailCache::Thumbnail::Thumbnail(float time, BitmapPtr pBmp)
+    : m_Time(time),
+      m_pBmp(pBmp)
+{
+}
+
+bool ThumbnailCache::Thumbnail::operator <(const Thumbnail& other) const
+{
+    return m_Time < other.m_Time;
+}
+
+ThumbnailCachePtr ThumbnailCache::get(const string& sFilename, float interval,
+        int width)
+{
+    string sKey = sFilename + "|" + toString(interval) + "|" + toString(width);
+    lock_guard lock(s_CachesMutex);
+    CacheMap::iterator it = s_Caches.find(sKey);
+    if (it != s_Caches.end()) {
+        ThumbnailCachePtr pCache = it->second.lock();
+        if (pCache) {
+            return pCache;
+        }
+    }
+    ThumbnailCachePtr pCache(new ThumbnailCache(sFilename, interval, width));
+    s_Caches[sKey] = pCache;
+    return pCache;
+}
+
+int ThumbnailCache::getNumCaches()
+{
+    lock_guard lock(s_CachesMutex);
+    int numCaches = 0;
+    for (CacheMap::iterator it = s_Caches.begin(); it != s_Caches.end(); ++it) {
+        if (!it->second.expired()) {
+            numCaches++;
+        }
+    }
+    return numCaches;
+}
+
+ThumbnailCache::ThumbnailCache(const string& sFilename, float interval, int width,
+        VideoDataSourcePtr pDataSource)
+    : m_sFilename(sFilename),
+      m_pDataSource(pDataSource),
+      m_Interval(interval),
+      m_Width(width),
+      m_bBuildRequested(false),
+      m_bComplete(false)
+{
+    if (interval < 0) {
+        throw Exception(AVG_ERR_OUT_OF_RANGE, 
+                "Thumbnail interval must not be negative.");
+    }
+    if (width <= 0) {
+        throw Exception(AVG_ERR_OUT_OF_RANGE, "Thumbnail width must be positive.");
+    }
+    ObjectCounter::get()->incRef(&typeid(*this));
+}
+
+ThumbnailCache::~ThumbnailCache()
+{
+    ObjectCounter::get()->decRef(&typeid(*this));
+}
+
+static ProfilingZoneID BuildThumbnailsProfilingZone("ThumbnailCache: build");
+
+void ThumbnailCache::requestBuild()
+{
+    {
+        lock_guard lock(m_Mutex);
+        if (m_bBuildRequested) {
+            return;
+        }
+        m_bBuildRequested = true;
+    }
+    // As with the keyframe index, the task keeps the cache alive until it's done.
+    TaskPool::getBackground()->submit(
+            boost::bind(&ThumbnailCache::build, shared_from_this()),
+            &BuildThumbnailsProfilingZone);
+}
+
+bool ThumbnailCache::isComplete() const
+{
+    lock_guard lock(m_Mutex);
+    return m_bComplete;
+}
+
+int ThumbnailCache::getNumThumbnails() const
+{
+    lock_guard lock(m_Mutex);
+    return m_Thumbnails.size();
+}
+
+float ThumbnailCache::getInterval() const
+{
+    return m_Interval;
+}
+
+int ThumbnailCache::getWidth() const
+{
+    return m_Width;
+}
+
+BitmapPtr ThumbnailCache::getThumbnail(float time) const
+{
+    lock_guard lock(m_Mutex);
+    if (m_Thumbnails.empty()) {
+        return BitmapPtr();
+    }
+    vector<Thumbnail>::const_iterator it = upper_bound(m_Thumbnails.begin(),
+            m_Thumbnails.end(), Thumbnail(time, BitmapPtr()));
+    if (it != m_Thumbnails.begin()) {
+        --it;
+    }
+    return it->m_pBmp;
+}
+
+void ThumbnailCache::build()
+{
+    AVFormatContext* pFormatContext = 0;
+    AVIOContext* pIOContext = 0;
+    AVInputFormat* pInputFormat = 0;
+    if (m_pDataSource) {
+        pIOContext = VideoDataSource::createIOContext(m_pDataSource);
+        pFormatContext = avformat_alloc_context();
+        pFormatContext->pb = pIOContext;
+    } else {
+        pInputFormat = StreamInfoCache::getInputFormat(m_sFilename);
+    }
+    int err = avformat_open_input(&pFormatContext, m_sFilename.c_str(), pInputFormat,
+            0);
+    bool bOpened = (err >= 0);
+    if (bOpened) {
+        err = avformat_find_stream_info(pFormatContext, 0);
+    }
+    AVStream* pStream = 0;
+    if (err >= 0) {
+        for (unsigned i = 0; i < pFormatContext->nb_streams; i++) {
+            if (pFormatContext->streams[i]->codec->codec_type == AVMEDIA_TYPE_VIDEO) {
+                pStream = pFormatContext->streams[i];
+                break;
+            }
+        }
+    }
+    AVCodecContext* pContext = 0;
+    if (pStream) {
+        pContext = pStream->codec;
+        AVCodec* pCodec = avcodec_find_decoder(pContext->codec_id);
+        // Only keyframes are needed, and a single thread avoids the extra frame of
+        // delay that frame-threaded decoding adds.
+        pContext->skip_frame = AVDISCARD_NONKEY;
+        pContext->thread_count = 1;
+        lock_guard lock(VideoDecoder::s_OpenMutex);
+        if (!pCodec || avcodec_open2(pContext, pCodec, 0) < 0) {
+            pContext = 0;
+        }
+    }
+    if (!pContext) {
+        if (bOpened) {
+            avformat_close_input(&pFormatContext);
+        }
+        if (pIOContext) {
+            VideoDataSource::freeIOContext(pIOContext);
+        }
+        AVG_TRACE(Logger::category::PLAYER, Logger::severity::WARNING,
+                "Could not extract thumbnails from " << m_sFilename);
+        lock_guard lock(m_Mutex);
+        m_bComplete = true;
+        return;
+    }
+
+#if LIBAVCODEC_VERSION_INT > AV_VERSION_INT(54, 28, 0) 
+    AVFrame* pFrame = av_frame_alloc();
+#else
+    AVFrame* pFrame = new AVFrame;
+#endif
+    // The keyframe index is shared with the decoders that play the file, so the file
+    // is only scanned once. This thread is a background thread anyway, so it can 
+    // build the index itself if that hasn't happened yet.
+    KeyframeIndexPtr pIndex;
+    if (m_pDataSource) {
+        pIndex = KeyframeIndexPtr(new KeyframeIndex(m_sFilename, pStream->index,
+                pStream->time_base, m_pDataSource));
+    } else {
+        pIndex = KeyframeIndex::get(m_sFilename, pStream->index, pStream->time_base);
+    }
+    pIndex->waitForBuild();
+    vector<KeyframeIndex::Entry> keyframes;
+    pIndex->getEntries(keyframes);
+
+    SwsContext* pSwsContext = 0;
+    double timeBase = av_q2d(pStream->time_base);
+    long long startPTS = pStream->start_time;
+    if (startPTS == (long long)AV_NOPTS_VALUE && !keyframes.empty()) {
+        startPTS = keyframes[0].m_PTS;
+    }
+    bool bHaveThumbnail = false;
+    float lastTime = 0;
+    AVPacket packet;
+    memset(&packet, 0, sizeof(AVPacket));
+    for (unsigned i = 0; i < keyframes.size(); ++i) {
+        const KeyframeIndex::Entry& keyframe = keyframes[i];
+        float time = float((keyframe.m_PTS-startPTS)*timeBase);
+        if (bHaveThumbnail && time < lastTime+m_Interval) {
+            continue;
+        }
+        if (pIndex->seek(pFormatContext, keyframe) < 0) {
+            continue;
+        }
+        bool bDecoded = false;
+        while (!bDecoded && av_read_frame(pFormatContext, &packet) >= 0) {
+            long long pts = packet.pts;
+            if (pts == (long long)AV_NOPTS_VALUE) {
+                pts = packet.dts;
+            }
+            // Seeks by timestamp can end up before the keyframe wanted.
+            if (packet.stream_index == pStream->index && 
+                    (packet.flags & AV_PKT_FLAG_KEY) && pts >= keyframe.m_PTS)
+            {
+                int bGotPicture = 0;
+                avcodec_decode_video2(pContext, pFrame, &bGotPicture, &packet);
+                if (!bGotPicture) {
+                    // Decoders that reorder frames hold the picture back until
+                    // more data arrives, so drain them to get it now.
+                    AVPacket emptyPacket;
+                    av_init_packet(&emptyPacket);
+                    emptyPacket.data = 0;
+                    emptyPacket.size = 0;
+                    avcodec_decode_video2(pContext, pFrame, &bGotPicture,
+                            &emptyPacket);
+                }
+                if (bGotPicture) {
+                    addThumbnail(time, createThumbnail(pContext, pFrame, 
+                            &pSwsContext));
+                    bHaveThumbnail = true;
+                    lastTime = time;
+                }
+                avcodec_flush_buffers(pContext);
+                bDecoded = true;
+            }
+            av_free_packet(&packet);
+        }
+    }
+
+    if (pSwsContext) {
+        sws_freeContext(pSwsContext);
+    }
+#if LIBAVCODEC_VERSION_INT > AV_VERSION_INT(55, 45,101)
+    av_frame_free(&pFrame);
+#elif LIBAVCODEC_VERSION_INT > AV_VERSION_INT(54, 28, 0)
+    avcodec_free_frame(&pFrame);
+#else
+    delete pFrame;
+#endif
+    {
+        lock_guard lock(VideoDecoder::s_OpenMutex);
+        avcodec_close(pContext);
+    }
+    avformat_close_input(&pFormatContext);
+    if (pIOContext) {
+        VideoDataSource::freeIOContext(pIOContext);
+    }
+    lock_guard lock(m_Mutex);
+    AVG_TRACE(Logger::category::PLAYER, Logger::severity::DEBUG,
+            "Thumbnails for " << m_sFilename << ": " << m_Thumbnails.size() << 
+            " frames.");
+    m_bComplete = true;
+}
+
+void ThumbnailCache::addThumbnail(float time, BitmapPtr pBmp)
+{
+    Thumbnail thumbnail(time, pBmp);
+    lock_guard lock(m_Mutex);
+    m_Thumbnails.insert(upper_bound(m_Thumbnails.begin(), m_Thumbnails.end(), 
+            thumbnail), thumbnail);
+}
+
+BitmapPtr ThumbnailCache::createThumbnail(AVCodecContext* pContext, AVFrame* pFrame,
+        SwsContext** ppSwsContext) const
+{
+    IntPoint size(m_Width, 
+            max(1, int(float(m_Width)*pContext->height/pContext->width+0.5f)));
+    bool bAlpha = (pContext->pix_fmt == AV_PIX_FMT_YUVA420P);
+    BitmapPtr pBmp(new Bitmap(size, bAlpha ? B8G8R8A8 : B8G8R8X8));
+    *ppSwsContext = sws_getCachedContext(*ppSwsContext, pContext->width, 
+            pContext->height, pContext->pix_fmt, size.x, size.y, AV_PIX_FMT_BGRA, 
+            SWS_BICUBIC, 0, 0, 0);
+    AVG_ASSERT(*ppSwsContext);
+    uint8_t* pDestData[4] = {pBmp->getPixels(), 0, 0, 0};
+    int destStrides[4] = {pBmp->getStride(), 0, 0, 0};
+    sws_scale(*ppSwsContext, pFrame->data, pFrame->linesize, 0, pContext->height, 
+            pDestData, destStrides);
+    if (!bAlpha) {
+        // Make sure the alpha channel is white.
+        unsigned char * pLine = pBmp->getPixels();
+        for (int y = 0; y < size.y; ++y) {
+            unsigned char * pPixel = pLine;
+            for (int x = 0; x < size.x; ++x) {
+                pPixel[3] = 0xFF;
+                pPixel += 4;
+            }
+            pLine += pBmp->getStride();
+        }
+    }
+    return pBmp;
+}
+
+}
@@ -0,0 +1,108 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _ThumbnailCache_H_
+#define _ThumbnailCache_H_
+
+#include "../api.h"
+#include "WrapFFMpeg.h"
+#include "VideoDataSource.h"
+
+#include "../base/GLMHelper.h"
+#include "../graphics/Bitmap.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace avg {
+
+class ThumbnailCache;
+typedef boost::shared_ptr<ThumbnailCache> ThumbnailCachePtr;
+
+// Downscaled frames of a video, e.g. for scrubbing. The frames are extracted in the 
+// background by a decoder of its own that only decodes keyframes, so a frame for any 
+// time is available immediately once the cache is built. The keyframes are found 
+// using the file's KeyframeIndex. Thumbnails become available progressively while 
+// the build is running.
+class AVG_API ThumbnailCache: public boost::enable_shared_from_this<ThumbnailCache> {
+    public:
+        // Caches are shared as long as someone holds a reference to them.
+        static ThumbnailCachePtr get(const std::string& sFilename, float interval,
+                int width);
+        static int getNumCaches();
+
+        // Extracts keyframes that are at least interval seconds apart (every keyframe
+        // if interval is 0) and scales them to the given width. Caches for data 
+        // sources aren't shared, since the filename doesn't identify the data.
+        ThumbnailCache(const std::string& sFilename, float interval, int width,
+                VideoDataSourcePtr pDataSource=VideoDataSourcePtr());
+        virtual ~ThumbnailCache();
+
+        // Starts extracting thumbnails if that hasn't happened yet.
+        void requestBuild();
+        bool isComplete() const;
+        int getNumThumbnails() const;
+        float getInterval() const;
+        int getWidth() const;
+
+        // Returns the last thumbnail at or before time (in seconds), the first one if
+        // there is none before it, or an empty pointer if there are no thumbnails yet.
+        BitmapPtr getThumbnail(float time) const;
+
+    private:
+        struct Thumbnail {
+            Thumbnail(float time, BitmapPtr pBmp);
+            bool operator <(const Thumbnail& other) const;
+
+            float m_Time;
+            BitmapPtr m_pBmp;
+        };
+
+        void build();
+        void addThumbnail(float time, BitmapPtr pBmp);
+        BitmapPtr createThumbnail(AVCodecContext* pContext, AVFrame* pFrame,
+                SwsContext** ppSwsContext) const;
+
+        std::string m_sFilename;
+        VideoDataSourcePtr m_pDataSource;
+        float m_Interval;
+        int m_Width;
+
+        mutable boost::mutex m_Mutex;
+        std::vector<Thumbnail> m_Thumbnails;
+        bool m_bBuildRequested;
+        bool m_bComplete;
+
+        typedef std::map<std::string, boost::weak_ptr<ThumbnailCache> > CacheMap;
+        static CacheMap s_Caches;
+        static boost::mutex s_CachesMutex;
+};
+
+}
+
+#endif
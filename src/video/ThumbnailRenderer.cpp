@@ -0,0 +1,117 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "ThumbnailRenderer.h"
+
+#include "../base/Exception.h"
+#include "../base/ObjectCounter.h"
+#include "../base/ProfilingZoneID.h"
+#include "../base/ScopeTimer.h"
+#include "../base/StringHelper.h"
+
+using namespace std;
+
+namespace avg {
+
+ThumbnailRenderer::ThumbnailRenderer(PixelFormat pf, const IntPoint& size)
+    : m_PF(pf),
+      m_Size(size),
+      m_pSwsContext(0)
+{
+    switch (pf) {
+        case YCbCr420p:
+            m_DestFmt = AV_PIX_FMT_YUV420P;
+            break;
+        case YCbCrJ420p:
+            m_DestFmt = AV_PIX_FMT_YUVJ420P;
+            break;
+        case YCbCrA420p:
+            m_DestFmt = AV_PIX_FMT_YUVA420P;
+            break;
+        case R8G8B8X8:
+        case R8G8B8A8:
+            m_DestFmt = AV_PIX_FMT_RGBA;
+            break;
+        case B8G8R8X8:
+        case B8G8R8A8:
+            m_DestFmt = AV_PIX_FMT_BGRA;
+            break;
+        default:
+            throw Exception(AVG_ERR_UNSUPPORTED, string("ThumbnailRenderer: ") +
+                    "Dest format " + toString(pf) + " not supported.");
+    }
+    if (pixelFormatIsPlanar(pf)) {
+        // libswscale rounds chroma planes of odd-sized frames up while the decoder 
+        // rounds them down, so frames are scaled to a picture of their own and the
+        // planes are copied over.
+        avpicture_alloc(&m_Pict, m_DestFmt, size.x, size.y);
+        IntPoint halfSize(size.x/2, size.y/2);
+        for (unsigned i = 0; i < getNumPixelFormatPlanes(pf); ++i) {
+            IntPoint planeSize = (i == 1 || i == 2) ? halfSize : size;
+            m_pBmps.push_back(BitmapPtr(new Bitmap(planeSize, I8)));
+        }
+    } else {
+        m_pBmps.push_back(BitmapPtr(new Bitmap(size, pf)));
+    }
+    ObjectCounter::get()->incRef(&typeid(*this));
+}
+
+ThumbnailRenderer::~ThumbnailRenderer()
+{
+    if (pixelFormatIsPlanar(m_PF)) {
+        avpicture_free(&m_Pict);
+    }
+    if (m_pSwsContext) {
+        sws_freeContext(m_pSwsContext);
+    }
+    ObjectCounter::get()->decRef(&typeid(*this));
+}
+
+static ProfilingZoneID RenderThumbnailProfilingZone("ThumbnailRenderer: render");
+
+void ThumbnailRenderer::render(BitmapPtr pThumbBmp, vector<BitmapPtr>& pBmps)
+{
+    ScopeTimer timer(RenderThumbnailProfilingZone);
+    IntPoint thumbSize = pThumbBmp->getSize();
+    m_pSwsContext = sws_getCachedContext(m_pSwsContext, thumbSize.x, thumbSize.y,
+            AV_PIX_FMT_BGRA, m_Size.x, m_Size.y, m_DestFmt, SWS_BILINEAR, 0, 0, 0);
+    AVG_ASSERT(m_pSwsContext);
+    const uint8_t* pSrcData[4] = {pThumbBmp->getPixels(), 0, 0, 0};
+    int srcStrides[4] = {pThumbBmp->getStride(), 0, 0, 0};
+    if (pixelFormatIsPlanar(m_PF)) {
+        sws_scale(m_pSwsContext, pSrcData, srcStrides, 0, thumbSize.y, m_Pict.data,
+                m_Pict.linesize);
+        for (unsigned i = 0; i < m_pBmps.size(); ++i) {
+            Bitmap planeBmp(m_pBmps[i]->getSize(), I8, m_Pict.data[i], 
+                    m_Pict.linesize[i], false);
+            m_pBmps[i]->copyPixels(planeBmp);
+        }
+    } else {
+        uint8_t* pDestData[4] = {m_pBmps[0]->getPixels(), 0, 0, 0};
+        int destStrides[4] = {m_pBmps[0]->getStride(), 0, 0, 0};
+        sws_scale(m_pSwsContext, pSrcData, srcStrides, 0, thumbSize.y, pDestData,
+                destStrides);
+    }
+    pBmps = m_pBmps;
+}
+
+}
@@ -0,0 +1,64 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _ThumbnailRenderer_H_
+#define _ThumbnailRenderer_H_
+
+#include "../api.h"
+#include "WrapFFMpeg.h"
+
+#include "../base/GLMHelper.h"
+#include "../graphics/Bitmap.h"
+#include "../graphics/PixelFormat.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+
+namespace avg {
+
+class ThumbnailRenderer;
+typedef boost::shared_ptr<ThumbnailRenderer> ThumbnailRendererPtr;
+
+// Scales thumbnails up to complete video frames in the pixel format and plane layout
+// the video decoder delivers. The scaler and the frame bitmaps are kept, so 
+// rendering doesn't allocate anything after the first frame.
+class AVG_API ThumbnailRenderer {
+    public:
+        ThumbnailRenderer(PixelFormat pf, const IntPoint& size);
+        virtual ~ThumbnailRenderer();
+
+        // The bitmaps returned are overwritten by the next call.
+        void render(BitmapPtr pThumbBmp, std::vector<BitmapPtr>& pBmps);
+
+    private:
+        PixelFormat m_PF;
+        IntPoint m_Size;
+        AVPixelFormat m_DestFmt;
+        SwsContext* m_pSwsContext;
+        AVPicture m_Pict;
+        std::vector<BitmapPtr> m_pBmps;
+};
+
+}
+
+#endif
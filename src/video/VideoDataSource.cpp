@@ -0,0 +1,258 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "VideoDataSource.h"
+
+#include "../base/Exception.h"
+#include "../base/ObjectCounter.h"
+#include "../base/StringHelper.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include <string.h>
+#include <stdio.h>
+
+// Size of the buffer libavformat reads ahead into.
+#define IO_BUFFER_SIZE 65536
+
+using namespace std;
+
+namespace avg {
+
+namespace {
+
+struct IOCursor {
+    VideoDataSourcePtr m_pSource;
+    long long m_Pos;
+};
+
+int readPacket(void* pOpaque, uint8_t* pBuf, int bufSize)
+{
+    IOCursor* pCursor = (IOCursor*)pOpaque;
+    long long bytesLeft = pCursor->m_pSource->getSize() - pCursor->m_Pos;
+    if (bytesLeft <= 0) {
+        return AVERROR_EOF;
+    }
+    int bytesRead = int(min((long long)bufSize, bytesLeft));
+    memcpy(pBuf, pCursor->m_pSource->getData()+pCursor->m_Pos, bytesRead);
+    pCursor->m_Pos += bytesRead;
+    return bytesRead;
+}
+
+int64_t seekPacket(void* pOpaque, int64_t offset, int whence)
+{
+    IOCursor* pCursor = (IOCursor*)pOpaque;
+    long long size = pCursor->m_pSource->getSize();
+    long long newPos;
+    switch (whence & ~AVSEEK_FORCE) {
+        case AVSEEK_SIZE:
+            return size;
+        case SEEK_SET:
+            newPos = offset;
+            break;
+        case SEEK_CUR:
+            newPos = pCursor->m_Pos + offset;
+            break;
+        case SEEK_END:
+            newPos = size + offset;
+            break;
+        default:
+            return -1;
+    }
+    if (newPos < 0 || newPos > size) {
+        return -1;
+    }
+    pCursor->m_Pos = newPos;
+    return newPos;
+}
+
+}
+
+VideoDataSource::VideoDataSource(const string& sName)
+    : m_sName(sName)
+{
+}
+
+VideoDataSource::~VideoDataSource()
+{
+}
+
+const string& VideoDataSource::getName() const
+{
+    return m_sName;
+}
+
+AVIOContext* VideoDataSource::createIOContext(VideoDataSourcePtr pSource)
+{
+    IOCursor* pCursor = new IOCursor;
+    pCursor->m_pSource = pSource;
+    pCursor->m_Pos = 0;
+    unsigned char* pBuffer = (unsigned char*)av_malloc(IO_BUFFER_SIZE);
+    AVIOContext* pIOContext = avio_alloc_context(pBuffer, IO_BUFFER_SIZE, 0, pCursor,
+            &readPacket, 0, &seekPacket);
+    AVG_ASSERT(pIOContext);
+    return pIOContext;
+}
+
+void VideoDataSource::freeIOContext(AVIOContext* pIOContext)
+{
+    delete (IOCursor*)pIOContext->opaque;
+    // libavformat may have replaced the buffer we allocated.
+    av_free(pIOContext->buffer);
+    av_free(pIOContext);
+}
+
+
+MemoryDataSource::MemoryDataSource(const unsigned char* pData, long long size,
+        const string& sName)
+    : VideoDataSource(sName),
+      m_Data(pData, pData+size)
+{
+    ObjectCounter::get()->incRef(&typeid(*this));
+}
+
+MemoryDataSource::~MemoryDataSource()
+{
+    ObjectCounter::get()->decRef(&typeid(*this));
+}
+
+const unsigned char* MemoryDataSource::getData() const
+{
+    if (m_Data.empty()) {
+        return 0;
+    }
+    return &(m_Data[0]);
+}
+
+long long MemoryDataSource::getSize() const
+{
+    return (long long)m_Data.size();
+}
+
+
+FileRegionDataSource::FileRegionDataSource(const string& sFilename, long long offset,
+        long long length)
+    : VideoDataSource(sFilename),
+      m_pMapping(0),
+      m_MappingSize(0),
+      m_Offset(0),
+      m_Size(0)
+{
+    long long fileSize;
+    long long mapOffset;
+#ifdef _WIN32
+    HANDLE hFile = CreateFileA(sFilename.c_str(), GENERIC_READ, FILE_SHARE_READ, 0,
+            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, 0);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        throw Exception(AVG_ERR_FILEIO, "Could not open '" + sFilename + "'.");
+    }
+    LARGE_INTEGER size;
+    GetFileSizeEx(hFile, &size);
+    fileSize = size.QuadPart;
+#else
+    int fd = ::open(sFilename.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw Exception(AVG_ERR_FILEIO, "Could not open '" + sFilename + "'.");
+    }
+    struct stat fileStat;
+    fstat(fd, &fileStat);
+    fileSize = fileStat.st_size;
+#endif
+    if (length == -1) {
+        length = fileSize - offset;
+    }
+    if (offset < 0 || length <= 0 || offset+length > fileSize) {
+#ifdef _WIN32
+        CloseHandle(hFile);
+#else
+        ::close(fd);
+#endif
+        throw Exception(AVG_ERR_OUT_OF_RANGE, "Region (" + toString(offset) + ", " +
+                toString(length) + ") is outside of '" + sFilename + "'.");
+    }
+
+    // Mappings need to start at a multiple of the allocation granularity.
+#ifdef _WIN32
+    SYSTEM_INFO sysInfo;
+    GetSystemInfo(&sysInfo);
+    mapOffset = offset - offset%sysInfo.dwAllocationGranularity;
+    m_MappingSize = offset-mapOffset+length;
+    HANDLE hMapping = CreateFileMapping(hFile, 0, PAGE_READONLY, 0, 0, 0);
+    if (hMapping) {
+        m_pMapping = (unsigned char*)MapViewOfFile(hMapping, FILE_MAP_READ, 
+                DWORD(mapOffset >> 32), DWORD(mapOffset & 0xFFFFFFFF), 
+                SIZE_T(m_MappingSize));
+        CloseHandle(hMapping);
+    }
+    CloseHandle(hFile);
+#else
+    long pageSize = sysconf(_SC_PAGESIZE);
+    mapOffset = offset - offset%pageSize;
+    m_MappingSize = offset-mapOffset+length;
+    void* pMapping = mmap(0, size_t(m_MappingSize), PROT_READ, MAP_PRIVATE, fd, 
+            off_t(mapOffset));
+    ::close(fd);
+    if (pMapping != MAP_FAILED) {
+        m_pMapping = (unsigned char*)pMapping;
+        madvise(m_pMapping, size_t(m_MappingSize), MADV_WILLNEED);
+    }
+#endif
+    if (!m_pMapping) {
+        throw Exception(AVG_ERR_FILEIO, "Could not map '" + sFilename + "' to memory.");
+    }
+    m_Offset = offset;
+    m_Size = length;
+    ObjectCounter::get()->incRef(&typeid(*this));
+}
+
+FileRegionDataSource::~FileRegionDataSource()
+{
+#ifdef _WIN32
+    UnmapViewOfFile(m_pMapping);
+#else
+    munmap(m_pMapping, size_t(m_MappingSize));
+#endif
+    ObjectCounter::get()->decRef(&typeid(*this));
+}
+
+const unsigned char* FileRegionDataSource::getData() const
+{
+    return m_pMapping + (m_MappingSize-m_Size);
+}
+
+long long FileRegionDataSource::getSize() const
+{
+    return m_Size;
+}
+
+long long FileRegionDataSource::getOffset() const
+{
+    return m_Offset;
+}
+
+}
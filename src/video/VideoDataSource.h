@@ -0,0 +1,97 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _VideoDataSource_H_
+#define _VideoDataSource_H_
+
+#include "../api.h"
+#include "WrapFFMpeg.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <string>
+#include <vector>
+
+namespace avg {
+
+class VideoDataSource;
+typedef boost::shared_ptr<VideoDataSource> VideoDataSourcePtr;
+
+// Contents of a video file that aren't opened by filename, e.g. because they have been
+// downloaded to memory or are stored inside an asset archive. Decoders read the data 
+// through a custom AVIOContext. The data is immutable, so any number of decoders and 
+// threads can read it at the same time.
+class AVG_API VideoDataSource {
+    public:
+        VideoDataSource(const std::string& sName);
+        virtual ~VideoDataSource();
+
+        // Used in log messages and as a hint when probing the container format.
+        const std::string& getName() const;
+        virtual const unsigned char* getData() const = 0;
+        virtual long long getSize() const = 0;
+
+        // Each context has a read position of its own.
+        static AVIOContext* createIOContext(VideoDataSourcePtr pSource);
+        static void freeIOContext(AVIOContext* pIOContext);
+
+    private:
+        std::string m_sName;
+};
+
+// A copy of a video file in memory.
+class AVG_API MemoryDataSource: public VideoDataSource {
+    public:
+        MemoryDataSource(const unsigned char* pData, long long size, 
+                const std::string& sName);
+        virtual ~MemoryDataSource();
+
+        virtual const unsigned char* getData() const;
+        virtual long long getSize() const;
+
+    private:
+        std::vector<unsigned char> m_Data;
+};
+
+// A region of a file, e.g. a video inside an asset archive. The region is 
+// memory-mapped and the operating system is asked to read it ahead.
+class AVG_API FileRegionDataSource: public VideoDataSource {
+    public:
+        // A length of -1 means 'up to the end of the file'.
+        FileRegionDataSource(const std::string& sFilename, long long offset, 
+                long long length);
+        virtual ~FileRegionDataSource();
+
+        virtual const unsigned char* getData() const;
+        virtual long long getSize() const;
+        long long getOffset() const;
+
+    private:
+        unsigned char* m_pMapping;
+        long long m_MappingSize;
+        long long m_Offset;
+        long long m_Size;
+};
+
+}
+
+#endif
@@ -20,11 +20,15 @@
 //
 
 #include "VideoDecoder.h"
+#include "StreamInfoCache.h"
 
 #include "../base/Exception.h"
 #include "../base/Logger.h"
 #include "../base/ObjectCounter.h"
 #include "../base/StringHelper.h"
+#include "../base/TaskPool.h"
+#include "../base/ProfilingZoneID.h"
+#include "../base/ThreadHelper.h"
 
 #include "../graphics/Bitmap.h"
 #include "../graphics/BitmapLoader.h"
@@ -33,11 +37,18 @@
 
 #include <string>
 
+#include <boost/bind.hpp>
+
 #include "WrapFFMpeg.h"
 
 using namespace std;
 using namespace boost;
 
+// Probing limits for files with cached stream info. They are enough to initialize
+// the decoders, but not to estimate durations and frame rates.
+#define CACHED_PROBE_SIZE (64*1024)
+#define CACHED_ANALYZE_DURATION (AV_TIME_BASE/2)
+
 namespace avg {
 
 bool VideoDecoder::s_bInitialized = false;
@@ -47,10 +58,17 @@ boost::mutex VideoDecoder::s_OpenMutex;
 VideoDecoder::VideoDecoder()
     : m_State(CLOSED),
       m_pFormatContext(0),
+      m_pIOContext(0),
       m_VStreamIndex(-1),
       m_pVStream(0),
       m_PF(NO_PIXELFORMAT),
       m_Size(0,0),
+      m_bFastSeek(false),
+      m_bLoopPreroll(false),
+      m_bAdaptiveDecode(false),
+      m_NumFramesDecoded(0),
+      m_NumFramesSkipped(0),
+      m_NumFramesDroppedLate(0),
       m_AStreamIndex(-1),
       m_pAStream(0)
 {
@@ -68,29 +86,65 @@ VideoDecoder::~VideoDecoder()
 
 void VideoDecoder::open(const string& sFilename, bool bEnableSound)
 {
-    lock_guard lock(s_OpenMutex);
     int err;
     m_sFilename = sFilename;
     
     AVG_TRACE(Logger::category::MEMORY, Logger::severity::INFO, "Opening " << sFilename);
-    err = avformat_open_input(&m_pFormatContext, sFilename.c_str(), 0, 0);
+    AVInputFormat* pInputFormat = 0;
+    if (m_pDataSource) {
+        m_pIOContext = VideoDataSource::createIOContext(m_pDataSource);
+        m_pFormatContext = avformat_alloc_context();
+        m_pFormatContext->pb = m_pIOContext;
+    } else {
+        pInputFormat = StreamInfoCache::getInputFormat(sFilename);
+    }
+    err = avformat_open_input(&m_pFormatContext, sFilename.c_str(), pInputFormat, 0);
     if (err < 0) {
         m_sFilename = "";
         m_pFormatContext = 0;
+        freeIOContext();
         avcodecError(sFilename, err);
     }
 
-    err = avformat_find_stream_info(m_pFormatContext, 0);
-
-    if (err < 0) {
-        m_sFilename = "";
-        m_pFormatContext = 0;
-        throw Exception(AVG_ERR_VIDEO_INIT_FAILED, 
-                sFilename + ": Could not find codec parameters.");
+    // The stream info cache identifies files by name, which doesn't work for data
+    // sources.
+    bool bStreamInfoRestored = false;
+    if (pInputFormat) {
+        // The decoders still need to see the start of the streams, but the 
+        // information that needs long probing is restored from the cache.
+        m_pFormatContext->probesize = CACHED_PROBE_SIZE;
+        m_pFormatContext->max_analyze_duration = CACHED_ANALYZE_DURATION;
+        err = avformat_find_stream_info(m_pFormatContext, 0);
+        bStreamInfoRestored = (err >= 0 && 
+                StreamInfoCache::restore(sFilename, m_pFormatContext));
+        if (!bStreamInfoRestored) {
+            // The file doesn't match the cache entry and is probed from scratch.
+            avformat_close_input(&m_pFormatContext);
+            err = avformat_open_input(&m_pFormatContext, sFilename.c_str(), 0, 0);
+            if (err < 0) {
+                m_sFilename = "";
+                m_pFormatContext = 0;
+                avcodecError(sFilename, err);
+            }
+        }
+    }
+    if (!bStreamInfoRestored) {
+        err = avformat_find_stream_info(m_pFormatContext, 0);
+        if (err < 0) {
+            m_sFilename = "";
+            m_pFormatContext = 0;
+            freeIOContext();
+            throw Exception(AVG_ERR_VIDEO_INIT_FAILED, 
+                    sFilename + ": Could not find codec parameters.");
+        }
+        if (!m_pDataSource) {
+            StreamInfoCache::store(sFilename, m_pFormatContext);
+        }
     }
     if (strcmp(m_pFormatContext->iformat->name, "image2") == 0) {
         m_sFilename = "";
         m_pFormatContext = 0;
+        freeIOContext();
         throw Exception(AVG_ERR_VIDEO_INIT_FAILED, 
                 sFilename + ": Image files not supported as videos.");
     }
@@ -133,6 +187,13 @@ void VideoDecoder::open(const string& sFilename, bool bEnableSound)
                     sFilename + ": unsupported video codec ("+szCodec+").");
         }
         m_PF = calcPixelFormat(true);
+        if (m_pDataSource) {
+            m_pKeyframeIndex = KeyframeIndexPtr(new KeyframeIndex(sFilename, 
+                    m_VStreamIndex, m_pVStream->time_base, m_pDataSource));
+        } else {
+            m_pKeyframeIndex = KeyframeIndex::get(sFilename, m_VStreamIndex, 
+                    m_pVStream->time_base);
+        }
     }
     // Enable audio stream demuxing.
     if (m_AStreamIndex >= 0) {
@@ -155,16 +216,47 @@ void VideoDecoder::open(const string& sFilename, bool bEnableSound)
     m_State = OPENED;
 }
 
+static ProfilingZoneID OpenProfilingZone("Open video");
+
+void VideoDecoder::openAsync(const string& sFilename, bool bEnableSound)
+{
+    AVG_ASSERT(m_State == CLOSED && !m_pOpenTasks);
+    // Opening can block on file I/O for a long time, so it doesn't run on the pool
+    // that does the per-frame work.
+    m_pOpenTasks = boost::shared_ptr<TaskGroup>(
+            new TaskGroup(TaskPool::getBackground()));
+    m_pOpenTasks->run(boost::bind(&VideoDecoder::open, this, sFilename, bEnableSound),
+            &OpenProfilingZone);
+}
+
+bool VideoDecoder::isOpenPending() const
+{
+    return m_pOpenTasks && !m_pOpenTasks->isDone();
+}
+
+void VideoDecoder::finishOpen()
+{
+    if (m_pOpenTasks) {
+        boost::shared_ptr<TaskGroup> pOpenTasks = m_pOpenTasks;
+        m_pOpenTasks = boost::shared_ptr<TaskGroup>();
+        pOpenTasks->wait();
+    }
+}
+
 void VideoDecoder::startDecoding(bool bDeliverYCbCr, const AudioParams* pAP)
 {
     AVG_ASSERT(m_State == OPENED);
     if (m_VStreamIndex >= 0) {
         m_PF = calcPixelFormat(bDeliverYCbCr);
     }
+    m_NumFramesDecoded = 0;
+    m_NumFramesSkipped = 0;
+    m_NumFramesDroppedLate = 0;
     bool bAudioEnabled = (pAP!=0);
     if (!bAudioEnabled) {
         m_AStreamIndex = -1;
         if (m_pAStream) {
+            lock_guard lock(s_OpenMutex);
             avcodec_close(m_pAStream->codec);
         }
         m_pAStream = 0;
@@ -190,29 +282,97 @@ void VideoDecoder::startDecoding(bool bDeliverYCbCr, const AudioParams* pAP)
 
 void VideoDecoder::close() 
 {
-    lock_guard lock(s_OpenMutex);
+    AVG_ASSERT(!m_pOpenTasks);
     AVG_TRACE(Logger::category::MEMORY, Logger::severity::INFO, "Closing " <<
             m_sFilename);
 
     // Close audio and video codecs
-    if (m_pVStream) {
-        avcodec_close(m_pVStream->codec);
-        m_pVStream = 0;
-        m_VStreamIndex = -1;
+    {
+        lock_guard lock(s_OpenMutex);
+        if (m_pVStream) {
+            avcodec_close(m_pVStream->codec);
+            m_pVStream = 0;
+            m_VStreamIndex = -1;
+        }
+        if (m_pAStream) {
+            avcodec_close(m_pAStream->codec);
+            m_pAStream = 0;
+            m_AStreamIndex = -1;
+        }
     }
+    m_pKeyframeIndex = KeyframeIndexPtr();
 
-    if (m_pAStream) {
-        avcodec_close(m_pAStream->codec);
-        m_pAStream = 0;
-        m_AStreamIndex = -1;
-    }
     if (m_pFormatContext) {
         avformat_close_input(&m_pFormatContext);
     }
+    freeIOContext();
     
     m_State = CLOSED;
 }
 
+void VideoDecoder::setDataSource(VideoDataSourcePtr pDataSource)
+{
+    AVG_ASSERT(m_State == CLOSED);
+    m_pDataSource = pDataSource;
+}
+
+VideoDataSourcePtr VideoDecoder::getDataSource() const
+{
+    return m_pDataSource;
+}
+
+void VideoDecoder::setFastSeek(bool bFastSeek)
+{
+    m_bFastSeek = bFastSeek;
+}
+
+bool VideoDecoder::getFastSeek() const
+{
+    return m_bFastSeek;
+}
+
+void VideoDecoder::setLoopPreroll(bool bLoopPreroll)
+{
+    AVG_ASSERT(m_State != DECODING);
+    m_bLoopPreroll = bLoopPreroll;
+}
+
+bool VideoDecoder::getLoopPreroll() const
+{
+    return m_bLoopPreroll;
+}
+
+void VideoDecoder::setAdaptiveDecode(bool bAdaptiveDecode)
+{
+    AVG_ASSERT(m_State != DECODING);
+    m_bAdaptiveDecode = bAdaptiveDecode;
+}
+
+bool VideoDecoder::getAdaptiveDecode() const
+{
+    return m_bAdaptiveDecode;
+}
+
+bool VideoDecoder::isSkippingFrames() const
+{
+    return false;
+}
+
+int VideoDecoder::getNumFramesDecoded() const
+{
+    return m_NumFramesDecoded;
+}
+
+int VideoDecoder::getNumFramesSkipped() const
+{
+    return m_NumFramesSkipped;
+}
+
+int VideoDecoder::getNumFramesDroppedLate() const
+{
+    return m_NumFramesDroppedLate;
+}
+
 VideoDecoder::DecoderState VideoDecoder::getState() const
 {
     return m_State;
@@ -308,6 +468,29 @@ void VideoDecoder::allocFrameBmps(vector<BitmapPtr>& pBmps)
     }
 }
 
+void VideoDecoder::freeIOContext()
+{
+    if (m_pIOContext) {
+        VideoDataSource::freeIOContext(m_pIOContext);
+        m_pIOContext = 0;
+    }
+}
+
+void VideoDecoder::addFramesDecoded(int numFrames)
+{
+    m_NumFramesDecoded += numFrames;
+}
+
+void VideoDecoder::addFramesSkipped(int numFrames)
+{
+    m_NumFramesSkipped += numFrames;
+}
+
+void VideoDecoder::addFramesDroppedLate(int numFrames)
+{
+    m_NumFramesDroppedLate += numFrames;
+}
+
 int VideoDecoder::getVStreamIndex() const
 {
     return m_VStreamIndex;
@@ -328,10 +511,39 @@ AVStream* VideoDecoder::getAudioStream() const
     return m_pAStream;
 }
 
+KeyframeIndexPtr VideoDecoder::getKeyframeIndex() const
+{
+    return m_pKeyframeIndex;
+}
+
+static int lockManager(void** ppMutex, enum AVLockOp op)
+{
+    switch (op) {
+        case AV_LOCK_CREATE:
+            *ppMutex = new boost::mutex();
+            return 0;
+        case AV_LOCK_OBTAIN:
+            static_cast<boost::mutex*>(*ppMutex)->lock();
+            return 0;
+        case AV_LOCK_RELEASE:
+            static_cast<boost::mutex*>(*ppMutex)->unlock();
+            return 0;
+        case AV_LOCK_DESTROY:
+            delete static_cast<boost::mutex*>(*ppMutex);
+            *ppMutex = 0;
+            return 0;
+        default:
+            return 1;
+    }
+}
+
 void VideoDecoder::initVideoSupport()
 {
     if (!s_bInitialized) {
         av_register_all();
+        // Lets libav protect the codec initialization it does internally, e.g. in
+        // avformat_find_stream_info(). Without it, files can't be opened in parallel.
+        av_lockmgr_register(&lockManager);
         s_bInitialized = true;
         // Tune libavcodec console spam.
 //        av_log_set_level(AV_LOG_DEBUG);
@@ -350,6 +562,7 @@ int VideoDecoder::openCodec(int streamIndex)
     if (!pCodec) {
         return -1;
     }
+    lock_guard lock(s_OpenMutex);
     int rc = avcodec_open2(pContext, pCodec, 0);
     if (rc < 0) {
         return -1;
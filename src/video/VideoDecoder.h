@@ -26,6 +26,8 @@
 #include "../avgconfigwrapper.h"
 
 #include "VideoInfo.h"
+#include "KeyframeIndex.h"
+#include "VideoDataSource.h"
 
 #include "../graphics/PixelFormat.h"
 
@@ -41,6 +43,7 @@ namespace avg {
 class Bitmap;
 typedef boost::shared_ptr<Bitmap> BitmapPtr;
 struct AudioParams;
+class TaskGroup;
 
 enum FrameAvailableCode {
     FA_NEW_FRAME, FA_USE_LAST_FRAME, FA_STILL_DECODING
@@ -57,6 +60,18 @@ class AVG_API VideoDecoder
         VideoDecoder();
         virtual ~VideoDecoder();
         virtual void open(const std::string& sFilename, bool bEnableSound);
+        // If a data source is set, open() reads the video from it instead of the file. 
+        // The filename is then only used as a name. Must be called while the decoder
+        // is closed.
+        void setDataSource(VideoDataSourcePtr pDataSource);
+        VideoDataSourcePtr getDataSource() const;
+        // Calls open() in a TaskPool thread. isOpenPending() returns true until it has
+        // finished. After that, finishOpen() must be called before any other method.
+        // It rethrows exceptions that occured while opening. This also applies to 
+        // close().
+        void openAsync(const std::string& sFilename, bool bEnableSound);
+        bool isOpenPending() const;
+        void finishOpen();
         virtual void startDecoding(bool bDeliverYCbCr, const AudioParams* pAP);
         virtual void close();
         virtual DecoderState getState() const;
@@ -65,6 +80,35 @@ class AVG_API VideoDecoder
         IntPoint getSize() const;
         float getStreamFPS() const;
 
+        // In fast seek mode, the keyframe preceding the seek destination is delivered
+        // as soon as it has been decoded. Decoding then continues to the exact 
+        // destination frame.
+        void setFastSeek(bool bFastSeek);
+        bool getFastSeek() const;
+        KeyframeIndexPtr getKeyframeIndex() const;
+
+        // In loop pre-roll mode, decoding continues at the start of the file without 
+        // waiting for loop() to be called. Must be set before startDecoding() and is 
+        // only supported by threaded decoders.
+        void setLoopPreroll(bool bLoopPreroll);
+        bool getLoopPreroll() const;
+
+        // In adaptive decode mode, a decoder that falls behind tells libavcodec to 
+        // skip non-reference frames and the loop filter and doesn't color-convert 
+        // frames that are already too late to be displayed. Must be set before 
+        // startDecoding() and is only supported by threaded decoders.
+        void setAdaptiveDecode(bool bAdaptiveDecode);
+        bool getAdaptiveDecode() const;
+
+        // Decoding statistics since startDecoding(). Skipped frames were never 
+        // delivered by the decoder, dropped frames were delivered too late to be 
+        // displayed.
+        int getNumFramesDecoded() const;
+        int getNumFramesSkipped() const;
+        int getNumFramesDroppedLate() const;
+        // True while an adaptive decoder is degrading quality to catch up.
+        virtual bool isSkippingFrames() const;
+
         virtual void seek(float destTime) = 0;
         virtual void loop() = 0;
         virtual int getCurFrame() const = 0;
@@ -79,7 +123,8 @@ class AVG_API VideoDecoder
         virtual bool isEOF() const = 0;
         virtual void throwAwayFrame(float timeWanted) = 0;
 
-        // Prevents different decoder instances from executing open/close simultaneously
+        // Protects the libav calls that aren't thread-safe: opening and closing codecs.
+        // Opening files and probing streams doesn't need it.
         static boost::mutex s_OpenMutex;
 
     protected:
@@ -88,6 +133,9 @@ class AVG_API VideoDecoder
         AVCodecContext const * getCodecContext() const;
         AVCodecContext * getCodecContext();
         void allocFrameBmps(std::vector<BitmapPtr>& pBmps);
+        void addFramesDecoded(int numFrames);
+        void addFramesSkipped(int numFrames);
+        void addFramesDroppedLate(int numFrames);
 
         int getVStreamIndex() const;
         AVStream* getVideoStream() const;
@@ -100,16 +148,27 @@ class AVG_API VideoDecoder
         float getDuration(StreamSelect streamSelect) const;
         PixelFormat calcPixelFormat(bool bUseYCbCr);
         std::string getStreamPF() const;
+        void freeIOContext();
 
         DecoderState m_State;
         AVFormatContext * m_pFormatContext;
         std::string m_sFilename;
+        VideoDataSourcePtr m_pDataSource;
+        AVIOContext * m_pIOContext;
 
         // Video
         int m_VStreamIndex;
         AVStream * m_pVStream;
         PixelFormat m_PF;
         IntPoint m_Size;
+        KeyframeIndexPtr m_pKeyframeIndex;
+        bool m_bFastSeek;
+        bool m_bLoopPreroll;
+        bool m_bAdaptiveDecode;
+        int m_NumFramesDecoded;
+        int m_NumFramesSkipped;
+        int m_NumFramesDroppedLate;
+        boost::shared_ptr<TaskGroup> m_pOpenTasks;
         
         // Audio
         int m_AStreamIndex;
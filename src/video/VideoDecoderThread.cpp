@@ -46,7 +46,14 @@ VideoDecoderThread::VideoDecoderThread(CQueue& cmdQ, VideoMsgQueue& msgQ,
       m_Size(size),
       m_PF(pf),
       m_bSeekDone(false),
-      m_bProcessingLastFrames(false)
+      m_bProcessingLastFrames(false),
+      m_bLooping(false),
+      m_bSkipFrames(false),
+      m_TimeWanted(-1),
+      m_SeekSeqNum(0),
+      m_NumLoops(0),
+      m_NumFramesSkipped(0),
+      m_LastDecodedFrameTime(-1)
 {
     m_pFrameDecoder = FFMpegFrameDecoderPtr(new FFMpegFrameDecoder(pStream));
 }
@@ -100,6 +107,13 @@ bool VideoDecoderThread::work()
                 handleEOF();
                 m_bProcessingLastFrames = true;
                 break;
+            case VideoMsg::LOOP:
+                // Decode the frames still buffered in the codec, then continue with 
+                // the packets from the start of the file.
+                m_bLooping = true;
+                m_bProcessingLastFrames = true;
+                handleEOF();
+                break;
             case VideoMsg::SEEK_DONE:
                 handleSeekDone(pMsg);
                 break;
@@ -132,12 +146,36 @@ void VideoDecoderThread::returnFrame(VideoMsgPtr pMsg)
     }
 }
 
+void VideoDecoderThread::setSkipFrames(bool bSkip)
+{
+    m_bSkipFrames = bSkip;
+    m_pFrameDecoder->setSkipNonRefFrames(bSkip);
+    if (!bSkip) {
+        m_TimeWanted = -1;
+    }
+}
+
+void VideoDecoderThread::setTimeWanted(float timeWanted, int seekSeqNum, int numLoops)
+{
+    // Times sent before a seek or loop was processed here refer to the old position.
+    if (seekSeqNum == m_SeekSeqNum && numLoops == m_NumLoops) {
+        m_TimeWanted = timeWanted;
+    }
+}
+
 void VideoDecoderThread::decodePacket(AVPacket* pPacket)
 {
     bool bGotPicture = m_pFrameDecoder->decodePacket(pPacket, m_pFrame, m_bSeekDone);
     if (bGotPicture) {
+        bool bFrameAfterSeek = m_bSeekDone;
         m_bSeekDone = false;
-        sendFrame(m_pFrame);
+        countCodecSkippedFrames();
+        if (!bFrameAfterSeek && isFrameLate()) {
+            // The frame will never be displayed, so don't bother converting it.
+            m_NumFramesSkipped++;
+        } else {
+            sendFrame(m_pFrame);
+        }
     }
 }
 
@@ -149,7 +187,17 @@ void VideoDecoderThread::handleEOF()
     } else {
         m_bProcessingLastFrames = false;
         VideoMsgPtr pMsg(new VideoMsg());
-        pMsg->setEOF();
+        if (m_bLooping) {
+            m_bLooping = false;
+            m_pFrameDecoder->handleSeek();
+            m_bSeekDone = true;
+            m_NumLoops++;
+            m_TimeWanted = -1;
+            m_LastDecodedFrameTime = -1;
+            pMsg->setLoop();
+        } else {
+            pMsg->setEOF();
+        }
         pushMsg(pMsg);
     }
 }
@@ -158,6 +206,10 @@ void VideoDecoderThread::handleSeekDone(VideoMsgPtr pMsg)
 {
     m_pFrameDecoder->handleSeek();
     m_bSeekDone = true;
+    m_SeekSeqNum = pMsg->getSeekSeqNum();
+    m_NumLoops = 0;
+    m_TimeWanted = -1;
+    m_LastDecodedFrameTime = -1;
     m_MsgQ.clear();
     pushMsg(pMsg);
 }
@@ -185,10 +237,36 @@ void VideoDecoderThread::sendFrame(AVFrame* pFrame)
         pBmps.push_back(getBmp(m_pBmpQ, m_Size, m_PF));
         m_pFrameDecoder->convertFrameToBmp(pFrame, pBmps[0]);
     }
-    pMsg->setFrame(pBmps, m_pFrameDecoder->getCurTime());
+    pMsg->setFrame(pBmps, m_pFrameDecoder->getCurTime(), m_NumFramesSkipped);
+    m_NumFramesSkipped = 0;
     pushMsg(pMsg);
 }
 
+bool VideoDecoderThread::isFrameLate() const
+{
+    if (!m_bSkipFrames || m_TimeWanted == -1) {
+        return false;
+    }
+    float timePerFrame = 1.0f/m_pFrameDecoder->getFPS();
+    return m_pFrameDecoder->getCurTime() < m_TimeWanted-0.5f*timePerFrame;
+}
+
+void VideoDecoderThread::countCodecSkippedFrames()
+{
+    // Packets that don't produce a picture can also be buffered by the decoder, so 
+    // frames discarded by libavcodec are counted by the gaps they leave in the frame
+    // times.
+    float curTime = m_pFrameDecoder->getCurTime();
+    if (m_pFrameDecoder->isSkippingFrames() && m_LastDecodedFrameTime != -1) {
+        float timePerFrame = 1.0f/m_pFrameDecoder->getFPS();
+        int numMissing = int((curTime-m_LastDecodedFrameTime)/timePerFrame+0.5f) - 1;
+        if (numMissing > 0) {
+            m_NumFramesSkipped += numMissing;
+        }
+    }
+    m_LastDecodedFrameTime = curTime;
+}
+
 void VideoDecoderThread::close()
 {
     m_MsgQ.clear();
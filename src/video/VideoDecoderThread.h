@@ -55,12 +55,16 @@ class AVG_API VideoDecoderThread: public WorkerThread<VideoDecoderThread> {
         bool work();
         void setFPS(float fps);
         void returnFrame(VideoMsgPtr pMsg);
+        void setSkipFrames(bool bSkip);
+        void setTimeWanted(float timeWanted, int seekSeqNum, int numLoops);
 
     private:
         void decodePacket(AVPacket* pPacket);
         void handleEOF();
         void handleSeekDone(VideoMsgPtr pMsg);
         void sendFrame(AVFrame* pFrame);
+        bool isFrameLate() const;
+        void countCodecSkippedFrames();
         void close();
         BitmapPtr getBmp(BitmapQueuePtr pBmpQ, const IntPoint& size, PixelFormat pf);
         void pushMsg(VideoMsgPtr pMsg);
@@ -77,7 +81,16 @@ class AVG_API VideoDecoderThread: public WorkerThread<VideoDecoderThread> {
 
         bool m_bSeekDone;
         bool m_bProcessingLastFrames;
+        bool m_bLooping;
         AVFrame* m_pFrame;
+
+        // Adaptive decoding
+        bool m_bSkipFrames;
+        float m_TimeWanted;
+        int m_SeekSeqNum;
+        int m_NumLoops;
+        int m_NumFramesSkipped;
+        float m_LastDecodedFrameTime;
 };
 
 }
@@ -29,12 +29,14 @@ using namespace std;
 namespace avg {
 
 VideoDemuxerThread::VideoDemuxerThread(CQueue& cmdQ, AVFormatContext* pFormatContext,
-        const map<int, VideoMsgQueuePtr>& packetQs)
+        const map<int, VideoMsgQueuePtr>& packetQs, KeyframeIndexPtr pKeyframeIndex, bool bLoop)
     : WorkerThread<VideoDemuxerThread>("VideoDemuxer", cmdQ),
       m_PacketQs(packetQs),
       m_bEOF(false),
       m_pFormatContext(pFormatContext),
-      m_pDemuxer()
+      m_pDemuxer(),
+      m_pKeyframeIndex(pKeyframeIndex),
+      m_bLoop(bLoop)
 {
     map<int, VideoMsgQueuePtr>::iterator it;
     for (it = m_PacketQs.begin(); it != m_PacketQs.end(); it++) {
@@ -55,6 +57,8 @@ bool VideoDemuxerThread::init()
         streamIndexes.push_back(it->first);
     }
     m_pDemuxer = FFMpegDemuxerPtr(new FFMpegDemuxer(m_pFormatContext, streamIndexes));
+    m_pDemuxer->setKeyframeIndex(m_pKeyframeIndex);
+    m_pDemuxer->setLoop(m_bLoop);
     return true;
 }
 
@@ -88,8 +92,13 @@ bool VideoDemuxerThread::work()
         AVPacket * pPacket = m_pDemuxer->getPacket(shortestQ);
         VideoMsgPtr pMsg(new VideoMsg);
         if (pPacket == 0) {
-            onStreamEOF(shortestQ);
-            pMsg->setEOF();
+            if (m_pDemuxer->isLoopPoint()) {
+                // The demuxer has already wrapped around, so the stream continues.
+                pMsg->setLoop();
+            } else {
+                onStreamEOF(shortestQ);
+                pMsg->setEOF();
+            }
         } else {
             pMsg->setPacket(pPacket);
         }
@@ -35,12 +35,14 @@ VideoMsg::~VideoMsg()
 {
 }
 
-void VideoMsg::setFrame(const std::vector<BitmapPtr>& pBmps, float frameTime)
+void VideoMsg::setFrame(const std::vector<BitmapPtr>& pBmps, float frameTime,
+        int numFramesSkipped)
 {
     AVG_ASSERT(pBmps.size() == 1 || pBmps.size() == 3 || pBmps.size() == 4);
     setType(FRAME);
     m_pBmps = pBmps;
     m_FrameTime = frameTime;
+    m_NumFramesSkipped = numFramesSkipped;
 }
 
 void VideoMsg::setPacket(AVPacket* pPacket)
@@ -77,5 +79,11 @@ float VideoMsg::getFrameTime()
     return m_FrameTime;
 }
 
+int VideoMsg::getNumFramesSkipped()
+{
+    AVG_ASSERT(getType() == FRAME);
+    return m_NumFramesSkipped;
+}
+
 }
 
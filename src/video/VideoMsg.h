@@ -40,13 +40,15 @@ typedef boost::shared_ptr<Bitmap> BitmapPtr;
 class AVG_API VideoMsg: public AudioMsg {
 public:
     VideoMsg();
-    void setFrame(const std::vector<BitmapPtr>& pBmps, float frameTime);
+    void setFrame(const std::vector<BitmapPtr>& pBmps, float frameTime, 
+            int numFramesSkipped);
     void setPacket(AVPacket* pPacket);
 
     virtual ~VideoMsg();
 
     BitmapPtr getFrameBitmap(int i);
     float getFrameTime();
+    int getNumFramesSkipped();
     AVPacket* getPacket();
     void freePacket();
 
@@ -54,6 +56,7 @@ private:
     // FRAME
     std::vector<BitmapPtr> m_pBmps;
     float m_FrameTime;
+    int m_NumFramesSkipped;
 
     // PACKET
     AVPacket * m_pPacket;
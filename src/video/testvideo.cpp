@@ -21,12 +21,16 @@
 
 #include "AsyncVideoDecoder.h"
 #include "SyncVideoDecoder.h"
+#include "SharedVideoDecoder.h"
+#include "StreamInfoCache.h"
+#include "KeyframeIndex.h"
 
 #include "../graphics/Filterfliprgba.h"
 #include "../graphics/Filterfliprgb.h"
 #include "../graphics/GraphicsTest.h"
 #include "../graphics/BitmapLoader.h"
 
+#include "../base/MathHelper.h"
 #include "../base/StringHelper.h"
 #include "../base/TimeSource.h"
 #include "../base/TestSuite.h"
@@ -34,6 +38,7 @@
 #include "../base/ThreadProfiler.h"
 #include "../base/Directory.h"
 #include "../base/DirEntry.h"
+#include "../base/FileHelper.h"
 
 #include <string>
 #include <sstream>
@@ -114,6 +119,18 @@ class DecoderTest: public GraphicsTest {
             }
         }
 
+        // Waits until the decoder delivers the frame for time. Returns the time at 
+        // which the frame arrived.
+        long long getFrame(VideoDecoderPtr pDecoder, float time, BitmapPtr& pBmp)
+        {
+            while (pDecoder->getRenderedBmp(pBmp, time) != FA_NEW_FRAME &&
+                    !pDecoder->isEOF())
+            {
+                msleep(0);
+            }
+            return TimeSource::get()->getCurrentMicrosecs();
+        }
+
         virtual void testEqual(Bitmap& resultBmp, const std::string& sFName, 
                 avg::PixelFormat pf = NO_PIXELFORMAT, float maxAverage=1.0,
                 float maxStdDev=1.0)
@@ -275,6 +292,231 @@ class VideoDecoderTest: public DecoderTest {
 
 };
 
+class SeekBenchmarkTest: public DecoderTest {
+    public:
+        SeekBenchmarkTest(bool bThreaded)
+            : DecoderTest("SeekBenchmarkTest", bThreaded)
+        {}
+
+        void runTests()
+        {
+            runBenchmark("mpeg1-48x48.mov", false);
+            runBenchmark("mpeg1-48x48.mov", true);
+#ifndef AVG_ENABLE_RPI
+            runBenchmark("mjpeg-48x48.avi", false);
+            runBenchmark("mjpeg-48x48.avi", true);
+#endif
+        }
+
+    private:
+        void runBenchmark(const string& sFilename, bool bFastSeek)
+        {
+            const int NUM_SEEKS = 100;
+
+            VideoDecoderPtr pDecoder = createDecoder();
+            pDecoder->open(getMediaLoc(sFilename), false);
+            pDecoder->setFastSeek(bFastSeek);
+            pDecoder->startDecoding(false, 0);
+            int numFrames = pDecoder->getVideoInfo().m_NumFrames;
+            float fps = pDecoder->getStreamFPS();
+
+            // The first seek triggers the construction of the keyframe index.
+            BitmapPtr pBmp;
+            pDecoder->seek(0);
+            getFrame(pDecoder, 0, pBmp);
+            KeyframeIndexPtr pIndex = pDecoder->getKeyframeIndex();
+            TEST(pIndex != KeyframeIndexPtr());
+            for (int i = 0; i < 500 && !pIndex->isComplete(); ++i) {
+                msleep(10);
+            }
+            TEST(pIndex->isComplete());
+            TEST(pIndex->getNumKeyframes() > 0);
+
+            long long firstFrameTime = 0;
+            long long exactFrameTime = 0;
+            for (int i = 0; i < NUM_SEEKS; ++i) {
+                // Jump back and forth through the video like a scrub wheel would.
+                int frame = (i*37)%(numFrames-1);
+                long long startTime = TimeSource::get()->getCurrentMicrosecs();
+                pDecoder->seek(frame/fps);
+                long long endTime = getFrame(pDecoder, frame/fps, pBmp);
+                firstFrameTime += endTime - startTime;
+                // In fast seek mode, the first frame is usually a keyframe before the 
+                // destination.
+                while (pDecoder->getCurFrame() != frame && !pDecoder->isEOF()) {
+                    endTime = getFrame(pDecoder, frame/fps, pBmp);
+                }
+                exactFrameTime += endTime - startTime;
+                TEST(pDecoder->getCurFrame() == frame);
+            }
+            cerr << "    " << sFilename << ", " << (bFastSeek ? "fast" : "exact") 
+                    << " seek: first frame: " << firstFrameTime/NUM_SEEKS 
+                    << " us, exact frame: " << exactFrameTime/NUM_SEEKS << " us" 
+                    << endl;
+            pDecoder->close();
+        }
+};
+
+class SharedDecoderTest: public DecoderTest {
+    public:
+        SharedDecoderTest()
+          : DecoderTest("SharedDecoderTest", true)
+        {}
+
+        void runTests()
+        {
+            typedef boost::shared_ptr<SharedVideoDecoder> SharedVideoDecoderPtr;
+            const int OFFSET = 2;
+            string sFilename = getMediaLoc("mpeg1-48x48.mov");
+            SharedVideoDecoderPtr pDecoder1(new SharedVideoDecoder(8));
+            SharedVideoDecoderPtr pDecoder2(new SharedVideoDecoder(8));
+            pDecoder1->open(sFilename, false);
+            pDecoder1->startDecoding(false, 0);
+            pDecoder2->open(sFilename, false);
+            pDecoder2->startDecoding(false, 0);
+            TEST(pDecoder1->getSource() == pDecoder2->getSource());
+            TEST(SharedVideoSource::getNumSources() == 1);
+
+            // The second decoder lags behind and gets its frames from the cache.
+            float fps = pDecoder1->getFPS();
+            vector<BitmapPtr> pBmps;
+            for (int i = 0; i < 10; ++i) {
+                BitmapPtr pBmp;
+                getFrame(pDecoder1, i/fps, pBmp);
+                TEST(pDecoder1->getCurFrame() == i);
+                pBmps.push_back(pBmp);
+                if (i >= OFFSET) {
+                    getFrame(pDecoder2, (i-OFFSET)/fps, pBmp);
+                    TEST(pDecoder2->getCurFrame() == i-OFFSET);
+                    TEST(pBmp == pBmps[i-OFFSET]);
+                }
+            }
+            TEST(pDecoder1->getSource()->getNumCachedFrames() == 10);
+
+            // Decoders with different speeds don't share a source.
+            SharedVideoDecoderPtr pDecoder3(new SharedVideoDecoder(8));
+            pDecoder3->open(sFilename, false);
+            pDecoder3->startDecoding(false, 0);
+            TEST(pDecoder3->getSource() == pDecoder1->getSource());
+            pDecoder3->setFPS(2*fps);
+            TEST(pDecoder3->getSource() != pDecoder1->getSource());
+            TEST(almostEqual(pDecoder3->getFPS(), 2*fps));
+            TEST(almostEqual(pDecoder1->getFPS(), fps));
+            TEST(SharedVideoSource::getNumSources() == 2);
+            pDecoder3->close();
+            TEST(SharedVideoSource::getNumSources() == 1);
+
+            // Seeking one decoder doesn't move the other one.
+            BitmapPtr pBmp;
+            pDecoder2->seek(20/fps);
+            TEST(pDecoder1->getSource() != pDecoder2->getSource());
+            getFrame(pDecoder2, 20/fps, pBmp);
+            TEST(pDecoder2->getCurFrame() == 20);
+            getFrame(pDecoder1, 10/fps, pBmp);
+            TEST(pDecoder1->getCurFrame() == 10);
+            TEST(SharedVideoSource::getNumSources() == 2);
+
+            // Seeking to the same time joins the source again.
+            pDecoder1->seek(20/fps);
+            TEST(pDecoder1->getSource() == pDecoder2->getSource());
+            TEST(SharedVideoSource::getNumSources() == 1);
+            getFrame(pDecoder1, 20/fps, pBmp);
+            TEST(pDecoder1->getCurFrame() == 20);
+
+            pDecoder1->close();
+            TEST(SharedVideoSource::getNumSources() == 1);
+            pDecoder2->close();
+            TEST(SharedVideoSource::getNumSources() == 0);
+        }
+};
+
+class KeyframeIndexCacheTest: public GraphicsTest {
+    public:
+        KeyframeIndexCacheTest()
+          : GraphicsTest("KeyframeIndexCacheTest", 2)
+        {}
+
+        void runTests()
+        {
+            // Getting an index doesn't build it, so the files don't need to be videos.
+            AVRational timeBase = {1, 25};
+            string sFilename = "resultimages/keyframeindex.mov";
+            writeWholeFile(sFilename, "1");
+            KeyframeIndex::clearCache();
+
+            cerr << "    Testing LRU bound" << endl;
+            vector<KeyframeIndexPtr> pIndexes;
+            for (int i = 0; i < 16; ++i) {
+                pIndexes.push_back(KeyframeIndex::get(sFilename, i, timeBase));
+            }
+            TEST(KeyframeIndex::getNumCachedIndexes() == 16);
+            TEST(KeyframeIndex::get(sFilename, 0, timeBase) == pIndexes[0]);
+            // Stream 1 is now the least recently used index.
+            KeyframeIndex::get(sFilename, 16, timeBase);
+            TEST(KeyframeIndex::getNumCachedIndexes() == 16);
+            TEST(KeyframeIndex::get(sFilename, 0, timeBase) == pIndexes[0]);
+            TEST(KeyframeIndex::get(sFilename, 1, timeBase) != pIndexes[1]);
+            TEST(KeyframeIndex::getNumCachedIndexes() == 16);
+
+            cerr << "    Testing invalidation" << endl;
+            KeyframeIndex::clearCache();
+            TEST(KeyframeIndex::getNumCachedIndexes() == 0);
+            KeyframeIndexPtr pIndex = KeyframeIndex::get(sFilename, 0, timeBase);
+            TEST(KeyframeIndex::get(sFilename, 0, timeBase) == pIndex);
+            writeWholeFile(sFilename, "12");
+            TEST(KeyframeIndex::get(sFilename, 0, timeBase) != pIndex);
+            TEST(KeyframeIndex::getNumCachedIndexes() == 2);
+            KeyframeIndex::clearCache();
+        }
+};
+
+class StreamInfoCacheTest: public DecoderTest {
+    public:
+        StreamInfoCacheTest(bool bThreaded)
+            : DecoderTest("StreamInfoCacheTest", bThreaded)
+        {}
+
+        void runTests()
+        {
+            StreamInfoCache::clear();
+            runFileTest("mpeg1-48x48.mov", 1);
+            runFileTest("mjpeg-48x48.avi", 2);
+            runFileTest("mpeg1-48x48.mov", 2);
+        }
+
+    private:
+        void runFileTest(const string& sFilename, int numCacheEntries)
+        {
+            cerr << "    Testing " << sFilename << endl;
+            string sPath = getMediaLoc(sFilename);
+            VideoDecoderPtr pDecoder = createDecoder();
+            pDecoder->open(sPath, false);
+            VideoInfo info = pDecoder->getVideoInfo();
+            pDecoder->close();
+            TEST(StreamInfoCache::getNumEntries() == numCacheEntries);
+
+            // The second open uses the cached stream info and is asynchronous.
+            pDecoder->openAsync(sPath, false);
+            pDecoder->finishOpen();
+            TEST(!pDecoder->isOpenPending());
+            VideoInfo cachedInfo = pDecoder->getVideoInfo();
+            TEST(cachedInfo.m_sContainerFormat == info.m_sContainerFormat);
+            TEST(cachedInfo.m_Size == info.m_Size);
+            TEST(cachedInfo.m_sPixelFormat == info.m_sPixelFormat);
+            TEST(cachedInfo.m_NumFrames == info.m_NumFrames);
+            TEST(almostEqual(cachedInfo.m_StreamFPS, info.m_StreamFPS));
+            TEST(cachedInfo.m_sVCodec == info.m_sVCodec);
+            TEST(almostEqual(cachedInfo.m_Duration, info.m_Duration));
+
+            pDecoder->startDecoding(false, 0);
+            BitmapPtr pBmp;
+            pDecoder->getRenderedBmp(pBmp, -1);
+            testEqual(*pBmp, sFilename+"_1", B8G8R8X8);
+            pDecoder->close();
+            TEST(StreamInfoCache::getNumEntries() == numCacheEntries);
+        }
+};
+
 class AudioDecoderTest: public DecoderTest {
     public:
         AudioDecoderTest()
@@ -473,6 +715,12 @@ private:
     {
         addTest(TestPtr(new VideoDecoderTest(false)));
         addTest(TestPtr(new VideoDecoderTest(true)));
+        addTest(TestPtr(new SeekBenchmarkTest(false)));
+        addTest(TestPtr(new SeekBenchmarkTest(true)));
+        addTest(TestPtr(new SharedDecoderTest()));
+        addTest(TestPtr(new KeyframeIndexCacheTest()));
+        addTest(TestPtr(new StreamInfoCacheTest(false)));
+        addTest(TestPtr(new StreamInfoCacheTest(true)));
 
         addTest(TestPtr(new AVDecoderTest()));
     }
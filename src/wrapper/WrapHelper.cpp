@@ -495,12 +495,15 @@ void export_base()
     to_python_converter<vector<string>, to_list<vector<string> > >();    
     from_python_sequence<vector<string> >();
   
+    to_python_converter<vector<float>, to_list<vector<float> > >();    
+    to_python_converter<vector<int>, to_list<vector<int> > >();    
     from_python_sequence<vector<float> >();
     from_python_sequence<vector<int> >();
 
     to_python_converter<std::type_info, type_info_to_string>();
     //Maps
     to_python_converter<TypeMap, to_dict<TypeMap> >();
+    to_python_converter<MemUsageMap, to_dict<MemUsageMap> >();
     to_python_converter<CatToSeverityMap, to_dict<CatToSeverityMap> >();
 }
 
@@ -527,6 +530,21 @@ void removePythonLogger(PyObject * self, PyObject * pyLogger)
     }
 }
 
+void setLoggerAsync(Logger* pLogger, bool bAsync)
+{
+    // Sinks called by the flusher thread might need the GIL.
+    Py_BEGIN_ALLOW_THREADS;
+    pLogger->setAsync(bAsync);
+    Py_END_ALLOW_THREADS;
+}
+
+void flushLogger(Logger* pLogger)
+{
+    Py_BEGIN_ALLOW_THREADS;
+    pLogger->flush();
+    Py_END_ALLOW_THREADS;
+}
+
 void pytrace(PyObject * self, const avg::category_t& category, const UTF8String& sMsg,
         avg::severity_t severity)
 {
@@ -42,6 +42,7 @@ void export_anim();
 #include "../player/VersionInfo.h"
 #include "../player/ExportedObject.h"
 #include "../player/TestHelper.h"
+#include "../player/FrameStats.h"
 #include "../anim/Anim.h"
 
 #include <boost/version.hpp>
@@ -130,6 +131,40 @@ BOOST_PYTHON_MODULE(avg)
             .export_values()
         ;
 
+        to_python_converter<FrameRecordVector, to_list<FrameRecordVector> >();
+
+        class_<FrameRecord>("FrameRecord", no_init)
+            .def_readonly("frameNum", &FrameRecord::m_FrameNum)
+            .def_readonly("duration", &FrameRecord::m_Duration)
+            .def_readonly("timersTime", &FrameRecord::m_TimersTime)
+            .def_readonly("eventsTime", &FrameRecord::m_EventsTime)
+            .def_readonly("offscreenTime", &FrameRecord::m_OffscreenTime)
+            .def_readonly("renderTime", &FrameRecord::m_RenderTime)
+            .def_readonly("waitTime", &FrameRecord::m_WaitTime)
+            .def_readonly("swapTime", &FrameRecord::m_SwapTime)
+            .add_property("gpuTimes", make_getter(&FrameRecord::m_GPUTimes,
+                    return_value_policy<return_by_value>()))
+            .def_readonly("numDrawCalls", &FrameRecord::m_NumDrawCalls)
+            .def_readonly("numTexUploads", &FrameRecord::m_NumTexUploads)
+            .def_readonly("numFXRenders", &FrameRecord::m_NumFXRenders)
+            .def_readonly("bytesMoved", &FrameRecord::m_BytesMoved)
+            .def_readonly("missedVBlanks", &FrameRecord::m_MissedVBlanks)
+            .add_property("inputLatencies", make_getter(&FrameRecord::m_InputLatencies,
+                    return_value_policy<return_by_value>()))
+        ;
+
+        class_<FrameStats, boost::noncopyable>("FrameStats", no_init)
+            .def("getFrames", &FrameStats::getFrames)
+            .def("getLastFrame", &FrameStats::getLastFrame)
+            .def("getNumMissedVBlanks", &FrameStats::getNumMissedVBlanks)
+            .def("getFrameTimeHistogram", &FrameStats::getFrameTimeHistogram)
+            .def("getLatencyHistogram", &FrameStats::getLatencyHistogram)
+            .add_property("windowSize", &FrameStats::getWindowSize,
+                    &FrameStats::setWindowSize)
+            .add_property("gpuTimersEnabled", &FrameStats::getGPUTimersEnabled,
+                    &FrameStats::setGPUTimersEnabled)
+        ;
+
         object playerClass = class_<Player, bases<Publisher>, boost::noncopyable>
                 ("Player") 
             .def("get", &Player::get, 
@@ -180,6 +215,7 @@ BOOST_PYTHON_MODULE(avg)
             .def("setOnFrameHandler", &Player::setOnFrameHandler)
             .def("clearInterval", &Player::clearInterval)
             .def("addInputDevice", &Player::addInputDevice)
+            .def("getNumCoalescedEvents", &Player::getNumCoalescedEvents)
             .def("getMouseState", &Player::getMouseState)
             .def("getCurrentEvent", &Player::getCurrentEvent)
             .def("getKeyModifierState", &Player::getKeyModifierState)
@@ -194,6 +230,10 @@ BOOST_PYTHON_MODULE(avg)
             .def("getVideoRefreshRate", &Player::getVideoRefreshRate)
             .def("getVideoMemInstalled", &Player::getVideoMemInstalled)
             .def("getVideoMemUsed", &Player::getVideoMemUsed)
+            .def("getResourceMemUsage", &Player::getResourceMemUsage)
+            .def("getNumDeferredTexUploads", &Player::getNumDeferredTexUploads)
+            .def("getFrameStats", &Player::getFrameStats,
+                    return_value_policy<reference_existing_object>())
             .def("setGamma", &Player::setGamma)
             .def("setMousePos", &Player::setMousePos)
             .def("loadPlugin", &Player::loadPlugin)
@@ -204,6 +244,9 @@ BOOST_PYTHON_MODULE(avg)
             .def("areFullShadersSupported", &Player::areFullShadersSupported)
             .add_property("pluginPath", &Player::getPluginPath, &Player::setPluginPath)
             .add_property("volume", &Player::getVolume, &Player::setVolume)
+            .add_property("fxBudget", &Player::getFXBudget, &Player::setFXBudget)
+            .add_property("texUploadBudget", &Player::getTexUploadBudget,
+                    &Player::setTexUploadBudget)
             .add_property("imageCache", make_function(&Player::getImageCache,
                     return_value_policy<reference_existing_object>()))
         ;
@@ -226,6 +269,11 @@ BOOST_PYTHON_MODULE(avg)
             .add_property("mipmap", &OffscreenCanvas::getMipmap)
             .add_property("autorender", &OffscreenCanvas::getAutoRender,
                     &OffscreenCanvas::setAutoRender)
+            .add_property("skipunchanged", &OffscreenCanvas::getSkipUnchanged,
+                    &OffscreenCanvas::setSkipUnchanged)
+            .add_property("numrenders", &OffscreenCanvas::getNumRenders)
+            .add_property("numskippedframes", &OffscreenCanvas::getNumSkippedFrames)
+            .add_property("lastrendertime", &OffscreenCanvas::getLastRenderTime)
             .def("getNumDependentCanvases", &OffscreenCanvas::getNumDependentCanvases)
             .def("isSupported", &OffscreenCanvas::isSupported)
             .staticmethod("isSupported")
@@ -44,11 +44,12 @@ void export_fx()
         ;
 
     class_<BlurFXNode, bases<FXNode>, boost::shared_ptr<BlurFXNode>,
-            boost::noncopyable>("BlurFXNode", init<optional<float> >(
-                        (bp::arg("radius")=1.f)
+            boost::noncopyable>("BlurFXNode", init<optional<float, bool> >(
+                        (bp::arg("radius")=1.f, bp::arg("fast")=false)
                         ))
         .add_property("radius", &BlurFXNode::getRadius,
                 &BlurFXNode::setRadius)
+        .add_property("fast", &BlurFXNode::getFast, &BlurFXNode::setFast)
         ;
 
     class_<ChromaKeyFXNode, bases<FXNode>, boost::shared_ptr<ChromaKeyFXNode>,
@@ -98,13 +99,15 @@ void export_fx()
 
     class_<ShadowFXNode, bases<FXNode>, boost::shared_ptr<ShadowFXNode>,
             boost::noncopyable>("ShadowFXNode", 
-            init<optional<glm::vec2, float, float, std::string> >(
+            init<optional<glm::vec2, float, float, std::string, bool> >(
                 (bp::arg("offset")=glm::vec2(0,0), bp::arg("radius")=1.f,
-                 bp::arg("opacity")=1.f, bp::arg("color")=std::string("FFFFFF"))
+                 bp::arg("opacity")=1.f, bp::arg("color")=std::string("FFFFFF"),
+                 bp::arg("fast")=false)
             ))
         .add_property("offset", &ShadowFXNode::getOffset, &ShadowFXNode::setOffset)
         .add_property("radius", &ShadowFXNode::getRadius, &ShadowFXNode::setRadius)
         .add_property("opacity", &ShadowFXNode::getOpacity, &ShadowFXNode::setOpacity)
         .add_property("color", &ShadowFXNode::getColor, &ShadowFXNode::setColor)
+        .add_property("fast", &ShadowFXNode::getFast, &ShadowFXNode::setFast)
         ;
 }
@@ -77,6 +77,9 @@ void export_misc()
             .def("configureCategory", &Logger::configureCategory,
                     (bp::arg("severity")=Logger::severity::NONE))
             .def("getCategories", &Logger::getCategories)
+            .add_property("async", &Logger::isAsync, setLoggerAsync)
+            .def("flush", flushLogger)
+            .def("getNumDroppedMessages", &Logger::getNumDroppedMessages)
             .def("trace", pytrace,
                     (bp::arg("severity")=Logger::severity::INFO))
             .def("debug", &Logger::logDebug,
@@ -24,11 +24,14 @@
 
 #include "../player/CameraNode.h"
 #include "../player/VideoNode.h"
+#include "../video/SharedVideoSource.h"
 
 using namespace boost::python;
 using namespace avg;
 using namespace std;
 
+namespace bp = boost::python;
+
 char cameraNodeName[] = "camera";
 char videoNodeName[] = "video";
 
@@ -38,6 +41,49 @@ long long getDurationDeprecated(VideoNode* pNode)
     return pNode->getDuration();
 }
 
+VideoDataSourcePtr createMemoryDataSource(object data, const string& sName)
+{
+    // File-like objects are read completely here, because the decoder threads can't
+    // call python code.
+    if (PyObject_HasAttrString(data.ptr(), "read")) {
+        data = data.attr("read")();
+    }
+    PyObject* pExporter = data.ptr();
+    if (PyObject_CheckBuffer(pExporter)) {
+        Py_buffer bufferView;
+        if (PyObject_GetBuffer(pExporter, &bufferView, PyBUF_SIMPLE) == -1) {
+            throw_error_already_set();
+        }
+        VideoDataSourcePtr pSource(new MemoryDataSource(
+                reinterpret_cast<const unsigned char*>(bufferView.buf),
+                bufferView.len, sName));
+        PyBuffer_Release(&bufferView);
+        return pSource;
+    } else {
+        const void* pBuf;
+        Py_ssize_t len;
+        if (PyObject_AsReadBuffer(pExporter, &pBuf, &len) == -1) {
+            throw Exception(AVG_ERR_INVALID_ARGS,
+                    "MemoryDataSource: data must support the buffer interface or be a file-like object.");
+        }
+        return VideoDataSourcePtr(new MemoryDataSource(
+                reinterpret_cast<const unsigned char*>(pBuf), len, sName));
+    }
+}
+
+ThumbnailCachePtr createThumbnailCache(const string& sFilename, float interval, 
+        int width)
+{
+    ThumbnailCachePtr pCache = ThumbnailCache::get(sFilename, interval, width);
+    pCache->requestBuild();
+    return pCache;
+}
+
+BitmapPtr getThumbnail(ThumbnailCache* pCache, long long time)
+{
+    return pCache->getThumbnail(float(time)/1000.0f);
+}
+
 void export_raster2()
 {
     class_<CameraNode, bases<RasterNode> >("CameraNode", no_init)
@@ -61,6 +107,10 @@ void export_raster2()
         .def("play", &CameraNode::play)
         .def("stop", &CameraNode::stop)
         .def("getBitmap", &CameraNode::getBitmap)
+        .def("getCaptureLatency", &CameraNode::getCaptureLatency)
+        .def("getNumFramesCaptured", &CameraNode::getNumFramesCaptured)
+        .def("getNumFramesDropped", &CameraNode::getNumFramesDropped)
+        .def("getNumFramesMissed", &CameraNode::getNumFramesMissed)
         .def("getWhitebalanceU", &CameraNode::getWhitebalanceU)
         .def("getWhitebalanceV", &CameraNode::getWhitebalanceV)
         .def("setWhitebalance", &CameraNode::setWhitebalance)
@@ -104,6 +154,42 @@ void export_raster2()
         .add_property("controls", &CameraInfo::getControls)
     ;
         
+    class_<VideoDataSource, VideoDataSourcePtr, boost::noncopyable>("VideoDataSource",
+            no_init)
+        .add_property("name", make_function(&VideoDataSource::getName,
+                return_value_policy<copy_const_reference>()))
+        .add_property("size", &VideoDataSource::getSize)
+    ;
+
+    class_<MemoryDataSource, bases<VideoDataSource>, boost::noncopyable>(
+            "MemoryDataSource", no_init)
+        .def("__init__", make_constructor(createMemoryDataSource, 
+                default_call_policies(), (bp::arg("data"), bp::arg("name")="")))
+    ;
+
+    class_<FileRegionDataSource, bases<VideoDataSource>, boost::noncopyable>(
+            "FileRegionDataSource", init<const string&, long long, long long>(
+                    (bp::arg("filename"), bp::arg("offset")=0, bp::arg("length")=-1)))
+        .add_property("offset", &FileRegionDataSource::getOffset)
+    ;
+
+    class_<ThumbnailCache, ThumbnailCachePtr, boost::noncopyable>(
+            "VideoThumbnailCache", no_init)
+        .def("__init__", make_constructor(createThumbnailCache,
+                default_call_policies(), (bp::arg("filename"), bp::arg("interval")=1.0,
+                bp::arg("width")=160)))
+        .def("getBitmap", &getThumbnail)
+        .def("getNumThumbnails", &ThumbnailCache::getNumThumbnails)
+        .def("isComplete", &ThumbnailCache::isComplete)
+        .add_property("interval", &ThumbnailCache::getInterval)
+        .add_property("width", &ThumbnailCache::getWidth)
+    ;
+
+    class_<SharedVideoSource, boost::noncopyable>("SharedVideoSource", no_init)
+        .def("getNumSources", &SharedVideoSource::getNumSources)
+        .staticmethod("getNumSources")
+    ;
+
     class_<VideoNode, bases<RasterNode> >("VideoNode", no_init)
         .def("__init__", raw_constructor(createNode<videoNodeName>))
         .def("play", &VideoNode::play)
@@ -111,6 +197,10 @@ void export_raster2()
         .def("pause", &VideoNode::pause)
         .def("getNumFrames", &VideoNode::getNumFrames)
         .def("getNumFramesQueued", &VideoNode::getNumFramesQueued)
+        .def("getNumFramesDecoded", &VideoNode::getNumFramesDecoded)
+        .def("getNumFramesSkipped", &VideoNode::getNumFramesSkipped)
+        .def("getNumFramesDroppedLate", &VideoNode::getNumFramesDroppedLate)
+        .def("getNumFramesTooLate", &VideoNode::getNumFramesTooLate)
         .def("getCurFrame", &VideoNode::getCurFrame)
         .def("seekToFrame", &VideoNode::seekToFrame)
         .def("getStreamPixelFormat", &VideoNode::getStreamPixelFormat)
@@ -126,6 +216,7 @@ void export_raster2()
         .def("getCurTime", &VideoNode::getCurTime)
         .def("seekToTime", &VideoNode::seekToTime)
         .def("isSeeking", &VideoNode::isSeeking)
+        .def("isSkippingFrames", &VideoNode::isSkippingFrames)
         .def("hasAudio", &VideoNode::hasAudio)
         .def("hasAlpha", &VideoNode::hasAlpha)
         .def("setEOFCallback", &VideoNode::setEOFCallback)
@@ -136,8 +227,17 @@ void export_raster2()
                         return_value_policy<copy_const_reference>()),
                 &VideoNode::setHRef)
         .add_property("loop", &VideoNode::getLoop)
+        .add_property("datasource", &VideoNode::getDataSource, &VideoNode::setDataSource)
         .add_property("volume", &VideoNode::getVolume, &VideoNode::setVolume)
         .add_property("threaded", &VideoNode::isThreaded)
+        .add_property("shared", &VideoNode::isShared)
+        .add_property("asyncopen", &VideoNode::isAsyncOpen)
+        .def("isOpenPending", &VideoNode::isOpenPending)
+        .add_property("adaptivedecode", &VideoNode::isAdaptiveDecode)
+        .add_property("scrub", &VideoNode::isScrub)
+        .add_property("scrubinterval", &VideoNode::getScrubInterval)
+        .add_property("scrubcache", &VideoNode::getScrubCache)
+        .add_property("fastseek", &VideoNode::getFastSeek, &VideoNode::setFastSeek)
         .add_property("duration", &VideoNode::getDuration)
     ;
 }
@@ -91,6 +91,8 @@ void export_raster()
                 &ImageNode::setHRef)
         .add_property("compression",
                 &ImageNode::getCompression)
+        .add_property("lod", &ImageNode::getLOD)
+        .add_property("lodlevel", &ImageNode::getLODLevel)
     ;
 
     class_<FontStyle, bases<ExportedObject> >("FontStyle", no_init)